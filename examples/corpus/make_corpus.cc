@@ -0,0 +1,92 @@
+// Tool to convert space-separated text files into binary corpus files, which
+// are loaded by primitiv::Corpus without parsing.
+//
+// The vocabulary is made from the first text file and saved with one word per
+// line. Each TEXT_FILE is converted into TEXT_FILE.bin.
+//
+// Usage:
+//   $ ./a.out [options] VOCAB_FILE TEXT_FILE [TEXT_FILE ...]
+//
+// Options:
+//   --vocab-size=N  Maximum size of the vocabulary (default: all words)
+//   --unk=WORD      Replacement of unknown words (default: <unk>)
+//   --bos=WORD      Word inserted at the beginning of each line (default: none)
+//   --eos=WORD      Word inserted at the end of each line (default: none)
+//   --threads=N     Number of threads (default: all hardware threads)
+//
+// Compile:
+// g++
+//   -std=c++11
+//   -I/path/to/primitiv/includes (typically -I../..)
+//   -L/path/to/primitiv/libs     (typically -L../../build/primitiv)
+//   make_corpus.cc -lprimitiv
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <primitiv/primitiv.h>
+
+using namespace primitiv;
+using namespace std;
+
+namespace {
+
+// Retrieves the value of the option "--name=value".
+bool parse_option(const string &arg, const string &name, string &value) {
+  const string prefix = "--" + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+  value = arg.substr(prefix.size());
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  unsigned vocab_size = 0;
+  unsigned num_threads = 0;
+  string unk = "<unk>", bos, eos, value;
+  vector<string> paths;
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if (::parse_option(arg, "vocab-size", value)) {
+      vocab_size = std::atoi(value.c_str());
+    } else if (::parse_option(arg, "threads", value)) {
+      num_threads = std::atoi(value.c_str());
+    } else if (::parse_option(arg, "unk", unk)) {
+    } else if (::parse_option(arg, "bos", bos)) {
+    } else if (::parse_option(arg, "eos", eos)) {
+    } else {
+      paths.emplace_back(arg);
+    }
+  }
+  if (paths.size() < 2) {
+    cerr << "Usage: " << argv[0]
+         << " [options] VOCAB_FILE TEXT_FILE [TEXT_FILE ...]" << endl;
+    return 1;
+  }
+
+  // Special words take first IDs.
+  vector<string> specials;
+  for (const string &w : {unk, bos, eos}) {
+    if (!w.empty() && find(begin(specials), end(specials), w) == end(specials)) {
+      specials.emplace_back(w);
+    }
+  }
+
+  const auto vocab = Corpus::make_vocab(
+      paths[1], specials, vocab_size, num_threads);
+  Corpus::save_vocab(paths[0], vocab);
+  cout << "#vocab: " << vocab.size() << endl;
+
+  for (unsigned i = 1; i < paths.size(); ++i) {
+    const string output = paths[i] + ".bin";
+    Corpus::write(paths[i], output, vocab, unk, bos, eos, num_threads);
+    const Corpus corpus(output);
+    cout << output << ": " << corpus.num_sentences() << " sentences, "
+         << corpus.num_tokens() << " tokens" << endl;
+  }
+  return 0;
+}
@@ -14,7 +14,12 @@
 //   https://github.com/odashi/small_parallel_enja
 //
 // Usage:
-//   Run 'download_data.sh' in the same directory before using this code.
+//   Run 'download_data.sh' in the same directory before using this code, and
+//   convert the dataset using examples/corpus/make_corpus.cc:
+//   $ make_corpus --vocab-size=4000 --bos='<bos>' --eos='<eos>' \
+//       data/vocab.en data/train.en data/dev.en
+//   $ make_corpus --vocab-size=5000 --bos='<bos>' --eos='<eos>' \
+//       data/vocab.ja data/train.ja data/dev.ja
 //
 // [Compile]
 //   $ g++ \
@@ -33,6 +38,7 @@
 //   $ ./a.out test <model_prefix> < data/test.en > test.hyp.ja
 
 #include <algorithm>
+#include <chrono>
 #include <random>
 
 #include <primitiv/primitiv.h>
@@ -48,15 +54,18 @@ static const unsigned SRC_VOCAB_SIZE = 4000;
 static const unsigned TRG_VOCAB_SIZE = 5000;
 static const unsigned NUM_EMBED_UNITS = 512;
 static const unsigned NUM_HIDDEN_UNITS = 512;
-static const unsigned BATCH_SIZE = 64;
+static const unsigned MAX_TOKENS = 1024;
+static const unsigned BUCKET_WIDTH = 2;
 static const unsigned MAX_EPOCH = 100;
 static const float DROPOUT_RATE = 0.5;
 static const unsigned GENERATION_LIMIT = 32;
 
-static const char *SRC_TRAIN_FILE = "data/train.en";
-static const char *TRG_TRAIN_FILE = "data/train.ja";
-static const char *SRC_VALID_FILE = "data/dev.en";
-static const char *TRG_VALID_FILE = "data/dev.ja";
+static const char *SRC_VOCAB_FILE = "data/vocab.en";
+static const char *TRG_VOCAB_FILE = "data/vocab.ja";
+static const char *SRC_TRAIN_FILE = "data/train.en.bin";
+static const char *TRG_TRAIN_FILE = "data/train.ja.bin";
+static const char *SRC_VALID_FILE = "data/dev.en.bin";
+static const char *TRG_VALID_FILE = "data/dev.ja.bin";
 
 // Encoder-decoder translation model with dot-attention.
 template<typename Var>
@@ -174,18 +183,18 @@ void train(
   optimizer.add(encdec);
 
   // Loads vocab.
-  const auto src_vocab = ::make_vocab(SRC_TRAIN_FILE, SRC_VOCAB_SIZE);
-  const auto trg_vocab = ::make_vocab(TRG_TRAIN_FILE, TRG_VOCAB_SIZE);
+  const auto src_vocab = Corpus::load_vocab(SRC_VOCAB_FILE);
+  const auto trg_vocab = Corpus::load_vocab(TRG_VOCAB_FILE);
   cout << "#src_vocab: " << src_vocab.size() << endl;  // == SRC_VOCAB_SIZE
   cout << "#trg_vocab: " << trg_vocab.size() << endl;  // == TRG_VOCAB_SIZE
 
-  // Loads all corpus.
-  const auto train_src_corpus = ::load_corpus(SRC_TRAIN_FILE, src_vocab);
-  const auto train_trg_corpus = ::load_corpus(TRG_TRAIN_FILE, trg_vocab);
-  const auto valid_src_corpus = ::load_corpus(SRC_VALID_FILE, src_vocab);
-  const auto valid_trg_corpus = ::load_corpus(TRG_VALID_FILE, trg_vocab);
-  const unsigned num_train_sents = train_trg_corpus.size();
-  const unsigned num_valid_sents = valid_trg_corpus.size();
+  // Maps all corpus.
+  const Corpus train_src_corpus(SRC_TRAIN_FILE);
+  const Corpus train_trg_corpus(TRG_TRAIN_FILE);
+  const Corpus valid_src_corpus(SRC_VALID_FILE);
+  const Corpus valid_trg_corpus(TRG_VALID_FILE);
+  const unsigned num_train_sents = train_trg_corpus.num_sentences();
+  const unsigned num_valid_sents = valid_trg_corpus.num_sentences();
   const unsigned num_train_labels = ::count_labels(train_trg_corpus);
   const unsigned num_valid_labels = ::count_labels(valid_trg_corpus);
   cout << "train: " << num_train_sents << " sentences, "
@@ -197,11 +206,14 @@ void train(
   random_device rd;
   mt19937 rng(rd());
 
-  // Sentence IDs.
-  vector<unsigned> train_ids(num_train_sents);
-  vector<unsigned> valid_ids(num_valid_sents);
-  iota(begin(train_ids), end(train_ids), 0);
-  iota(begin(valid_ids), end(valid_ids), 0);
+  // Minibatches of sentence pairs with similar lengths.
+  const BatchSampler train_sampler(
+      ::pair_lengths(train_src_corpus, train_trg_corpus),
+      MAX_TOKENS, BUCKET_WIDTH);
+  const BatchSampler valid_sampler(
+      ::pair_lengths(valid_src_corpus, valid_trg_corpus),
+      MAX_TOKENS, BUCKET_WIDTH);
+  const auto valid_batches = valid_sampler.sample();
 
   // Computation graph.
   Graph g;
@@ -211,17 +223,23 @@ void train(
   for (unsigned epoch = 0; epoch < MAX_EPOCH; ++epoch) {
     cout << "epoch " << (epoch + 1) << '/' << MAX_EPOCH
          << ", lr_scale = " << optimizer.get_learning_rate_scaling() << endl;
-    // Shuffles train sentence IDs.
-    shuffle(begin(train_ids), end(train_ids), rng);
+    // Shuffles train sentences and minibatches.
+    const auto train_batches = train_sampler.sample(rng);
 
     // Training.
     float train_loss = 0;
-    for (unsigned ofs = 0; ofs < num_train_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(train_ids) + ofs,
-          begin(train_ids) + std::min<unsigned>(ofs + BATCH_SIZE, num_train_sents));
+    unsigned long long num_tokens = 0, num_padded_tokens = 0;
+    const auto start = chrono::steady_clock::now();
+    for (unsigned i = 0; i < train_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = train_batches[i];
       const auto src_batch = ::make_batch(train_src_corpus, batch_ids, src_vocab);
       const auto trg_batch = ::make_batch(train_trg_corpus, batch_ids, trg_vocab);
+      for (const unsigned sid : batch_ids) {
+        num_tokens +=
+          train_src_corpus.length(sid) + train_trg_corpus.length(sid);
+      }
+      num_padded_tokens +=
+        (src_batch.size() + trg_batch.size()) * batch_ids.size();
 
       g.clear();
       encdec.encode(src_batch, true);
@@ -232,18 +250,21 @@ void train(
       loss.backward();
       optimizer.update();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
+    const chrono::duration<double> elapsed =
+      chrono::steady_clock::now() - start;
 
     const float train_ppl = std::exp(train_loss / num_train_labels);
     cout << "  train ppl = " << train_ppl << endl;
+    cout << "  padding = "
+         << 100. * (num_padded_tokens - num_tokens) / num_padded_tokens
+         << "%, " << num_tokens / elapsed.count() << " tokens/sec" << endl;
 
     // Validation.
     float valid_loss = 0;
-    for (unsigned ofs = 0; ofs < num_valid_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(valid_ids) + ofs,
-          begin(valid_ids) + std::min<unsigned>(ofs + BATCH_SIZE, num_valid_sents));
+    for (unsigned i = 0; i < valid_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = valid_batches[i];
       const auto src_batch = ::make_batch(valid_src_corpus, batch_ids, src_vocab);
       const auto trg_batch = ::make_batch(valid_trg_corpus, batch_ids, trg_vocab);
 
@@ -252,7 +273,7 @@ void train(
       const auto loss = encdec.loss(trg_batch, false);
       valid_loss += loss.to_float() * batch_ids.size();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
 
     const float valid_ppl = std::exp(valid_loss / num_valid_labels);
@@ -277,14 +298,17 @@ void train(
 // Generates translation by consuming stdin.
 void test(::AttentionalEncoderDecoder<Tensor> &encdec) {
   // Loads vocab.
-  const auto src_vocab = ::make_vocab(SRC_TRAIN_FILE, SRC_VOCAB_SIZE);
-  const auto trg_vocab = ::make_vocab(TRG_TRAIN_FILE, TRG_VOCAB_SIZE);
+  const auto src_vocab = Corpus::load_vocab(SRC_VOCAB_FILE);
+  const auto trg_vocab = Corpus::load_vocab(TRG_VOCAB_FILE);
   const auto inv_trg_vocab = ::make_inv_vocab(trg_vocab);
 
   string line;
   while (getline(cin, line)) {
-    const vector<vector<unsigned>> src_corpus {::line_to_sent(line, src_vocab)};
-    const auto src_batch = ::make_batch(src_corpus, {0}, src_vocab);
+    // Each step of the minibatch has only one word.
+    vector<vector<unsigned>> src_batch;
+    for (const unsigned w : ::line_to_sent(line, src_vocab)) {
+      src_batch.emplace_back(1, w);
+    }
     encdec.encode(src_batch, false);
 
     // Generates target words one-by-one.
@@ -353,6 +377,9 @@ int main(const int argc, const char *argv[]) {
     ::AttentionalEncoderDecoder<Tensor> encdec;
     encdec.load(prefix + ".model");
     cerr << "done." << endl;
+    // Tensor operations are recorded and executed with fusion when their
+    // results are required.
+    dev.set_lazy(true);
     ::test(encdec);
   }
   return 0;
@@ -2,6 +2,7 @@
 #define PRIMITIV_EXAMPLE_ENCDEC_LSTM_H_
 
 #include <string>
+#include <vector>
 
 #include <primitiv/primitiv.h>
 
@@ -59,6 +60,13 @@ public:
     return h_;
   }
 
+  // Selects minibatch elements of internal states.
+  void reorder(const std::vector<unsigned> &ids) {
+    namespace F = primitiv::functions;
+    c_ = F::batch::pick(c_, ids);
+    h_ = F::batch::pick(h_, ids);
+  }
+
   // Retrieves current states.
   Var get_c() const { return c_; }
   Var get_h() const { return h_; }
@@ -1,13 +1,15 @@
 #ifndef PRIMITIV_EXAMPLE_ENCDEC_UTILS_H_
 #define PRIMITIV_EXAMPLE_ENCDEC_UTILS_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
-#include <queue>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <primitiv/corpus.h>
+
 // Helper to open fstream
 template <class FStreamT>
 inline void open_file(const std::string &path, FStreamT &fs) {
@@ -18,44 +20,6 @@ inline void open_file(const std::string &path, FStreamT &fs) {
   }
 }
 
-// Gathers the set of words from space-separated corpus and makes a vocabulary.
-inline std::unordered_map<std::string, unsigned> make_vocab(
-    const std::string &path, unsigned size) {
-  if (size < 3) {
-    std::cerr << "Vocab size should be <= 3." << std::endl;
-    exit(1);
-  }
-  std::ifstream ifs;
-  ::open_file(path, ifs);
-
-  // Counts all word existences.
-  std::unordered_map<std::string, unsigned> freq;
-  std::string line, word;
-  while (getline(ifs, line)) {
-    std::stringstream ss(line);
-    while (getline(ss, word, ' ')) ++freq[word];
-  }
-
-  // Sorting.
-  using freq_t = std::pair<std::string, unsigned>;
-  auto cmp = [](const freq_t &a, const freq_t &b) {
-    return a.second < b.second;
-  };
-  std::priority_queue<freq_t, std::vector<freq_t>, decltype(cmp)> q(cmp);
-  for (const auto &x : freq) q.push(x);
-
-  // Chooses top size-3 frequent words to make the vocabulary.
-  std::unordered_map<std::string, unsigned> vocab;
-  vocab.emplace("<unk>", 0);
-  vocab.emplace("<bos>", 1);
-  vocab.emplace("<eos>", 2);
-  for (unsigned i = 3; i < size; ++i) {
-    vocab.emplace(q.top().first, i);
-    q.pop();
-  }
-  return vocab;
-}
-
 // Generates ID-to-word dictionary.
 inline std::vector<std::string> make_inv_vocab(
     const std::unordered_map<std::string, unsigned> &vocab) {
@@ -83,27 +47,23 @@ inline std::vector<unsigned> line_to_sent(
   return sent;
 }
 
-// Generates word ID list from a corpus.
-// All out-of-vocab words are replaced to <unk>.
-inline std::vector<std::vector<unsigned>> load_corpus(
-    const std::string &path,
-    const std::unordered_map<std::string, unsigned> &vocab) {
-  std::ifstream ifs;
-  ::open_file(path, ifs);
-  std::vector<std::vector<unsigned>> corpus;
-  std::string line, word;
-  while (getline(ifs, line)) corpus.emplace_back(::line_to_sent(line, vocab));
-  return corpus;
+// Counts output labels in the corpus.
+inline unsigned count_labels(const primitiv::Corpus &corpus) {
+  return corpus.num_tokens() - corpus.num_sentences();  // w/o <bos>
 }
 
-// Counts output labels in the corpus.
-inline unsigned count_labels(const std::vector<std::vector<unsigned>> &corpus) {
-  unsigned ret = 0;
-  for (const auto &sent : corpus) ret += sent.size() - 1;  // w/o <bos>
+// Calculates lengths of sentence pairs to make minibatches, which are the
+// longer ones of source and target sentences.
+inline std::vector<unsigned> pair_lengths(
+    const primitiv::Corpus &src_corpus, const primitiv::Corpus &trg_corpus) {
+  std::vector<unsigned> ret(trg_corpus.num_sentences());
+  for (unsigned i = 0; i < ret.size(); ++i) {
+    ret[i] = std::max<unsigned>(src_corpus.length(i), trg_corpus.length(i));
+  }
   return ret;
 }
 
-// Extracts a minibatch from loaded corpus
+// Extracts a minibatch from the memory-mapped corpus.
 // NOTE(odashi):
 // Lengths of all sentences are adjusted to the maximum one in the minibatch.
 // All additional subsequences are filled by <eos>. E.g.,
@@ -122,20 +82,21 @@ inline unsigned count_labels(const std::vector<std::vector<unsigned>> &corpus) {
 //     {<eos>, <eos>, <eos>, <eos>},
 //   }
 inline std::vector<std::vector<unsigned>> make_batch(
-    const std::vector<std::vector<unsigned>> &corpus,
+    const primitiv::Corpus &corpus,
     const std::vector<unsigned> &sent_ids,
     const std::unordered_map<std::string, unsigned> &vocab) {
   const unsigned batch_size = sent_ids.size();
   const unsigned eos_id = vocab.at("<eos>");
   unsigned max_len = 0;
   for (const unsigned sid : sent_ids) {
-    max_len = std::max<unsigned>(max_len, corpus[sid].size());
+    max_len = std::max<unsigned>(max_len, corpus.length(sid));
   }
   std::vector<std::vector<unsigned>> batch(
       max_len, std::vector<unsigned>(batch_size, eos_id));
   for (unsigned i = 0; i < batch_size; ++i) {
-    const auto &sent = corpus[sent_ids[i]];
-    for (unsigned j = 0; j < sent.size(); ++j) {
+    const unsigned len = corpus.length(sent_ids[i]);
+    const std::uint32_t *sent = corpus.data(sent_ids[i]);
+    for (unsigned j = 0; j < len; ++j) {
       batch[j][i] = sent[j];
     }
   }
@@ -98,9 +98,7 @@ int main() {
   optimizer.add(pw1, pb1, pw2, pb2);
 
   // Helper lambda to construct the predictor network.
-  auto make_graph = [&](const vector<float> &inputs, bool train) {
-    // Stores input values.
-    Node x = F::input<Node>(Shape({NUM_INPUT_UNITS}, BATCH_SIZE), inputs);
+  auto make_graph = [&](const Node &x, bool train) {
     // Calculates the hidden layer.
     Node w1 = F::parameter<Node>(pw1);
     Node b1 = F::parameter<Node>(pb1);
@@ -113,6 +111,23 @@ int main() {
     return F::matmul(w2, h) + b2;
   };
 
+  // Minibatches for training are made by a background thread and uploaded to
+  // the device in advance.
+  DataLoader loader([&](DataLoader::Batch &b) {
+    b.shapes.assign({Shape({NUM_INPUT_UNITS}, BATCH_SIZE)});
+    b.values.resize(1);
+    b.values[0].resize(BATCH_SIZE * NUM_INPUT_UNITS);
+    b.ids.resize(1);
+    b.ids[0].resize(BATCH_SIZE);
+    for (unsigned i = 0; i < BATCH_SIZE; ++i) {
+      const unsigned id = b.samples[i];
+      copy(&train_inputs[id * NUM_INPUT_UNITS],
+           &train_inputs[(id + 1) * NUM_INPUT_UNITS],
+           &b.values[0][i * NUM_INPUT_UNITS]);
+      b.ids[0][i] = train_labels[id];
+    }
+  }, 1, 4, &dev);
+
   // Batch randomizer
   mt19937 rng;
   vector<unsigned> ids(NUM_TRAIN_SAMPLES);
@@ -121,28 +136,23 @@ int main() {
   for (unsigned epoch = 0; epoch < MAX_EPOCH; ++epoch) {
     // Shuffles sample IDs.
     shuffle(begin(ids), end(ids), rng);
-
-    // Training loop
+    vector<vector<unsigned>> plan(NUM_TRAIN_BATCHES);
     for (unsigned batch = 0; batch < NUM_TRAIN_BATCHES; ++batch) {
-      // Makes a minibatch for training.
-      vector<float> inputs(BATCH_SIZE * NUM_INPUT_UNITS);
-      vector<unsigned> labels(BATCH_SIZE);
-      for (unsigned i = 0; i < BATCH_SIZE; ++i) {
-        const unsigned id = ids[i + batch * BATCH_SIZE];
-        copy(&train_inputs[id * NUM_INPUT_UNITS],
-             &train_inputs[(id + 1) * NUM_INPUT_UNITS],
-             &inputs[i * NUM_INPUT_UNITS]);
-        labels[i] = train_labels[id];
-      }
+      plan[batch].assign(
+          &ids[batch * BATCH_SIZE], &ids[(batch + 1) * BATCH_SIZE]);
+    }
+    loader.start(plan);
 
+    // Training loop
+    while (const DataLoader::Batch *b = loader.next()) {
       // Constructs the graph.
       g.clear();
-      Node y = make_graph(inputs, true);
-      Node loss = F::softmax_cross_entropy(y, labels, 0);
+      Node y = make_graph(F::input_node(b->tensors[0], nullptr), true);
+      Node loss = F::softmax_cross_entropy(y, b->ids[0], 0);
       Node avg_loss = F::batch::mean(loss);
 
       // Dump computation graph at the first time.
-      //if (epoch == 0 && batch == 0) cout << g.dump("dot");
+      //if (epoch == 0 && b->index == 0) cout << g.dump("dot");
 
       // Implicit forward, backward, and updates parameters.
       optimizer.reset_gradients();
@@ -162,7 +172,8 @@ int main() {
 
       // Constructs the graph.
       g.clear();
-      Node y = make_graph(inputs, false);
+      Node y = make_graph(
+          F::input<Node>(Shape({NUM_INPUT_UNITS}, BATCH_SIZE), inputs), false);
 
       // Gets outputs, argmax, and compares them with the label.
       vector<float> y_val = y.to_vector();
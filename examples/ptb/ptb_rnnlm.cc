@@ -6,7 +6,10 @@
 //   http://www.fit.vutbr.cz/research/groups/speech/publi/2010/mikolov_interspeech2010_IS100722.pdf
 //
 // Usage:
-//   Run 'download_data.sh' in the same directory before using this code.
+//   Run 'download_data.sh' in the same directory before using this code, and
+//   convert the dataset using examples/corpus/make_corpus.cc:
+//   $ make_corpus --bos='<s>' --eos='<s>' data/ptb.vocab
+//       data/ptb.train.txt data/ptb.valid.txt
 // g++
 //   -std=c++11
 //   -I/path/to/primitiv/includes (typically -I../..)
@@ -14,6 +17,7 @@
 //   ptb_rnnlm.cc -lprimitiv
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -37,7 +41,8 @@ using namespace std;
 namespace {
 
 static const unsigned NUM_HIDDEN_UNITS = 256;
-static const unsigned BATCH_SIZE = 64;
+static const unsigned MAX_TOKENS = 2048;
+static const unsigned BUCKET_WIDTH = 4;
 static const unsigned MAX_EPOCH = 100;
 
 class RNNLM : public Model {
@@ -95,15 +100,15 @@ private:
 
 int main() {
   // Loads vocab.
-  const auto vocab = utils::make_vocab("data/ptb.train.txt");
+  const auto vocab = Corpus::load_vocab("data/ptb.vocab");
   cout << "#vocab: " << vocab.size() << endl;  // maybe 10000
   const unsigned eos_id = vocab.at("<s>");
 
-  // Loads all corpus.
-  const auto train_corpus = utils::load_corpus("data/ptb.train.txt", vocab);
-  const auto valid_corpus = utils::load_corpus("data/ptb.valid.txt", vocab);
-  const unsigned num_train_sents = train_corpus.size();
-  const unsigned num_valid_sents = valid_corpus.size();
+  // Maps all corpus.
+  const Corpus train_corpus("data/ptb.train.txt.bin");
+  const Corpus valid_corpus("data/ptb.valid.txt.bin");
+  const unsigned num_train_sents = train_corpus.num_sentences();
+  const unsigned num_valid_sents = valid_corpus.num_sentences();
   const unsigned num_train_labels = utils::count_labels(train_corpus);
   const unsigned num_valid_labels = utils::count_labels(valid_corpus);
   cout << "train: " << num_train_sents << " sentences, "
@@ -129,26 +134,33 @@ int main() {
   random_device rd;
   mt19937 rng(rd());
 
-  // Sentence IDs.
-  vector<unsigned> train_ids(num_train_sents);
-  vector<unsigned> valid_ids(num_valid_sents);
-  iota(begin(train_ids), end(train_ids), 0);
-  iota(begin(valid_ids), end(valid_ids), 0);
+  // Minibatches of sentences with similar lengths.
+  auto lengths = [](const Corpus &corpus) {
+    vector<unsigned> ret(corpus.num_sentences());
+    for (unsigned i = 0; i < ret.size(); ++i) ret[i] = corpus.length(i);
+    return ret;
+  };
+  const BatchSampler train_sampler(
+      lengths(train_corpus), MAX_TOKENS, BUCKET_WIDTH);
+  const BatchSampler valid_sampler(
+      lengths(valid_corpus), MAX_TOKENS, BUCKET_WIDTH);
+  const auto valid_batches = valid_sampler.sample();
 
   // Train/valid loop.
   for (unsigned epoch = 0; epoch < MAX_EPOCH; ++epoch) {
     cout << "epoch " << (epoch + 1) << '/' << MAX_EPOCH << ':' << endl;
-    // Shuffles train sentence IDs.
-    shuffle(begin(train_ids), end(train_ids), rng);
+    // Shuffles train sentences and minibatches.
+    const auto train_batches = train_sampler.sample(rng);
 
     // Training.
     float train_loss = 0;
-    for (unsigned ofs = 0; ofs < num_train_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(train_ids) + ofs,
-          begin(train_ids) + std::min<unsigned>(
-            ofs + BATCH_SIZE, num_train_sents));
+    unsigned long long num_tokens = 0, num_padded_tokens = 0;
+    const auto start = chrono::steady_clock::now();
+    for (unsigned i = 0; i < train_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = train_batches[i];
       const auto batch = utils::make_batch(train_corpus, batch_ids, eos_id);
+      num_tokens += train_sampler.num_tokens(batch_ids);
+      num_padded_tokens += train_sampler.num_padded_tokens(batch_ids);
 
       g.clear();
       const auto outputs = lm.forward(batch);
@@ -159,19 +171,21 @@ int main() {
       loss.backward();
       optimizer.update();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
+    const chrono::duration<double> elapsed =
+      chrono::steady_clock::now() - start;
 
     const float train_ppl = std::exp(train_loss / num_train_labels);
     cout << "  train ppl = " << train_ppl << endl;
+    cout << "  padding = "
+         << 100. * (num_padded_tokens - num_tokens) / num_padded_tokens
+         << "%, " << num_tokens / elapsed.count() << " tokens/sec" << endl;
 
     // Validation.
     float valid_loss = 0;
-    for (unsigned ofs = 0; ofs < num_valid_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(valid_ids) + ofs,
-          begin(valid_ids) + std::min<unsigned>(
-            ofs + BATCH_SIZE, num_valid_sents));
+    for (unsigned i = 0; i < valid_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = valid_batches[i];
       const auto batch = utils::make_batch(valid_corpus, batch_ids, eos_id);
 
       g.clear();
@@ -179,7 +193,7 @@ int main() {
       const auto loss = lm.forward_loss(outputs, batch);
       valid_loss += loss.to_float() * batch_ids.size();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
 
     const float valid_ppl = std::exp(valid_loss / num_valid_labels);
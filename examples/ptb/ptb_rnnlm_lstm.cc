@@ -3,7 +3,10 @@
 //   http://www.fit.vutbr.cz/~imikolov/rnnlm/simple-examples.tgz
 //
 // Usage:
-//   Run 'download_data.sh' in the same directory before using this code.
+//   Run 'download_data.sh' in the same directory before using this code, and
+//   convert the dataset using examples/corpus/make_corpus.cc:
+//   $ make_corpus --bos='<s>' --eos='<s>' data/ptb.vocab
+//       data/ptb.train.txt data/ptb.valid.txt
 // g++
 //   -std=c++11
 //   -I/path/to/primitiv/includes (typically -I../..)
@@ -11,6 +14,7 @@
 //   ptb_rnnlm_lstm.cc -lprimitiv
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -35,7 +39,9 @@ using namespace std;
 namespace {
 
 static const unsigned NUM_HIDDEN_UNITS = 650;
-static const unsigned BATCH_SIZE = 20;
+// About 20 sentences in each minibatch.
+static const unsigned MAX_TOKENS = 512;
+static const unsigned BUCKET_WIDTH = 4;
 static const unsigned MAX_EPOCH = 50;
 static const float DROPOUT_RATE = 0.5;
 
@@ -110,6 +116,12 @@ public:
     h_ = o * F::tanh(c_);
     return h_;
   }
+
+  // Drops internal states of finished sequences.
+  void shrink(const PackedSequence &seq, unsigned t) {
+    h_ = seq.shrink(h_, t);
+    c_ = seq.shrink(c_, t);
+  }
 };
 
 // Language model using above LSTM.
@@ -131,57 +143,65 @@ public:
       add("hy", hy_);
     }
 
-  // Forward function of RNNLM. Input data should be arranged below:
-  // inputs = {
-  //   {sent1_word1, sent2_word1, ..., sentN_word1},  // 1st input (<bos>)
-  //   {sent1_word2, sent2_word2, ..., sentN_word2},  // 2nd input/1st output
-  //   ...,
-  //   {sent1_wordM, sent2_wordM, ..., sentN_wordM},  // last output (<eos>)
-  // };
-  vector<Var> forward(const vector<vector<unsigned>> &inputs, bool train) {
+  // Forward function of RNNLM. Sentences in the minibatch are packed without
+  // paddings, and finished sentences are dropped from the minibatch at each
+  // step. The i-th output predicts `seq.step(i + 1)`.
+  vector<Var> forward(const PackedSequence &seq, bool train) {
     Var lookup = F::parameter<Var>(plookup_);
     rnn1_.init();
     rnn2_.init();
     hy_.init();
 
     vector<Var> outputs;
-    for (unsigned i = 0; i < inputs.size() - 1; ++i) {
-      Var x = F::pick(lookup, inputs[i], 1);
+    for (unsigned i = 0; i < seq.max_length() - 1; ++i) {
+      rnn1_.shrink(seq, i);
+      rnn2_.shrink(seq, i);
+      Var x = F::pick(lookup, seq.step(i), 1);
       x = F::dropout(x, DROPOUT_RATE, train);
       Var h1 = rnn1_.forward(x);
       h1 = F::dropout(h1, DROPOUT_RATE, train);
       Var h2 = rnn2_.forward(h1);
       h2 = F::dropout(h2, DROPOUT_RATE, train);
-      outputs.emplace_back(hy_.forward(h2));
+      outputs.emplace_back(hy_.forward(seq.shrink(h2, i + 1)));
     }
     return outputs;
   }
 
   // Loss function.
-  Var loss(
-      const vector<Var> &outputs, const vector<vector<unsigned>> &inputs) {
+  Var loss(const vector<Var> &outputs, const PackedSequence &seq) {
     vector<Var> losses;
     for (unsigned i = 0; i < outputs.size(); ++i) {
-      losses.emplace_back(
-          F::softmax_cross_entropy(outputs[i], inputs[i + 1], 0));
+      losses.emplace_back(F::batch::sum(
+            F::softmax_cross_entropy(outputs[i], seq.step(i + 1), 0)));
     }
-    return F::batch::mean(F::sum(losses));
+    return F::sum(losses) / seq.num_sequences();
   }
 };
 
+// Extracts a packed minibatch from the memory-mapped corpus.
+PackedSequence make_batch(
+    const Corpus &corpus, const vector<unsigned> &sent_ids) {
+  vector<vector<unsigned>> sents;
+  sents.reserve(sent_ids.size());
+  for (const unsigned sid : sent_ids) {
+    const unsigned *sent = corpus.data(sid);
+    sents.emplace_back(sent, sent + corpus.length(sid));
+  }
+  return PackedSequence(sents);
+}
+
 }  // namespace
 
 int main() {
   // Loads vocab.
-  const auto vocab = utils::make_vocab("data/ptb.train.txt");
+  const auto vocab = Corpus::load_vocab("data/ptb.vocab");
   cout << "#vocab: " << vocab.size() << endl;  // maybe 10000
-  const unsigned eos_id = vocab.at("<s>");
 
-  // Loads all corpus.
-  const auto train_corpus = utils::load_corpus("data/ptb.train.txt", vocab);
-  const auto valid_corpus = utils::load_corpus("data/ptb.valid.txt", vocab);
-  const unsigned num_train_sents = train_corpus.size();
-  const unsigned num_valid_sents = valid_corpus.size();
+  // Maps all corpus.
+  const Corpus train_corpus("data/ptb.train.txt.bin");
+  const Corpus valid_corpus("data/ptb.valid.txt.bin");
+  const unsigned num_train_sents = train_corpus.num_sentences();
+  const unsigned num_valid_sents = valid_corpus.num_sentences();
   const unsigned num_train_labels = utils::count_labels(train_corpus);
   const unsigned num_valid_labels = utils::count_labels(valid_corpus);
   cout << "train: " << num_train_sents << " sentences, "
@@ -207,28 +227,35 @@ int main() {
   random_device rd;
   mt19937 rng(rd());
 
-  // Sentence IDs.
-  vector<unsigned> train_ids(num_train_sents);
-  vector<unsigned> valid_ids(num_valid_sents);
-  iota(begin(train_ids), end(train_ids), 0);
-  iota(begin(valid_ids), end(valid_ids), 0);
+  // Minibatches of sentences with similar lengths.
+  auto lengths = [](const Corpus &corpus) {
+    vector<unsigned> ret(corpus.num_sentences());
+    for (unsigned i = 0; i < ret.size(); ++i) ret[i] = corpus.length(i);
+    return ret;
+  };
+  const BatchSampler train_sampler(
+      lengths(train_corpus), MAX_TOKENS, BUCKET_WIDTH);
+  const BatchSampler valid_sampler(
+      lengths(valid_corpus), MAX_TOKENS, BUCKET_WIDTH);
+  const auto valid_batches = valid_sampler.sample();
 
   float best_valid_ppl = 1e10;
 
   // Train/valid loop.
   for (unsigned epoch = 0; epoch < MAX_EPOCH; ++epoch) {
     cout << "epoch " << (epoch + 1) << '/' << MAX_EPOCH << ':' << endl;
-    // Shuffles train sentence IDs.
-    shuffle(begin(train_ids), end(train_ids), rng);
+    // Shuffles train sentences and minibatches.
+    const auto train_batches = train_sampler.sample(rng);
 
     // Training.
     float train_loss = 0;
-    for (unsigned ofs = 0; ofs < num_train_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(train_ids) + ofs,
-          begin(train_ids) + std::min<unsigned>(
-            ofs + BATCH_SIZE, num_train_sents));
-      const auto batch = utils::make_batch(train_corpus, batch_ids, eos_id);
+    unsigned long long num_tokens = 0, num_padded_tokens = 0;
+    const auto start = chrono::steady_clock::now();
+    for (unsigned i = 0; i < train_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = train_batches[i];
+      const auto batch = ::make_batch(train_corpus, batch_ids);
+      num_tokens += train_sampler.num_tokens(batch_ids);
+      num_padded_tokens += train_sampler.num_padded_tokens(batch_ids);
 
       g.clear();
       const auto outputs = lm.forward(batch, true);
@@ -239,27 +266,31 @@ int main() {
       loss.backward();
       optimizer.update();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
+    const chrono::duration<double> elapsed =
+      chrono::steady_clock::now() - start;
 
     const float train_ppl = std::exp(train_loss / num_train_labels);
     cout << "  train ppl = " << train_ppl << endl;
+    // NOTE: PackedSequence does not calculate paddings, which are reported
+    // to compare with other examples.
+    cout << "  padding = "
+         << 100. * (num_padded_tokens - num_tokens) / num_padded_tokens
+         << "%, " << num_tokens / elapsed.count() << " tokens/sec" << endl;
 
     // Validation.
     float valid_loss = 0;
-    for (unsigned ofs = 0; ofs < num_valid_sents; ofs += BATCH_SIZE) {
-      const vector<unsigned> batch_ids(
-          begin(valid_ids) + ofs,
-          begin(valid_ids) + std::min<unsigned>(
-            ofs + BATCH_SIZE, num_valid_sents));
-      const auto batch = utils::make_batch(valid_corpus, batch_ids, eos_id);
+    for (unsigned i = 0; i < valid_batches.size(); ++i) {
+      const vector<unsigned> &batch_ids = valid_batches[i];
+      const auto batch = ::make_batch(valid_corpus, batch_ids);
 
       g.clear();
       const auto outputs = lm.forward(batch, false);
       const auto loss = lm.loss(outputs, batch);
       valid_loss += loss.to_float() * batch_ids.size();
 
-      cout << ofs << '\r' << flush;
+      cout << i << '\r' << flush;
     }
 
     const float valid_ppl = std::exp(valid_loss / num_valid_labels);
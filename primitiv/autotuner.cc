@@ -0,0 +1,169 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+#include <primitiv/autotuner.h>
+#include <primitiv/error.h>
+#include <primitiv/version.h>
+
+namespace {
+
+// Number of measurements of each candidate.
+// The minimum time is used to reduce effects of warming up and other
+// processes.
+constexpr std::uint32_t NUM_TRIALS = 2;
+
+// Removes delimiters of the cache file.
+std::string sanitize(std::string str) {
+  std::replace(str.begin(), str.end(), '\t', ' ');
+  std::replace(str.begin(), str.end(), '\n', ' ');
+  return str;
+}
+
+// Splits a line of the cache file.
+std::vector<std::string> split_fields(const std::string &line) {
+  std::vector<std::string> ret;
+  std::string::size_type begin = 0;
+  while (true) {
+    const auto end = line.find('\t', begin);
+    ret.emplace_back(line.substr(begin, end - begin));
+    if (end == std::string::npos) break;
+    begin = end + 1;
+  }
+  return ret;
+}
+
+}  // namespace
+
+namespace primitiv {
+
+Autotuner::Autotuner(
+    const std::string &hardware_key, const std::string &cache_path)
+: hardware_key_(::sanitize(hardware_key))
+, cache_path_(cache_path) {
+  load();
+}
+
+std::uint32_t Autotuner::select(
+    const std::string &key,
+    const std::vector<std::uint32_t> &candidates,
+    const std::function<void(std::uint32_t)> &run) {
+  if (candidates.empty()) {
+    THROW_ERROR("No candidates for tuning: " << key);
+  }
+  const std::string k = ::sanitize(key);
+  const auto it = results_.find(k);
+  if (it != results_.end()) return it->second;
+
+  using Clock = std::chrono::steady_clock;
+  std::uint32_t best = candidates[0];
+  Clock::duration best_time = Clock::duration::max();
+  for (const std::uint32_t c : candidates) {
+    Clock::duration time = Clock::duration::max();
+    for (std::uint32_t i = 0; i < ::NUM_TRIALS; ++i) {
+      const auto start = Clock::now();
+      run(c);
+      time = std::min(time, Clock::now() - start);
+    }
+    if (time < best_time) {
+      best = c;
+      best_time = time;
+    }
+  }
+
+  results_.emplace(k, best);
+  store(k, best);
+  return best;
+}
+
+std::string Autotuner::default_cache_path() {
+  const char *path = std::getenv("PRIMITIV_TUNING_CACHE");
+  return path ? path : "";
+}
+
+std::string Autotuner::cpu_hardware_key() {
+  std::string model = "unknown";
+  std::ifstream ifs("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      const auto pos = line.find(':');
+      if (pos != std::string::npos) {
+        model = line.substr(line.find_first_not_of(' ', pos + 1));
+      }
+      break;
+    }
+  }
+  std::ostringstream ss;
+  ss << "cpu:" << model << ':' << std::thread::hardware_concurrency();
+  return ss.str();
+}
+
+void Autotuner::load() {
+  if (cache_path_.empty()) return;
+  std::ifstream ifs(cache_path_);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    const auto fields = ::split_fields(line);
+    if (fields.size() != 4) continue;
+    if (fields[0] != PRIMITIV_VERSION || fields[1] != hardware_key_) continue;
+    char *end;
+    const unsigned long value = std::strtoul(fields[3].c_str(), &end, 10);
+    if (fields[3].empty() || *end != '\0') continue;
+    results_[fields[2]] = static_cast<std::uint32_t>(value);
+  }
+}
+
+void Autotuner::store(const std::string &key, std::uint32_t value) const {
+  // The cache file is only an optimization. Failures on updating the file are
+  // ignored and the result is kept only in this object.
+  if (cache_path_.empty()) return;
+
+  // Reloads the file to retain entries added by other objects.
+  std::vector<std::string> lines;
+  {
+    std::ifstream ifs(cache_path_);
+    std::string line;
+    while (std::getline(ifs, line)) {
+      const auto fields = ::split_fields(line);
+      if (fields.size() == 4 &&
+          fields[0] == PRIMITIV_VERSION &&
+          fields[1] == hardware_key_ &&
+          fields[2] == key) continue;
+      lines.emplace_back(std::move(line));
+    }
+  }
+  std::ostringstream ss;
+  ss << PRIMITIV_VERSION << '\t' << hardware_key_ << '\t'
+     << key << '\t' << value;
+  lines.emplace_back(ss.str());
+
+  // Writes into a temporary file and replaces the cache at once to prevent
+  // other processes from reading incomplete files.
+  std::ostringstream tmp_ss;
+  tmp_ss << cache_path_ << ".tmp" << ::getpid();
+  const std::string tmp_path = tmp_ss.str();
+  {
+    std::ofstream ofs(tmp_path);
+    if (!ofs.is_open()) return;
+    for (const std::string &line : lines) ofs << line << '\n';
+    if (!ofs) {
+      ofs.close();
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_path_.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+}  // namespace primitiv
@@ -0,0 +1,88 @@
+#ifndef PRIMITIV_AUTOTUNER_H_
+#define PRIMITIV_AUTOTUNER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <primitiv/mixins.h>
+
+namespace primitiv {
+
+/**
+ * Selects the fastest configuration of kernels by benchmarking candidates on
+ * first use, and remembers the results.
+ *
+ * Results can be stored in a cache file shared by all devices and processes.
+ * Each line of the file has the following tab-separated fields:
+ *
+ *     <library version> <hardware key> <tuning key> <selected value>
+ *
+ * Entries with other library versions or other hardware keys are ignored but
+ * retained when the file is updated.
+ */
+class Autotuner : mixins::Nonmovable<Autotuner> {
+public:
+  /**
+   * Creates a new Autotuner object and loads cached results.
+   * @param hardware_key Identifier of the hardware.
+   * @param cache_path Path of the cache file. If empty, results are kept only
+   *                   in this object.
+   */
+  Autotuner(const std::string &hardware_key, const std::string &cache_path);
+
+  /**
+   * Returns the selected value for the key, benchmarking all candidates if
+   * there is no result yet.
+   * @param key Identifier of the kernel and the class of arguments.
+   * @param candidates Candidate values.
+   * @param run Function to run the kernel with a candidate value.
+   * @return The fastest value in `candidates`, or the cached value.
+   * @throw primitiv::Error `candidates` is empty.
+   */
+  std::uint32_t select(
+      const std::string &key,
+      const std::vector<std::uint32_t> &candidates,
+      const std::function<void(std::uint32_t)> &run);
+
+  /**
+   * Returns the number of results held by this object.
+   * @return The number of results.
+   */
+  std::size_t num_results() const { return results_.size(); }
+
+  /**
+   * Returns the hardware key.
+   * @return The hardware key.
+   */
+  const std::string &hardware_key() const { return hardware_key_; }
+
+  /**
+   * Returns the path of the default cache file, which is specified by the
+   * `PRIMITIV_TUNING_CACHE` environment variable.
+   * @return Path of the cache file, or an empty string if the variable is not
+   *         set.
+   */
+  static std::string default_cache_path();
+
+  /**
+   * Returns the hardware key of the host CPU.
+   * @return A string which contains the model name of the CPU and the number
+   *         of hardware threads.
+   */
+  static std::string cpu_hardware_key();
+
+private:
+  void load();
+  void store(const std::string &key, std::uint32_t value) const;
+
+  std::string hardware_key_;
+  std::string cache_path_;
+  std::unordered_map<std::string, std::uint32_t> results_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_AUTOTUNER_H_
@@ -76,6 +76,7 @@ type_traits::Identity<Var> pow(const Var &a, const Var &b);
  * input<Var>(shape, data, &dev)
  * input<Var>(shape, data, dev)
  * input<Var>(shape, data)
+ * input_node(x, &g)
  */
 
 Tensor input_tensor(
@@ -84,6 +85,8 @@ Tensor input_tensor(
 Node input_node(
     const Shape &shape, const std::vector<float> &data, Device *dev, Graph *g);
 
+Node input_node(const Tensor &x, Graph *g);
+
 template<typename Var>
 type_traits::Identity<Var> input(
     const Shape &shape, const std::vector<float> &data, Device *dev);
@@ -257,6 +260,15 @@ type_traits::Identity<Var> broadcast(
 template<typename Var>
 type_traits::Identity<Var> logsumexp(const Var &x, std::uint32_t dim);
 
+template<typename Var>
+type_traits::Identity<Var> max(const Var &x, std::uint32_t dim);
+
+template<typename Var>
+type_traits::Identity<Var> min(const Var &x, std::uint32_t dim);
+
+template<typename Var>
+type_traits::Identity<Var> squared_norm(const Var &x, std::uint32_t dim);
+
 template<typename Var>
 type_traits::Identity<Var> log_softmax(const Var &x, std::uint32_t dim);
 
@@ -274,8 +286,49 @@ type_traits::Identity<Var> softmax_cross_entropy(
 template<typename Var>
 type_traits::Identity<Var> stop_gradient(const Var &x);
 
+template<typename Var>
+type_traits::Identity<Var> dropout(const Var &x, float rate, bool enabled);
+
 namespace batch {
 
+template<typename Var>
+type_traits::Identity<Var> pick(
+    const Var &x, const std::vector<std::uint32_t> &ids);
+
+template<typename Var>
+type_traits::Identity<Var> slice(
+    const Var &x, std::uint32_t lower, std::uint32_t upper);
+
+template<typename Var>
+type_traits::Identity<Var> concat(const std::vector<Var> &xs);
+
+template<typename Var>
+type_traits::Identity<Var> concat(const std::vector<const Var *> &xs);
+
+template<typename Var>
+inline type_traits::Identity<Var> concat(
+    const std::initializer_list<Var> xs) {
+  return concat(std::vector<Var>(xs));
+}
+
+template<typename Var>
+inline type_traits::Identity<Var> concat(
+    const std::initializer_list<const Var *> xs) {
+  return concat(std::vector<const Var *>(xs));
+}
+
+template<typename Container>
+inline type_traits::Reduce<Container> concat(const Container &xs) {
+  using Var = type_traits::Reduce<Container>;
+  return concat(std::vector<Var>(xs.begin(), xs.end()));
+}
+
+template<typename Container>
+inline type_traits::ReducePtr<Container> concat(const Container &xs) {
+  using Var = type_traits::ReducePtr<Container>;
+  return concat(std::vector<const Var *>(xs.begin(), xs.end()));
+}
+
 template<typename Var>
 type_traits::Identity<Var> sum(const Var &x);
 
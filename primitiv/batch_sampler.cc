@@ -0,0 +1,94 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <numeric>
+#include <primitiv/batch_sampler.h>
+#include <primitiv/error.h>
+
+using std::vector;
+
+namespace primitiv {
+
+BatchSampler::BatchSampler(
+    const vector<std::uint32_t> &lengths,
+    std::uint32_t max_tokens,
+    std::uint32_t bucket_width,
+    std::uint32_t max_batch_size)
+: lengths_(lengths)
+, max_tokens_(max_tokens)
+, bucket_width_(bucket_width)
+, max_batch_size_(max_batch_size) {
+  if (max_tokens_ == 0) THROW_ERROR("max_tokens should be positive.");
+  if (bucket_width_ == 0) THROW_ERROR("bucket_width should be positive.");
+}
+
+vector<vector<std::uint32_t>> BatchSampler::sample(std::mt19937 &rng) const {
+  vector<std::uint32_t> ids(lengths_.size());
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), rng);
+  vector<vector<std::uint32_t>> batches = pack(ids);
+  std::shuffle(batches.begin(), batches.end(), rng);
+  return batches;
+}
+
+vector<vector<std::uint32_t>> BatchSampler::sample() const {
+  vector<std::uint32_t> ids(lengths_.size());
+  std::iota(ids.begin(), ids.end(), 0);
+  return pack(ids);
+}
+
+vector<vector<std::uint32_t>> BatchSampler::pack(
+    const vector<std::uint32_t> &ids) const {
+  // Samples are ordered by buckets, and the original order is kept in each
+  // bucket.
+  vector<std::uint32_t> sorted = ids;
+  std::stable_sort(
+      sorted.begin(), sorted.end(),
+      [this](std::uint32_t a, std::uint32_t b) {
+        return lengths_[a] / bucket_width_ < lengths_[b] / bucket_width_;
+      });
+
+  vector<vector<std::uint32_t>> batches;
+  vector<std::uint32_t> batch;
+  std::uint64_t max_len = 0;
+  const auto flush = [&] {
+    // Longer samples come first as PackedSequence expects.
+    std::stable_sort(
+        batch.begin(), batch.end(),
+        [this](std::uint32_t a, std::uint32_t b) {
+          return lengths_[a] > lengths_[b];
+        });
+    batches.emplace_back(std::move(batch));
+    batch.clear();
+    max_len = 0;
+  };
+  for (const std::uint32_t id : sorted) {
+    const std::uint64_t len = std::max<std::uint64_t>(max_len, lengths_[id]);
+    const bool full =
+      (batch.size() + 1) * len > max_tokens_ ||
+      (max_batch_size_ > 0 && batch.size() >= max_batch_size_);
+    if (!batch.empty() && full) flush();
+    batch.emplace_back(id);
+    max_len = std::max<std::uint64_t>(max_len, lengths_[id]);
+  }
+  if (!batch.empty()) flush();
+  return batches;
+}
+
+std::uint64_t BatchSampler::num_tokens(
+    const vector<std::uint32_t> &batch) const {
+  std::uint64_t ret = 0;
+  for (const std::uint32_t id : batch) ret += lengths_.at(id);
+  return ret;
+}
+
+std::uint64_t BatchSampler::num_padded_tokens(
+    const vector<std::uint32_t> &batch) const {
+  std::uint64_t max_len = 0;
+  for (const std::uint32_t id : batch) {
+    max_len = std::max<std::uint64_t>(max_len, lengths_.at(id));
+  }
+  return batch.size() * max_len;
+}
+
+}  // namespace primitiv
@@ -0,0 +1,86 @@
+#ifndef PRIMITIV_BATCH_SAMPLER_H_
+#define PRIMITIV_BATCH_SAMPLER_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace primitiv {
+
+/**
+ * Sampler which groups samples with similar lengths into minibatches.
+ *
+ * Minibatches are limited by the number of tokens after padding (i.e., the
+ * number of samples times the maximum length in the minibatch) instead of the
+ * number of samples, so that short samples make large minibatches and long
+ * samples do not inflate the calculation of other samples.
+ *
+ * Each call of `sample()` shuffles samples in each bucket of lengths, packs
+ * them into minibatches, and shuffles the order of minibatches:
+ *
+ *     BatchSampler sampler(lengths, 4096, 4);
+ *     for (const auto &batch : sampler.sample(rng)) {
+ *       ... make a minibatch from samples `batch` ...
+ *     }
+ */
+class BatchSampler {
+public:
+  /**
+   * Creates a new BatchSampler object.
+   * @param lengths Lengths of each sample.
+   * @param max_tokens Maximum number of tokens in each minibatch including
+   *                   paddings. A sample longer than this makes a minibatch
+   *                   by itself.
+   * @param bucket_width Width of each bucket of lengths. Samples in the same
+   *                     bucket are shuffled with each other.
+   * @param max_batch_size Maximum number of samples in each minibatch. If 0,
+   *                       minibatches are limited only by `max_tokens`.
+   */
+  BatchSampler(
+      const std::vector<std::uint32_t> &lengths,
+      std::uint32_t max_tokens,
+      std::uint32_t bucket_width = 1,
+      std::uint32_t max_batch_size = 0);
+
+  /**
+   * Makes minibatches of all samples.
+   * @param rng Random number generator to shuffle samples and minibatches.
+   * @return List of minibatches, each of which is a list of sample IDs sorted
+   *         by their lengths in descending order.
+   */
+  std::vector<std::vector<std::uint32_t>> sample(std::mt19937 &rng) const;
+
+  /**
+   * Makes minibatches of all samples without shuffling.
+   * @return List of minibatches in ascending order of lengths.
+   */
+  std::vector<std::vector<std::uint32_t>> sample() const;
+
+  /**
+   * Returns the number of actual tokens in a minibatch.
+   * @param batch List of sample IDs.
+   * @return Sum of lengths of samples.
+   */
+  std::uint64_t num_tokens(const std::vector<std::uint32_t> &batch) const;
+
+  /**
+   * Returns the number of tokens in a minibatch after padding.
+   * @param batch List of sample IDs.
+   * @return Number of samples times the maximum length.
+   */
+  std::uint64_t num_padded_tokens(
+      const std::vector<std::uint32_t> &batch) const;
+
+private:
+  std::vector<std::vector<std::uint32_t>> pack(
+      const std::vector<std::uint32_t> &ids) const;
+
+  std::vector<std::uint32_t> lengths_;
+  std::uint32_t max_tokens_;
+  std::uint32_t bucket_width_;
+  std::uint32_t max_batch_size_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_BATCH_SAMPLER_H_
@@ -0,0 +1,111 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <limits>
+#include <primitiv/beam_search.h>
+
+using std::vector;
+
+namespace primitiv {
+
+BeamSearch::BeamSearch(
+    std::uint32_t batch_size, std::uint32_t beam_size,
+    std::uint32_t bos_id, std::uint32_t eos_id)
+: batch_size_(batch_size)
+, beam_size_(beam_size)
+, eos_id_(eos_id)
+, expand_ids_(batch_size * beam_size)
+, words_(batch_size * beam_size, bos_id)
+, scores_(batch_size * beam_size, -std::numeric_limits<float>::infinity()) {
+  if (batch_size == 0 || beam_size == 0) {
+    THROW_ERROR(
+        "Invalid beam search configuration. batch_size: " << batch_size
+        << ", beam_size: " << beam_size);
+  }
+  for (std::uint32_t i = 0; i < expand_ids_.size(); ++i) {
+    expand_ids_[i] = i / beam_size;
+  }
+  // Only the first hypothesis of each sequence is alive at the beginning.
+  for (std::uint32_t b = 0; b < batch_size; ++b) {
+    scores_[b * beam_size] = 0;
+  }
+  parents_ = expand_ids_;
+}
+
+bool BeamSearch::finished() const {
+  if (history_words_.empty()) return false;
+  for (const std::uint32_t w : words_) {
+    if (w != eos_id_) return false;
+  }
+  return true;
+}
+
+void BeamSearch::update(
+    const vector<std::uint32_t> &ids, const vector<float> &values,
+    std::uint32_t k) {
+  struct Candidate {
+    float score;
+    std::uint32_t parent;
+    std::uint32_t word;
+  };
+
+  const bool first = history_words_.empty();
+  vector<Candidate> cands;
+  cands.reserve(beam_size_ * k);
+  vector<std::uint32_t> new_words(words_.size());
+  vector<std::uint32_t> new_parents(words_.size());
+  vector<float> new_scores(words_.size());
+
+  for (std::uint32_t b = 0; b < batch_size_; ++b) {
+    cands.clear();
+    for (std::uint32_t j = 0; j < beam_size_; ++j) {
+      const std::uint32_t h = b * beam_size_ + j;
+      if (!first && words_[h] == eos_id_) {
+        // Finished hypotheses are carried over without changing scores.
+        cands.push_back({scores_[h], h, eos_id_});
+        continue;
+      }
+      for (std::uint32_t i = 0; i < k; ++i) {
+        cands.push_back({scores_[h] + values[h * k + i], h, ids[h * k + i]});
+      }
+    }
+    // Each hypothesis yields at least one candidate, so `cands` always has
+    // `beam_size_` or more elements. stable_sort keeps tied candidates in the
+    // order of parents and word ranks.
+    std::stable_sort(
+        cands.begin(), cands.end(),
+        [](const Candidate &a, const Candidate &b) {
+          return a.score > b.score;
+        });
+    for (std::uint32_t j = 0; j < beam_size_; ++j) {
+      const std::uint32_t h = b * beam_size_ + j;
+      new_words[h] = cands[j].word;
+      new_parents[h] = cands[j].parent;
+      new_scores[h] = cands[j].score;
+    }
+  }
+
+  words_ = std::move(new_words);
+  parents_ = std::move(new_parents);
+  scores_ = std::move(new_scores);
+  history_words_.emplace_back(words_);
+  history_parents_.emplace_back(parents_);
+}
+
+vector<vector<std::uint32_t>> BeamSearch::best() const {
+  vector<vector<std::uint32_t>> ret(batch_size_);
+  for (std::uint32_t b = 0; b < batch_size_; ++b) {
+    vector<std::uint32_t> &seq = ret[b];
+    // Hypotheses are sorted by scores, and the first one is the best.
+    std::uint32_t h = b * beam_size_;
+    for (std::uint32_t t = history_words_.size(); t > 0; --t) {
+      seq.emplace_back(history_words_[t - 1][h]);
+      h = history_parents_[t - 1][h];
+    }
+    std::reverse(seq.begin(), seq.end());
+    while (!seq.empty() && seq.back() == eos_id_) seq.pop_back();
+  }
+  return ret;
+}
+
+}  // namespace primitiv
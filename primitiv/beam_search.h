@@ -0,0 +1,165 @@
+#ifndef PRIMITIV_BEAM_SEARCH_H_
+#define PRIMITIV_BEAM_SEARCH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+
+namespace primitiv {
+
+/**
+ * Batched beam search over a minibatch of sequences.
+ *
+ * All hypotheses are folded into the minibatch dimension: the hypothesis `j`
+ * of the sequence `b` is stored in the minibatch element `b * beam_size + j`.
+ * Recurrent states can be kept as one batched variable and reordered after
+ * each step using `reorder()`, which is backed by `functions::batch::pick()`.
+ *
+ * Typical usage:
+ *
+ *     BeamSearch beam(batch_size, beam_size, bos_id, eos_id);
+ *     state = beam.expand(state);
+ *     while (!beam.finished() && beam.length() < limit) {
+ *       const Var logits = decoder.step(beam.words(), state);
+ *       beam.step(logits);
+ *       state = beam.reorder(state);
+ *     }
+ *     const auto results = beam.best();
+ */
+class BeamSearch {
+public:
+  /**
+   * Creates a new BeamSearch object.
+   * @param batch_size Number of sequences to be decoded simultaneously.
+   * @param beam_size Number of hypotheses kept for each sequence.
+   * @param bos_id Word ID used as the first input of all hypotheses.
+   * @param eos_id Word ID that terminates a hypothesis.
+   */
+  BeamSearch(
+      std::uint32_t batch_size, std::uint32_t beam_size,
+      std::uint32_t bos_id, std::uint32_t eos_id);
+
+  /**
+   * Returns the number of sequences.
+   * @return Number of sequences.
+   */
+  std::uint32_t batch_size() const { return batch_size_; }
+
+  /**
+   * Returns the beam size.
+   * @return Number of hypotheses for each sequence.
+   */
+  std::uint32_t beam_size() const { return beam_size_; }
+
+  /**
+   * Returns the number of steps performed so far.
+   * @return Number of steps.
+   */
+  std::uint32_t length() const { return history_words_.size(); }
+
+  /**
+   * Returns the last words of all hypotheses.
+   * @return List of word IDs with `batch_size * beam_size` elements, which
+   *         should be used as inputs of the next step.
+   */
+  const std::vector<std::uint32_t> &words() const { return words_; }
+
+  /**
+   * Returns the accumulated log-probabilities of all hypotheses.
+   * @return List of scores with `batch_size * beam_size` elements.
+   */
+  const std::vector<float> &scores() const { return scores_; }
+
+  /**
+   * Returns the minibatch IDs of parent hypotheses selected at the last step.
+   * @return List of minibatch IDs with `batch_size * beam_size` elements.
+   * @remarks Before the first step, this function returns IDs to expand
+   *          per-sequence variables to per-hypothesis variables.
+   */
+  const std::vector<std::uint32_t> &parents() const { return parents_; }
+
+  /**
+   * Checks whether all hypotheses have been terminated by `eos_id`.
+   * @return true if all hypotheses finished, false otherwise.
+   */
+  bool finished() const;
+
+  /**
+   * Expands a per-sequence variable into per-hypothesis variable.
+   * @param x A variable with `batch_size` minibatch elements.
+   * @return A variable with `batch_size * beam_size` minibatch elements.
+   */
+  template<typename Var>
+  Var expand(const Var &x) const {
+    return functions::batch::pick(x, expand_ids_);
+  }
+
+  /**
+   * Reorders a per-hypothesis variable according to the last step.
+   * @param x A variable with `batch_size * beam_size` minibatch elements.
+   * @return A variable of which minibatch elements are the states of
+   *         surviving hypotheses.
+   */
+  template<typename Var>
+  Var reorder(const Var &x) const {
+    return functions::batch::pick(x, parents_);
+  }
+
+  /**
+   * Advances all hypotheses by one word.
+   * @param logits Unnormalized scores of the next words. The shape should be
+   *               `Shape({vocab_size}, batch_size * beam_size)`.
+   * @remarks Only top-`beam_size` candidates of each hypothesis are
+   *          transferred from the device, which are sufficient to decide the
+   *          top-`beam_size` hypotheses of each sequence.
+   */
+  template<typename Var>
+  void step(const Var &logits) {
+    const Shape &s = logits.shape();
+    if (s.volume() != s[0] || s.batch() != words_.size()) {
+      THROW_ERROR(
+          "Invalid shape of logits: " << s.to_string()
+          << ", expected: [" << s[0] << "]x" << words_.size());
+    }
+    const std::uint32_t k = std::min(beam_size_, s[0]);
+    std::vector<float> values;
+    const std::vector<std::uint32_t> ids
+      = functions::log_softmax(logits, 0).topk(0, k, values);
+    update(ids, values, k);
+  }
+
+  /**
+   * Retrieves the best hypothesis of each sequence.
+   * @return List of `batch_size` word sequences. Each sequence contains
+   *         neither `bos_id` nor the terminating `eos_id`.
+   */
+  std::vector<std::vector<std::uint32_t>> best() const;
+
+private:
+  /**
+   * Selects surviving hypotheses using candidates given by `step()`.
+   * @param ids Top-k word IDs of each hypothesis.
+   * @param values Log-probabilities corresponding to `ids`.
+   * @param k Number of candidates of each hypothesis.
+   */
+  void update(
+      const std::vector<std::uint32_t> &ids, const std::vector<float> &values,
+      std::uint32_t k);
+
+  std::uint32_t batch_size_;
+  std::uint32_t beam_size_;
+  std::uint32_t eos_id_;
+  std::vector<std::uint32_t> expand_ids_;
+  std::vector<std::uint32_t> words_;
+  std::vector<std::uint32_t> parents_;
+  std::vector<float> scores_;
+  std::vector<std::vector<std::uint32_t>> history_words_;
+  std::vector<std::vector<std::uint32_t>> history_parents_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_BEAM_SEARCH_H_
@@ -0,0 +1,111 @@
+#include <primitiv/config.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <primitiv/binary_cache.h>
+#include <primitiv/version.h>
+
+namespace {
+
+// First line of cache files.
+const char *MAGIC = "primitiv-binary-cache";
+
+}  // namespace
+
+namespace primitiv {
+
+BinaryCache::BinaryCache(const std::string &directory)
+: directory_(directory) {
+  if (!directory_.empty()) {
+    // Fails silently if the directory already exists. Other errors appear
+    // later as missing entries.
+    ::mkdir(directory_.c_str(), 0755);
+  }
+}
+
+bool BinaryCache::load(const std::string &key, std::string &binary) const {
+  if (directory_.empty()) return false;
+  std::ifstream ifs(path(key), std::ios::binary);
+  if (!ifs.is_open()) return false;
+
+  // Header: magic, library version, key, size and digest of the binary.
+  std::string magic, version, stored_key, size_str, stored_digest;
+  if (!std::getline(ifs, magic) || magic != ::MAGIC) return false;
+  if (!std::getline(ifs, version) || version != PRIMITIV_VERSION) return false;
+  if (!std::getline(ifs, stored_key) || stored_key != key) return false;
+  if (!std::getline(ifs, size_str) || !std::getline(ifs, stored_digest)) {
+    return false;
+  }
+  char *end;
+  const unsigned long long size = std::strtoull(size_str.c_str(), &end, 10);
+  if (size_str.empty() || *end != '\0') return false;
+
+  std::string data(
+      (std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  if (data.size() != size || digest(data) != stored_digest) return false;
+  binary = std::move(data);
+  return true;
+}
+
+void BinaryCache::store(
+    const std::string &key, const std::string &binary) const {
+  if (directory_.empty()) return;
+  // Keys are written in one line.
+  if (key.find('\n') != std::string::npos) return;
+
+  // Writes into a temporary file and replaces the entry at once to prevent
+  // other processes from reading incomplete files.
+  const std::string dest = path(key);
+  std::ostringstream tmp_ss;
+  tmp_ss << dest << ".tmp" << ::getpid();
+  const std::string tmp = tmp_ss.str();
+  {
+    std::ofstream ofs(tmp, std::ios::binary);
+    if (!ofs.is_open()) return;
+    ofs << ::MAGIC << '\n'
+        << PRIMITIV_VERSION << '\n'
+        << key << '\n'
+        << binary.size() << '\n'
+        << digest(binary) << '\n';
+    ofs.write(binary.data(), binary.size());
+    if (!ofs) {
+      ofs.close();
+      std::remove(tmp.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp.c_str(), dest.c_str()) != 0) {
+    std::remove(tmp.c_str());
+  }
+}
+
+std::string BinaryCache::path(const std::string &key) const {
+  if (directory_.empty()) return "";
+  return directory_ + '/' + digest(key) + ".bin";
+}
+
+std::string BinaryCache::default_directory() {
+  const char *dir = std::getenv("PRIMITIV_KERNEL_CACHE_DIR");
+  return dir ? dir : "";
+}
+
+std::string BinaryCache::digest(const std::string &data) {
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for (const char c : data) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ull;
+  }
+  char buf[17];
+  std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+  return buf;
+}
+
+}  // namespace primitiv
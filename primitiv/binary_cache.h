@@ -0,0 +1,78 @@
+#ifndef PRIMITIV_BINARY_CACHE_H_
+#define PRIMITIV_BINARY_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+namespace primitiv {
+
+/**
+ * On-disk cache of compiled binaries, e.g., OpenCL programs.
+ *
+ * Each entry is stored in a separate file named by the digest of its key.
+ * Files contain the whole key, the size and the digest of the binary, and
+ * entries which do not match them are treated as missing.
+ */
+class BinaryCache {
+public:
+  /**
+   * Creates a new BinaryCache object.
+   * @param directory Path of the directory to store cache files. If empty,
+   *                  the cache is disabled. The directory is created if it
+   *                  does not exist.
+   */
+  explicit BinaryCache(const std::string &directory);
+
+  /**
+   * Loads an entry.
+   * @param key Identifier of the entry.
+   * @param binary String to store the binary.
+   * @return true if a valid entry was found, false otherwise. `binary` is
+   *         not modified if false.
+   */
+  bool load(const std::string &key, std::string &binary) const;
+
+  /**
+   * Stores an entry.
+   * @param key Identifier of the entry.
+   * @param binary Data to be stored.
+   * @remarks Failures on writing files are ignored.
+   */
+  void store(const std::string &key, const std::string &binary) const;
+
+  /**
+   * Returns the path of the cache file of the key.
+   * @param key Identifier of the entry.
+   * @return Path of the cache file, or an empty string if the cache is
+   *         disabled.
+   */
+  std::string path(const std::string &key) const;
+
+  /**
+   * Returns the path of the directory.
+   * @return Path of the directory.
+   */
+  const std::string &directory() const { return directory_; }
+
+  /**
+   * Returns the path of the default directory, which is specified by the
+   * `PRIMITIV_KERNEL_CACHE_DIR` environment variable.
+   * @return Path of the directory, or an empty string if the variable is not
+   *         set.
+   */
+  static std::string default_directory();
+
+  /**
+   * Calculates a 64-bit FNV-1a digest of the data.
+   * @param data Target data.
+   * @return Digest represented by 16 hexadecimal digits.
+   */
+  static std::string digest(const std::string &data);
+
+private:
+  std::string directory_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_BINARY_CACHE_H_
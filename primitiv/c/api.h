@@ -9,6 +9,7 @@
 #include <primitiv/c/naive_device.h>
 #include <primitiv/c/functions.h>
 #include <primitiv/c/parameter.h>
+#include <primitiv/c/program.h>
 #include <primitiv/c/shape.h>
 #include <primitiv/c/status.h>
 #include <primitiv/c/tensor.h>
@@ -0,0 +1,248 @@
+/* Copyright 2017 The primitiv Authors. All Rights Reserved. */
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <primitiv/functions.h>
+
+#include <primitiv/c/internal.h>
+#include <primitiv/c/program.h>
+
+using primitiv::Node;
+namespace F = primitiv::functions;
+
+struct primitiv_Program {
+  std::vector<primitiv_Instruction> instructions;
+};
+
+namespace {
+
+// Number of register arguments of each opcode.
+std::uint32_t num_args(std::uint32_t opcode) {
+  switch (opcode) {
+    case PRIMITIV_OP_INPUT:
+    case PRIMITIV_OP_PARAMETER:
+      return 0;
+    case PRIMITIV_OP_NEGATIVE:
+    case PRIMITIV_OP_SQRT:
+    case PRIMITIV_OP_EXP:
+    case PRIMITIV_OP_LOG:
+    case PRIMITIV_OP_TANH:
+    case PRIMITIV_OP_SIGMOID:
+    case PRIMITIV_OP_SOFTPLUS:
+    case PRIMITIV_OP_RELU:
+    case PRIMITIV_OP_ADD_CONST:
+    case PRIMITIV_OP_MULTIPLY_CONST:
+    case PRIMITIV_OP_SUM:
+    case PRIMITIV_OP_MEAN:
+    case PRIMITIV_OP_BATCH_SUM:
+    case PRIMITIV_OP_BATCH_MEAN:
+    case PRIMITIV_OP_SOFTMAX:
+    case PRIMITIV_OP_BACKWARD:
+      return 1;
+    case PRIMITIV_OP_ADD:
+    case PRIMITIV_OP_SUBTRACT:
+    case PRIMITIV_OP_MULTIPLY:
+    case PRIMITIV_OP_DIVIDE:
+    case PRIMITIV_OP_MATMUL:
+    case PRIMITIV_OP_SOFTMAX_CROSS_ENTROPY:
+      return 2;
+    default:
+      THROW_ERROR("Unknown opcode: " << opcode);
+  }
+}
+
+// Checks whether the instruction can be the `reg`-th one or not.
+void check_instruction(const primitiv_Instruction &inst, std::uint32_t reg) {
+  const std::uint32_t n = ::num_args(inst.opcode);
+  for (std::uint32_t i = 0; i < n; ++i) {
+    if (inst.args[i] >= reg) {
+      THROW_ERROR(
+          "Instruction " << reg << " refers an undefined register: "
+          << inst.args[i]);
+    }
+  }
+}
+
+// Executes one instruction.
+Node execute(
+    const primitiv_Instruction &inst, const std::vector<Node> &regs,
+    primitiv::Graph &g, primitiv::Device &dev,
+    const primitiv_Shape *const *input_shapes, const float *const *inputs,
+    std::size_t num_inputs,
+    primitiv_Parameter *const *params, std::size_t num_params) {
+  // Arguments were checked by check_instruction().
+  const std::uint32_t n = ::num_args(inst.opcode);
+  const Node a = n > 0 ? regs[inst.args[0]] : Node();
+  const Node b = n > 1 ? regs[inst.args[1]] : Node();
+  switch (inst.opcode) {
+    case PRIMITIV_OP_INPUT:
+      {
+        if (inst.attr >= num_inputs) {
+          THROW_ERROR("Invalid input index: " << inst.attr);
+        }
+        const primitiv::Shape &shape = *to_cc(input_shapes[inst.attr]);
+        const float *data = inputs[inst.attr];
+        return F::input_node(
+            shape, std::vector<float>(data, data + shape.size()), &dev, &g);
+      }
+    case PRIMITIV_OP_PARAMETER:
+      if (inst.attr >= num_params) {
+        THROW_ERROR("Invalid parameter index: " << inst.attr);
+      }
+      return F::parameter_node(*to_cc(params[inst.attr]), &g);
+    case PRIMITIV_OP_NEGATIVE: return -a;
+    case PRIMITIV_OP_SQRT: return F::sqrt(a);
+    case PRIMITIV_OP_EXP: return F::exp(a);
+    case PRIMITIV_OP_LOG: return F::log(a);
+    case PRIMITIV_OP_TANH: return F::tanh(a);
+    case PRIMITIV_OP_SIGMOID: return F::sigmoid(a);
+    case PRIMITIV_OP_SOFTPLUS: return F::softplus(a);
+    case PRIMITIV_OP_RELU: return F::relu(a);
+    case PRIMITIV_OP_ADD: return a + b;
+    case PRIMITIV_OP_SUBTRACT: return a - b;
+    case PRIMITIV_OP_MULTIPLY: return a * b;
+    case PRIMITIV_OP_DIVIDE: return a / b;
+    case PRIMITIV_OP_MATMUL: return F::matmul(a, b);
+    case PRIMITIV_OP_ADD_CONST: return a + inst.value;
+    case PRIMITIV_OP_MULTIPLY_CONST: return a * inst.value;
+    case PRIMITIV_OP_SUM: return F::sum(a, inst.attr);
+    case PRIMITIV_OP_MEAN: return F::mean(a, inst.attr);
+    case PRIMITIV_OP_BATCH_SUM: return F::batch::sum(a);
+    case PRIMITIV_OP_BATCH_MEAN: return F::batch::mean(a);
+    case PRIMITIV_OP_SOFTMAX: return F::softmax(a, inst.attr);
+    case PRIMITIV_OP_SOFTMAX_CROSS_ENTROPY:
+      return F::softmax_cross_entropy(a, b, inst.attr);
+    case PRIMITIV_OP_BACKWARD:
+      a.backward();
+      return Node();
+    default:
+      THROW_ERROR("Unknown opcode: " << inst.opcode);
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+primitiv_Program *primitiv_Program_new() {
+  return new primitiv_Program;
+}
+primitiv_Program *safe_primitiv_Program_new(primitiv_Status *status) {
+  SAFE_RETURN(primitiv_Program_new(), status, nullptr);
+}
+
+primitiv_Program *primitiv_Program_new_with_instructions(
+    const primitiv_Instruction *instructions, size_t n) {
+  for (std::uint32_t i = 0; i < n; ++i) {
+    ::check_instruction(instructions[i], i);
+  }
+  return new primitiv_Program {
+    std::vector<primitiv_Instruction>(instructions, instructions + n),
+  };
+}
+primitiv_Program *safe_primitiv_Program_new_with_instructions(
+    const primitiv_Instruction *instructions,
+    size_t n,
+    primitiv_Status *status) {
+  SAFE_RETURN(
+      primitiv_Program_new_with_instructions(instructions, n),
+      status, nullptr);
+}
+
+void primitiv_Program_delete(primitiv_Program *program) {
+  delete program;
+}
+void safe_primitiv_Program_delete(primitiv_Program *program,
+                                  primitiv_Status *status) {
+  SAFE_EXPR(primitiv_Program_delete(program), status);
+}
+
+uint32_t primitiv_Program_append(
+    primitiv_Program *program, const primitiv_Instruction *instruction) {
+  const std::uint32_t reg = program->instructions.size();
+  ::check_instruction(*instruction, reg);
+  program->instructions.emplace_back(*instruction);
+  return reg;
+}
+uint32_t safe_primitiv_Program_append(
+    primitiv_Program *program,
+    const primitiv_Instruction *instruction,
+    primitiv_Status *status) {
+  SAFE_RETURN(primitiv_Program_append(program, instruction), status, 0);
+}
+
+size_t primitiv_Program_num_instructions(const primitiv_Program *program) {
+  return program->instructions.size();
+}
+size_t safe_primitiv_Program_num_instructions(
+    const primitiv_Program *program, primitiv_Status *status) {
+  SAFE_RETURN(primitiv_Program_num_instructions(program), status, 0);
+}
+
+void primitiv_Program_get_instructions(
+    const primitiv_Program *program, primitiv_Instruction *instructions) {
+  std::copy(
+      program->instructions.begin(), program->instructions.end(),
+      instructions);
+}
+void safe_primitiv_Program_get_instructions(
+    const primitiv_Program *program,
+    primitiv_Instruction *instructions,
+    primitiv_Status *status) {
+  SAFE_EXPR(primitiv_Program_get_instructions(program, instructions), status);
+}
+
+void primitiv_Program_run(
+    const primitiv_Program *program,
+    primitiv_Graph *g,
+    primitiv_Device *dev,
+    const primitiv_Shape *const *input_shapes,
+    const float *const *inputs,
+    size_t num_inputs,
+    primitiv_Parameter *const *params,
+    size_t num_params,
+    const uint32_t *outputs,
+    float *const *output_data,
+    size_t num_outputs) {
+  primitiv::Graph &graph = *to_cc(g);
+  primitiv::Device &device = primitiv::Device::get_reference_or_default(
+      to_cc(dev));
+  graph.clear();
+  std::vector<Node> regs;
+  regs.reserve(program->instructions.size());
+  for (const primitiv_Instruction &inst : program->instructions) {
+    regs.emplace_back(::execute(
+          inst, regs, graph, device,
+          input_shapes, inputs, num_inputs, params, num_params));
+  }
+  for (std::size_t i = 0; i < num_outputs; ++i) {
+    if (outputs[i] >= regs.size() || !regs[outputs[i]].valid()) {
+      THROW_ERROR("Invalid output register: " << outputs[i]);
+    }
+    const std::vector<float> values = regs[outputs[i]].to_vector();
+    std::copy(values.begin(), values.end(), output_data[i]);
+  }
+}
+void safe_primitiv_Program_run(
+    const primitiv_Program *program,
+    primitiv_Graph *g,
+    primitiv_Device *dev,
+    const primitiv_Shape *const *input_shapes,
+    const float *const *inputs,
+    size_t num_inputs,
+    primitiv_Parameter *const *params,
+    size_t num_params,
+    const uint32_t *outputs,
+    float *const *output_data,
+    size_t num_outputs,
+    primitiv_Status *status) {
+  SAFE_EXPR(
+      primitiv_Program_run(
+          program, g, dev, input_shapes, inputs, num_inputs, params,
+          num_params, outputs, output_data, num_outputs),
+      status);
+}
+
+}  // end extern "C"
@@ -0,0 +1,138 @@
+/* Copyright 2017 The primitiv Authors. All Rights Reserved. */
+
+#ifndef PRIMITIV_C_PROGRAM_H_
+#define PRIMITIV_C_PROGRAM_H_
+
+#include <primitiv/c/define.h>
+#include <primitiv/c/device.h>
+#include <primitiv/c/graph.h>
+#include <primitiv/c/parameter.h>
+#include <primitiv/c/shape.h>
+#include <primitiv/c/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Programs describe whole computation graphs as arrays of instructions, so
+ * that language bindings can build and run a graph with one call per step.
+ *
+ * The i-th instruction defines the register `i`, and `args` refer registers
+ * of preceding instructions. `attr` and `value` are used as follows:
+ *
+ *   INPUT         attr: index of the input array given to primitiv_Program_run
+ *   PARAMETER     attr: index of the parameter given to primitiv_Program_run
+ *   *_CONST       value: the constant operand
+ *   SUM, MEAN, SOFTMAX, SOFTMAX_CROSS_ENTROPY
+ *                 attr: the dimension
+ *   BACKWARD      args[0]: the register to calculate gradients from
+ */
+typedef enum primitiv_Opcode {
+  PRIMITIV_OP_INPUT = 0,
+  PRIMITIV_OP_PARAMETER = 1,
+  PRIMITIV_OP_NEGATIVE = 2,
+  PRIMITIV_OP_SQRT = 3,
+  PRIMITIV_OP_EXP = 4,
+  PRIMITIV_OP_LOG = 5,
+  PRIMITIV_OP_TANH = 6,
+  PRIMITIV_OP_SIGMOID = 7,
+  PRIMITIV_OP_SOFTPLUS = 8,
+  PRIMITIV_OP_RELU = 9,
+  PRIMITIV_OP_ADD = 10,
+  PRIMITIV_OP_SUBTRACT = 11,
+  PRIMITIV_OP_MULTIPLY = 12,
+  PRIMITIV_OP_DIVIDE = 13,
+  PRIMITIV_OP_MATMUL = 14,
+  PRIMITIV_OP_ADD_CONST = 15,
+  PRIMITIV_OP_MULTIPLY_CONST = 16,
+  PRIMITIV_OP_SUM = 17,
+  PRIMITIV_OP_MEAN = 18,
+  PRIMITIV_OP_BATCH_SUM = 19,
+  PRIMITIV_OP_BATCH_MEAN = 20,
+  PRIMITIV_OP_SOFTMAX = 21,
+  PRIMITIV_OP_SOFTMAX_CROSS_ENTROPY = 22,
+  PRIMITIV_OP_BACKWARD = 23,
+} primitiv_Opcode;
+
+typedef struct primitiv_Instruction {
+  uint32_t opcode;
+  uint32_t args[2];
+  uint32_t attr;
+  float value;
+} primitiv_Instruction;
+
+typedef struct primitiv_Program primitiv_Program;
+
+CAPI extern primitiv_Program *primitiv_Program_new();
+CAPI extern primitiv_Program *safe_primitiv_Program_new(
+    primitiv_Status *status);
+
+CAPI extern primitiv_Program *primitiv_Program_new_with_instructions(
+    const primitiv_Instruction *instructions, size_t n);
+CAPI extern primitiv_Program *safe_primitiv_Program_new_with_instructions(
+    const primitiv_Instruction *instructions,
+    size_t n,
+    primitiv_Status *status);
+
+CAPI extern void primitiv_Program_delete(primitiv_Program *program);
+CAPI extern void safe_primitiv_Program_delete(primitiv_Program *program,
+                                              primitiv_Status *status);
+
+/* Captures an instruction and returns its register. */
+CAPI extern uint32_t primitiv_Program_append(
+    primitiv_Program *program, const primitiv_Instruction *instruction);
+CAPI extern uint32_t safe_primitiv_Program_append(
+    primitiv_Program *program,
+    const primitiv_Instruction *instruction,
+    primitiv_Status *status);
+
+CAPI extern size_t primitiv_Program_num_instructions(
+    const primitiv_Program *program);
+CAPI extern size_t safe_primitiv_Program_num_instructions(
+    const primitiv_Program *program, primitiv_Status *status);
+
+/* Copies all instructions to serialize the program. */
+CAPI extern void primitiv_Program_get_instructions(
+    const primitiv_Program *program, primitiv_Instruction *instructions);
+CAPI extern void safe_primitiv_Program_get_instructions(
+    const primitiv_Program *program,
+    primitiv_Instruction *instructions,
+    primitiv_Status *status);
+
+/*
+ * Replays the program on the graph after clearing it.
+ * `inputs[i]` should have `primitiv_Shape_size(input_shapes[i])` values.
+ * Values of registers `outputs[i]` are copied into `output_data[i]`.
+ */
+CAPI extern void primitiv_Program_run(
+    const primitiv_Program *program,
+    primitiv_Graph *g,
+    primitiv_Device *dev,
+    const primitiv_Shape *const *input_shapes,
+    const float *const *inputs,
+    size_t num_inputs,
+    primitiv_Parameter *const *params,
+    size_t num_params,
+    const uint32_t *outputs,
+    float *const *output_data,
+    size_t num_outputs);
+CAPI extern void safe_primitiv_Program_run(
+    const primitiv_Program *program,
+    primitiv_Graph *g,
+    primitiv_Device *dev,
+    const primitiv_Shape *const *input_shapes,
+    const float *const *inputs,
+    size_t num_inputs,
+    primitiv_Parameter *const *params,
+    size_t num_params,
+    const uint32_t *outputs,
+    float *const *output_data,
+    size_t num_outputs,
+    primitiv_Status *status);
+
+#ifdef __cplusplus
+}  // end extern "C"
+#endif
+
+#endif  // PRIMITIV_C_PROGRAM_H_
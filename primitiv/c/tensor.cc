@@ -2,15 +2,79 @@
 #include <primitiv/config.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
+#include <primitiv/device.h>
 #include <primitiv/tensor.h>
 
 #include <primitiv/c/internal.h>
 #include <primitiv/c/tensor.h>
 
+using primitiv::Device;
+using primitiv::Shape;
 using primitiv::Tensor;
 
+namespace {
+
+// Owner of the array exposed by primitiv_Tensor_to_dlpack().
+struct DLPackContext {
+  Tensor tensor;
+  std::vector<std::int64_t> shape;
+  std::vector<std::int64_t> strides;
+  primitiv_DLManagedTensor managed;
+};
+
+void delete_dlpack_context(primitiv_DLManagedTensor *self) {
+  delete static_cast<DLPackContext *>(self->manager_ctx);
+}
+
+// Obtains the shape of a DLPack tensor.
+Shape dlpack_shape(const primitiv_DLTensor &src, bool has_batch) {
+  if (src.device.device_type != PRIMITIV_DL_CPU) {
+    THROW_ERROR("Unsupported DLPack device type: " << src.device.device_type);
+  }
+  if (src.dtype.code != PRIMITIV_DL_FLOAT ||
+      src.dtype.bits != 32 || src.dtype.lanes != 1) {
+    THROW_ERROR(
+        "Unsupported DLPack data type: code=" << +src.dtype.code
+        << ", bits=" << +src.dtype.bits << ", lanes=" << src.dtype.lanes);
+  }
+  const std::int32_t max_ndim = Shape::MAX_DEPTH + has_batch;
+  if (src.ndim < has_batch || src.ndim > max_ndim) {
+    THROW_ERROR("Invalid number of DLPack axes: " << src.ndim);
+  }
+  if (!src.data) THROW_ERROR("DLPack array is null.");
+
+  // NOTE: Null strides represent a compact row-major array, which is accepted
+  // only if it is also column-major.
+  std::int64_t size = 1;
+  std::uint32_t num_nontrivial = 0;
+  std::vector<std::uint32_t> dims;
+  for (std::int32_t i = 0; i < src.ndim; ++i) {
+    const std::int64_t n = src.shape[i];
+    if (n < 1 || n > std::numeric_limits<std::uint32_t>::max()) {
+      THROW_ERROR("Invalid DLPack extent: shape[" << i << "]=" << n);
+    }
+    if (n > 1) {
+      ++num_nontrivial;
+      if (src.strides ? src.strides[i] != size : num_nontrivial > 1) {
+        THROW_ERROR("DLPack array is not a compact column-major array.");
+      }
+    }
+    size *= n;
+    dims.emplace_back(n);
+  }
+  std::uint32_t batch = 1;
+  if (has_batch) {
+    batch = dims.back();
+    dims.pop_back();
+  }
+  return Shape(dims, batch);
+}
+
+}  // namespace
+
 extern "C" {
 
 primitiv_Tensor *primitiv_Tensor_new() {
@@ -164,4 +228,55 @@ primitiv_Tensor *safe_primitiv_Tensor_inplace_subtract(
   SAFE_RETURN(primitiv_Tensor_inplace_subtract(tensor, x), status, nullptr);
 }
 
+primitiv_Tensor *primitiv_Tensor_new_from_dlpack(
+    primitiv_DLManagedTensor *src, bool has_batch, primitiv_Device *device) {
+  const primitiv_DLTensor &dl = src->dl_tensor;
+  const Shape shape = ::dlpack_shape(dl, has_batch);
+  float *data = reinterpret_cast<float *>(
+      static_cast<char *>(dl.data) + dl.byte_offset);
+  Device &dev = Device::get_reference_or_default(to_cc(device));
+  return to_c_from_value(dev.new_tensor_by_external_array(
+        shape, data, [src](float *) { if (src->deleter) src->deleter(src); }));
+}
+primitiv_Tensor *safe_primitiv_Tensor_new_from_dlpack(
+    primitiv_DLManagedTensor *src,
+    bool has_batch,
+    primitiv_Device *device,
+    primitiv_Status *status) {
+  SAFE_RETURN(
+      primitiv_Tensor_new_from_dlpack(src, has_batch, device),
+      status, nullptr);
+}
+
+primitiv_DLManagedTensor *primitiv_Tensor_to_dlpack(
+    const primitiv_Tensor *tensor) {
+  const Tensor &x = *to_cc(tensor);
+  x.check_valid();
+  const float *data = x.device().host_array(x);
+  const Shape &s = x.shape();
+  DLPackContext *ctx = new DLPackContext {x, {}, {}, {}};
+  std::int64_t stride = 1;
+  for (std::uint32_t i = 0; i <= s.depth(); ++i) {
+    const std::uint32_t n = i < s.depth() ? s[i] : s.batch();
+    ctx->shape.emplace_back(n);
+    ctx->strides.emplace_back(stride);
+    stride *= n;
+  }
+  primitiv_DLTensor &dl = ctx->managed.dl_tensor;
+  dl.data = const_cast<float *>(data);
+  dl.device = {PRIMITIV_DL_CPU, 0};
+  dl.ndim = ctx->shape.size();
+  dl.dtype = {PRIMITIV_DL_FLOAT, 32, 1};
+  dl.shape = ctx->shape.data();
+  dl.strides = ctx->strides.data();
+  dl.byte_offset = 0;
+  ctx->managed.manager_ctx = ctx;
+  ctx->managed.deleter = ::delete_dlpack_context;
+  return &ctx->managed;
+}
+primitiv_DLManagedTensor *safe_primitiv_Tensor_to_dlpack(
+    const primitiv_Tensor *tensor, primitiv_Status *status) {
+  SAFE_RETURN(primitiv_Tensor_to_dlpack(tensor), status, nullptr);
+}
+
 }  // end extern "C"
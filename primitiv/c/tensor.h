@@ -4,6 +4,7 @@
 #define PRIMITIV_C_TENSOR_H_
 
 #include <primitiv/c/define.h>
+#include <primitiv/c/device.h>
 #include <primitiv/c/shape.h>
 #include <primitiv/c/status.h>
 
@@ -13,6 +14,41 @@ extern "C" {
 
 typedef struct primitiv_Tensor primitiv_Tensor;
 
+/*
+ * Structures to exchange tensors without copying, which have the same layout
+ * as DLTensor and DLManagedTensor of DLPack (https://github.com/dmlc/dlpack).
+ */
+typedef struct primitiv_DLDevice {
+  int32_t device_type;
+  int32_t device_id;
+} primitiv_DLDevice;
+
+typedef struct primitiv_DLDataType {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+} primitiv_DLDataType;
+
+typedef struct primitiv_DLTensor {
+  void *data;
+  primitiv_DLDevice device;
+  int32_t ndim;
+  primitiv_DLDataType dtype;
+  int64_t *shape;
+  int64_t *strides;
+  uint64_t byte_offset;
+} primitiv_DLTensor;
+
+typedef struct primitiv_DLManagedTensor {
+  primitiv_DLTensor dl_tensor;
+  void *manager_ctx;
+  void (*deleter)(struct primitiv_DLManagedTensor *self);
+} primitiv_DLManagedTensor;
+
+/* Values of primitiv_DLDevice::device_type and primitiv_DLDataType::code. */
+#define PRIMITIV_DL_CPU 1
+#define PRIMITIV_DL_FLOAT 2
+
 CAPI extern primitiv_Tensor *primitiv_Tensor_new();
 CAPI extern primitiv_Tensor *safe_primitiv_Tensor_new(primitiv_Status *status);
 
@@ -99,6 +135,35 @@ CAPI extern primitiv_Tensor *primitiv_Tensor_inplace_subtract(
 CAPI extern primitiv_Tensor *safe_primitiv_Tensor_inplace_subtract(
     primitiv_Tensor *tensor, const primitiv_Tensor *x, primitiv_Status *status);
 
+/*
+ * Wraps an external float32 array on the host memory as a new tensor.
+ * Axes of `src` are treated as dimensions of the tensor, and the last axis is
+ * treated as the batch if `has_batch` is true. Only compact column-major
+ * arrays (each stride is the product of preceding extents) are accepted.
+ * On success, the tensor takes the ownership of `src` and calls its deleter
+ * when the last tensor which refers the array is destroyed. The device
+ * should store tensors on the host memory (naive, Eigen or hybrid).
+ */
+CAPI extern primitiv_Tensor *primitiv_Tensor_new_from_dlpack(
+    primitiv_DLManagedTensor *src, bool has_batch, primitiv_Device *device);
+CAPI extern primitiv_Tensor *safe_primitiv_Tensor_new_from_dlpack(
+    primitiv_DLManagedTensor *src,
+    bool has_batch,
+    primitiv_Device *device,
+    primitiv_Status *status);
+
+/*
+ * Exposes the internal array of a tensor on the host memory without copying.
+ * The result has `primitiv_Shape_depth() + 1` axes: the dimensions of the
+ * tensor followed by the batch, with column-major strides. The array should
+ * be treated as read-only, and stays alive until the deleter of the result
+ * is called.
+ */
+CAPI extern primitiv_DLManagedTensor *primitiv_Tensor_to_dlpack(
+    const primitiv_Tensor *tensor);
+CAPI extern primitiv_DLManagedTensor *safe_primitiv_Tensor_to_dlpack(
+    const primitiv_Tensor *tensor, primitiv_Status *status);
+
 #ifdef __cplusplus
 }  // end extern "C"
 #endif
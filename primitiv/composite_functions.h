@@ -1,6 +1,10 @@
 #ifndef PRIMITIV_COMPOSITE_FUNCTIONS_H_
 #define PRIMITIV_COMPOSITE_FUNCTIONS_H_
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <primitiv/arithmetic.h>
 #include <primitiv/basic_functions.h>
 
@@ -66,6 +70,145 @@ inline type_traits::Identity<Var> mean(const Var &x, std::uint32_t dim) {
   return sum(x, dim) / x.shape()[dim];
 }
 
+namespace detail {
+
+/*
+ * Applies a single-dimension reduction over several dimensions.
+ * Each run of adjacent dimensions is merged into one axis by a (zero-copy)
+ * reshape and reduced by one call, and runs with larger volumes are reduced
+ * earlier to minimize the amount of data touched by the following calls.
+ * `first` is applied to the first run, and `rest` to remaining runs.
+ * The resulting shape keeps all reduced dimensions as size 1.
+ */
+template<typename Var, typename FirstOp, typename RestOp>
+inline type_traits::Identity<Var> reduce_dims(
+    const Var &x, std::vector<std::uint32_t> dims,
+    FirstOp first, RestOp rest) {
+  if (dims.empty()) THROW_ERROR("No dimensions to reduce.");
+  const Shape &s = x.shape();
+  std::sort(dims.begin(), dims.end());
+  dims.erase(std::unique(dims.begin(), dims.end()), dims.end());
+
+  // Collects runs of adjacent dimensions with non-trivial sizes.
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> runs;
+  for (const std::uint32_t d : dims) {
+    if (d >= s.depth()) break;
+    if (!runs.empty() && runs.back().second + 1 == d) runs.back().second = d;
+    else runs.emplace_back(d, d);
+  }
+  if (runs.empty()) return first(x, dims[0]);
+
+  const auto run_volume = [&s](const std::pair<std::uint32_t, std::uint32_t> &r) {
+    std::uint32_t v = 1;
+    for (std::uint32_t i = r.first; i <= r.second; ++i) v *= s[i];
+    return v;
+  };
+  std::stable_sort(
+      runs.begin(), runs.end(),
+      [&run_volume](
+        const std::pair<std::uint32_t, std::uint32_t> &a,
+        const std::pair<std::uint32_t, std::uint32_t> &b) {
+        return run_volume(a) > run_volume(b);
+      });
+
+  Var ret = x;
+  bool is_first = true;
+  for (const auto &r : runs) {
+    const Shape cur = ret.shape();
+    if (r.first == r.second) {
+      ret = is_first ? first(ret, r.first) : rest(ret, r.first);
+    } else {
+      std::vector<std::uint32_t> merged;
+      Shape target = cur;
+      for (std::uint32_t i = 0; i < r.first; ++i) merged.emplace_back(cur[i]);
+      merged.emplace_back(run_volume(r));
+      for (std::uint32_t i = r.second + 1; i < cur.depth(); ++i) {
+        merged.emplace_back(cur[i]);
+      }
+      for (std::uint32_t i = r.first; i <= r.second; ++i) {
+        target = target.resize_dim(i, 1);
+      }
+      const Var y = reshape(ret, Shape(merged, cur.batch()));
+      ret = reshape(
+          is_first ? first(y, r.first) : rest(y, r.first), target);
+    }
+    is_first = false;
+  }
+  return ret;
+}
+
+}  // namespace detail
+
+template<typename Var>
+inline type_traits::Identity<Var> sum(
+    const Var &x, const std::vector<std::uint32_t> &dims) {
+  const auto op = [](const Var &y, std::uint32_t d) { return sum(y, d); };
+  return detail::reduce_dims(x, dims, op, op);
+}
+
+template<typename Var>
+inline type_traits::Identity<Var> mean(
+    const Var &x, const std::vector<std::uint32_t> &dims) {
+  const Var y = sum(x, dims);
+  return y / (x.shape().volume() / y.shape().volume());
+}
+
+template<typename Var>
+inline type_traits::Identity<Var> max(
+    const Var &x, const std::vector<std::uint32_t> &dims) {
+  const auto op = [](const Var &y, std::uint32_t d) { return max(y, d); };
+  return detail::reduce_dims(x, dims, op, op);
+}
+
+template<typename Var>
+inline type_traits::Identity<Var> min(
+    const Var &x, const std::vector<std::uint32_t> &dims) {
+  const auto op = [](const Var &y, std::uint32_t d) { return min(y, d); };
+  return detail::reduce_dims(x, dims, op, op);
+}
+
+template<typename Var>
+inline type_traits::Identity<Var> squared_norm(
+    const Var &x, const std::vector<std::uint32_t> &dims) {
+  return detail::reduce_dims(
+      x, dims,
+      [](const Var &y, std::uint32_t d) { return squared_norm(y, d); },
+      [](const Var &y, std::uint32_t d) { return sum(y, d); });
+}
+
+/*
+ * Softmax cross entropy only over unmasked minibatch elements.
+ * `mask[i] == false` means that the i-th element is a padding and is removed
+ * before calculating the loss, so the resulting minibatch size is equal to
+ * the number of unmasked elements. If unmasked elements form a prefix of the
+ * minibatch, they are extracted by batch::slice() without copying memory.
+ */
+template<typename Var>
+inline type_traits::Identity<Var> masked_softmax_cross_entropy(
+    const Var &x, const std::vector<std::uint32_t> &ids,
+    const std::vector<bool> &mask, std::uint32_t dim) {
+  const std::uint32_t bs = x.shape().batch();
+  if (ids.size() != bs || mask.size() != bs) {
+    THROW_ERROR(
+        "Invalid sizes of IDs or mask. x.shape: " << x.shape().to_string()
+        << ", ids.size(): " << ids.size() << ", mask.size(): " << mask.size());
+  }
+  std::vector<std::uint32_t> valid;
+  std::vector<std::uint32_t> valid_ids;
+  for (std::uint32_t i = 0; i < bs; ++i) {
+    if (mask[i]) {
+      valid.emplace_back(i);
+      valid_ids.emplace_back(ids[i]);
+    }
+  }
+  if (valid.empty()) THROW_ERROR("All minibatch elements are masked.");
+  if (valid.size() == bs) return softmax_cross_entropy(x, ids, dim);
+  const Var y = valid.back() + 1 == valid.size()
+    ? batch::slice(x, 0, valid.size())
+    : batch::pick(x, valid);
+  return softmax_cross_entropy(y, valid_ids, dim);
+}
+
 template<typename Container>
 inline type_traits::Reduce<Container> mean(const Container &xs) {
   return sum(xs) / xs.size();
@@ -157,15 +300,6 @@ inline type_traits::Identity<Var> ones(const Shape &shape) {
   return constant<Var>(shape, 1.);
 }
 
-template<typename Var>
-inline type_traits::Identity<Var> dropout(
-    const Var &x, float rate, bool enabled) {
-  if (!enabled) return x;
-  if (rate == 1.) return 0. * x;
-  const float p = 1. - rate;
-  return (1. / p) * x * random::bernoulli<Var>(x.shape(), p, x.device());
-}
-
 }  // namespace functions
 }  // namespace primitiv
 
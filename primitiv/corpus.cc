@@ -0,0 +1,403 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <primitiv/corpus.h>
+#include <primitiv/file_format.h>
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace {
+
+// Header of corpus files, followed by `num_tokens` IDs (padded to 8 bytes)
+// and `num_sentences + 1` offsets.
+struct Header {
+  std::uint32_t major;
+  std::uint32_t minor;
+  std::uint32_t datatype;
+  std::uint32_t reserved;
+  std::uint64_t num_sentences;
+  std::uint64_t num_tokens;
+};
+
+// Maximum number of bytes of text tokenized by each thread at once.
+const std::size_t CHUNK_SIZE = 16 << 20;
+
+std::uint64_t offsets_position(std::uint64_t num_tokens) {
+  return (sizeof(Header) + num_tokens * sizeof(std::uint32_t) + 7) & ~7ull;
+}
+
+std::uint32_t resolve_num_threads(std::uint32_t num_threads) {
+  return num_threads ? num_threads
+    : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Read-only mapping of a whole file.
+class MappedFile : primitiv::mixins::Nonmovable<MappedFile> {
+public:
+  explicit MappedFile(const string &path) : addr_(nullptr), size_(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) THROW_ERROR("Could not open file: " << path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      THROW_ERROR("Could not open file: " << path);
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      addr_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr_ == MAP_FAILED) {
+        addr_ = nullptr;
+        ::close(fd);
+        THROW_ERROR("Could not map file: " << path);
+      }
+    }
+    // The mapping remains after closing the descriptor.
+    ::close(fd);
+  }
+
+  ~MappedFile() {
+    if (addr_) ::munmap(addr_, size_);
+  }
+
+  // Releases the ownership of the mapping.
+  void *release() {
+    void *addr = addr_;
+    addr_ = nullptr;
+    return addr;
+  }
+
+  const char *data() const { return static_cast<const char *>(addr_); }
+  std::size_t size() const { return size_; }
+
+private:
+  void *addr_;
+  std::size_t size_;
+};
+
+// Temporary file which is removed unless committed.
+class TemporaryFile : primitiv::mixins::Nonmovable<TemporaryFile> {
+public:
+  explicit TemporaryFile(const string &path) : path_(path), committed_(false) {}
+
+  ~TemporaryFile() {
+    if (!committed_) std::remove(path_.c_str());
+  }
+
+  // Moves the file to `dest`.
+  void commit(const string &dest) {
+    if (std::rename(path_.c_str(), dest.c_str()) != 0) {
+      THROW_ERROR("Could not write file: " << dest);
+    }
+    committed_ = true;
+  }
+
+  const string &path() const { return path_; }
+
+private:
+  string path_;
+  bool committed_;
+};
+
+// Returns the position just after the end of the line including `p`.
+const char *next_line(const char *p, const char *end) {
+  const void *nl = std::memchr(p, '\n', end - p);
+  return nl ? static_cast<const char *>(nl) + 1 : end;
+}
+
+// Splits [begin, end) into at most `n` ranges at line boundaries.
+vector<std::pair<const char *, const char *>> split_lines(
+    const char *begin, const char *end, std::uint32_t n) {
+  vector<std::pair<const char *, const char *>> ranges;
+  const std::size_t step = (end - begin + n - 1) / n;
+  while (begin < end) {
+    const char *p = begin + std::min<std::size_t>(step, end - begin);
+    p = p > begin && p[-1] == '\n' ? p : next_line(p, end);
+    ranges.emplace_back(begin, p);
+    begin = p;
+  }
+  return ranges;
+}
+
+// Calls `word(b, e)` for each word and `eol()` at the end of each line.
+template<typename WordFunc, typename EolFunc>
+void tokenize(const char *p, const char *end, WordFunc word, EolFunc eol) {
+  while (p < end) {
+    const char *line_end = next_line(p, end);
+    while (p < line_end) {
+      while (p < line_end && (*p == ' ' || *p == '\t' ||
+                              *p == '\r' || *p == '\n')) ++p;
+      const char *b = p;
+      while (p < line_end && *p != ' ' && *p != '\t' &&
+             *p != '\r' && *p != '\n') ++p;
+      if (p > b) word(b, p);
+    }
+    eol();
+  }
+}
+
+// Runs `fn(0), ..., fn(n - 1)` on separate threads.
+void run_parallel(std::uint32_t n, const std::function<void(std::uint32_t)> &fn) {
+  vector<std::exception_ptr> errors(n);
+  vector<std::thread> threads;
+  for (std::uint32_t i = 1; i < n; ++i) {
+    threads.emplace_back([&, i] {
+        try { fn(i); } catch (...) { errors[i] = std::current_exception(); }
+    });
+  }
+  try { if (n > 0) fn(0); } catch (...) { errors[0] = std::current_exception(); }
+  for (std::thread &t : threads) t.join();
+  for (const auto &e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+}  // namespace
+
+namespace primitiv {
+
+Corpus::Corpus(const string &path)
+: addr_(nullptr), size_(0) {
+  MappedFile file(path);
+  if (file.size() < sizeof(Header)) {
+    THROW_ERROR("Invalid corpus file: " << path);
+  }
+  const Header &header = *reinterpret_cast<const Header *>(file.data());
+  FileFormat::assert_version(header.major, header.minor);
+  FileFormat::assert_datatype(
+      FileFormat::DataType::CORPUS, header.datatype);
+  // NOTE: Sizes are compared by divisions to avoid overflows with broken
+  // headers.
+  if (header.num_tokens >
+      (file.size() - sizeof(Header)) / sizeof(std::uint32_t)) {
+    THROW_ERROR("Invalid corpus file: " << path);
+  }
+  const std::uint64_t pos = ::offsets_position(header.num_tokens);
+  const std::uint64_t rest = file.size() - std::min<std::uint64_t>(
+      pos, file.size());
+  if (rest % sizeof(std::uint64_t) != 0 ||
+      rest / sizeof(std::uint64_t) == 0 ||
+      rest / sizeof(std::uint64_t) - 1 != header.num_sentences) {
+    THROW_ERROR("Invalid corpus file: " << path);
+  }
+  num_sentences_ = header.num_sentences;
+  num_tokens_ = header.num_tokens;
+  ids_ = reinterpret_cast<const std::uint32_t *>(
+      file.data() + sizeof(Header));
+  offsets_ = reinterpret_cast<const std::uint64_t *>(file.data() + pos);
+  size_ = file.size();
+  addr_ = file.release();
+}
+
+Corpus::~Corpus() {
+  ::munmap(addr_, size_);
+}
+
+unordered_map<string, std::uint64_t> Corpus::count_words(
+    const string &path, std::uint32_t num_threads) {
+  const MappedFile file(path);
+  const auto ranges = ::split_lines(
+      file.data(), file.data() + file.size(),
+      ::resolve_num_threads(num_threads));
+
+  vector<unordered_map<string, std::uint64_t>> freqs(ranges.size());
+  ::run_parallel(ranges.size(), [&](std::uint32_t i) {
+      auto &freq = freqs[i];
+      string word;
+      ::tokenize(
+          ranges[i].first, ranges[i].second,
+          [&](const char *b, const char *e) {
+            word.assign(b, e);
+            ++freq[word];
+          },
+          [] {});
+  });
+
+  if (freqs.empty()) return {};
+  auto &ret = freqs[0];
+  for (std::uint32_t i = 1; i < freqs.size(); ++i) {
+    for (const auto &kv : freqs[i]) ret[kv.first] += kv.second;
+  }
+  return std::move(ret);
+}
+
+unordered_map<string, std::uint32_t> Corpus::make_vocab(
+    const string &path,
+    const vector<string> &specials,
+    std::uint32_t size,
+    std::uint32_t num_threads) {
+  unordered_map<string, std::uint32_t> vocab;
+  for (const string &w : specials) {
+    if (!vocab.emplace(w, vocab.size()).second) {
+      THROW_ERROR("Duplicated special word: " << w);
+    }
+  }
+  if (size > 0 && size < vocab.size()) {
+    THROW_ERROR(
+        "Vocabulary size is less than the number of special words. size: "
+        << size << ", specials: " << vocab.size());
+  }
+
+  const auto freq = count_words(path, num_threads);
+  vector<std::pair<std::uint64_t, const string *>> words;
+  words.reserve(freq.size());
+  for (const auto &kv : freq) words.emplace_back(kv.second, &kv.first);
+  std::sort(
+      words.begin(), words.end(),
+      [](const std::pair<std::uint64_t, const string *> &a,
+         const std::pair<std::uint64_t, const string *> &b) {
+        return a.first != b.first ? a.first > b.first : *a.second < *b.second;
+      });
+  for (const auto &w : words) {
+    if (size > 0 && vocab.size() >= size) break;
+    vocab.emplace(*w.second, vocab.size());
+  }
+  return vocab;
+}
+
+void Corpus::write(
+    const string &text_path,
+    const string &corpus_path,
+    const unordered_map<string, std::uint32_t> &vocab,
+    const string &unk,
+    const string &bos,
+    const string &eos,
+    std::uint32_t num_threads) {
+  const auto find_special = [&vocab](const string &w, const char *name) {
+    if (w.empty()) return -1ll;
+    const auto it = vocab.find(w);
+    if (it == vocab.end()) {
+      THROW_ERROR("Vocabulary does not contain the " << name << ": " << w);
+    }
+    return static_cast<long long>(it->second);
+  };
+  const long long unk_id = find_special(unk, "unknown word");
+  const long long bos_id = find_special(bos, "BOS");
+  const long long eos_id = find_special(eos, "EOS");
+
+  const MappedFile text(text_path);
+  // The corpus is written into a temporary file and renamed at last, so that
+  // failures do not leave broken files at `corpus_path`.
+  TemporaryFile temp(corpus_path + ".tmp" + std::to_string(::getpid()));
+  std::ofstream ofs(temp.path(), std::ios::binary);
+  if (!ofs.is_open()) THROW_ERROR("Could not open file: " << temp.path());
+  Header header {
+    FileFormat::CurrentVersion::MAJOR,
+    FileFormat::CurrentVersion::MINOR,
+    static_cast<std::uint32_t>(FileFormat::DataType::CORPUS),
+    0, 0, 0,
+  };
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  // Tokenizes the text chunk by chunk to bound the memory.
+  num_threads = ::resolve_num_threads(num_threads);
+  vector<std::uint64_t> offsets {0};
+  const char *p = text.data();
+  const char *end = p + text.size();
+  while (p < end) {
+    const char *round_end = p + std::min<std::size_t>(
+        static_cast<std::size_t>(end - p), num_threads * ::CHUNK_SIZE);
+    if (round_end < end && round_end[-1] != '\n') {
+      round_end = ::next_line(round_end, end);
+    }
+    const auto ranges = ::split_lines(p, round_end, num_threads);
+    vector<vector<std::uint32_t>> ids(ranges.size());
+    vector<vector<std::uint32_t>> lengths(ranges.size());
+    ::run_parallel(ranges.size(), [&](std::uint32_t i) {
+        auto &out = ids[i];
+        std::size_t begin = 0;
+        string word;
+        if (bos_id >= 0) out.emplace_back(bos_id);
+        ::tokenize(
+            ranges[i].first, ranges[i].second,
+            [&](const char *b, const char *e) {
+              word.assign(b, e);
+              const auto it = vocab.find(word);
+              if (it != vocab.end()) {
+                out.emplace_back(it->second);
+              } else if (unk_id >= 0) {
+                out.emplace_back(unk_id);
+              } else {
+                THROW_ERROR("Unknown word: " << word);
+              }
+            },
+            [&] {
+              if (eos_id >= 0) out.emplace_back(eos_id);
+              lengths[i].emplace_back(out.size() - begin);
+              begin = out.size();
+              if (bos_id >= 0) out.emplace_back(bos_id);
+            });
+        // Removes the BOS of the line after the last one.
+        if (bos_id >= 0) out.pop_back();
+    });
+    for (std::uint32_t i = 0; i < ranges.size(); ++i) {
+      ofs.write(
+          reinterpret_cast<const char *>(ids[i].data()),
+          ids[i].size() * sizeof(std::uint32_t));
+      for (const std::uint32_t len : lengths[i]) {
+        offsets.emplace_back(offsets.back() + len);
+      }
+    }
+    p = round_end;
+  }
+
+  header.num_sentences = offsets.size() - 1;
+  header.num_tokens = offsets.back();
+  const std::uint64_t pos = ::offsets_position(header.num_tokens);
+  const std::uint64_t written =
+    sizeof(Header) + header.num_tokens * sizeof(std::uint32_t);
+  const char padding[8] {};
+  ofs.write(padding, pos - written);
+  ofs.write(
+      reinterpret_cast<const char *>(offsets.data()),
+      offsets.size() * sizeof(std::uint64_t));
+  ofs.seekp(0);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.close();
+  if (!ofs) THROW_ERROR("Could not write file: " << temp.path());
+  temp.commit(corpus_path);
+}
+
+void Corpus::save_vocab(
+    const string &path, const unordered_map<string, std::uint32_t> &vocab) {
+  vector<const string *> words(vocab.size(), nullptr);
+  for (const auto &kv : vocab) {
+    if (kv.second >= words.size() || words[kv.second]) {
+      THROW_ERROR("Invalid word ID: " << kv.first << ": " << kv.second);
+    }
+    words[kv.second] = &kv.first;
+  }
+  std::ofstream ofs(path);
+  if (!ofs.is_open()) THROW_ERROR("Could not open file: " << path);
+  for (const string *w : words) ofs << *w << '\n';
+  if (!ofs) THROW_ERROR("Could not write file: " << path);
+}
+
+unordered_map<string, std::uint32_t> Corpus::load_vocab(const string &path) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open()) THROW_ERROR("Could not open file: " << path);
+  unordered_map<string, std::uint32_t> vocab;
+  string word;
+  while (std::getline(ifs, word)) {
+    if (!vocab.emplace(word, vocab.size()).second) {
+      THROW_ERROR("Duplicated word in the vocabulary: " << word);
+    }
+  }
+  return vocab;
+}
+
+}  // namespace primitiv
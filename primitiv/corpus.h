@@ -0,0 +1,177 @@
+#ifndef PRIMITIV_CORPUS_H_
+#define PRIMITIV_CORPUS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <primitiv/error.h>
+#include <primitiv/mixins.h>
+
+namespace primitiv {
+
+/**
+ * Tokenized corpus stored in a binary file.
+ *
+ * The file consists of a header, word IDs of all sentences, and offsets of
+ * each sentence in the ID array. Corpus objects map the file into the memory,
+ * so that opening corpora takes a constant time and memory regardless of
+ * their sizes.
+ *
+ * Corpus files are made from space-separated text files by `write()`, which
+ * tokenizes lines using multiple threads:
+ *
+ *     const auto vocab = Corpus::make_vocab("train.txt", {"<unk>"}, 10000);
+ *     Corpus::write("train.txt", "train.bin", vocab, "<unk>", "", "");
+ *     const Corpus corpus("train.bin");
+ */
+class Corpus : mixins::Nonmovable<Corpus> {
+public:
+  /**
+   * Opens a corpus file.
+   * @param path Path to the file made by `write()`.
+   */
+  explicit Corpus(const std::string &path);
+
+  ~Corpus();
+
+  /**
+   * Returns the number of sentences.
+   * @return Number of sentences.
+   */
+  std::uint64_t num_sentences() const { return num_sentences_; }
+
+  /**
+   * Returns the number of word IDs in all sentences.
+   * @return Number of word IDs.
+   */
+  std::uint64_t num_tokens() const { return num_tokens_; }
+
+  /**
+   * Returns the length of a sentence.
+   * @param i Index of the sentence.
+   * @return Number of word IDs in the sentence.
+   * @throw primitiv::Error `i` is out of range or the file is broken.
+   */
+  std::uint32_t length(std::uint64_t i) const {
+    check_index(i);
+    return offsets_[i + 1] - offsets_[i];
+  }
+
+  /**
+   * Returns word IDs of a sentence without copying.
+   * @param i Index of the sentence.
+   * @return Pointer to `length(i)` word IDs, which is valid while this object
+   *         is alive.
+   * @throw primitiv::Error `i` is out of range or the file is broken.
+   */
+  const std::uint32_t *data(std::uint64_t i) const {
+    check_index(i);
+    return ids_ + offsets_[i];
+  }
+
+  /**
+   * Returns word IDs of a sentence.
+   * @param i Index of the sentence.
+   * @return List of word IDs.
+   */
+  std::vector<std::uint32_t> sentence(std::uint64_t i) const {
+    const std::uint32_t *p = data(i);
+    return std::vector<std::uint32_t>(p, p + length(i));
+  }
+
+  /**
+   * Counts words in a space-separated text file.
+   * @param path Path to the text file.
+   * @param num_threads Number of threads. If 0, the number of hardware
+   *                    threads is used.
+   * @return Frequencies of each word.
+   */
+  static std::unordered_map<std::string, std::uint64_t> count_words(
+      const std::string &path, std::uint32_t num_threads = 0);
+
+  /**
+   * Makes a vocabulary from a space-separated text file.
+   * @param path Path to the text file.
+   * @param specials Words which take first IDs in this order.
+   * @param size Maximum size of the vocabulary including `specials`. If 0,
+   *             all words in the file are used.
+   * @param num_threads Number of threads. If 0, the number of hardware
+   *                    threads is used.
+   * @return Mapping from words to their IDs. Words in the file are sorted by
+   *         their frequencies (and words themselves for ties).
+   */
+  static std::unordered_map<std::string, std::uint32_t> make_vocab(
+      const std::string &path,
+      const std::vector<std::string> &specials,
+      std::uint32_t size = 0,
+      std::uint32_t num_threads = 0);
+
+  /**
+   * Tokenizes a space-separated text file and writes a corpus file.
+   * @param text_path Path to the text file. Each line becomes a sentence.
+   * @param corpus_path Path to the resulting corpus file.
+   * @param vocab Mapping from words to their IDs.
+   * @param unk Word used in place of unknown words. If empty, unknown words
+   *            are reported as errors.
+   * @param bos Word inserted at the beginning of each sentence, or empty.
+   * @param eos Word inserted at the end of each sentence, or empty.
+   * @param num_threads Number of threads. If 0, the number of hardware
+   *                    threads is used.
+   */
+  static void write(
+      const std::string &text_path,
+      const std::string &corpus_path,
+      const std::unordered_map<std::string, std::uint32_t> &vocab,
+      const std::string &unk,
+      const std::string &bos,
+      const std::string &eos,
+      std::uint32_t num_threads = 0);
+
+  /**
+   * Saves a vocabulary into a text file with one word per line.
+   * @param path Path to the text file.
+   * @param vocab Mapping from words to their IDs. IDs should be unique and
+   *              less than `vocab.size()`.
+   */
+  static void save_vocab(
+      const std::string &path,
+      const std::unordered_map<std::string, std::uint32_t> &vocab);
+
+  /**
+   * Loads a vocabulary saved by `save_vocab()`.
+   * @param path Path to the text file.
+   * @return Mapping from words to their IDs.
+   */
+  static std::unordered_map<std::string, std::uint32_t> load_vocab(
+      const std::string &path);
+
+private:
+  void check_index(std::uint64_t i) const {
+    if (i >= num_sentences_) {
+      THROW_ERROR(
+          "Sentence index out of range. i: " << i
+          << ", num_sentences: " << num_sentences_);
+    }
+    // NOTE: Offsets are checked here instead of the constructor to keep
+    // opening corpora in a constant time.
+    if (offsets_[i] > offsets_[i + 1] || offsets_[i + 1] > num_tokens_) {
+      THROW_ERROR(
+          "Invalid offsets of the sentence. i: " << i
+          << ", begin: " << offsets_[i] << ", end: " << offsets_[i + 1]
+          << ", num_tokens: " << num_tokens_);
+    }
+  }
+
+  void *addr_;
+  std::uint64_t size_;
+  std::uint64_t num_sentences_;
+  std::uint64_t num_tokens_;
+  const std::uint32_t *ids_;
+  const std::uint64_t *offsets_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_CORPUS_H_
@@ -0,0 +1,442 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <primitiv/cpp_exporter.h>
+#include <primitiv/error.h>
+#include <primitiv/operator_impl.h>
+#include <primitiv/parameter.h>
+#include <primitiv/string_utils.h>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// Kernels used by Operator::forward_cpp().
+const char *KERNELS = R"(// y[r, b] = combine(map(x[r, 0, b]), map(x[r, 1, b]), ...)
+template<
+  std::uint32_t B, std::uint32_t N, std::uint32_t R,
+  typename Map, typename Combine>
+inline void reduce(float *y, const float *x, Map map, Combine combine) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    float *py = y + r * B;
+    const float *px = x + r * B * N;
+    for (std::uint32_t b = 0; b < B; ++b) py[b] = map(px[b]);
+    for (std::uint32_t j = 1; j < N; ++j) {
+      px += B;
+      for (std::uint32_t b = 0; b < B; ++b) py[b] = combine(py[b], map(px[b]));
+    }
+  }
+}
+
+// y[r, j, b] = x[r, b]
+template<std::uint32_t B, std::uint32_t N, std::uint32_t R>
+inline void broadcast(float *y, const float *x) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    for (std::uint32_t j = 0; j < N; ++j) {
+      std::copy(x + r * B, x + (r + 1) * B, y + (r * N + j) * B);
+    }
+  }
+}
+
+// Copies R blocks with SIZE elements.
+template<
+  std::uint32_t SIZE, std::uint32_t R, std::uint32_t SKIP_X,
+  std::uint32_t SKIP_Y>
+inline void copy_blocks(float *y, const float *x) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    std::copy(x + r * SKIP_X, x + r * SKIP_X + SIZE, y + r * SKIP_Y);
+  }
+}
+
+template<std::uint32_t D1, std::uint32_t D2, std::uint32_t BS>
+inline void transpose(float *y, const float *x) {
+  for (std::uint32_t n = 0; n < BS; ++n) {
+    for (std::uint32_t j = 0; j < D2; ++j) {
+      for (std::uint32_t i = 0; i < D1; ++i) {
+        y[n * D1 * D2 + j + i * D2] = x[n * D1 * D2 + i + j * D1];
+      }
+    }
+  }
+}
+
+// y = a . b, where a is D1xD2 and b is D2xD3.
+// SKIP_A/SKIP_B are 0 if the operand is shared by all minibatch elements.
+template<
+  std::uint32_t D1, std::uint32_t D2, std::uint32_t D3, std::uint32_t BS,
+  std::uint32_t SKIP_A, std::uint32_t SKIP_B>
+inline void matmul(float *y, const float *a, const float *b) {
+  for (std::uint32_t n = 0; n < BS; ++n) {
+    const float *pa = a + n * SKIP_A;
+    const float *pb = b + n * SKIP_B;
+    for (std::uint32_t k = 0; k < D3; ++k) {
+      float *py = y + (n * D3 + k) * D1;
+      for (std::uint32_t i = 0; i < D1; ++i) py[i] = 0;
+      for (std::uint32_t j = 0; j < D2; ++j) {
+        const float bjk = pb[j + k * D2];
+        const float *paj = pa + j * D1;
+        for (std::uint32_t i = 0; i < D1; ++i) py[i] += paj[i] * bjk;
+      }
+    }
+  }
+}
+
+template<std::uint32_t SIZE, std::uint32_t BS>
+inline void batch_sum(float *y, const float *x) {
+  std::copy(x, x + SIZE, y);
+  for (std::uint32_t n = 1; n < BS; ++n) {
+    for (std::uint32_t i = 0; i < SIZE; ++i) y[i] += x[n * SIZE + i];
+  }
+}
+)";
+
+// Floats in the workspace are aligned to 32 bytes.
+const std::uint32_t ALIGNMENT = 8;
+
+// Adds indentation to each line.
+string indent(const string &code, const string &prefix) {
+  std::stringstream ss;
+  string::size_type begin = 0;
+  while (begin <= code.size()) {
+    const string::size_type end = std::min(code.find('\n', begin), code.size());
+    ss << prefix << code.substr(begin, end - begin) << '\n';
+    begin = end + 1;
+  }
+  return ss.str();
+}
+
+// Simple first-fit allocator of the workspace.
+class WorkspacePlanner {
+public:
+  WorkspacePlanner() : size_(0) {}
+
+  std::uint32_t allocate(std::uint32_t size) {
+    size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      if (it->second >= size) {
+        const std::uint32_t offset = it->first;
+        const std::uint32_t rest = it->second - size;
+        free_.erase(it);
+        if (rest > 0) free_.emplace(offset + size, rest);
+        return offset;
+      }
+    }
+    // Extends the last free block if it reaches the end.
+    if (!free_.empty()) {
+      const auto last = std::prev(free_.end());
+      if (last->first + last->second == size_) {
+        const std::uint32_t offset = last->first;
+        free_.erase(last);
+        size_ = offset + size;
+        return offset;
+      }
+    }
+    const std::uint32_t offset = size_;
+    size_ += size;
+    return offset;
+  }
+
+  void release(std::uint32_t offset, std::uint32_t size) {
+    size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    auto it = free_.emplace(offset, size).first;
+    // Merges adjacent blocks.
+    if (it != free_.begin()) {
+      const auto prev = std::prev(it);
+      if (prev->first + prev->second == it->first) {
+        prev->second += it->second;
+        free_.erase(it);
+        it = prev;
+      }
+    }
+    const auto next = std::next(it);
+    if (next != free_.end() && it->first + it->second == next->first) {
+      it->second += next->second;
+      free_.erase(next);
+    }
+  }
+
+  std::uint32_t size() const { return size_; }
+
+private:
+  std::uint32_t size_;
+  std::map<std::uint32_t, std::uint32_t> free_;
+};
+
+}  // namespace
+
+namespace primitiv {
+
+string CppExporter::generate(
+    const vector<Node> &outputs, const string &name) const {
+  if (outputs.empty()) THROW_ERROR("No nodes to export.");
+  const Graph &g = outputs[0].graph();
+  const auto &ops = g.ops_;
+  const std::uint32_t num_ops = ops.size();
+
+  for (const Node &node : outputs) {
+    if (&node.graph() != &g) {
+      THROW_ERROR(
+          "Graph mismatched. node.graph(): " << &node.graph()
+          << " != outputs[0].graph(): " << &g);
+    }
+  }
+  for (const auto &op : ops) {
+    if (op.rets.size() != 1) {
+      THROW_ERROR(
+          "Operators with multiple results are not supported: "
+          << op.op->name());
+    }
+  }
+
+  // Operators which are required to calculate outputs.
+  // Operators are always sorted topologically.
+  vector<bool> used(num_ops, false);
+  for (const Node &node : outputs) used[node.operator_id()] = true;
+  for (std::uint32_t i = num_ops; i-- > 0; ) {
+    if (!used[i]) continue;
+    for (const auto &arg : ops[i].args) used[arg.op_id] = true;
+  }
+
+  const auto shape = [&ops](std::uint32_t i) -> const Shape & {
+    return ops[i].rets[0].shape;
+  };
+
+  // Names of parameters.
+  std::unordered_map<const Tensor *, const vector<string> *> param_names;
+  const auto all_params = model_.get_all_parameters();
+  for (const auto &kv : all_params) {
+    param_names.emplace(&kv.second->value(), &kv.first);
+  }
+
+  enum class Kind { INPUT, PARAMETER, ELEMENTWISE, KERNEL };
+  struct Value {
+    Kind kind;
+    string name;
+    std::uint32_t num_uses;
+    std::uint32_t consumer;
+    bool is_output;
+    bool inlined;
+    // Position where the value is actually read at last.
+    std::uint32_t last_use;
+    std::uint32_t offset;
+  };
+  vector<Value> vals(num_ops);
+
+  vector<std::uint32_t> inputs;
+  vector<std::uint32_t> params;
+  for (std::uint32_t i = 0; i < num_ops; ++i) {
+    if (!used[i]) continue;
+    const Operator &op = *ops[i].op;
+    Value &v = vals[i];
+    v.num_uses = 0;
+    v.consumer = i;
+    v.is_output = false;
+    v.inlined = false;
+    v.last_use = i;
+    v.offset = 0;
+    if (dynamic_cast<const operators::Input *>(&op)) {
+      v.kind = Kind::INPUT;
+      v.name = "x" + std::to_string(inputs.size());
+      inputs.emplace_back(i);
+    } else if (dynamic_cast<const operators::ParameterInput *>(&op)) {
+      const auto it = param_names.find(op.get_inner_value());
+      if (it == param_names.end()) {
+        THROW_ERROR("The graph contains a parameter out of the model.");
+      }
+      v.kind = Kind::PARAMETER;
+      v.name = "p" + std::to_string(params.size());
+      params.emplace_back(i);
+    } else if (!op.elementwise_cpp(
+          vector<string>(ops[i].args.size(), "x")).empty()) {
+      v.kind = Kind::ELEMENTWISE;
+    } else {
+      v.kind = Kind::KERNEL;
+    }
+    for (const auto &arg : ops[i].args) {
+      ++vals[arg.op_id].num_uses;
+      vals[arg.op_id].consumer = i;
+    }
+  }
+
+  // Outputs are written directly into the buffers given by the caller. Other
+  // outputs (inputs, parameters and duplicated nodes) are copied at last.
+  vector<std::uint32_t> copied_outputs;
+  for (std::uint32_t j = 0; j < outputs.size(); ++j) {
+    Value &v = vals[outputs[j].operator_id()];
+    if (v.kind == Kind::INPUT || v.kind == Kind::PARAMETER || v.is_output) {
+      copied_outputs.emplace_back(j);
+    } else {
+      v.is_output = true;
+      v.name = "y" + std::to_string(j);
+    }
+  }
+
+  // Elementwise operations used only once by another elementwise operation
+  // with the same size are inlined into the consumer.
+  for (std::uint32_t i = 0; i < num_ops; ++i) {
+    Value &v = vals[i];
+    if (!used[i] || v.kind != Kind::ELEMENTWISE || v.is_output) continue;
+    if (v.num_uses != 1) continue;
+    if (vals[v.consumer].kind != Kind::ELEMENTWISE) continue;
+    if (shape(i).size() != shape(v.consumer).size()) continue;
+    v.inlined = true;
+  }
+
+  // Calculates lifetimes of values. Arguments of inlined operations are read
+  // in the loop of the consumer.
+  vector<std::uint32_t> position(num_ops);
+  for (std::uint32_t i = num_ops; i-- > 0; ) {
+    position[i] = used[i] && vals[i].inlined ? position[vals[i].consumer] : i;
+  }
+  for (std::uint32_t i = 0; i < num_ops; ++i) {
+    if (!used[i]) continue;
+    for (const auto &arg : ops[i].args) {
+      Value &a = vals[arg.op_id];
+      a.last_use = std::max(a.last_use, position[i]);
+    }
+  }
+
+  // Plans the workspace.
+  WorkspacePlanner planner;
+  vector<std::uint32_t> allocated;
+  for (std::uint32_t i = 0; i < num_ops; ++i) {
+    Value &v = vals[i];
+    if (!used[i] || v.inlined || v.is_output) continue;
+    if (v.kind == Kind::INPUT || v.kind == Kind::PARAMETER) continue;
+    // Results which are no longer read can be overwritten.
+    auto it = allocated.begin();
+    while (it != allocated.end()) {
+      if (vals[*it].last_use < i) {
+        planner.release(vals[*it].offset, shape(*it).size());
+        it = allocated.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    v.offset = planner.allocate(shape(i).size());
+    v.name = "v" + std::to_string(i);
+    allocated.emplace_back(i);
+  }
+
+  // Builds the expression of an element of the value `i`.
+  std::function<string(std::uint32_t)> expression = [&](std::uint32_t i) {
+    const Shape &sy = shape(i);
+    vector<string> args;
+    for (const auto &arg : ops[i].args) {
+      const Value &a = vals[arg.op_id];
+      if (a.inlined) {
+        args.emplace_back(expression(arg.op_id));
+        continue;
+      }
+      const Shape &sa = shape(arg.op_id);
+      string index;
+      if (sa.size() == sy.size()) {
+        index = "i";
+      } else if (sa.volume() == sy.volume()) {
+        index = "i % " + std::to_string(sy.volume());
+      } else if (sa.volume() == 1 && sa.batch() == sy.batch()) {
+        index = "i / " + std::to_string(sy.volume());
+      } else if (sa.size() == 1) {
+        index = "0";
+      } else {
+        THROW_ERROR(
+            "Unexpected shapes of elementwise operation. operator: "
+            << ops[i].op->name() << ", arg: " << sa.to_string()
+            << ", ret: " << sy.to_string());
+      }
+      args.emplace_back(a.name + '[' + index + ']');
+    }
+    return ops[i].op->elementwise_cpp(args);
+  };
+
+  std::stringstream ss;
+  ss << "// Generated by primitiv::CppExporter.\n//\n// Inputs:\n";
+  for (std::uint32_t j = 0; j < inputs.size(); ++j) {
+    ss << "//   x" << j << ": " << shape(inputs[j]).to_string() << '\n';
+  }
+  ss << "// Outputs:\n";
+  for (std::uint32_t j = 0; j < outputs.size(); ++j) {
+    ss << "//   y" << j << ": "
+       << shape(outputs[j].operator_id()).to_string() << '\n';
+  }
+  ss << R"(
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace )" << name << " {\n\nnamespace {\n\n";
+
+  for (std::uint32_t j = 0; j < params.size(); ++j) {
+    const Tensor &value = *ops[params[j]].op->get_inner_value();
+    const vector<float> data = value.to_vector();
+    ss << "// " << string_utils::join(*param_names.at(&value), ".") << ": "
+       << value.shape().to_string() << '\n'
+       << "alignas(32) const float p" << j << '[' << data.size() << "] = {";
+    for (std::uint32_t k = 0; k < data.size(); ++k) {
+      ss << (k % 6 == 0 ? "\n  " : " ")
+         << string_utils::to_cpp_literal(data[k]) << ',';
+    }
+    ss << "\n};\n\n";
+  }
+
+  ss << KERNELS << '\n';
+  if (planner.size() > 0) {
+    ss << "alignas(32) thread_local float ws[" << planner.size() << "];\n\n";
+  }
+  ss << "}  // namespace\n\nvoid forward(";
+  {
+    vector<string> fargs;
+    for (std::uint32_t j = 0; j < inputs.size(); ++j) {
+      fargs.emplace_back("const float *x" + std::to_string(j));
+    }
+    for (std::uint32_t j = 0; j < outputs.size(); ++j) {
+      fargs.emplace_back("float *y" + std::to_string(j));
+    }
+    ss << string_utils::join(fargs, ", ") << ") {\n";
+  }
+
+  for (std::uint32_t i = 0; i < num_ops; ++i) {
+    const Value &v = vals[i];
+    if (!used[i] || v.inlined) continue;
+    if (v.kind == Kind::INPUT || v.kind == Kind::PARAMETER) continue;
+    const Shape &sy = shape(i);
+    ss << "  // " << ops[i].op->name() << ": " << sy.to_string() << '\n';
+    if (!v.is_output) {
+      ss << "  float *const " << v.name << " = ws + " << v.offset << ";\n";
+    }
+    if (v.kind == Kind::ELEMENTWISE) {
+      ss << "  for (std::uint32_t i = 0; i < " << sy.size() << "; ++i) {\n"
+         << "    " << v.name << "[i] = " << expression(i) << ";\n  }\n";
+    } else {
+      vector<string> args;
+      vector<const Shape *> arg_shapes;
+      for (const auto &arg : ops[i].args) {
+        args.emplace_back(vals[arg.op_id].name);
+        arg_shapes.emplace_back(&shape(arg.op_id));
+      }
+      const string code = ops[i].op->forward_cpp(args, arg_shapes, v.name, sy);
+      if (code.empty()) {
+        THROW_ERROR(
+            "Operator is not supported by CppExporter: " << ops[i].op->name());
+      }
+      ss << indent(code, "  ");
+    }
+  }
+
+  for (const std::uint32_t j : copied_outputs) {
+    const std::uint32_t i = outputs[j].operator_id();
+    ss << "  std::copy(" << vals[i].name << ", " << vals[i].name << " + "
+       << shape(i).size() << ", y" << j << ");\n";
+  }
+
+  ss << "}\n\n}  // namespace " << name << '\n';
+  return ss.str();
+}
+
+}  // namespace primitiv
@@ -0,0 +1,75 @@
+#ifndef PRIMITIV_CPP_EXPORTER_H_
+#define PRIMITIV_CPP_EXPORTER_H_
+
+#include <string>
+#include <vector>
+
+#include <primitiv/graph.h>
+#include <primitiv/mixins.h>
+#include <primitiv/model.h>
+
+namespace primitiv {
+
+/**
+ * Ahead-of-time compiler of the forward computation of a Graph.
+ *
+ * The exporter emits a standalone C++11 translation unit which calculates
+ * given nodes without primitiv itself. The generated code depends only on the
+ * standard library:
+ *
+ *   - Shapes are fixed to those in the graph and appear as compile-time
+ *     constants in loops and kernel templates.
+ *   - Values of parameters are embedded as constant arrays, and named by
+ *     their names in the model.
+ *   - Chains of elementwise operations whose intermediate results are used
+ *     only once are fused into one loop.
+ *   - Other intermediate results are placed into one workspace, whose layout
+ *     is planned statically from lifetimes of results.
+ *
+ * The generated translation unit defines one function:
+ *
+ *     namespace <name> {
+ *     void forward(const float *x0, const float *x1, ..., float *y0, ...);
+ *     }
+ *
+ * where `x<i>` are values of Input nodes in the order of their creation, and
+ * `y<i>` are buffers to store values of `outputs`. Each thread has its own
+ * workspace, so the function can be called concurrently.
+ *
+ * Typical usage:
+ *
+ *     Graph g;
+ *     Graph::set_default(g);
+ *     MyModel model;
+ *     model.load("model.bin");
+ *     const Node x = functions::input<Node>(Shape({784}), dummy_data);
+ *     const Node y = model.forward(x);
+ *     std::ofstream("model.cc") << CppExporter(model).generate({y}, "mnist");
+ */
+class CppExporter : mixins::Nonmovable<CppExporter> {
+public:
+  /**
+   * Creates a new CppExporter object.
+   * @param model Model which holds all parameters used in graphs.
+   */
+  explicit CppExporter(const Model &model) : model_(model) {}
+
+  /**
+   * Generates the C++ code which calculates given nodes.
+   * @param outputs Nodes to be calculated. All nodes should belong to the same
+   *                graph.
+   * @param name Name of the namespace of the generated code.
+   * @return Generated C++ code.
+   * @throw primitiv::Error The graph contains operators which are not
+   *                        supported or parameters out of the model.
+   */
+  std::string generate(
+      const std::vector<Node> &outputs, const std::string &name) const;
+
+private:
+  const Model &model_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_CPP_EXPORTER_H_
@@ -37,6 +37,34 @@ __global__ void rand_bernoulli_dev(float p, float size, float *py) {
   if (i < size) py[i] = (float)(py[i] <= p);
 }
 
+__global__ void dropout_mask_dev(
+    const float *pu, float p, std::uint32_t size, std::uint32_t *pm) {
+  const std::uint32_t w = IDX;
+  const std::uint32_t begin = w << 5;
+  if (begin < size) {
+    const std::uint32_t n = ::min(32u, size - begin);
+    std::uint32_t word = 0;
+    for (std::uint32_t i = 0; i < n; ++i) {
+      word |= (std::uint32_t)(pu[begin + i] <= p) << i;
+    }
+    pm[w] = word;
+  }
+}
+
+__global__ void dropout_fw_dev(
+    const float *px, const std::uint32_t *pm, float scale, std::uint32_t size,
+    float *py) {
+  const std::uint32_t i = IDX;
+  if (i < size) py[i] = (pm[i >> 5] >> (i & 31)) & 1 ? px[i] * scale : 0;
+}
+
+__global__ void dropout_bw_dev(
+    const float *pgy, const std::uint32_t *pm, float scale, std::uint32_t size,
+    float *pgx) {
+  const std::uint32_t i = IDX;
+  if (i < size && (pm[i >> 5] >> (i & 31)) & 1) pgx[i] += pgy[i] * scale;
+}
+
 __global__ void rand_affine_dev(
     float shift, float scale, std::uint32_t size, float *py) {
   const std::uint32_t i = IDX;
@@ -364,6 +392,116 @@ __global__ void logsumexp_fw_dev(
   if (tid == 0) py[bid] = temp[0];
 }
 
+template<std::uint32_t BLOCK_SIZE>
+__global__ void max_fw_dev(
+    const float *px, std::uint32_t skip, std::uint32_t n, float *py) {
+  __shared__ float temp[BLOCK_SIZE];
+  const std::uint32_t bid = blockIdx.x;
+  const std::uint32_t tid = threadIdx.x;
+  px += bid % skip + (bid / skip) * skip * n;
+  temp[tid] = -INFINITY;
+  for (std::uint32_t i = tid; i < n; i += BLOCK_SIZE) {
+    temp[tid] = ::fmaxf(temp[tid], px[i * skip]);
+  }
+  __syncthreads();
+#define REDUCE(k) \
+  if (BLOCK_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] = ::fmaxf(temp[tid], temp[tid + k]); \
+    __syncthreads(); \
+  }
+  REDUCE(512)
+  REDUCE(256)
+  REDUCE(128)
+  REDUCE(64)
+  REDUCE(32)
+  REDUCE(16)
+  REDUCE(8)
+  REDUCE(4)
+  REDUCE(2)
+  REDUCE(1)
+#undef REDUCE
+  if (tid == 0) py[bid] = temp[0];
+}
+
+template<std::uint32_t BLOCK_SIZE>
+__global__ void min_fw_dev(
+    const float *px, std::uint32_t skip, std::uint32_t n, float *py) {
+  __shared__ float temp[BLOCK_SIZE];
+  const std::uint32_t bid = blockIdx.x;
+  const std::uint32_t tid = threadIdx.x;
+  px += bid % skip + (bid / skip) * skip * n;
+  temp[tid] = INFINITY;
+  for (std::uint32_t i = tid; i < n; i += BLOCK_SIZE) {
+    temp[tid] = ::fminf(temp[tid], px[i * skip]);
+  }
+  __syncthreads();
+#define REDUCE(k) \
+  if (BLOCK_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] = ::fminf(temp[tid], temp[tid + k]); \
+    __syncthreads(); \
+  }
+  REDUCE(512)
+  REDUCE(256)
+  REDUCE(128)
+  REDUCE(64)
+  REDUCE(32)
+  REDUCE(16)
+  REDUCE(8)
+  REDUCE(4)
+  REDUCE(2)
+  REDUCE(1)
+#undef REDUCE
+  if (tid == 0) py[bid] = temp[0];
+}
+
+template<std::uint32_t BLOCK_SIZE>
+__global__ void squared_norm_fw_dev(
+    const float *px, std::uint32_t skip, std::uint32_t n, float *py) {
+  __shared__ float temp[BLOCK_SIZE];
+  const std::uint32_t bid = blockIdx.x;
+  const std::uint32_t tid = threadIdx.x;
+  px += bid % skip + (bid / skip) * skip * n;
+  temp[tid] = 0;
+  for (std::uint32_t i = tid; i < n; i += BLOCK_SIZE) {
+    const float val = px[i * skip];
+    temp[tid] += val * val;
+  }
+  __syncthreads();
+#define REDUCE(k) \
+  if (BLOCK_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] += temp[tid + k]; \
+    __syncthreads(); \
+  }
+  REDUCE(512)
+  REDUCE(256)
+  REDUCE(128)
+  REDUCE(64)
+  REDUCE(32)
+  REDUCE(16)
+  REDUCE(8)
+  REDUCE(4)
+  REDUCE(2)
+  REDUCE(1)
+#undef REDUCE
+  if (tid == 0) py[bid] = temp[0];
+}
+
+__global__ void max_bw_dev(
+    const float *px, const float *py, const float *pgy,
+    std::uint32_t skip, std::uint32_t n, std::uint32_t size, float *pgx) {
+  const std::uint32_t i = IDX;
+  if (i < size) {
+    const float y = py[i];
+    std::uint32_t offset = i % skip + (i / skip) * skip * n;
+    for (std::uint32_t j = 0; j < n; ++j, offset += skip) {
+      if (px[offset] == y) {
+        pgx[offset] += pgy[i];
+        break;
+      }
+    }
+  }
+}
+
 template<std::uint32_t BLOCK_SIZE>
 __global__ void argmax_dev(
     const float *px, std::uint32_t skip, std::uint32_t n, std::uint32_t *py) {
@@ -446,6 +584,67 @@ __global__ void argmin_dev(
   if (tid == 0) py[bid] = argmin_val[0];
 }
 
+template<std::uint32_t BLOCK_SIZE>
+__global__ void topk_dev(
+    const float *px, std::uint32_t skip, std::uint32_t n, std::uint32_t k,
+    float *py, std::uint32_t *pi) {
+  __shared__ float max_val[BLOCK_SIZE];
+  __shared__ std::uint32_t argmax_val[BLOCK_SIZE];
+  __shared__ float prev_val;
+  __shared__ std::uint32_t prev_arg;
+  const std::uint32_t bid = blockIdx.x;
+  const std::uint32_t tid = threadIdx.x;
+  px += bid % skip + (bid / skip) * skip * n;
+  py += bid * k;
+  pi += bid * k;
+  // NOTE:
+  // Each iteration selects the largest element that is strictly smaller than
+  // the previously selected one in the order of (value desc, index asc).
+  // This requires no temporary memory and O(k * n) operations.
+  for (std::uint32_t r = 0; r < k; ++r) {
+    max_val[tid] = -INFINITY;
+    argmax_val[tid] = n;
+    for (std::uint32_t i = tid; i < n; i += BLOCK_SIZE) {
+      const float val = px[i * skip];
+      if ((r == 0 || val < prev_val || (val == prev_val && i > prev_arg)) &&
+          (val > max_val[tid] ||
+           (val == max_val[tid] && i < argmax_val[tid]))) {
+        max_val[tid] = val;
+        argmax_val[tid] = i;
+      }
+    }
+    __syncthreads();
+#define REDUCE(k) \
+    if (BLOCK_SIZE >= k << 1) { \
+      if (tid < k) { \
+        if (max_val[tid + k] > max_val[tid] || \
+            (max_val[tid + k] == max_val[tid] && \
+             argmax_val[tid + k] < argmax_val[tid])) { \
+          max_val[tid] = max_val[tid + k]; \
+          argmax_val[tid] = argmax_val[tid + k]; \
+        } \
+      } \
+      __syncthreads(); \
+    }
+    REDUCE(512)
+    REDUCE(256)
+    REDUCE(128)
+    REDUCE(64)
+    REDUCE(32)
+    REDUCE(16)
+    REDUCE(8)
+    REDUCE(4)
+    REDUCE(2)
+    REDUCE(1)
+#undef REDUCE
+    if (tid == 0) {
+      py[r] = prev_val = max_val[0];
+      pi[r] = prev_arg = argmax_val[0];
+    }
+    __syncthreads();
+  }
+}
+
 __global__ void broadcast_fw_dev(
     const float *px, std::uint32_t skip1, std::uint32_t skip2, std::uint32_t size, float *py) {
   const std::uint32_t i = IDX;
@@ -675,7 +874,8 @@ CUDA::CUDA(std::uint32_t device_id, std::uint32_t rng_seed)
 CUDA::CUDA(std::uint32_t device_id) : CUDA(device_id, std::random_device()()) {}
 
 CUDA::~CUDA() {
-  // Nothing to do for now.
+  // Deferred operations hold memories allocated by the memory pool.
+  discard_deferred_operations();
 }
 
 void CUDA::dump_description() const {
@@ -786,6 +986,46 @@ std::vector<std::uint32_t> CUDA::argmin_impl(const Tensor &x, std::uint32_t dim)
   return ret;
 }
 
+void CUDA::topk_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    std::vector<float> &values, std::vector<std::uint32_t> &ids) {
+  const Shape &shape = x.shape();
+  const std::uint32_t n = shape[dim];
+  const std::uint32_t r = shape.size() / n;
+  const std::uint32_t s = shape.lower_volume(dim);
+  std::uint32_t block_size = dim1_x_;
+  while (block_size >> 1 >= n) block_size >>= 1;
+  std::shared_ptr<void> py = state_->pool.allocate(sizeof(float) * r * k);
+  std::shared_ptr<void> pi = state_->pool.allocate(
+      sizeof(std::uint32_t) * r * k);
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  switch (block_size) {
+#define CASE(bs) \
+    case bs: ::topk_dev<bs><<<r, bs>>>( \
+        CDATA(x), s, n, k, static_cast<float *>(py.get()), \
+        static_cast<std::uint32_t *>(pi.get())); break
+    CASE(1024);
+    CASE(512);
+    CASE(256);
+    CASE(128);
+    CASE(64);
+    CASE(32);
+    CASE(16);
+    CASE(8);
+    CASE(4);
+    CASE(2);
+    CASE(1);
+#undef CASE
+  }
+  values.resize(r * k);
+  ids.resize(r * k);
+  CUDA_CALL(::cudaMemcpy(
+        &values[0], py.get(), sizeof(float) * r * k, cudaMemcpyDeviceToHost));
+  CUDA_CALL(::cudaMemcpy(
+        &ids[0], pi.get(), sizeof(std::uint32_t) * r * k,
+        cudaMemcpyDeviceToHost));
+}
+
 void CUDA::reset_tensor_impl(float k, Tensor &x) {
   const std::uint32_t size = x.shape().size();
   const std::uint32_t num_blocks = GRID_SIZE(size, dim1_x_);
@@ -907,6 +1147,24 @@ void CUDA::concat_fw_impl(
   }
 }
 
+void CUDA::batch_pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) {
+  // NOTE:
+  // Selecting minibatches is equivalent to pick() over the flattened tensor
+  // with shape ([volume, batch]) along the last dimension.
+  const std::uint32_t size = y.shape().volume();
+  const std::uint32_t g1 = GRID_SIZE(size, dim1_x_);
+  const std::uint32_t bs = y.shape().batch();
+
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  CUDA_CALL(::cudaMemcpy(
+        ids_ptr_.get(), ids.data(), sizeof(std::uint32_t) * ids.size(),
+        cudaMemcpyHostToDevice));
+  ::pick_fw_dev<<<dim3(g1, bs), dim1_x_>>>(
+      CDATA(x), static_cast<const std::uint32_t *>(ids_ptr_.get()),
+      size, size, 0, 1, size, MDATA(y));
+}
+
 void CUDA::pick_bw_impl(
     const Tensor &gy, const std::vector<std::uint32_t>& ids, std::uint32_t dim,
     Tensor &gx) {
@@ -942,6 +1200,46 @@ void CUDA::slice_bw_impl(
   ::slice_bw_dev<<<g1, dim1_x_>>>(CDATA(gy), wx, wy, nx, ny, MDATA(gx) + ox);
 }
 
+void CUDA::batch_pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) {
+  const std::uint32_t size = gy.shape().volume();
+  const std::uint32_t g1 = GRID_SIZE(size, dim1_x_);
+  const std::uint32_t bs = gy.shape().batch();
+
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  CUDA_CALL(::cudaMemcpy(
+        ids_ptr_.get(), ids.data(), sizeof(std::uint32_t) * ids.size(),
+        cudaMemcpyHostToDevice));
+  ::pick_bw_dev<<<dim3(g1, bs), dim1_x_>>>(
+      CDATA(gy), static_cast<const std::uint32_t *>(ids_ptr_.get()),
+      size, size, 0, 1, size, MDATA(gx));
+}
+
+void CUDA::dropout_fw_impl(
+    const Tensor &x, float p, Tensor &mask, Tensor &y) {
+  const std::uint32_t size = x.shape().size();
+  const std::uint32_t num_words = mask.shape().size();
+  const std::uint32_t g1 = GRID_SIZE(num_words, dim1_x_);
+  const std::uint32_t g2 = GRID_SIZE(size, dim1_x_);
+  std::uint32_t *pm = static_cast<std::uint32_t *>(get_mutable_handle(mask));
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  // Uniform values are generated into y and immediately packed into bits, so
+  // no temporary buffer is required.
+  CURAND_CALL(::curandGenerateUniform(state_->curand.get(), MDATA(y), size));
+  ::dropout_mask_dev<<<g1, dim1_x_>>>(CDATA(y), p, size, pm);
+  ::dropout_fw_dev<<<g2, dim1_x_>>>(CDATA(x), pm, 1. / p, size, MDATA(y));
+}
+
+void CUDA::dropout_bw_impl(
+    const Tensor &gy, const Tensor &mask, float p, Tensor &gx) {
+  const std::uint32_t size = gy.shape().size();
+  const std::uint32_t g1 = GRID_SIZE(size, dim1_x_);
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  ::dropout_bw_dev<<<g1, dim1_x_>>>(
+      CDATA(gy), static_cast<const std::uint32_t *>(get_handle(mask)),
+      1. / p, size, MDATA(gx));
+}
+
 #define CUDADEV_FW_X(name) \
 void CUDA::name##_fw_impl(const Tensor &x, Tensor &y) { \
   const std::uint32_t size = x.shape().size(); \
@@ -1232,6 +1530,82 @@ void CUDA::logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
   }
 }
 
+void CUDA::max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t block_size = dim1_x_;
+  while (block_size >> 1 >= n) block_size >>= 1;
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  switch (block_size) {
+#define CASE(k) \
+    case k: ::max_fw_dev<k><<<r, k>>>(CDATA(x), s, n, MDATA(y)); break
+    CASE(1024);
+    CASE(512);
+    CASE(256);
+    CASE(128);
+    CASE(64);
+    CASE(32);
+    CASE(16);
+    CASE(8);
+    CASE(4);
+    CASE(2);
+    CASE(1);
+#undef CASE
+  }
+}
+
+void CUDA::min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t block_size = dim1_x_;
+  while (block_size >> 1 >= n) block_size >>= 1;
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  switch (block_size) {
+#define CASE(k) \
+    case k: ::min_fw_dev<k><<<r, k>>>(CDATA(x), s, n, MDATA(y)); break
+    CASE(1024);
+    CASE(512);
+    CASE(256);
+    CASE(128);
+    CASE(64);
+    CASE(32);
+    CASE(16);
+    CASE(8);
+    CASE(4);
+    CASE(2);
+    CASE(1);
+#undef CASE
+  }
+}
+
+void CUDA::squared_norm_fw_impl(
+    const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t block_size = dim1_x_;
+  while (block_size >> 1 >= n) block_size >>= 1;
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  switch (block_size) {
+#define CASE(k) \
+    case k: ::squared_norm_fw_dev<k><<<r, k>>>(CDATA(x), s, n, MDATA(y)); break
+    CASE(1024);
+    CASE(512);
+    CASE(256);
+    CASE(128);
+    CASE(64);
+    CASE(32);
+    CASE(16);
+    CASE(8);
+    CASE(4);
+    CASE(2);
+    CASE(1);
+#undef CASE
+  }
+}
+
 void CUDA::broadcast_fw_impl(
     const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) {
   const std::uint32_t skip1 = y.shape().lower_volume(dim);
@@ -1250,6 +1624,25 @@ void CUDA::batch_sum_fw_impl(const Tensor &x, Tensor &y) {
       CDATA(x), size, x.shape().batch(), MDATA(y));
 }
 
+void CUDA::max_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  const std::uint32_t g1 = GRID_SIZE(r, dim1_x_);
+  CUDA_CALL(::cudaSetDevice(dev_id_));
+  ::max_bw_dev<<<g1, dim1_x_>>>(
+      CDATA(x), CDATA(y), CDATA(gy), s, n, r, MDATA(gx));
+}
+
+void CUDA::min_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The backward operation of min() is same as that of max().
+  max_bw_impl(x, y, gy, dim, gx);
+}
+
 void CUDA::inplace_multiply_const_impl(float k, Tensor &x) {
   const std::uint32_t size = x.shape().size();
   const std::uint32_t g1 = GRID_SIZE(size, dim1_x_);
@@ -0,0 +1,148 @@
+#include <primitiv/config.h>
+
+#include <primitiv/data_loader.h>
+#include <primitiv/device.h>
+#include <primitiv/error.h>
+
+using std::vector;
+
+namespace primitiv {
+
+DataLoader::DataLoader(
+    const Builder &builder,
+    std::uint32_t num_workers,
+    std::uint32_t capacity,
+    Device *device)
+: builder_(builder)
+, capacity_(capacity)
+, device_(device)
+, next_build_(0)
+, cursor_(0)
+, num_building_(0)
+, stop_(false) {
+  if (!builder_) THROW_ERROR("Builder is empty.");
+  if (num_workers == 0) THROW_ERROR("Number of workers should be positive.");
+  if (capacity_ == 0) THROW_ERROR("Capacity should be positive.");
+
+  // NOTE: One more slot holds the batch being used by the training loop.
+  for (std::uint32_t i = 0; i <= capacity_; ++i) {
+    slots_.emplace_back(new Batch());
+  }
+  ready_.assign(slots_.size(), false);
+  uploaded_.assign(slots_.size(), false);
+  for (std::uint32_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this] { work(); });
+  }
+}
+
+DataLoader::~DataLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread &t : workers_) t.join();
+}
+
+void DataLoader::start(const vector<vector<std::uint32_t>> &plan) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Batches of the previous epoch may still be filled by workers.
+    next_build_ = plan_.size();
+    cv_.wait(lock, [this] { return num_building_ == 0; });
+    // NOTE: Tensors should be released before workers can refill the slots.
+    for (auto &slot : slots_) slot->tensors.clear();
+    plan_ = plan;
+    next_build_ = 0;
+    cursor_ = 0;
+    error_ = nullptr;
+    ready_.assign(slots_.size(), false);
+    uploaded_.assign(slots_.size(), false);
+  }
+  cv_.notify_all();
+}
+
+const DataLoader::Batch *DataLoader::next() {
+  Batch *cur;
+  Batch *ahead = nullptr;
+  bool uploaded;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Tensors are released on this thread because devices are not thread-safe.
+    if (cursor_ > 0) slot(cursor_ - 1).tensors.clear();
+    if (cursor_ >= plan_.size()) return nullptr;
+    const std::uint32_t s = cursor_ % slots_.size();
+    cv_.wait(lock, [this, s] { return ready_[s] || error_; });
+    if (error_) {
+      // Stops the epoch.
+      cursor_ = next_build_ = plan_.size();
+      std::rethrow_exception(error_);
+    }
+    cur = &slot(cursor_);
+    uploaded = uploaded_[s];
+    ready_[s] = false;
+    uploaded_[s] = false;
+    ++cursor_;
+
+    // Stages the upload of the next batch if it is already built.
+    if (device_ && cursor_ < plan_.size()) {
+      const std::uint32_t t = cursor_ % slots_.size();
+      if (ready_[t]) {
+        ahead = &slot(cursor_);
+        uploaded_[t] = true;
+      }
+    }
+  }
+  cv_.notify_all();
+  // NOTE: Workers never touch built batches until they are returned and
+  // released by the next call of this function.
+  if (!uploaded) upload(*cur);
+  if (ahead) upload(*ahead);
+  return cur;
+}
+
+void DataLoader::upload(Batch &batch) {
+  if (!device_) return;
+  if (batch.shapes.size() != batch.values.size()) {
+    THROW_ERROR(
+        "Numbers of shapes and values mismatched. shapes: "
+        << batch.shapes.size() << ", values: " << batch.values.size());
+  }
+  batch.tensors.clear();
+  for (std::uint32_t i = 0; i < batch.values.size(); ++i) {
+    batch.tensors.emplace_back(
+        device_->new_tensor_by_vector(batch.shapes[i], batch.values[i]));
+  }
+}
+
+void DataLoader::work() {
+  while (true) {
+    std::uint32_t i;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] {
+          return stop_ || (
+            next_build_ < plan_.size() && next_build_ < cursor_ + capacity_);
+      });
+      if (stop_) return;
+      i = next_build_++;
+      slot(i).index = i;
+      slot(i).samples = plan_[i];
+      ++num_building_;
+    }
+    try {
+      builder_(slot(i));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_[i % slots_.size()] = true;
+      --num_building_;
+    }
+    cv_.notify_all();
+  }
+}
+
+}  // namespace primitiv
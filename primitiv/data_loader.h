@@ -0,0 +1,152 @@
+#ifndef PRIMITIV_DATA_LOADER_H_
+#define PRIMITIV_DATA_LOADER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <primitiv/mixins.h>
+#include <primitiv/shape.h>
+#include <primitiv/tensor.h>
+
+namespace primitiv {
+
+class Device;
+
+/**
+ * Minibatch pipeline which prepares batches on background threads.
+ *
+ * Each epoch is described by a plan, a list of batches each of which is a
+ * list of sample IDs. Worker threads fill preallocated host buffers of
+ * upcoming batches by calling the builder function, and the training loop
+ * receives ready batches in the order of the plan through `next()`. At most
+ * `capacity` batches are prepared ahead of the training loop.
+ *
+ * If a device is given, `values` of each batch are also uploaded to the
+ * device as `tensors`. Uploads are issued on the caller thread of `next()`,
+ * one batch ahead, so that devices with asynchronous transfers (e.g. OpenCL)
+ * overlap them with the calculation of the current batch.
+ *
+ * Typical usage:
+ *
+ *     DataLoader loader([&](DataLoader::Batch &b) {
+ *       b.shapes.assign({Shape({784}, b.samples.size())});
+ *       b.values.resize(1);
+ *       b.values[0].clear();
+ *       for (std::uint32_t id : b.samples) { ... append values ... }
+ *     }, 2, 4, &dev);
+ *     loader.start(plan);
+ *     while (const DataLoader::Batch *b = loader.next()) {
+ *       Node x = F::input<Node>(b->tensors[0]);
+ *       ...
+ *     }
+ */
+class DataLoader : mixins::Nonmovable<DataLoader> {
+public:
+  /**
+   * Buffers of one minibatch, which are reused by later batches.
+   */
+  struct Batch {
+    /** Position of the batch in the plan. */
+    std::uint32_t index;
+
+    /** Sample IDs given by the plan. */
+    std::vector<std::uint32_t> samples;
+
+    /** Shapes of `values`. */
+    std::vector<Shape> shapes;
+
+    /** Arrays of input values packed by the builder. */
+    std::vector<std::vector<float>> values;
+
+    /** Arrays of labels or token IDs packed by the builder. */
+    std::vector<std::vector<std::uint32_t>> ids;
+
+    /** `values` on the device. This is empty if no device is given. */
+    std::vector<Tensor> tensors;
+  };
+
+  /**
+   * Function to fill buffers of a batch from `Batch::samples`.
+   * @remarks This function is called on worker threads concurrently, and
+   *          should not use any Device, Tensor or Node objects.
+   */
+  using Builder = std::function<void(Batch &batch)>;
+
+  /**
+   * Creates a new DataLoader object and starts worker threads.
+   * @param builder Function to fill buffers of each batch.
+   * @param num_workers Number of worker threads.
+   * @param capacity Maximum number of batches prepared ahead.
+   * @param device Device to upload `Batch::values`, or nullptr to keep them
+   *               only on the host memory.
+   */
+  DataLoader(
+      const Builder &builder,
+      std::uint32_t num_workers = 1,
+      std::uint32_t capacity = 2,
+      Device *device = nullptr);
+
+  ~DataLoader();
+
+  /**
+   * Starts a new epoch.
+   * @param plan List of batches, each of which is a list of sample IDs.
+   * @remarks Batches of the previous epoch which are not retrieved yet are
+   *          discarded.
+   */
+  void start(const std::vector<std::vector<std::uint32_t>> &plan);
+
+  /**
+   * Retrieves the next batch of the current epoch.
+   * @return Pointer to the next batch, or nullptr if all batches of the epoch
+   *         were retrieved. The batch is valid until the next call of
+   *         `next()` or `start()`.
+   * @throw primitiv::Error The builder failed on a worker thread. The epoch
+   *                        can not be continued after this error.
+   */
+  const Batch *next();
+
+  /**
+   * Retrieves the number of batches in the current epoch.
+   * @return Number of batches.
+   */
+  std::uint32_t num_batches() const { return plan_.size(); }
+
+private:
+  void work();
+  void upload(Batch &batch);
+
+  // Slot which holds the `i`-th batch.
+  Batch &slot(std::uint32_t i) { return *slots_[i % slots_.size()]; }
+
+  Builder builder_;
+  std::uint32_t capacity_;
+  Device *device_;
+  std::vector<std::vector<std::uint32_t>> plan_;
+  std::vector<std::unique_ptr<Batch>> slots_;
+
+  // Whether each slot holds a built batch of the current epoch or not.
+  std::vector<bool> ready_;
+
+  // Whether each slot was already uploaded to the device or not.
+  std::vector<bool> uploaded_;
+
+  std::uint32_t next_build_;
+  std::uint32_t cursor_;
+  std::uint32_t num_building_;
+  std::exception_ptr error_;
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_DATA_LOADER_H_
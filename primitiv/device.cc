@@ -1,5 +1,7 @@
 #include <primitiv/config.h>
 
+#include <algorithm>
+#include <unordered_map>
 #include <primitiv/device.h>
 #include <primitiv/error.h>
 #include <primitiv/shape_ops.h>
@@ -17,6 +19,190 @@ using std::vector;
 
 namespace primitiv {
 
+bool Device::supports_host_kernels() const {
+  const auto group = static_cast<std::uint32_t>(type())
+    & static_cast<std::uint32_t>(DeviceType::GROUP_FILTER);
+  return group == static_cast<std::uint32_t>(DeviceType::GROUP_CPU);
+}
+
+bool Device::supports_source_kernels() const {
+  const auto group = static_cast<std::uint32_t>(type())
+    & static_cast<std::uint32_t>(DeviceType::GROUP_FILTER);
+  return group == static_cast<std::uint32_t>(DeviceType::GROUP_OPENCL);
+}
+
+void Device::set_stream(
+    std::uint32_t stream, const vector<std::uint32_t> &waits) {
+  const std::uint32_t n = num_streams();
+  if (stream >= n) {
+    THROW_ERROR("Invalid stream ID: " << stream << " >= " << n);
+  }
+  for (const std::uint32_t w : waits) {
+    if (w >= n) THROW_ERROR("Invalid stream ID: " << w << " >= " << n);
+  }
+  set_stream_impl(stream, waits);
+  stream_ = stream;
+}
+
+void Device::join_streams() {
+  vector<std::uint32_t> all(num_streams());
+  for (std::uint32_t i = 0; i < all.size(); ++i) all[i] = i;
+  set_stream(0, all);
+}
+
+void Device::set_lazy(bool enabled) {
+  if (!enabled) flush();
+  lazy_ = enabled;
+}
+
+std::uint32_t Device::flush() {
+  if (flushing_ || trace_.empty()) return 0;
+  vector<DeferredOperation> ops;
+  ops.swap(trace_);
+
+  // Removes operations whose results are never used. Releasing arguments of
+  // an unused operation may also make preceding operations unused.
+  for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+    if (it->slot.expired()) {
+      it->args.clear();
+      it->func = nullptr;
+    }
+  }
+
+  const bool fusible = supports_host_kernels() && has_linear_memory();
+  std::uint32_t num_executed = 0;
+  flushing_ = true;
+  try {
+    std::size_t i = 0;
+    while (i < ops.size()) {
+      if (!ops[i].func) {
+        ++i;
+        continue;
+      }
+
+      // Collects consecutive elementwise operations with the same shape.
+      std::size_t end = i + 1;
+      std::uint32_t num_fused = 1;
+      if (fusible && ops[i].elementwise) {
+        for (std::size_t j = i + 1; j < ops.size(); ++j) {
+          if (!ops[j].func) continue;
+          if (!ops[j].elementwise || ops[j].shape != ops[i].shape) break;
+          end = j + 1;
+          ++num_fused;
+        }
+      }
+
+      if (num_fused > 1) {
+        execute_fused(ops, i, end);
+      } else {
+        DeferredOperation &op = ops[i];
+        vector<const Tensor *> xs;
+        xs.reserve(op.args.size());
+        for (const Tensor &x : op.args) xs.emplace_back(&x);
+        Tensor y = new_raw_tensor(op.shape);
+        op.func(xs, y);
+        if (auto slot = op.slot.lock()) *slot = std::move(y.handle_);
+        // Arguments are released as soon as possible to reuse the memory.
+        op.args.clear();
+        op.func = nullptr;
+      }
+      num_executed += num_fused;
+      i = end;
+    }
+  } catch (...) {
+    flushing_ = false;
+    throw;
+  }
+  flushing_ = false;
+  return num_executed;
+}
+
+Tensor Device::defer(
+    const Shape &shape, vector<Tensor> &&args,
+    DeferredOperation::Function &&func, bool elementwise) {
+  Tensor y(shape, *this, std::shared_ptr<void>());
+  y.deferred_ = std::make_shared<std::shared_ptr<void>>();
+  trace_.emplace_back(DeferredOperation {
+      y.deferred_, shape, std::move(args), std::move(func), elementwise });
+  return y;
+}
+
+void Device::execute_fused(
+    vector<DeferredOperation> &ops, std::size_t begin, std::size_t end) {
+  // Number of elements calculated at once. Intermediate results of each block
+  // are expected to stay in the cache.
+  const std::uint32_t BLOCK_SIZE = 4096;
+  const std::uint32_t size = ops[begin].shape.size();
+
+  // Finds arguments produced in the group, and decides which results should
+  // be stored into the whole memory.
+  std::unordered_map<const std::shared_ptr<void> *, std::size_t> producers;
+  std::unordered_map<const std::shared_ptr<void> *, std::uint32_t> uses;
+  vector<std::size_t> live;
+  for (std::size_t i = begin; i < end; ++i) {
+    if (!ops[i].func) continue;
+    for (const Tensor &x : ops[i].args) {
+      const auto it = producers.find(x.deferred_.get());
+      if (it != producers.end()) ++uses[it->first];
+    }
+    producers.emplace(ops[i].slot.lock().get(), i);
+    live.emplace_back(i);
+  }
+
+  // Results used outside the group are materialized. Others are calculated
+  // only in block buffers.
+  std::unordered_map<std::size_t, Tensor> outputs;
+  std::unordered_map<std::size_t, bool> materialized;
+  for (const std::size_t i : live) {
+    const auto slot = ops[i].slot.lock();
+    // `slot` itself holds one more reference.
+    const bool used_outside = slot.use_count() - 1 > uses[slot.get()];
+    Tensor y = new_raw_tensor(
+        used_outside ? ops[i].shape : Shape({BLOCK_SIZE}));
+    if (used_outside) *slot = y.handle_;
+    outputs.emplace(i, std::move(y));
+    materialized.emplace(i, used_outside);
+  }
+
+  // Non-owning views of blocks. Owners are kept by `args` and `outputs`.
+  const auto view = [this](float *data, std::uint32_t n) {
+    return make_view(Shape({n}), data);
+  };
+
+  for (std::uint32_t offset = 0; offset < size; offset += BLOCK_SIZE) {
+    const std::uint32_t n = std::min(BLOCK_SIZE, size - offset);
+    std::unordered_map<std::size_t, Tensor> blocks;
+    for (const std::size_t i : live) {
+      DeferredOperation &op = ops[i];
+      vector<Tensor> args;
+      vector<const Tensor *> xs;
+      args.reserve(op.args.size());
+      xs.reserve(op.args.size());
+      for (const Tensor &x : op.args) {
+        const auto it = producers.find(x.deferred_.get());
+        if (it != producers.end() && it->second < i) {
+          args.emplace_back(blocks.at(it->second));
+        } else {
+          float *data = const_cast<float *>(
+              static_cast<const float *>(get_handle(x)));
+          args.emplace_back(view(data + offset, n));
+        }
+      }
+      for (const Tensor &x : args) xs.emplace_back(&x);
+      float *data = static_cast<float *>(outputs.at(i).handle_.get());
+      if (materialized.at(i)) data += offset;
+      Tensor y = view(data, n);
+      op.func(xs, y);
+      blocks.emplace(i, std::move(y));
+    }
+  }
+
+  for (const std::size_t i : live) {
+    ops[i].args.clear();
+    ops[i].func = nullptr;
+  }
+}
+
 Tensor Device::new_raw_tensor(const Shape &shape) {
   return Tensor(shape, *this, new_handle(shape));
 }
@@ -40,6 +226,28 @@ Tensor Device::new_tensor_by_vector(
   return ret;
 }
 
+Tensor Device::new_tensor_by_external_array(
+    const Shape &shape, float *data, std::function<void(float *)> release) {
+  if (!supports_host_kernels() || !has_linear_memory()) {
+    THROW_ERROR("External arrays are not supported by the device: " << this);
+  }
+  if (!data) THROW_ERROR("External array is null.");
+  // NOTE: Unlike make_view(), the handle owns a reference count so that
+  // copies of the tensor are duplicated before modified.
+  return Tensor(shape, *this, std::shared_ptr<void>(
+        data, [release](void *p) {
+          if (release) release(static_cast<float *>(p));
+        }));
+}
+
+const float *Device::host_array(const Tensor &x) {
+  CHECK_DEVICE(x);
+  if (!supports_host_kernels() || !has_linear_memory()) {
+    THROW_ERROR("Host arrays are not supported by the device: " << this);
+  }
+  return static_cast<const float *>(get_handle(x));
+}
+
 vector<float> Device::tensor_to_vector(const Tensor &x) {
   CHECK_DEVICE(x);
   return tensor_to_vector_impl(x);
@@ -55,6 +263,41 @@ vector<std::uint32_t> Device::argmin(const Tensor &x, std::uint32_t dim) {
   return argmin_impl(x, dim);
 }
 
+vector<std::uint32_t> Device::topk(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    vector<float> &values) {
+  CHECK_DEVICE(x);
+  if (k == 0 || k > x.shape()[dim]) {
+    THROW_ERROR(
+        "Invalid number of elements to retrieve. x.shape: "
+        << x.shape().to_string() << ", dim: " << dim << ", k: " << k);
+  }
+  vector<std::uint32_t> ids;
+  topk_impl(x, dim, k, values, ids);
+  return ids;
+}
+
+vector<std::uint32_t> Device::sample(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k) {
+  CHECK_DEVICE(x);
+  if (k == 0 || k > x.shape()[dim]) {
+    THROW_ERROR(
+        "Invalid number of samples. x.shape: "
+        << x.shape().to_string() << ", dim: " << dim << ", k: " << k);
+  }
+  // NOTE:
+  // Top-k indices of x + g, where g ~ Gumbel(0, 1), are a sample without
+  // replacement from softmax(x). g is calculated by -log(-log(u)) with
+  // u ~ Uniform(0, 1], and the small constant prevents log(0) when u == 1.
+  const Tensor u = random_uniform(x.shape(), 0, 1);
+  const Tensor e = subtract_const_l_fw(log_fw(u), 1e-20);
+  const Tensor y = subtract_fw(x, log_fw(e));
+  vector<float> values;
+  vector<std::uint32_t> ids;
+  topk_impl(y, dim, k, values, ids);
+  return ids;
+}
+
 void Device::reset_tensor(float k, Tensor &x) {
   CHECK_DEVICE(x);
   reset_tensor_impl(k, x);
@@ -142,6 +385,13 @@ Tensor Device::random_log_normal(const Shape &shape, float mean, float sd) {
 Tensor Device::pick_fw(
     const Tensor &x, const vector<std::uint32_t> &ids, std::uint32_t dim) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        shape_ops::pick(x.shape(), ids, dim), {x},
+        [this, ids, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          pick_fw_impl(*xs[0], ids, dim, y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(shape_ops::pick(x.shape(), ids, dim));
   pick_fw_impl(x, ids, dim, y);
   return y;
@@ -150,6 +400,13 @@ Tensor Device::pick_fw(
 Tensor Device::slice_fw(
     const Tensor &x, std::uint32_t dim, std::uint32_t lower, std::uint32_t upper) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        shape_ops::slice(x.shape(), dim, lower, upper), {x},
+        [this, dim, lower](const vector<const Tensor *> &xs, Tensor &y) {
+          slice_fw_impl(*xs[0], dim, lower, y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(shape_ops::slice(x.shape(), dim, lower, upper));
   slice_fw_impl(x, dim, lower, y);
   return y;
@@ -165,11 +422,80 @@ Tensor Device::concat_fw(const vector<const Tensor *> &xs, std::uint32_t dim) {
     shapes.emplace_back(xs[i]->shape());
   }
 
+  if (lazy_ && !flushing_) {
+    vector<Tensor> args;
+    args.reserve(xs.size());
+    for (const Tensor *x : xs) args.emplace_back(*x);
+    return defer(
+        shape_ops::concat(shapes, dim), std::move(args),
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          concat_fw_impl(xs, dim, y);
+        }, false);
+  }
+
   Tensor y = new_raw_tensor(shape_ops::concat(shapes, dim));
   concat_fw_impl(xs, dim, y);
   return y;
 }
 
+Tensor Device::batch_pick_fw(
+    const Tensor &x, const vector<std::uint32_t> &ids) {
+  CHECK_DEVICE(x);
+  Tensor y = new_raw_tensor(shape_ops::batch_pick(x.shape(), ids));
+  batch_pick_fw_impl(x, ids, y);
+  return y;
+}
+
+Tensor Device::batch_slice_fw(
+    const Tensor &x, std::uint32_t lower, std::uint32_t upper) {
+  CHECK_DEVICE(x);
+  const Shape sy = shape_ops::batch_slice(x.shape(), lower, upper);
+  if (sy == x.shape()) return x;
+  if (has_linear_memory()) {
+    // Minibatch is the outermost dimension, and the slice is a contiguous
+    // memory region of `x`.
+    x.resolve();
+    return Tensor(
+        sy, *this,
+        std::shared_ptr<void>(
+          x.handle_,
+          static_cast<float *>(x.handle_.get()) + lower * sy.volume()));
+  }
+  vector<std::uint32_t> ids(upper - lower);
+  for (std::uint32_t i = 0; i < ids.size(); ++i) ids[i] = lower + i;
+  Tensor y = new_raw_tensor(sy);
+  batch_pick_fw_impl(x, ids, y);
+  return y;
+}
+
+Tensor Device::batch_concat_fw(const vector<const Tensor *> &xs) {
+  if (xs.empty()) THROW_ERROR("No tensors to concat.");
+  vector<const Shape *> shapes;
+  shapes.reserve(xs.size());
+  for (const Tensor *x : xs) {
+    CHECK_DEVICE(*x);
+    shapes.emplace_back(&x->shape_);
+  }
+  const Shape sy = shape_ops::batch_concat(shapes);
+
+  // Concatenation along the minibatch is same as the concatenation along the
+  // last dimension of the matrix with shape [volume, batch].
+  const std::uint32_t volume = sy.volume();
+  vector<Tensor> mats;
+  vector<const Tensor *> mat_ptrs;
+  mats.reserve(xs.size());
+  for (const Tensor *x : xs) {
+    x->resolve();
+    mats.emplace_back(
+        Tensor(Shape({volume, x->shape_.batch()}), *this, x->handle_));
+    mat_ptrs.emplace_back(&mats.back());
+  }
+  Tensor y = new_raw_tensor(Shape({volume, sy.batch()}));
+  concat_fw_impl(mat_ptrs, 1, y);
+  y.shape_ = sy;
+  return y;
+}
+
 void Device::pick_bw(
     const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim,
     Tensor &gx) {
@@ -201,9 +527,134 @@ void Device::slice_bw(
   else slice_bw_impl(gy, dim, offset, gx);
 }
 
-#define DEV_FW_X(name, sop) \
+void Device::batch_pick_bw(
+    const Tensor &gy, const vector<std::uint32_t> &ids, Tensor &gx) {
+  CHECK_DEVICE(gy);
+  CHECK_DEVICE(gx);
+  const Shape sy = shape_ops::batch_pick(gx.shape(), ids);
+  if (gy.shape() != sy) {
+    THROW_ERROR(
+        "Shape mismatched. gy.shape(): " << gy.shape().to_string()
+        << " != expected shape: " << sy.to_string());
+  }
+  batch_pick_bw_impl(gy, ids, gx);
+}
+
+void Device::batch_slice_bw(
+    const Tensor &gy, std::uint32_t offset, Tensor &gx) {
+  CHECK_DEVICE(gy);
+  CHECK_DEVICE(gx);
+  const Shape &sy = gy.shape();
+  const Shape &sx = gx.shape();
+  if (!sy.has_same_dims(sx) || offset + sy.batch() > sx.batch()) {
+    THROW_ERROR(
+        "Attempted to add gradients with shape "
+        << sy.to_string() << ", offset " << offset
+        << " to shape" << sx.to_string() << '.');
+  }
+  vector<std::uint32_t> ids(sy.batch());
+  for (std::uint32_t i = 0; i < ids.size(); ++i) ids[i] = offset + i;
+  batch_pick_bw_impl(gy, ids, gx);
+}
+
+Tensor Device::dropout_fw(const Tensor &x, float rate, Tensor &mask) {
+  CHECK_DEVICE(x);
+  if (rate < 0 || rate >= 1) {
+    THROW_ERROR("Invalid dropout rate: " << rate);
+  }
+  // Each float element of the mask holds 32 bits.
+  mask = new_raw_tensor({(x.shape().size() + 31) / 32});
+  Tensor y = new_raw_tensor(x.shape());
+  dropout_fw_impl(x, 1 - rate, mask, y);
+  return y;
+}
+
+Tensor Device::elementwise_fw(
+    const vector<const Tensor *> &xs, const Shape &shape,
+    const HostKernel &kernel) {
+  if (!supports_host_kernels()) {
+    THROW_ERROR("Host kernels are not supported by the device: " << this);
+  }
+  check_elementwise_args(xs, shape);
+  const std::uint32_t size = shape.volume();
+  const std::uint32_t bs = shape.batch();
+  vector<const float *> srcs;
+  vector<std::uint32_t> skips;
+  srcs.reserve(xs.size());
+  skips.reserve(xs.size());
+  for (const Tensor *x : xs) {
+    srcs.emplace_back(static_cast<const float *>(get_handle(*x)));
+    skips.emplace_back(x->shape().has_batch() * size);
+  }
+  Tensor y = new_raw_tensor(shape);
+  float *dest = static_cast<float *>(get_mutable_handle(y));
+  for (std::uint32_t batch = 0; batch < bs; ++batch) {
+    kernel(srcs.data(), dest, size);
+    dest += size;
+    for (std::uint32_t j = 0; j < srcs.size(); ++j) srcs[j] += skips[j];
+  }
+  return y;
+}
+
+Tensor Device::elementwise_source_fw(
+    const vector<const Tensor *> &xs, const Shape &shape,
+    const std::string &source) {
+  if (!supports_source_kernels()) {
+    THROW_ERROR("Source kernels are not supported by the device: " << this);
+  }
+  check_elementwise_args(xs, shape);
+  Tensor y = new_raw_tensor(shape);
+  elementwise_source_fw_impl(xs, source, y);
+  return y;
+}
+
+void Device::check_elementwise_args(
+    const vector<const Tensor *> &xs, const Shape &shape) const {
+  for (const Tensor *x : xs) {
+    CHECK_DEVICE(*x);
+    const Shape &sx = x->shape();
+    if (!sx.has_same_dims(shape) ||
+        (sx.has_batch() && sx.batch() != shape.batch())) {
+      THROW_ERROR(
+          "Shape mismatched. x.shape: " << sx.to_string()
+          << " != shape: " << shape.to_string());
+    }
+  }
+}
+
+void Device::elementwise_source_fw_impl(
+    const vector<const Tensor *> &, const std::string &, Tensor &) {
+  THROW_ERROR("Source kernels are not supported by the device: " << this);
+}
+
+void Device::dropout_bw(
+    const Tensor &gy, const Tensor &mask, float rate, Tensor &gx) {
+  CHECK_DEVICE(gy);
+  CHECK_DEVICE(mask);
+  CHECK_DEVICE(gx);
+  if (rate < 0 || rate >= 1) {
+    THROW_ERROR("Invalid dropout rate: " << rate);
+  }
+  const Shape sm({(gx.shape().size() + 31) / 32});
+  if (gy.shape() != gx.shape() || mask.shape() != sm) {
+    THROW_ERROR(
+        "Shape mismatched. gy.shape(): " << gy.shape().to_string()
+        << ", mask.shape(): " << mask.shape().to_string()
+        << ", gx.shape(): " << gx.shape().to_string());
+  }
+  dropout_bw_impl(gy, mask, 1 - rate, gx);
+}
+
+#define DEV_FW_X(name, sop, elementwise) \
 Tensor Device::name##_fw(const Tensor &x) { \
   CHECK_DEVICE(x); \
+  if (lazy_ && !flushing_) { \
+    return defer( \
+        sop(x.shape()), {x}, \
+        [this](const vector<const Tensor *> &xs, Tensor &y) { \
+          name##_fw_impl(*xs[0], y); \
+        }, elementwise); \
+  } \
   Tensor y = new_raw_tensor(sop(x.shape())); \
   name##_fw_impl(x, y); \
   return y; \
@@ -232,6 +683,13 @@ void Device::name##_bw( \
 #define DEV_FW_X_CONST(name) \
 Tensor Device::name##_fw(const Tensor &x, float k) { \
   CHECK_DEVICE(x); \
+  if (lazy_ && !flushing_) { \
+    return defer( \
+        x.shape(), {x}, \
+        [this, k](const vector<const Tensor *> &xs, Tensor &y) { \
+          name##_fw_impl(*xs[0], k, y); \
+        }, true); \
+  } \
   Tensor y = new_raw_tensor(x.shape()); \
   name##_fw_impl(x, k, y); \
   return y; \
@@ -256,10 +714,17 @@ void Device::name##_bw( \
   name##_bw_impl(x, y, gy, k, gx); \
 }
 
-#define DEV_FW_AB(name, sop) \
+#define DEV_FW_AB(name, sop, elementwise) \
 Tensor Device::name##_fw(const Tensor &a, const Tensor &b) { \
   CHECK_DEVICE(a); \
   CHECK_DEVICE(b); \
+  if (lazy_ && !flushing_) { \
+    return defer( \
+        sop(a.shape(), b.shape()), {a, b}, \
+        [this](const vector<const Tensor *> &xs, Tensor &y) { \
+          name##_fw_impl(*xs[0], *xs[1], y); \
+        }, (elementwise) && a.shape() == b.shape()); \
+  } \
   Tensor y = new_raw_tensor(sop(a.shape(), b.shape())); \
   name##_fw_impl(a, b, y); \
   return y; \
@@ -291,17 +756,17 @@ void Device::name##_bw( \
   name##_bw_impl(a, b, y, gy, ga, gb); \
 }
 
-DEV_FW_X(negate, static_cast<const Shape &>);
-DEV_FW_X(sqrt, static_cast<const Shape &>);
-DEV_FW_X(exp, static_cast<const Shape &>);
-DEV_FW_X(log, static_cast<const Shape &>);
-DEV_FW_X(tanh, static_cast<const Shape &>);
-DEV_FW_X(sigmoid, static_cast<const Shape &>);
-DEV_FW_X(softplus, static_cast<const Shape &>);
-DEV_FW_X(sin, static_cast<const Shape &>);
-DEV_FW_X(cos, static_cast<const Shape &>);
-DEV_FW_X(tan, static_cast<const Shape &>);
-DEV_FW_X(transpose, shape_ops::transpose);
+DEV_FW_X(negate, static_cast<const Shape &>, true);
+DEV_FW_X(sqrt, static_cast<const Shape &>, true);
+DEV_FW_X(exp, static_cast<const Shape &>, true);
+DEV_FW_X(log, static_cast<const Shape &>, true);
+DEV_FW_X(tanh, static_cast<const Shape &>, true);
+DEV_FW_X(sigmoid, static_cast<const Shape &>, true);
+DEV_FW_X(softplus, static_cast<const Shape &>, true);
+DEV_FW_X(sin, static_cast<const Shape &>, true);
+DEV_FW_X(cos, static_cast<const Shape &>, true);
+DEV_FW_X(tan, static_cast<const Shape &>, true);
+DEV_FW_X(transpose, shape_ops::transpose, false);
 
 DEV_BW_X(sqrt, static_cast<const Shape &>);
 DEV_BW_X(exp, static_cast<const Shape &>);
@@ -336,21 +801,21 @@ DEV_BW_X_CONST(pow_const_l);
 DEV_BW_X_CONST(prelu);
 DEV_BW_X_CONST(elu);
 
-DEV_FW_AB(add_scalar, shape_ops::scalar_op);
-DEV_FW_AB(subtract_scalar_r, shape_ops::scalar_op);
-DEV_FW_AB(subtract_scalar_l, shape_ops::scalar_op);
-DEV_FW_AB(multiply_scalar, shape_ops::scalar_op);
-DEV_FW_AB(divide_scalar_r, shape_ops::scalar_op);
-DEV_FW_AB(divide_scalar_l, shape_ops::scalar_op);
-DEV_FW_AB(pow_scalar_r, shape_ops::scalar_op);
-DEV_FW_AB(pow_scalar_l, shape_ops::scalar_op);
-
-DEV_FW_AB(add, shape_ops::elementwise);
-DEV_FW_AB(subtract, shape_ops::elementwise);
-DEV_FW_AB(multiply, shape_ops::elementwise);
-DEV_FW_AB(divide, shape_ops::elementwise);
-DEV_FW_AB(pow, shape_ops::elementwise);
-DEV_FW_AB(matmul, shape_ops::matmul);
+DEV_FW_AB(add_scalar, shape_ops::scalar_op, false);
+DEV_FW_AB(subtract_scalar_r, shape_ops::scalar_op, false);
+DEV_FW_AB(subtract_scalar_l, shape_ops::scalar_op, false);
+DEV_FW_AB(multiply_scalar, shape_ops::scalar_op, false);
+DEV_FW_AB(divide_scalar_r, shape_ops::scalar_op, false);
+DEV_FW_AB(divide_scalar_l, shape_ops::scalar_op, false);
+DEV_FW_AB(pow_scalar_r, shape_ops::scalar_op, false);
+DEV_FW_AB(pow_scalar_l, shape_ops::scalar_op, false);
+
+DEV_FW_AB(add, shape_ops::elementwise, true);
+DEV_FW_AB(subtract, shape_ops::elementwise, true);
+DEV_FW_AB(multiply, shape_ops::elementwise, true);
+DEV_FW_AB(divide, shape_ops::elementwise, true);
+DEV_FW_AB(pow, shape_ops::elementwise, true);
+DEV_FW_AB(matmul, shape_ops::matmul, false);
 
 DEV_BW_AB(add, shape_ops::elementwise);
 DEV_BW_AB(subtract, shape_ops::elementwise);
@@ -368,6 +833,13 @@ DEV_BW_AB(matmul, shape_ops::matmul);
 
 Tensor Device::sum_fw(const Tensor &x, std::uint32_t dim) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_dim(dim, 1), {x},
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          sum_fw_impl(*xs[0], dim, y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(x.shape().resize_dim(dim, 1));
   sum_fw_impl(x, dim, y);
   return y;
@@ -375,13 +847,69 @@ Tensor Device::sum_fw(const Tensor &x, std::uint32_t dim) {
 
 Tensor Device::logsumexp_fw(const Tensor &x, std::uint32_t dim) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_dim(dim, 1), {x},
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          logsumexp_fw_impl(*xs[0], dim, y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(x.shape().resize_dim(dim, 1));
   logsumexp_fw_impl(x, dim, y);
   return y;
 }
 
+Tensor Device::max_fw(const Tensor &x, std::uint32_t dim) {
+  CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_dim(dim, 1), {x},
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          max_fw_impl(*xs[0], dim, y);
+        }, false);
+  }
+  Tensor y = new_raw_tensor(x.shape().resize_dim(dim, 1));
+  max_fw_impl(x, dim, y);
+  return y;
+}
+
+Tensor Device::min_fw(const Tensor &x, std::uint32_t dim) {
+  CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_dim(dim, 1), {x},
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          min_fw_impl(*xs[0], dim, y);
+        }, false);
+  }
+  Tensor y = new_raw_tensor(x.shape().resize_dim(dim, 1));
+  min_fw_impl(x, dim, y);
+  return y;
+}
+
+Tensor Device::squared_norm_fw(const Tensor &x, std::uint32_t dim) {
+  CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_dim(dim, 1), {x},
+        [this, dim](const vector<const Tensor *> &xs, Tensor &y) {
+          squared_norm_fw_impl(*xs[0], dim, y);
+        }, false);
+  }
+  Tensor y = new_raw_tensor(x.shape().resize_dim(dim, 1));
+  squared_norm_fw_impl(x, dim, y);
+  return y;
+}
+
 Tensor Device::broadcast_fw(const Tensor &x, std::uint32_t dim, std::uint32_t size) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        shape_ops::broadcast(x.shape(), dim, size), {x},
+        [this, dim, size](const vector<const Tensor *> &xs, Tensor &y) {
+          broadcast_fw_impl(*xs[0], dim, size, y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(shape_ops::broadcast(x.shape(), dim, size));
   broadcast_fw_impl(x, dim, size, y);
   return y;
@@ -389,11 +917,45 @@ Tensor Device::broadcast_fw(const Tensor &x, std::uint32_t dim, std::uint32_t si
 
 Tensor Device::batch_sum_fw(const Tensor &x) {
   CHECK_DEVICE(x);
+  if (lazy_ && !flushing_) {
+    return defer(
+        x.shape().resize_batch(1), {x},
+        [this](const vector<const Tensor *> &xs, Tensor &y) {
+          batch_sum_fw_impl(*xs[0], y);
+        }, false);
+  }
   Tensor y = new_raw_tensor(x.shape().resize_batch(1));
   batch_sum_fw_impl(x, y);
   return y;
 }
 
+#define DEV_BW_DIM(name) \
+void Device::name##_bw( \
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, \
+    Tensor &gx) { \
+  CHECK_DEVICE(x); \
+  CHECK_DEVICE(y); \
+  CHECK_DEVICE(gy); \
+  CHECK_DEVICE(gx); \
+  if (x.shape() != gx.shape() || \
+      y.shape() != gy.shape() || \
+      y.shape() != x.shape().resize_dim(dim, 1)) { \
+    THROW_ERROR( \
+        "Shape mismatched at " #name "_bw" \
+        << ". x.shape: " << x.shape().to_string() \
+        << ", y.shape: " << y.shape().to_string() \
+        << ", gy.shape: " << gy.shape().to_string() \
+        << ", gx.shape: " << gx.shape().to_string() \
+        << ", dim: " << dim); \
+  } \
+  name##_bw_impl(x, y, gy, dim, gx); \
+}
+
+DEV_BW_DIM(max);
+DEV_BW_DIM(min);
+
+#undef DEV_BW_DIM
+
 void Device::inplace_multiply_const(float k, Tensor &x) {
   CHECK_DEVICE(x);
   inplace_multiply_const_impl(k, x);
@@ -2,7 +2,9 @@
 #define PRIMITIV_DEVICE_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
 #include <primitiv/mixins.h>
 #include <primitiv/shape.h>
 #include <primitiv/tensor.h>
@@ -32,6 +34,7 @@ public:
 
     NAIVE = 0x00000000,
     EIGEN = 0x00000001,
+    HYBRID = 0x00000002,
 
     GROUP_CUDA = 0x00010000,
     CUDA = 0x00010000,
@@ -54,7 +57,168 @@ public:
    */
   virtual DeviceType type() const = 0;
 
+  /**
+   * Accuracy mode of elementwise transcendental functions.
+   */
+  enum class MathMode : std::uint32_t {
+    /**
+     * Uses the standard math library.
+     */
+    PRECISE = 0,
+
+    /**
+     * Uses vectorizable approximations with bounded errors for exp, log, tanh,
+     * sigmoid and softplus.
+     */
+    FAST = 1,
+  };
+
+  /**
+   * Retrieves the current math mode of the device.
+   * @return A MathMode value.
+   */
+  MathMode math_mode() const { return math_mode_; }
+
+  /**
+   * Changes the math mode of the device.
+   * @param mode A new MathMode value.
+   * @remarks Devices without fast implementations ignore this setting.
+   *          Currently only Naive and Eigen devices support MathMode::FAST.
+   */
+  void set_math_mode(MathMode mode) { math_mode_ = mode; }
+
+  /**
+   * Function type of elementwise kernels executed on the host.
+   * `kernel(srcs, dest, size)` should calculate `size` elements of `dest`,
+   * where `srcs[j]` points the corresponding elements of the j-th argument.
+   */
+  using HostKernel = std::function<
+    void(const float *const *srcs, float *dest, std::uint32_t size)>;
+
+  /**
+   * Checks whether the device can execute host kernels or not.
+   * @return true if the device stores tensors on the host memory, false
+   *         otherwise.
+   */
+  bool supports_host_kernels() const;
+
+  /**
+   * Checks whether the device can execute kernels generated from source code
+   * or not.
+   * @return true if elementwise_source_fw() is available, false otherwise.
+   */
+  bool supports_source_kernels() const;
+
+  /**
+   * Checks whether the device is in the lazy mode or not.
+   * @return true if the device is in the lazy mode, false otherwise.
+   */
+  bool is_lazy() const { return lazy_; }
+
+  /**
+   * Enables or disables the lazy mode.
+   * In the lazy mode, forward operations of the device (i.e., functions::* for
+   * Tensor) are recorded into a trace instead of being executed immediately.
+   * Recorded operations are executed by flush(), which is also called
+   * automatically when the internal memory of a resulting tensor is required,
+   * e.g., by Tensor::to_vector().
+   * @param enabled true to enable the lazy mode, false otherwise.
+   * @remarks Disabling the lazy mode executes all recorded operations.
+   */
+  void set_lazy(bool enabled);
+
+  /**
+   * Executes all operations recorded in the lazy mode.
+   * Operations whose results are no longer referenced are skipped, and
+   * consecutive elementwise operations with the same shape are fused on
+   * devices which support host kernels.
+   * @return Number of operations actually executed.
+   */
+  std::uint32_t flush();
+
+  /**
+   * Retrieves the number of streams of the device.
+   * Operations in one stream are executed in the submitted order, while
+   * operations in different streams may be executed concurrently.
+   * @return Number of streams. Devices without streams have only one stream.
+   */
+  virtual std::uint32_t num_streams() const { return 1; }
+
+  /**
+   * Retrieves the stream which executes subsequent operations.
+   * @return Stream ID.
+   */
+  std::uint32_t current_stream() const { return stream_; }
+
+  /**
+   * Selects the stream which executes subsequent operations.
+   * @param stream Stream ID, which should be less than num_streams().
+   * @param waits Stream IDs. Subsequent operations start after all
+   *              operations already submitted to these streams.
+   * @remarks Memory of tensors released while multiple streams are used is
+   *          reused after all streams finished their operations, but the
+   *          callers have to resolve other dependencies through `waits`.
+   */
+  void set_stream(
+      std::uint32_t stream, const std::vector<std::uint32_t> &waits);
+
+  /**
+   * Waits for all operations in all streams and selects the stream 0.
+   */
+  void join_streams();
+
 private:
+  // Operation recorded in the lazy mode.
+  struct DeferredOperation {
+    using Function = std::function<
+      void(const std::vector<const Tensor *> &args, Tensor &y)>;
+
+    // Result slot shared with the resulting Tensor objects.
+    std::weak_ptr<std::shared_ptr<void>> slot;
+    Shape shape;
+    std::vector<Tensor> args;
+    Function func;
+    // true if `func` can be applied to any range of elements independently.
+    bool elementwise;
+  };
+
+  /**
+   * Records a new operation into the trace.
+   * @param shape Shape of the result.
+   * @param args Arguments of the operation.
+   * @param func Function to calculate the result.
+   * @param elementwise Whether the operation is elementwise or not.
+   * @return A new Tensor object which waits for the result.
+   */
+  Tensor defer(
+      const Shape &shape, std::vector<Tensor> &&args,
+      DeferredOperation::Function &&func, bool elementwise);
+
+  /**
+   * Executes consecutive elementwise operations block by block without
+   * materializing intermediate results used only in the operations.
+   * @param ops Deferred operations.
+   * @param begin Index of the first operation.
+   * @param end Index of the next to the last operation.
+   */
+  void execute_fused(
+      std::vector<DeferredOperation> &ops,
+      std::size_t begin, std::size_t end);
+
+  /**
+   * Checks arguments of fused elementwise operations.
+   * @param xs Arguments.
+   * @param shape Shape of the result.
+   */
+  void check_elementwise_args(
+      const std::vector<const Tensor *> &xs, const Shape &shape) const;
+
+  MathMode math_mode_ = MathMode::PRECISE;
+  std::uint32_t stream_ = 0;
+  bool lazy_ = false;
+  bool flushing_ = false;
+  std::vector<DeferredOperation> trace_;
+
   /**
    * Provides a new Tensor object on the device.
    * @param shape Shape of the tensor.
@@ -88,6 +252,34 @@ public:
   Tensor new_tensor_by_vector(
       const Shape &shape, const std::vector<float> &values);
 
+  /**
+   * Provides a new Tensor object which uses an external array as the internal
+   * memory without copying.
+   * @param shape Shape of the tensor.
+   * @param data Pointer to `shape.size()` values. Each element should be
+   *             ordered by the column-major order, and the batch size is
+   *             assumed as the last dimension.
+   * @param release Function called with `data` when the last Tensor object
+   *                which refers the array is destroyed. This may be empty.
+   * @return A new Tensor object.
+   * @remarks Only devices which satisfy supports_host_kernels() can execute
+   *          this function. In-place operations write into `data` directly
+   *          while the array is not shared with other Tensor objects.
+   */
+  Tensor new_tensor_by_external_array(
+      const Shape &shape, float *data, std::function<void(float *)> release);
+
+  /**
+   * Obtains the internal array of a tensor on the host memory.
+   * @param x A tensor on this device.
+   * @return Pointer to `x.shape().size()` values ordered in the same way as
+   *         new_tensor_by_array().
+   * @remarks Only devices which satisfy supports_host_kernels() can execute
+   *          this function. The pointer is valid while `x` or its copies are
+   *          alive and not modified.
+   */
+  const float *host_array(const Tensor &x);
+
   /**
    * Copies the tensor to this device with allocating a new memory.
    * @param x A tensor to be copied.
@@ -111,9 +303,30 @@ public:
   Tensor pick_fw(const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim);
   Tensor slice_fw(const Tensor &x, std::uint32_t dim, std::uint32_t lower, std::uint32_t upper);
   Tensor concat_fw(const std::vector<const Tensor *> &xs, std::uint32_t dim);
+  Tensor batch_pick_fw(const Tensor &x, const std::vector<std::uint32_t> &ids);
+  Tensor batch_slice_fw(const Tensor &x, std::uint32_t lower, std::uint32_t upper);
+  Tensor batch_concat_fw(const std::vector<const Tensor *> &xs);
 
   void pick_bw(const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &gx);
   void slice_bw(const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx);
+  void batch_pick_bw(const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx);
+  void batch_slice_bw(const Tensor &gy, std::uint32_t offset, Tensor &gx);
+
+  // Dropout. `mask` receives the dropout mask packed into 32 bits per element
+  // of its float array, and should be passed to dropout_bw().
+  Tensor dropout_fw(const Tensor &x, float rate, Tensor &mask);
+  void dropout_bw(const Tensor &gy, const Tensor &mask, float rate, Tensor &gx);
+
+  // Fused elementwise operation. `kernel` is called once for each minibatch,
+  // and arguments without minibatch are broadcasted. Only devices which
+  // satisfy supports_host_kernels() can execute this function.
+  Tensor elementwise_fw(const std::vector<const Tensor *> &xs, const Shape &shape, const HostKernel &kernel);
+
+  // Fused elementwise operation described by an expression of OpenCL C, which
+  // calculates one element of the result from elements `x0`, `x1`, ... of
+  // arguments. Arguments without minibatch are broadcasted. Only devices
+  // which satisfy supports_source_kernels() can execute this function.
+  Tensor elementwise_source_fw(const std::vector<const Tensor *> &xs, const Shape &shape, const std::string &source);
 
   // Unary operations.
   Tensor negate_fw(const Tensor &x);
@@ -202,9 +415,19 @@ public:
   // Dimension operations.
   Tensor sum_fw(const Tensor &x, std::uint32_t dim);
   Tensor logsumexp_fw(const Tensor &x, std::uint32_t dim);
+  Tensor max_fw(const Tensor &x, std::uint32_t dim);
+  Tensor min_fw(const Tensor &x, std::uint32_t dim);
+  Tensor squared_norm_fw(const Tensor &x, std::uint32_t dim);
   Tensor broadcast_fw(const Tensor &x, std::uint32_t dim, std::uint32_t size);
   Tensor batch_sum_fw(const Tensor &x);
 
+  void max_bw(
+      const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+      Tensor &gx);
+  void min_bw(
+      const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+      Tensor &gx);
+
   /**
    * Directly multiplies all elements by a constant.
    * @param k A constant to multiply.
@@ -260,6 +483,36 @@ private:
    */
   std::vector<std::uint32_t> argmin(const Tensor &x, std::uint32_t dim);
 
+  /**
+   * Retrieves the k largest values and their indices along an axis.
+   * @param x A tensor.
+   * @param dim A specified axis.
+   * @param k Number of elements to be retrieved from each slice.
+   * @param values A list to store the resulting values.
+   * @return A list of integers that indicates positions of the k largest
+   *         values.
+   * @remarks Results of each slice along `dim` are stored in `k` consecutive
+   *          elements, and are ordered by descending values. Ties are resolved
+   *          by preferring smaller indices.
+   */
+  std::vector<std::uint32_t> topk(
+      const Tensor &x, std::uint32_t dim, std::uint32_t k,
+      std::vector<float> &values);
+
+  /**
+   * Draws indices from categorical distributions along an axis.
+   * @param x A tensor of unnormalized log-probabilities.
+   * @param dim A specified axis.
+   * @param k Number of distinct indices to be drawn from each slice.
+   * @return A list of sampled indices.
+   * @remarks Each slice along `dim` is treated as a distribution
+   *          `softmax(x, dim)`, and indices are drawn without replacement
+   *          using the Gumbel-max trick. The layout of the result is same as
+   *          that of `topk()`.
+   */
+  std::vector<std::uint32_t> sample(
+      const Tensor &x, std::uint32_t dim, std::uint32_t k);
+
 protected:
   /**
    * Obtains an inner handle from a Tensor.
@@ -279,6 +532,28 @@ protected:
     return x.mutable_handle();
   }
 
+  /**
+   * Makes a Tensor which refers an existing array without owning it.
+   * @param shape Shape of the new Tensor.
+   * @param data Pointer to the array. The array should be alive while the
+   *             Tensor is used.
+   * @return A new Tensor object on this device.
+   * @remarks Tensor::mutable_handle() never copies the array of the returned
+   *          Tensor, and only devices with linear memory can use this
+   *          function.
+   */
+  Tensor make_view(const Shape &shape, float *data) {
+    return Tensor(shape, *this, std::shared_ptr<void>(
+          std::shared_ptr<void>(), data));
+  }
+
+  /**
+   * Discards all operations recorded in the lazy mode.
+   * @remarks Devices whose handles depend on their internal state should call
+   *          this function in the destructor.
+   */
+  void discard_deferred_operations() { trace_.clear(); }
+
   /**
    * Reset internal values of the tensor using a constant.
    * @param k A value used to initialize each element.
@@ -311,9 +586,19 @@ private:
 
   virtual std::shared_ptr<void> new_handle(const Shape &shape) = 0;
 
+  /**
+   * Checks whether handles of this device are plain pointers to float arrays.
+   * @return true if a handle shifted by some elements can be used as a handle
+   *         of another tensor, false otherwise.
+   * @remarks If this function returns true, batch_slice_fw() returns tensors
+   *          that share the memory with the source tensor.
+   */
+  virtual bool has_linear_memory() const { return false; }
+
   virtual std::vector<float> tensor_to_vector_impl(const Tensor &x) = 0;
   virtual std::vector<std::uint32_t> argmax_impl(const Tensor &x, std::uint32_t dim) = 0;
   virtual std::vector<std::uint32_t> argmin_impl(const Tensor &x, std::uint32_t dim) = 0;
+  virtual void topk_impl(const Tensor &x, std::uint32_t dim, std::uint32_t k, std::vector<float> &values, std::vector<std::uint32_t> &ids) = 0;
 
   virtual void reset_tensor_impl(float k, Tensor &x) = 0;
   virtual void reset_tensor_by_array_impl(const float values[], Tensor &x) = 0;
@@ -330,9 +615,14 @@ private:
   virtual void pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &y) = 0;
   virtual void slice_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t offset, Tensor &y) = 0;
   virtual void concat_fw_impl(const std::vector<const Tensor *> &xs, std::uint32_t dim, Tensor &y) = 0;
+  virtual void batch_pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) = 0;
 
   virtual void pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &gx) = 0;
   virtual void slice_bw_impl(const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx) = 0;
+  virtual void batch_pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) = 0;
+
+  virtual void dropout_fw_impl(const Tensor &x, float p, Tensor &mask, Tensor &y) = 0;
+  virtual void dropout_bw_impl(const Tensor &gy, const Tensor &mask, float p, Tensor &gx) = 0;
 
   virtual void negate_fw_impl(const Tensor &x, Tensor &y) = 0;
   virtual void sqrt_fw_impl(const Tensor &x, Tensor &y) = 0;
@@ -416,13 +706,27 @@ private:
 
   virtual void sum_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) = 0;
   virtual void logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) = 0;
+  virtual void max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) = 0;
+  virtual void min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) = 0;
+  virtual void squared_norm_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) = 0;
   virtual void broadcast_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) = 0;
   virtual void batch_sum_fw_impl(const Tensor &x, Tensor &y) = 0;
 
+  virtual void max_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) = 0;
+  virtual void min_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) = 0;
+
   virtual void inplace_multiply_const_impl(float k, Tensor &x) = 0;
 
   virtual void inplace_add_impl(const Tensor &x, Tensor &y) = 0;
   virtual void inplace_subtract_impl(const Tensor &x, Tensor &y) = 0;
+
+  // Optional. Devices which satisfy supports_source_kernels() should override
+  // this function.
+  virtual void elementwise_source_fw_impl(const std::vector<const Tensor *> &xs, const std::string &source, Tensor &y);
+
+  // Optional. Devices which have multiple streams should override this
+  // function.
+  virtual void set_stream_impl(std::uint32_t, const std::vector<std::uint32_t> &) {}
 };
 
 }  // namespace primitiv
@@ -17,6 +17,8 @@
 
 #include <primitiv/eigen_device.h>
 #include <primitiv/error.h>
+#include <primitiv/numeric_utils.h>
+#include <primitiv/small_kernels.h>
 
 using std::cerr;
 using std::endl;
@@ -111,6 +113,38 @@ std::vector<std::uint32_t> Eigen::argmin_impl(const Tensor &x, std::uint32_t dim
   return ret;
 }
 
+void Eigen::topk_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    std::vector<float> &values, std::vector<std::uint32_t> &ids) {
+  const Shape &s = x.shape();
+  const std::uint32_t n = s[dim];
+  const std::uint32_t repeat = s.size() / n;
+  const std::uint32_t skip1 = s.lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  const float *src = CDATA(x);
+  values.clear();
+  values.reserve(repeat * k);
+  ids.clear();
+  ids.reserve(repeat * k);
+  std::vector<std::uint32_t> buf(n);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    const float *src_i = src + i % skip1 + (i / skip1) * skip2;
+    for (std::uint32_t j = 0; j < n; ++j) buf[j] = j;
+    // NOTE: Only the first k elements are ordered by partial_sort.
+    std::partial_sort(
+        buf.begin(), buf.begin() + k, buf.end(),
+        [src_i, skip1](std::uint32_t a, std::uint32_t b) {
+          const float va = src_i[a * skip1];
+          const float vb = src_i[b * skip1];
+          return va > vb || (va == vb && a < b);
+        });
+    for (std::uint32_t j = 0; j < k; ++j) {
+      values.emplace_back(src_i[buf[j] * skip1]);
+      ids.emplace_back(buf[j]);
+    }
+  }
+}
+
 void Eigen::reset_tensor_impl(float k, Tensor &x) {
   EMap<EArrayXf>(MDATA(x), x.shape().size()).setConstant(k);
 }
@@ -224,6 +258,15 @@ void Eigen::concat_fw_impl(
   }
 }
 
+void Eigen::batch_pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) {
+  const std::uint32_t size = x.shape().volume();
+  for (std::uint32_t i = 0; i < ids.size(); ++i) {
+    EMap<EArrayXf>(MDATA(y) + i * size, size)
+      = EMap<const EArrayXf>(CDATA(x) + ids[i] * size, size);
+  }
+}
+
 void Eigen::pick_bw_impl(
     const Tensor &gy, const std::vector<std::uint32_t>& ids, std::uint32_t dim,
     Tensor &gx) {
@@ -274,6 +317,41 @@ void Eigen::slice_bw_impl(
   }
 }
 
+void Eigen::batch_pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) {
+  const std::uint32_t size = gx.shape().volume();
+  for (std::uint32_t i = 0; i < ids.size(); ++i) {
+    EMap<EArrayXf>(MDATA(gx) + ids[i] * size, size)
+      += EMap<const EArrayXf>(CDATA(gy) + i * size, size);
+  }
+}
+
+void Eigen::dropout_fw_impl(
+    const Tensor &x, float p, Tensor &mask, Tensor &y) {
+  const std::size_t size = x.shape().size();
+  const float scale = 1. / p;
+  std::uint32_t *pm = static_cast<std::uint32_t *>(get_mutable_handle(mask));
+  randomizer_.fill_bernoulli_bits(p, size, pm);
+  const float *px = CDATA(x);
+  float *py = MDATA(y);
+  for (std::size_t i = 0; i < size; ++i) {
+    py[i] = (pm[i >> 5] >> (i & 31)) & 1 ? px[i] * scale : 0;
+  }
+}
+
+void Eigen::dropout_bw_impl(
+    const Tensor &gy, const Tensor &mask, float p, Tensor &gx) {
+  const std::size_t size = gy.shape().size();
+  const float scale = 1. / p;
+  const std::uint32_t *pm = static_cast<const std::uint32_t *>(
+      get_handle(mask));
+  const float *pgy = CDATA(gy);
+  float *pgx = MDATA(gx);
+  for (std::size_t i = 0; i < size; ++i) {
+    pgx[i] += (pm[i >> 5] >> (i & 31)) & 1 ? pgy[i] * scale : 0;
+  }
+}
+
 #define MAYBE_USED(x) static_cast<void>(x)
 
 #define EIGEN_DEV_FW_X(name, op) \
@@ -293,6 +371,22 @@ void Eigen::name##_bw_impl( \
   EMap<EArrayXf>(MDATA(gx_), size) += (op); \
 }
 
+// Same as EIGEN_DEV_FW_X, but applies `fast_fn` elementwise in
+// MathMode::FAST. Plain loops are used because Eigen has no packet
+// implementations of these approximations.
+#define EIGEN_DEV_FW_X_MATH(name, op, fast_fn) \
+void Eigen::name##_fw_impl(const Tensor &x_, Tensor &y_) { \
+  const std::size_t size = x_.shape().size(); \
+  if (math_mode() == MathMode::FAST) { \
+    const float *px = CDATA(x_); \
+    float *py = MDATA(y_); \
+    for (std::size_t i = 0; i < size; ++i) py[i] = fast_fn(px[i]); \
+  } else { \
+    EMap<const EArrayXf> x(CDATA(x_), size); \
+    EMap<EArrayXf>(MDATA(y_), size) = (op); \
+  } \
+}
+
 #define EIGEN_DEV_FW_X_CONST(name, op) \
 void Eigen::name##_fw_impl(const Tensor &x_, float k, Tensor &y_) { \
   const std::size_t size = x_.shape().size(); \
@@ -351,14 +445,16 @@ void Eigen::name##_fw_impl(const Tensor &a_, const Tensor &b_, Tensor &y_) { \
 
 EIGEN_DEV_FW_X(negate, -x);
 EIGEN_DEV_FW_X(sqrt, x.sqrt());
-EIGEN_DEV_FW_X(exp, x.exp());
-EIGEN_DEV_FW_X(log, x.log());
-EIGEN_DEV_FW_X(tanh, x.tanh());
-EIGEN_DEV_FW_X(sigmoid, .5 + .5 * (.5 * x).tanh());
-EIGEN_DEV_FW_X(
+EIGEN_DEV_FW_X_MATH(exp, x.exp(), numeric_utils::fast_exp);
+EIGEN_DEV_FW_X_MATH(log, x.log(), numeric_utils::fast_log);
+EIGEN_DEV_FW_X_MATH(tanh, x.tanh(), numeric_utils::fast_tanh);
+EIGEN_DEV_FW_X_MATH(
+    sigmoid, .5 + .5 * (.5 * x).tanh(), numeric_utils::fast_sigmoid);
+EIGEN_DEV_FW_X_MATH(
     softplus, (x > 0.).select(
       x + (1. + (-x).exp()).log(),
-      (1. + x.exp()).log()));
+      (1. + x.exp()).log()),
+    numeric_utils::fast_softplus);
 EIGEN_DEV_FW_X(sin, x.sin());
 EIGEN_DEV_FW_X(cos, x.cos());
 EIGEN_DEV_FW_X(tan, x.tan());
@@ -368,7 +464,24 @@ EIGEN_DEV_BW_X(exp, gy * y);
 EIGEN_DEV_BW_X(log, gy / x);
 EIGEN_DEV_BW_X(tanh, gy * (1. - y * y));
 EIGEN_DEV_BW_X(sigmoid, gy * y * (1. - y));
-EIGEN_DEV_BW_X(softplus, gy * (.5 + .5 * (.5 * x).tanh()));
+
+void Eigen::softplus_bw_impl(
+    const Tensor &x_, const Tensor &, const Tensor &gy_, Tensor &gx_) {
+  const std::size_t size = x_.shape().size();
+  if (math_mode() == MathMode::FAST) {
+    const float *px = CDATA(x_);
+    const float *pgy = CDATA(gy_);
+    float *pgx = MDATA(gx_);
+    for (std::size_t i = 0; i < size; ++i) {
+      pgx[i] += numeric_utils::fast_sigmoid(px[i]) * pgy[i];
+    }
+  } else {
+    EMap<const EArrayXf> x(CDATA(x_), size);
+    EMap<const EArrayXf> gy(CDATA(gy_), size);
+    EMap<EArrayXf>(MDATA(gx_), size) += gy * (.5 + .5 * (.5 * x).tanh());
+  }
+}
+
 EIGEN_DEV_BW_X(sin, gy * x.cos());
 EIGEN_DEV_BW_X(cos, -gy * x.sin());
 EIGEN_DEV_BW_X(tan, gy * (1. + y * y));
@@ -412,6 +525,7 @@ EIGEN_DEV_FW_AB(pow, a.pow(b));
 
 #undef EIGEN_DEV_FW_X
 #undef EIGEN_DEV_BW_X
+#undef EIGEN_DEV_FW_X_MATH
 #undef EIGEN_DEV_FW_X_CONST
 #undef EIGEN_DEV_BW_X_CONST
 #undef EIGEN_DEV_FW_X_SCALAR
@@ -568,6 +682,16 @@ void Eigen::matmul_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) {
     const std::uint32_t b_skip = b.shape().has_batch() * dj * dk;
     const std::uint32_t y_skip = di * dk;
     const std::uint32_t bs = a.shape().batch();
+    // Eigen's dynamic-size GEMM is dominated by its overhead for small
+    // matrix-vector-like products, but wins if `a` is reused by many columns.
+    const auto kernel = dk <= 2
+      ? small_kernels::get_matmul_kernel(di, dk) : nullptr;
+    if (kernel) {
+      for (std::uint32_t n = 0; n < bs; ++n) {
+        kernel(src_a + n * a_skip, src_b + n * b_skip, dest + n * y_skip, dj);
+      }
+      return;
+    }
     for (std::uint32_t n = 0; n < bs; ++n) {
       EMap<const EMatrixXf> aa(src_a + n * a_skip, di, dj);
       EMap<const EMatrixXf> bb(src_b + n * b_skip, dj, dk);
@@ -577,6 +701,12 @@ void Eigen::matmul_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) {
   } else {
     // Do multiplication only once using a combined matrix.
     const std::uint32_t dk_batch = dk * b.shape().batch();
+    const auto kernel = dk_batch <= 2
+      ? small_kernels::get_matmul_kernel(di, dk_batch) : nullptr;
+    if (kernel) {
+      kernel(src_a, src_b, dest, dj);
+      return;
+    }
     EMap<const EMatrixXf> aa(src_a, di, dj);
     EMap<const EMatrixXf> bb(src_b, dj, dk_batch);
     EMap<EMatrixXf> yy(dest, di, dk_batch);
@@ -686,6 +816,28 @@ void Eigen::logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
   }
 }
 
+#define EIGEN_DEV_FW_DIM(name, op) \
+void Eigen::name##_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) { \
+  const std::uint32_t n = x.shape()[dim]; \
+  const std::uint32_t skip1 = y.shape().lower_volume(dim); \
+  const std::uint32_t skip2 = skip1 * n; \
+  const std::uint32_t repeat = y.shape().size() / skip1; \
+  float *dest = MDATA(y); \
+  const float *src = CDATA(x); \
+  for (std::uint32_t i = 0; i < repeat; ++i) { \
+    EMap<const EMatrixXf> xx(src, skip1, n); \
+    EMap<EMatrixXf>(dest, skip1, 1) = xx.rowwise().op(); \
+    src += skip2; \
+    dest += skip1; \
+  } \
+}
+
+EIGEN_DEV_FW_DIM(max, maxCoeff);
+EIGEN_DEV_FW_DIM(min, minCoeff);
+EIGEN_DEV_FW_DIM(squared_norm, squaredNorm);
+
+#undef EIGEN_DEV_FW_DIM
+
 void Eigen::broadcast_fw_impl(
     const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) {
   // TODO(odashi): Optimize this functions using Eigen operations.
@@ -720,6 +872,38 @@ void Eigen::batch_sum_fw_impl(const Tensor &x_, Tensor &y_) {
   }
 }
 
+void Eigen::max_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The gradient is routed only to the first element that has
+  // the resulting value, which matches the behavior of argmax().
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t repeat = y.shape().size();
+  const std::uint32_t skip1 = y.shape().lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  const float *src_x = CDATA(x);
+  const float *src_y = CDATA(y);
+  const float *src_gy = CDATA(gy);
+  float *dest = MDATA(gx);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    std::uint32_t offset = i % skip1 + (i / skip1) * skip2;
+    for (std::uint32_t j = 0; j < n; ++j) {
+      if (src_x[offset] == src_y[i]) {
+        dest[offset] += src_gy[i];
+        break;
+      }
+      offset += skip1;
+    }
+  }
+}
+
+void Eigen::min_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The backward operation of min() is same as that of max().
+  max_bw_impl(x, y, gy, dim, gx);
+}
+
 void Eigen::inplace_multiply_const_impl(float k, Tensor &x) {
   EMap<EArrayXf>(MDATA(x), x.shape().size()) *= k;
 }
@@ -11,6 +11,8 @@ namespace devices {
  * Device class for the Eigen3 backend.
  */
 class Eigen : public Device {
+  friend class Hybrid;
+
 public:
   /**
    * Creates a Eigen object.
@@ -30,10 +32,12 @@ public:
 
 private:
   std::shared_ptr<void> new_handle(const Shape &shape) override;
+  bool has_linear_memory() const override { return true; }
 
   std::vector<float> tensor_to_vector_impl(const Tensor &x) override;
   std::vector<std::uint32_t> argmax_impl(const Tensor &x, std::uint32_t dim) override;
   std::vector<std::uint32_t> argmin_impl(const Tensor &x, std::uint32_t dim) override;
+  void topk_impl(const Tensor &x, std::uint32_t dim, std::uint32_t k, std::vector<float> &values, std::vector<std::uint32_t> &ids) override;
 
   void reset_tensor_impl(float k, Tensor &x) override;
   void reset_tensor_by_array_impl(const float values[], Tensor &x) override;
@@ -50,9 +54,14 @@ private:
   void pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &y) override;
   void slice_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t offset, Tensor &y) override;
   void concat_fw_impl(const std::vector<const Tensor *> &xs, std::uint32_t dim, Tensor &y) override;
+  void batch_pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) override;
 
   void pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &gx) override;
   void slice_bw_impl(const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx) override;
+  void batch_pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) override;
+
+  void dropout_fw_impl(const Tensor &x, float p, Tensor &mask, Tensor &y) override;
+  void dropout_bw_impl(const Tensor &gy, const Tensor &mask, float p, Tensor &gx) override;
 
   void negate_fw_impl(const Tensor &x, Tensor &y) override;
   void sqrt_fw_impl(const Tensor &x, Tensor &y) override;
@@ -136,16 +145,22 @@ private:
 
   void sum_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
   void logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void squared_norm_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
   void broadcast_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) override;
   void batch_sum_fw_impl(const Tensor &x, Tensor &y) override;
 
+  void max_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+  void min_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+
   void inplace_multiply_const_impl(float k, Tensor &x) override;
 
   void inplace_add_impl(const Tensor &x, Tensor &y) override;
   void inplace_subtract_impl(const Tensor &x, Tensor &y) override;
 
 private:
-  DefaultRandomizer randomizer_;
+  PhiloxRandomizer randomizer_;
 };
 
 }  // namespace devices
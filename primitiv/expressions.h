@@ -0,0 +1,339 @@
+#ifndef PRIMITIV_EXPRESSIONS_H_
+#define PRIMITIV_EXPRESSIONS_H_
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <primitiv/basic_functions.h>
+#include <primitiv/device.h>
+#include <primitiv/shape_ops.h>
+#include <primitiv/string_utils.h>
+#include <primitiv/tensor.h>
+
+namespace primitiv {
+
+/*
+ * Expression templates of elementwise Tensor operations.
+ *
+ * Operators and functions in this namespace build lightweight expression
+ * objects instead of calculating each operation immediately. An expression is
+ * evaluated when it is converted into a Tensor: devices that support host
+ * kernels calculate the whole expression in one loop without any temporary
+ * tensors, devices that support source kernels (OpenCL) compile the whole
+ * expression into one kernel, and other devices fall back to calling
+ * functions::* for each operation.
+ *
+ * Expressions start from `lazy()`:
+ *
+ *     using primitiv::expressions::lazy;
+ *     m = alpha * lazy(m) + (1 - alpha) * lazy(g) * lazy(g);
+ *
+ * Each expression holds copies of its argument tensors (which share the
+ * internal memory), so it is safe to keep expressions in local variables.
+ */
+namespace expressions {
+
+/**
+ * Base class of expressions.
+ * @tparam Derived Type of the actual expression.
+ */
+template<typename Derived>
+class Expression {
+public:
+  /**
+   * Retrieves the actual expression.
+   * @return Reference to the actual expression.
+   */
+  const Derived &derived() const {
+    return static_cast<const Derived &>(*this);
+  }
+
+  /**
+   * Evaluates the expression.
+   * @return A new Tensor object with the result.
+   */
+  Tensor eval() const;
+
+  /**
+   * Evaluates the expression.
+   * @return A new Tensor object with the result.
+   */
+  operator Tensor() const { return eval(); }
+
+  /**
+   * Evaluates the expression and retrieves its values.
+   * @return A list of the resulting values.
+   */
+  std::vector<float> to_vector() const { return eval().to_vector(); }
+};
+
+/**
+ * Leaf expression which refers a Tensor.
+ */
+class Ref : public Expression<Ref> {
+  Tensor x_;
+
+public:
+  explicit Ref(const Tensor &x) : x_(x) { x_.check_valid(); }
+
+  Shape shape() const { return x_.shape(); }
+  Device &device() const { return x_.device(); }
+  void collect(std::vector<const Tensor *> &xs) const { xs.emplace_back(&x_); }
+  const Tensor &eager() const { return x_; }
+  std::string source(std::uint32_t &n) const {
+    return 'x' + std::to_string(n++);
+  }
+
+  class Evaluator {
+    const float *p_;
+
+  public:
+    Evaluator(const Ref &, const float *const *&srcs) : p_(*srcs++) {}
+    float operator[](std::uint32_t i) const { return p_[i]; }
+  };
+};
+
+/**
+ * Leaf expression which holds a constant.
+ * This class can be used only as an argument of other expressions.
+ */
+class Constant {
+  float k_;
+
+public:
+  explicit Constant(float k) : k_(k) {}
+
+  void collect(std::vector<const Tensor *> &) const {}
+  float eager() const { return k_; }
+  std::string source(std::uint32_t &) const {
+    return string_utils::to_c_literal(k_);
+  }
+
+  class Evaluator {
+    float k_;
+
+  public:
+    Evaluator(const Constant &c, const float *const *&) : k_(c.k_) {}
+    float operator[](std::uint32_t) const { return k_; }
+  };
+};
+
+namespace detail {
+
+// Resulting shape of binary operations.
+template<typename L, typename R>
+inline Shape binary_shape(const L &l, const R &r) {
+  return shape_ops::elementwise(l.shape(), r.shape());
+}
+
+template<typename L>
+inline Shape binary_shape(const L &l, const Constant &) { return l.shape(); }
+
+template<typename R>
+inline Shape binary_shape(const Constant &, const R &r) { return r.shape(); }
+
+// Device of binary operations. Mismatched devices of arguments are reported
+// by Device::elementwise_fw() or functions::*.
+template<typename L, typename R>
+inline Device &binary_device(const L &l, const R &) { return l.device(); }
+
+template<typename R>
+inline Device &binary_device(const Constant &, const R &r) {
+  return r.device();
+}
+
+}  // namespace detail
+
+/**
+ * Elementwise unary operation.
+ * @tparam Op Operation with `apply(x)` and `eager(x)`.
+ * @tparam E Type of the argument.
+ */
+template<typename Op, typename E>
+class Unary : public Expression<Unary<Op, E>> {
+  E e_;
+
+public:
+  explicit Unary(const E &e) : e_(e) {}
+
+  Shape shape() const { return e_.shape(); }
+  Device &device() const { return e_.device(); }
+  void collect(std::vector<const Tensor *> &xs) const { e_.collect(xs); }
+  Tensor eager() const { return Op::eager(e_.eager()); }
+  std::string source(std::uint32_t &n) const {
+    return Op::source(e_.source(n));
+  }
+
+  class Evaluator {
+    typename E::Evaluator e_;
+
+  public:
+    Evaluator(const Unary &u, const float *const *&srcs) : e_(u.e_, srcs) {}
+    float operator[](std::uint32_t i) const { return Op::apply(e_[i]); }
+  };
+};
+
+/**
+ * Elementwise binary operation.
+ * @tparam Op Operation with `apply(a, b)` and `eager(a, b)`.
+ * @tparam L Type of the left-hand side argument.
+ * @tparam R Type of the right-hand side argument.
+ */
+template<typename Op, typename L, typename R>
+class Binary : public Expression<Binary<Op, L, R>> {
+  L l_;
+  R r_;
+
+public:
+  Binary(const L &l, const R &r) : l_(l), r_(r) {}
+
+  Shape shape() const { return detail::binary_shape(l_, r_); }
+  Device &device() const { return detail::binary_device(l_, r_); }
+
+  void collect(std::vector<const Tensor *> &xs) const {
+    l_.collect(xs);
+    r_.collect(xs);
+  }
+
+  Tensor eager() const { return Op::eager(l_.eager(), r_.eager()); }
+
+  std::string source(std::uint32_t &n) const {
+    // NOTE: Arguments are numbered in the same order as collect().
+    const std::string l = l_.source(n);
+    return Op::source(l, r_.source(n));
+  }
+
+  class Evaluator {
+    // NOTE: Arguments are initialized in the same order as collect().
+    typename L::Evaluator l_;
+    typename R::Evaluator r_;
+
+  public:
+    Evaluator(const Binary &b, const float *const *&srcs)
+      : l_(b.l_, srcs), r_(b.r_, srcs) {}
+    float operator[](std::uint32_t i) const {
+      return Op::apply(l_[i], r_[i]);
+    }
+  };
+};
+
+template<typename Derived>
+Tensor Expression<Derived>::eval() const {
+  const Derived &e = derived();
+  Device &dev = e.device();
+  std::vector<const Tensor *> xs;
+  if (dev.supports_source_kernels()) {
+    e.collect(xs);
+    std::uint32_t n = 0;
+    return dev.elementwise_source_fw(xs, e.shape(), e.source(n));
+  }
+  if (!dev.supports_host_kernels()) return e.eager();
+  e.collect(xs);
+  return dev.elementwise_fw(
+      xs, e.shape(),
+      [&e](const float *const *srcs, float *dest, std::uint32_t size) {
+        const typename Derived::Evaluator ev(e, srcs);
+        for (std::uint32_t i = 0; i < size; ++i) dest[i] = ev[i];
+      });
+}
+
+/**
+ * Starts an expression.
+ * @param x A tensor.
+ * @return An expression which refers `x`.
+ */
+inline Ref lazy(const Tensor &x) { return Ref(x); }
+
+namespace ops {
+
+#define PRIMITIV_EXPR_UNARY_OP(name, func, op, src) \
+struct name { \
+  static float apply(float x) { return (op); } \
+  static std::string source(const std::string &x) { return (src); } \
+  template<typename X> \
+  static Tensor eager(const X &x) { return functions::func(x); } \
+}
+
+PRIMITIV_EXPR_UNARY_OP(Negate, negative, -x, "(-" + x + ')');
+PRIMITIV_EXPR_UNARY_OP(Sqrt, sqrt, std::sqrt(x), "sqrt(" + x + ')');
+PRIMITIV_EXPR_UNARY_OP(Exp, exp, std::exp(x), "exp(" + x + ')');
+PRIMITIV_EXPR_UNARY_OP(Log, log, std::log(x), "log(" + x + ')');
+PRIMITIV_EXPR_UNARY_OP(Tanh, tanh, std::tanh(x), "tanh(" + x + ')');
+PRIMITIV_EXPR_UNARY_OP(
+    Sigmoid, sigmoid, .5f + .5f * std::tanh(.5f * x),
+    "(.5f + .5f * tanh(.5f * " + x + "))");
+
+#undef PRIMITIV_EXPR_UNARY_OP
+
+#define PRIMITIV_EXPR_BINARY_OP(name, func, op) \
+struct name { \
+  static float apply(float a, float b) { return (a op b); } \
+  static std::string source(const std::string &a, const std::string &b) { \
+    return '(' + a + " " #op " " + b + ')'; \
+  } \
+  template<typename A, typename B> \
+  static Tensor eager(const A &a, const B &b) { \
+    return functions::func(a, b); \
+  } \
+}
+
+PRIMITIV_EXPR_BINARY_OP(Add, add, +);
+PRIMITIV_EXPR_BINARY_OP(Subtract, subtract, -);
+PRIMITIV_EXPR_BINARY_OP(Multiply, multiply, *);
+PRIMITIV_EXPR_BINARY_OP(Divide, divide, /);
+
+#undef PRIMITIV_EXPR_BINARY_OP
+
+}  // namespace ops
+
+#define PRIMITIV_EXPR_UNARY_FUNC(func, Op) \
+template<typename E> \
+inline Unary<ops::Op, E> func(const Expression<E> &e) { \
+  return Unary<ops::Op, E>(e.derived()); \
+}
+
+PRIMITIV_EXPR_UNARY_FUNC(operator-, Negate);
+PRIMITIV_EXPR_UNARY_FUNC(sqrt, Sqrt);
+PRIMITIV_EXPR_UNARY_FUNC(exp, Exp);
+PRIMITIV_EXPR_UNARY_FUNC(log, Log);
+PRIMITIV_EXPR_UNARY_FUNC(tanh, Tanh);
+PRIMITIV_EXPR_UNARY_FUNC(sigmoid, Sigmoid);
+
+#undef PRIMITIV_EXPR_UNARY_FUNC
+
+#define PRIMITIV_EXPR_BINARY_FUNC(func, Op) \
+template<typename L, typename R> \
+inline Binary<ops::Op, L, R> func( \
+    const Expression<L> &l, const Expression<R> &r) { \
+  return Binary<ops::Op, L, R>(l.derived(), r.derived()); \
+} \
+template<typename L> \
+inline Binary<ops::Op, L, Ref> func(const Expression<L> &l, const Tensor &r) { \
+  return Binary<ops::Op, L, Ref>(l.derived(), Ref(r)); \
+} \
+template<typename R> \
+inline Binary<ops::Op, Ref, R> func(const Tensor &l, const Expression<R> &r) { \
+  return Binary<ops::Op, Ref, R>(Ref(l), r.derived()); \
+} \
+template<typename L> \
+inline Binary<ops::Op, L, Constant> func(const Expression<L> &l, float r) { \
+  return Binary<ops::Op, L, Constant>(l.derived(), Constant(r)); \
+} \
+template<typename R> \
+inline Binary<ops::Op, Constant, R> func(float l, const Expression<R> &r) { \
+  return Binary<ops::Op, Constant, R>(Constant(l), r.derived()); \
+}
+
+PRIMITIV_EXPR_BINARY_FUNC(operator+, Add);
+PRIMITIV_EXPR_BINARY_FUNC(operator-, Subtract);
+PRIMITIV_EXPR_BINARY_FUNC(operator*, Multiply);
+PRIMITIV_EXPR_BINARY_FUNC(operator/, Divide);
+
+#undef PRIMITIV_EXPR_BINARY_FUNC
+
+}  // namespace expressions
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_EXPRESSIONS_H_
@@ -4,5 +4,6 @@
 #include <primitiv/arithmetic.h>
 #include <primitiv/basic_functions.h>
 #include <primitiv/composite_functions.h>
+#include <primitiv/expressions.h>
 
 #endif  // PRIMITIV_FUNCTIONS_H_
@@ -7,6 +7,7 @@
 
 #include <primitiv/config.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
@@ -22,10 +23,25 @@ using std::endl;
 using std::move;
 using std::vector;
 
+namespace {
+
+// Registers the device if it has multiple streams.
+bool register_streams(
+    primitiv::Device &dev, vector<primitiv::Device *> &devices) {
+  if (dev.num_streams() <= 1) return false;
+  if (std::find(devices.begin(), devices.end(), &dev) == devices.end()) {
+    devices.emplace_back(&dev);
+  }
+  return true;
+}
+
+}  // namespace
+
 namespace primitiv {
 
 void Graph::clear() {
   ops_.clear();
+  next_stream_ = 0;
 }
 
 #define CHECK_NODE(n) { \
@@ -80,6 +96,7 @@ Node Graph::add_operator(
   vector<NodeInfo> rets;
   rets.emplace_back(NodeInfo {
       move(ret_shape), *ret_device, Tensor(), Tensor(), vector<std::uint32_t>(),
+      0, 0, false,
   });
 
   // Updates the graph.
@@ -92,9 +109,63 @@ Node Graph::add_operator(
   return Node(*this, ret_op_id, 0);
 }
 
+void Graph::select_forward_stream(
+    std::uint32_t op_id, vector<Device *> &devices) {
+  OperatorInfo &cur_f = ops_[op_id];
+  NodeInfo &cur_n = cur_f.rets[0];
+  Device &dev = cur_n.device;
+  if (!::register_streams(dev, devices)) return;
+
+  // NOTE: Values outside the graph (e.g., parameters) are treated as the
+  // results of the stream 0.
+  vector<std::uint32_t> waits;
+  bool inherited = false;
+  for (const Address &arg : cur_f.args) {
+    NodeInfo &arg_n = ops_[arg.op_id].rets[arg.val_id];
+    if (&arg_n.device != &dev) {
+      // Copies from other devices do not know streams.
+      arg_n.device.join_streams();
+      continue;
+    }
+    waits.emplace_back(arg_n.stream);
+    if (!inherited && !arg_n.inherited && arg_n.value.valid()) {
+      cur_n.stream = arg_n.stream;
+      arg_n.inherited = inherited = true;
+    }
+  }
+  if (!inherited) {
+    cur_n.stream = next_stream_++ % dev.num_streams();
+  }
+  dev.set_stream(cur_n.stream, waits);
+}
+
+void Graph::select_backward_stream(
+    std::uint32_t op_id, vector<Device *> &devices) {
+  OperatorInfo &cur_f = ops_[op_id];
+  NodeInfo &cur_n = cur_f.rets[0];
+  Device &dev = cur_n.device;
+  if (!::register_streams(dev, devices)) return;
+
+  // Waits for the calculation of all values and gradients used in the
+  // operator. Gradients of arguments are also waited to serialize
+  // accumulations from different operators.
+  vector<std::uint32_t> waits { cur_n.grad_stream };
+  for (const Address &arg : cur_f.args) {
+    NodeInfo &arg_n = ops_[arg.op_id].rets[arg.val_id];
+    if (&arg_n.device != &dev) {
+      arg_n.device.join_streams();
+      continue;
+    }
+    waits.emplace_back(arg_n.stream);
+    if (arg_n.grad.valid()) waits.emplace_back(arg_n.grad_stream);
+  }
+  dev.set_stream(cur_n.stream, waits);
+}
+
 const Tensor &Graph::forward(const Node &node) {
   CHECK_NODE(node);
 
+  vector<Device *> stream_devices;
   std::function<const Tensor *(std::uint32_t)> forward_recursive = [&](
       std::uint32_t op_id) -> const Tensor * {
     OperatorInfo &cur_f = ops_[op_id];
@@ -113,13 +184,16 @@ const Tensor &Graph::forward(const Node &node) {
       }
 
       // Calculates the value.
+      select_forward_stream(op_id, stream_devices);
       cur_n.value = cur_f.op->forward(arg_values);
     }
 
     return &cur_n.value;
   };
 
-  return *forward_recursive(node.op_id_);
+  const Tensor *ret = forward_recursive(node.op_id_);
+  for (Device *dev : stream_devices) dev->join_streams();
+  return *ret;
 }
 
 void Graph::backward(const Node &node) {
@@ -145,6 +219,8 @@ void Graph::backward(const Node &node) {
 
   // Makes the identity gradient (dx/dx = 1) at the last node.
   last_n.grad = functions::ones<Tensor>(last_v->shape(), last_n.device);
+  last_n.grad_stream = last_n.device.current_stream();
+  vector<Device *> stream_devices;
 
   // Performs backpropagation.
   // NOTE(odashi):
@@ -160,6 +236,8 @@ void Graph::backward(const Node &node) {
     // If the gradient is invalid, this operator is out of the forward path.
     if (!cur_n.grad.valid()) continue;
 
+    select_backward_stream(op_id, stream_devices);
+
     // Gathers argument value/gradient tensors.
     const std::uint32_t arg_size = cur_f.args.size();
     vector<const Tensor *> arg_values;
@@ -176,6 +254,7 @@ void Graph::backward(const Node &node) {
       if (!arg_n.grad.valid()) {
         arg_n.grad = functions::zeros<Tensor>(arg_v->shape(), arg_n.device);
       }
+      arg_n.grad_stream = arg_n.device.current_stream();
       arg_values.emplace_back(arg_v);
       arg_grads.emplace_back(&arg_n.grad);
     }
@@ -186,6 +265,8 @@ void Graph::backward(const Node &node) {
     // Deletes current gradient to suppress memory.
     cur_n.grad.invalidate();
   }
+
+  for (Device *dev : stream_devices) dev->join_streams();
 }
 
 Shape Graph::get_shape(const Node &node) const {
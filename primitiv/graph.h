@@ -10,6 +10,7 @@
 
 namespace primitiv {
 
+class CppExporter;
 class Device;
 class Graph;
 class Node;
@@ -116,6 +117,34 @@ public:
    */
   std::vector<std::uint32_t> argmin(std::uint32_t dim) const;
 
+  /**
+   * Returns indices of the k largest values along an axis of this node.
+   * @param dim A specified axis.
+   * @param k Number of elements to be retrieved from each slice.
+   * @return A list of integers that indicates positions of the k largest
+   *         values.
+   */
+  std::vector<std::uint32_t> topk(std::uint32_t dim, std::uint32_t k) const;
+
+  /**
+   * Returns the k largest values and their indices along an axis of this node.
+   * @param dim A specified axis.
+   * @param k Number of elements to be retrieved from each slice.
+   * @param values A list to store the resulting values.
+   * @return A list of integers that indicates positions of the k largest
+   *         values.
+   */
+  std::vector<std::uint32_t> topk(
+      std::uint32_t dim, std::uint32_t k, std::vector<float> &values) const;
+
+  /**
+   * Draws indices from categorical distributions along an axis of this node.
+   * @param dim A specified axis.
+   * @param k Number of distinct indices to be drawn from each slice.
+   * @return A list of sampled indices.
+   */
+  std::vector<std::uint32_t> sample(std::uint32_t dim, std::uint32_t k = 1) const;
+
   /**
    * Executes the backward operation from this node.
    */
@@ -142,6 +171,8 @@ private:
 class Graph
     : public mixins::DefaultSettable<Graph>
     , mixins::Nonmovable<Graph> {
+  friend CppExporter;
+
 public:
   Graph() = default;
   ~Graph() = default;
@@ -229,6 +260,12 @@ private:
     Tensor value;
     Tensor grad;
     std::vector<std::uint32_t> sinks;
+    // Stream which calculated `value`.
+    std::uint32_t stream;
+    // Stream which updated `grad` last.
+    std::uint32_t grad_stream;
+    // Whether `stream` is already inherited by a sink or not.
+    bool inherited;
   };
 
   /**
@@ -241,8 +278,28 @@ private:
     std::vector<NodeInfo> rets;
   };
 
+  /**
+   * Selects the stream of the device to calculate the value of the operator.
+   * The operator inherits the stream of its first argument whose stream is
+   * not inherited yet, or uses a new stream in round-robin order otherwise.
+   * @param op_id Operator ID.
+   * @param devices List of devices whose streams are used.
+   */
+  void select_forward_stream(
+      std::uint32_t op_id, std::vector<Device *> &devices);
+
+  /**
+   * Selects the stream of the device to calculate gradients of the operator.
+   * The operator uses the same stream as the forward calculation.
+   * @param op_id Operator ID.
+   * @param devices List of devices whose streams are used.
+   */
+  void select_backward_stream(
+      std::uint32_t op_id, std::vector<Device *> &devices);
+
   static Graph *default_obj_;
   std::vector<OperatorInfo> ops_;
+  std::uint32_t next_stream_ = 0;
 };
 
 inline Shape Node::shape() const {
@@ -275,6 +332,24 @@ inline std::vector<std::uint32_t> Node::argmin(std::uint32_t dim) const {
   return g_->forward(*this).argmin(dim);
 }
 
+inline std::vector<std::uint32_t> Node::topk(
+    std::uint32_t dim, std::uint32_t k) const {
+  if (!valid()) THROW_ERROR("Invalid node.");
+  return g_->forward(*this).topk(dim, k);
+}
+
+inline std::vector<std::uint32_t> Node::topk(
+    std::uint32_t dim, std::uint32_t k, std::vector<float> &values) const {
+  if (!valid()) THROW_ERROR("Invalid node.");
+  return g_->forward(*this).topk(dim, k, values);
+}
+
+inline std::vector<std::uint32_t> Node::sample(
+    std::uint32_t dim, std::uint32_t k) const {
+  if (!valid()) THROW_ERROR("Invalid node.");
+  return g_->forward(*this).sample(dim, k);
+}
+
 inline void Node::backward() const {
   if (!valid()) THROW_ERROR("Invalid node.");
   g_->backward(*this);
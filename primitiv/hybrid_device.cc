@@ -0,0 +1,835 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <primitiv/error.h>
+#include <primitiv/hybrid_device.h>
+#include <primitiv/mixins.h>
+#include <primitiv/numeric_utils.h>
+#include <primitiv/random.h>
+
+using std::cerr;
+using std::endl;
+
+namespace {
+
+// Maximum number of shifts of problem sizes used in calibration.
+// Larger problems share the selection of this size.
+constexpr std::uint32_t MAX_CALIBRATION_SHIFTS = 22;
+
+// Minimum number of elements processed by one thread.
+constexpr std::uint32_t MIN_GRAIN_SIZE = 1024;
+
+// Names of kernel classes used in keys of the tuning cache.
+const char *KERNEL_CLASS_NAMES[] = { "unary", "binary", "matmul" };
+
+}  // namespace
+
+namespace primitiv {
+namespace devices {
+
+/**
+ * Pool of worker threads owned by a Hybrid device.
+ */
+class HybridThreadPool : mixins::Nonmovable<HybridThreadPool> {
+public:
+  /**
+   * Creates worker threads.
+   * @param num_threads Number of threads including the caller thread.
+   */
+  explicit HybridThreadPool(std::uint32_t num_threads)
+  : fn_(nullptr), num_tasks_(0), next_task_(0), remaining_(0)
+  , num_active_(0), generation_(0), stop_(false) {
+    for (std::uint32_t i = 1; i < num_threads; ++i) {
+      workers_.emplace_back([this] { work(); });
+    }
+  }
+
+  ~HybridThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (std::thread &t : workers_) t.join();
+  }
+
+  /**
+   * Retrieves the number of threads including the caller thread.
+   * @return Number of threads.
+   */
+  std::uint32_t num_threads() const { return workers_.size() + 1; }
+
+  /**
+   * Runs `fn(0), fn(1), ..., fn(n - 1)` in parallel and waits for them.
+   * @param n Number of tasks.
+   * @param fn Function to run.
+   */
+  void run(std::uint32_t n, const std::function<void(std::uint32_t)> &fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      num_tasks_ = n;
+      remaining_ = n;
+      next_task_ = 0;
+      error_ = nullptr;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+    run_tasks();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] {
+        return remaining_ == 0 && num_active_ == 0;
+    });
+    fn_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+  }
+
+private:
+  void work() {
+    std::uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        if (!fn_) continue;
+        ++num_active_;
+      }
+      run_tasks();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --num_active_;
+      }
+      done_cv_.notify_all();
+    }
+  }
+
+  void run_tasks() {
+    while (true) {
+      const std::uint32_t i = next_task_.fetch_add(1);
+      if (i >= num_tasks_) break;
+      try {
+        (*fn_)(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) error_ = std::current_exception();
+      }
+      if (remaining_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_cv_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(std::uint32_t)> *fn_;
+  std::uint32_t num_tasks_;
+  std::atomic<std::uint32_t> next_task_;
+  std::atomic<std::uint32_t> remaining_;
+  std::uint32_t num_active_;
+  std::uint64_t generation_;
+  std::exception_ptr error_;
+  bool stop_;
+};
+
+Hybrid::Hybrid() : Hybrid(std::random_device()(), 0) {}
+
+Hybrid::Hybrid(std::uint32_t seed) : Hybrid(seed, 0) {}
+
+Hybrid::Hybrid(std::uint32_t seed, std::uint32_t num_threads)
+: naive_(seed)
+, eigen_(seed)
+, tuner_(Autotuner::cpu_hardware_key(), Autotuner::default_cache_path())
+, forced_(Backend::AUTO) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (num_threads > 1) pool_.reset(new HybridThreadPool(num_threads));
+  for (auto &sel : selected_) sel.fill(Backend::AUTO);
+}
+
+Hybrid::~Hybrid() {
+  // Deferred operations may use the thread pool.
+  discard_deferred_operations();
+}
+
+void Hybrid::dump_description() const {
+  cerr << "Device " << this << endl;
+  cerr << "  Type: Hybrid" << endl;
+  cerr << "  Threads: " << num_threads() << endl;
+}
+
+std::uint32_t Hybrid::num_threads() const {
+  return pool_ ? pool_->num_threads() : 1;
+}
+
+Hybrid::Backend Hybrid::select_backend(KernelClass kc, std::uint32_t size) {
+  sync_math_mode();
+  if (forced_ != Backend::AUTO) {
+    return forced_ == Backend::THREADED && !pool_ ? Backend::EIGEN : forced_;
+  }
+  const std::uint32_t sc = std::min<std::uint32_t>(
+      numeric_utils::calculate_shifts(std::max(size, 1u)),
+      ::MAX_CALIBRATION_SHIFTS);
+  Backend &sel = selected_[static_cast<std::uint32_t>(kc)][sc];
+  if (sel == Backend::AUTO) sel = calibrate(kc, sc);
+  return sel;
+}
+
+void Hybrid::sync_math_mode() {
+  naive_.set_math_mode(math_mode());
+  eigen_.set_math_mode(math_mode());
+}
+
+Hybrid::Backend Hybrid::calibrate(KernelClass kc, std::uint32_t size_class) {
+  std::vector<std::uint32_t> candidates {
+    static_cast<std::uint32_t>(Backend::NAIVE),
+    static_cast<std::uint32_t>(Backend::EIGEN),
+  };
+  if (pool_) {
+    candidates.emplace_back(static_cast<std::uint32_t>(Backend::THREADED));
+  }
+
+  // Representative kernels run on temporary buffers with the largest size in
+  // the size class. Small kernels are repeated to obtain measurable times.
+  const std::uint32_t size = 1u << size_class;
+  const std::uint32_t repeat = std::max(1u, (1u << 16) >> size_class);
+  std::function<void()> kernel;
+  std::vector<float> a, b, y;
+  switch (kc) {
+    case KernelClass::UNARY:
+      a.assign(size, .5);
+      y.resize(size);
+      kernel = [&] {
+        const Tensor x = make_view(Shape({size}), a.data());
+        Tensor yy = make_view(Shape({size}), y.data());
+        exp_fw_impl(x, yy);
+      };
+      break;
+    case KernelClass::BINARY:
+      a.assign(size, .5);
+      b.assign(size, .5);
+      y.resize(size);
+      kernel = [&] {
+        const Tensor aa = make_view(Shape({size}), a.data());
+        const Tensor bb = make_view(Shape({size}), b.data());
+        Tensor yy = make_view(Shape({size}), y.data());
+        add_fw_impl(aa, bb, yy);
+      };
+      break;
+    case KernelClass::MATMUL:
+      {
+        const std::uint32_t d = std::max(
+            1u, static_cast<std::uint32_t>(std::cbrt(static_cast<double>(size))));
+        a.assign(d * d, .5);
+        b.assign(d * d, .5);
+        y.resize(d * d);
+        kernel = [&, d] {
+          const Tensor aa = make_view(Shape({d, d}), a.data());
+          const Tensor bb = make_view(Shape({d, d}), b.data());
+          Tensor yy = make_view(Shape({d, d}), y.data());
+          matmul_fw_impl(aa, bb, yy);
+        };
+      }
+      break;
+  }
+
+  std::ostringstream key;
+  key << "hybrid." << ::KERNEL_CLASS_NAMES[static_cast<std::uint32_t>(kc)]
+      << ':' << size_class;
+  const Backend prev = forced_;
+  try {
+    const std::uint32_t ret = tuner_.select(
+        key.str(), candidates, [&](std::uint32_t c) {
+          forced_ = static_cast<Backend>(c);
+          for (std::uint32_t i = 0; i < repeat; ++i) kernel();
+        });
+    forced_ = prev;
+    return static_cast<Backend>(ret);
+  } catch (...) {
+    forced_ = prev;
+    throw;
+  }
+}
+
+void Hybrid::parallel_for(
+    std::uint32_t size, std::uint32_t grain,
+    const std::function<void(std::uint32_t, std::uint32_t)> &fn) {
+  grain = std::max(grain, 1u);
+  const std::uint32_t max_tasks = (size + grain - 1) / grain;
+  const std::uint32_t num_tasks = std::min(max_tasks, num_threads());
+  if (num_tasks <= 1) {
+    fn(0, size);
+    return;
+  }
+  // Chunks are aligned to multiples of `grain`.
+  const std::uint32_t chunk = (max_tasks + num_tasks - 1) / num_tasks * grain;
+  pool_->run(num_tasks, [&](std::uint32_t i) {
+      const std::uint32_t begin = std::min(i * chunk, size);
+      const std::uint32_t end = std::min(begin + chunk, size);
+      if (begin < end) fn(begin, end);
+  });
+}
+
+std::shared_ptr<void> Hybrid::new_handle(const Shape &shape) {
+  const std::uint32_t mem_size = sizeof(float) * shape.size();
+  void *data = std::malloc(mem_size);
+  if (!data) {
+    THROW_ERROR("Memory allocation failed. Requested size: " << mem_size);
+  }
+  return std::shared_ptr<void>(data, std::free);
+}
+
+#define CDATA(x) static_cast<const float *>(get_handle(x))
+#define MDATA(x) static_cast<float *>(get_mutable_handle(x))
+
+// Non-owning view of a range of elements.
+#define VIEW(ptr, begin, end) \
+  make_view(Shape({(end) - (begin)}), const_cast<float *>(ptr) + (begin))
+
+std::vector<float> Hybrid::tensor_to_vector_impl(const Tensor &x) {
+  return naive_.tensor_to_vector_impl(x);
+}
+
+std::vector<std::uint32_t> Hybrid::argmax_impl(
+    const Tensor &x, std::uint32_t dim) {
+  return naive_.argmax_impl(x, dim);
+}
+
+std::vector<std::uint32_t> Hybrid::argmin_impl(
+    const Tensor &x, std::uint32_t dim) {
+  return naive_.argmin_impl(x, dim);
+}
+
+void Hybrid::topk_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    std::vector<float> &values, std::vector<std::uint32_t> &ids) {
+  naive_.topk_impl(x, dim, k, values, ids);
+}
+
+void Hybrid::reset_tensor_impl(float k, Tensor &x) {
+  naive_.reset_tensor_impl(k, x);
+}
+
+void Hybrid::reset_tensor_by_array_impl(const float values[], Tensor &x) {
+  naive_.reset_tensor_by_array_impl(values, x);
+}
+
+void Hybrid::copy_tensor_impl(const Tensor &x, Tensor &y) {
+  switch (x.device().type()) {
+    case Device::DeviceType::NAIVE:
+    case Device::DeviceType::EIGEN:
+    case Device::DeviceType::HYBRID:
+      reset_tensor_by_array(CDATA(x), y);
+      break;
+    default:
+      reset_tensor_by_vector(x.to_vector(), y);
+  }
+}
+
+void Hybrid::identity_impl(Tensor &y) {
+  naive_.identity_impl(y);
+}
+
+// Random numbers are generated by the counter-based randomizer of the Eigen
+// device. Each thread calculates its own range of the sequence, and results
+// are same as those of the Eigen device regardless of the number of threads.
+#define HYBRID_RANDOM(name, ...) { \
+  PhiloxRandomizer &rng = eigen_.randomizer_; \
+  const std::uint32_t size = y.shape().size(); \
+  const std::uint64_t offset = rng.reserve(size); \
+  float *py = MDATA(y); \
+  parallel_for( \
+      size, ::MIN_GRAIN_SIZE, [&](std::uint32_t begin, std::uint32_t end) { \
+        rng.generate_##name(__VA_ARGS__, offset, begin, end, py); \
+      }); \
+}
+
+void Hybrid::random_bernoulli_impl(float p, Tensor &y) {
+  HYBRID_RANDOM(bernoulli, p);
+}
+
+void Hybrid::random_uniform_impl(float lower, float upper, Tensor &y) {
+  HYBRID_RANDOM(uniform, lower, upper);
+}
+
+void Hybrid::random_normal_impl(float mean, float sd, Tensor &y) {
+  HYBRID_RANDOM(normal, mean, sd);
+}
+
+void Hybrid::random_log_normal_impl(float mean, float sd, Tensor &y) {
+  HYBRID_RANDOM(log_normal, mean, sd);
+}
+
+#undef HYBRID_RANDOM
+
+void Hybrid::pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim,
+    Tensor &y) {
+  naive_.pick_fw_impl(x, ids, dim, y);
+}
+
+void Hybrid::slice_fw_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t offset, Tensor &y) {
+  naive_.slice_fw_impl(x, dim, offset, y);
+}
+
+void Hybrid::concat_fw_impl(
+    const std::vector<const Tensor *> &xs, std::uint32_t dim, Tensor &y) {
+  naive_.concat_fw_impl(xs, dim, y);
+}
+
+void Hybrid::batch_pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) {
+  naive_.batch_pick_fw_impl(x, ids, y);
+}
+
+void Hybrid::pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t>& ids, std::uint32_t dim,
+    Tensor &gx) {
+  naive_.pick_bw_impl(gy, ids, dim, gx);
+}
+
+void Hybrid::slice_bw_impl(
+    const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx) {
+  naive_.slice_bw_impl(gy, dim, offset, gx);
+}
+
+void Hybrid::batch_pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) {
+  naive_.batch_pick_bw_impl(gy, ids, gx);
+}
+
+void Hybrid::dropout_fw_impl(
+    const Tensor &x, float p, Tensor &mask, Tensor &y) {
+  eigen_.dropout_fw_impl(x, p, mask, y);
+}
+
+void Hybrid::dropout_bw_impl(
+    const Tensor &gy, const Tensor &mask, float p, Tensor &gx) {
+  eigen_.dropout_bw_impl(gy, mask, p, gx);
+}
+
+#define HYBRID_FW_X(name) \
+void Hybrid::name##_fw_impl(const Tensor &x, Tensor &y) { \
+  switch (select_backend(KernelClass::UNARY, x.shape().size())) { \
+    case Backend::NAIVE: \
+      naive_.name##_fw_impl(x, y); \
+      break; \
+    case Backend::EIGEN: \
+      eigen_.name##_fw_impl(x, y); \
+      break; \
+    default: \
+      { \
+        const float *px = CDATA(x); \
+        float *py = MDATA(y); \
+        parallel_for( \
+            x.shape().size(), ::MIN_GRAIN_SIZE, \
+            [&](std::uint32_t begin, std::uint32_t end) { \
+              const Tensor xx = VIEW(px, begin, end); \
+              Tensor yy = VIEW(py, begin, end); \
+              eigen_.name##_fw_impl(xx, yy); \
+            }); \
+      } \
+  } \
+}
+
+#define HYBRID_BW_X(name) \
+void Hybrid::name##_bw_impl( \
+    const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) { \
+  switch (select_backend(KernelClass::UNARY, x.shape().size())) { \
+    case Backend::NAIVE: \
+      naive_.name##_bw_impl(x, y, gy, gx); \
+      break; \
+    case Backend::EIGEN: \
+      eigen_.name##_bw_impl(x, y, gy, gx); \
+      break; \
+    default: \
+      { \
+        const float *px = CDATA(x); \
+        const float *py = CDATA(y); \
+        const float *pgy = CDATA(gy); \
+        float *pgx = MDATA(gx); \
+        parallel_for( \
+            x.shape().size(), ::MIN_GRAIN_SIZE, \
+            [&](std::uint32_t begin, std::uint32_t end) { \
+              const Tensor xx = VIEW(px, begin, end); \
+              const Tensor yy = VIEW(py, begin, end); \
+              const Tensor gyy = VIEW(pgy, begin, end); \
+              Tensor gxx = VIEW(pgx, begin, end); \
+              eigen_.name##_bw_impl(xx, yy, gyy, gxx); \
+            }); \
+      } \
+  } \
+}
+
+#define HYBRID_FW_X_CONST(name) \
+void Hybrid::name##_fw_impl(const Tensor &x, float k, Tensor &y) { \
+  switch (select_backend(KernelClass::UNARY, x.shape().size())) { \
+    case Backend::NAIVE: \
+      naive_.name##_fw_impl(x, k, y); \
+      break; \
+    case Backend::EIGEN: \
+      eigen_.name##_fw_impl(x, k, y); \
+      break; \
+    default: \
+      { \
+        const float *px = CDATA(x); \
+        float *py = MDATA(y); \
+        parallel_for( \
+            x.shape().size(), ::MIN_GRAIN_SIZE, \
+            [&](std::uint32_t begin, std::uint32_t end) { \
+              const Tensor xx = VIEW(px, begin, end); \
+              Tensor yy = VIEW(py, begin, end); \
+              eigen_.name##_fw_impl(xx, k, yy); \
+            }); \
+      } \
+  } \
+}
+
+#define HYBRID_BW_X_CONST(name) \
+void Hybrid::name##_bw_impl( \
+    const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) { \
+  switch (select_backend(KernelClass::UNARY, x.shape().size())) { \
+    case Backend::NAIVE: \
+      naive_.name##_bw_impl(x, y, gy, k, gx); \
+      break; \
+    case Backend::EIGEN: \
+      eigen_.name##_bw_impl(x, y, gy, k, gx); \
+      break; \
+    default: \
+      { \
+        const float *px = CDATA(x); \
+        const float *py = CDATA(y); \
+        const float *pgy = CDATA(gy); \
+        float *pgx = MDATA(gx); \
+        parallel_for( \
+            x.shape().size(), ::MIN_GRAIN_SIZE, \
+            [&](std::uint32_t begin, std::uint32_t end) { \
+              const Tensor xx = VIEW(px, begin, end); \
+              const Tensor yy = VIEW(py, begin, end); \
+              const Tensor gyy = VIEW(pgy, begin, end); \
+              Tensor gxx = VIEW(pgx, begin, end); \
+              eigen_.name##_bw_impl(xx, yy, gyy, k, gxx); \
+            }); \
+      } \
+  } \
+}
+
+// Operations with scalar tensors are not distributed because of the
+// broadcasting along the minibatch.
+#define HYBRID_FW_X_SCALAR(name) \
+void Hybrid::name##_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) { \
+  if (select_backend(KernelClass::UNARY, y.shape().size()) \
+      == Backend::NAIVE) { \
+    naive_.name##_fw_impl(x, k, y); \
+  } else { \
+    eigen_.name##_fw_impl(x, k, y); \
+  } \
+}
+
+#define HYBRID_FW_AB(name) \
+void Hybrid::name##_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) { \
+  const Backend backend = select_backend( \
+      KernelClass::BINARY, y.shape().size()); \
+  if (backend == Backend::NAIVE) { \
+    naive_.name##_fw_impl(a, b, y); \
+  } else if (backend == Backend::EIGEN || a.shape() != b.shape()) { \
+    eigen_.name##_fw_impl(a, b, y); \
+  } else { \
+    const float *pa = CDATA(a); \
+    const float *pb = CDATA(b); \
+    float *py = MDATA(y); \
+    parallel_for( \
+        y.shape().size(), ::MIN_GRAIN_SIZE, \
+        [&](std::uint32_t begin, std::uint32_t end) { \
+          const Tensor aa = VIEW(pa, begin, end); \
+          const Tensor bb = VIEW(pb, begin, end); \
+          Tensor yy = VIEW(py, begin, end); \
+          eigen_.name##_fw_impl(aa, bb, yy); \
+        }); \
+  } \
+}
+
+#define HYBRID_BW_AB(name) \
+void Hybrid::name##_bw_impl( \
+    const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy, \
+    Tensor &ga, Tensor &gb) { \
+  const Backend backend = select_backend( \
+      KernelClass::BINARY, y.shape().size()); \
+  if (backend == Backend::NAIVE) { \
+    naive_.name##_bw_impl(a, b, y, gy, ga, gb); \
+  } else if (backend == Backend::EIGEN || a.shape() != b.shape()) { \
+    eigen_.name##_bw_impl(a, b, y, gy, ga, gb); \
+  } else { \
+    const float *pa = CDATA(a); \
+    const float *pb = CDATA(b); \
+    const float *py = CDATA(y); \
+    const float *pgy = CDATA(gy); \
+    float *pga = MDATA(ga); \
+    float *pgb = MDATA(gb); \
+    parallel_for( \
+        y.shape().size(), ::MIN_GRAIN_SIZE, \
+        [&](std::uint32_t begin, std::uint32_t end) { \
+          const Tensor aa = VIEW(pa, begin, end); \
+          const Tensor bb = VIEW(pb, begin, end); \
+          const Tensor yy = VIEW(py, begin, end); \
+          const Tensor gyy = VIEW(pgy, begin, end); \
+          Tensor gaa = VIEW(pga, begin, end); \
+          Tensor gbb = VIEW(pgb, begin, end); \
+          eigen_.name##_bw_impl(aa, bb, yy, gyy, gaa, gbb); \
+        }); \
+  } \
+}
+
+HYBRID_FW_X(negate);
+HYBRID_FW_X(sqrt);
+HYBRID_FW_X(exp);
+HYBRID_FW_X(log);
+HYBRID_FW_X(tanh);
+HYBRID_FW_X(sigmoid);
+HYBRID_FW_X(softplus);
+HYBRID_FW_X(sin);
+HYBRID_FW_X(cos);
+HYBRID_FW_X(tan);
+
+HYBRID_BW_X(sqrt);
+HYBRID_BW_X(exp);
+HYBRID_BW_X(log);
+HYBRID_BW_X(tanh);
+HYBRID_BW_X(sigmoid);
+HYBRID_BW_X(softplus);
+HYBRID_BW_X(sin);
+HYBRID_BW_X(cos);
+HYBRID_BW_X(tan);
+
+HYBRID_FW_X_CONST(add_const);
+HYBRID_FW_X_CONST(subtract_const_r);
+HYBRID_FW_X_CONST(subtract_const_l);
+HYBRID_FW_X_CONST(multiply_const);
+HYBRID_FW_X_CONST(divide_const_r);
+HYBRID_FW_X_CONST(divide_const_l);
+HYBRID_FW_X_CONST(pow_const_r);
+HYBRID_FW_X_CONST(pow_const_l);
+HYBRID_FW_X_CONST(prelu);
+HYBRID_FW_X_CONST(elu);
+
+HYBRID_BW_X_CONST(add_const);
+HYBRID_BW_X_CONST(subtract_const_r);
+HYBRID_BW_X_CONST(subtract_const_l);
+HYBRID_BW_X_CONST(multiply_const);
+HYBRID_BW_X_CONST(divide_const_r);
+HYBRID_BW_X_CONST(divide_const_l);
+HYBRID_BW_X_CONST(pow_const_r);
+HYBRID_BW_X_CONST(pow_const_l);
+HYBRID_BW_X_CONST(prelu);
+HYBRID_BW_X_CONST(elu);
+
+HYBRID_FW_X_SCALAR(add_scalar);
+HYBRID_FW_X_SCALAR(subtract_scalar_r);
+HYBRID_FW_X_SCALAR(subtract_scalar_l);
+HYBRID_FW_X_SCALAR(multiply_scalar);
+HYBRID_FW_X_SCALAR(divide_scalar_r);
+HYBRID_FW_X_SCALAR(divide_scalar_l);
+HYBRID_FW_X_SCALAR(pow_scalar_r);
+HYBRID_FW_X_SCALAR(pow_scalar_l);
+
+HYBRID_FW_AB(add);
+HYBRID_FW_AB(subtract);
+HYBRID_FW_AB(multiply);
+HYBRID_FW_AB(divide);
+HYBRID_FW_AB(pow);
+
+HYBRID_BW_AB(add);
+HYBRID_BW_AB(subtract);
+HYBRID_BW_AB(multiply);
+HYBRID_BW_AB(divide);
+HYBRID_BW_AB(pow);
+
+#undef HYBRID_FW_X
+#undef HYBRID_BW_X
+#undef HYBRID_FW_X_CONST
+#undef HYBRID_BW_X_CONST
+#undef HYBRID_FW_X_SCALAR
+#undef HYBRID_FW_AB
+#undef HYBRID_BW_AB
+
+void Hybrid::transpose_fw_impl(const Tensor &x, Tensor &y) {
+  if (select_backend(KernelClass::UNARY, x.shape().size()) == Backend::NAIVE) {
+    naive_.transpose_fw_impl(x, y);
+  } else {
+    eigen_.transpose_fw_impl(x, y);
+  }
+}
+
+void Hybrid::transpose_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) {
+  // NOTE: Naive::transpose_bw_impl() uses other functions of its own device.
+  eigen_.transpose_bw_impl(x, y, gy, gx);
+}
+
+void Hybrid::matmul_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) {
+  const std::uint32_t d1 = a.shape()[0];
+  const std::uint32_t d2 = a.shape()[1];
+  const std::uint32_t d3 = b.shape()[1];
+  const std::uint32_t bs = y.shape().batch();
+  const std::uint64_t volume = static_cast<std::uint64_t>(d1) * d2 * d3 * bs;
+  const std::uint32_t size = static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(volume, 0xffffffffu));
+  switch (select_backend(KernelClass::MATMUL, size)) {
+    case Backend::NAIVE:
+      naive_.matmul_fw_impl(a, b, y);
+      return;
+    case Backend::EIGEN:
+      eigen_.matmul_fw_impl(a, b, y);
+      return;
+    default:
+      break;
+  }
+
+  const float *pa = CDATA(a);
+  const float *pb = CDATA(b);
+  float *py = MDATA(y);
+  if (!a.shape().has_batch()) {
+    // Distributes columns of the combined matrix of `b`.
+    const std::uint32_t grain = std::max(
+        1u, ::MIN_GRAIN_SIZE / std::max(1u, d1 * d2));
+    parallel_for(
+        d3 * bs, grain, [&](std::uint32_t begin, std::uint32_t end) {
+          const Tensor bb = make_view(
+              Shape({d2, end - begin}), const_cast<float *>(pb) + begin * d2);
+          Tensor yy = make_view(Shape({d1, end - begin}), py + begin * d1);
+          eigen_.matmul_fw_impl(a, bb, yy);
+        });
+  } else {
+    // Distributes minibatch elements.
+    const bool b_batch = b.shape().has_batch();
+    parallel_for(bs, 1, [&](std::uint32_t begin, std::uint32_t end) {
+        const std::uint32_t n = end - begin;
+        const Tensor aa = make_view(
+            Shape({d1, d2}, n), const_cast<float *>(pa) + begin * d1 * d2);
+        const Tensor bb = b_batch
+          ? make_view(
+              Shape({d2, d3}, n), const_cast<float *>(pb) + begin * d2 * d3)
+          : b;
+        Tensor yy = make_view(Shape({d1, d3}, n), py + begin * d1 * d3);
+        eigen_.matmul_fw_impl(aa, bb, yy);
+    });
+  }
+}
+
+void Hybrid::matmul_bw_impl(
+    const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+    Tensor &ga, Tensor &gb) {
+  // NOTE: Naive::matmul_bw_impl() uses other functions of its own device.
+  eigen_.matmul_bw_impl(a, b, y, gy, ga, gb);
+}
+
+void Hybrid::sum_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  naive_.sum_fw_impl(x, dim, y);
+}
+
+void Hybrid::logsumexp_fw_impl(
+    const Tensor &x, std::uint32_t dim, Tensor &y) {
+  naive_.logsumexp_fw_impl(x, dim, y);
+}
+
+void Hybrid::max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  naive_.max_fw_impl(x, dim, y);
+}
+
+void Hybrid::min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  naive_.min_fw_impl(x, dim, y);
+}
+
+void Hybrid::squared_norm_fw_impl(
+    const Tensor &x, std::uint32_t dim, Tensor &y) {
+  naive_.squared_norm_fw_impl(x, dim, y);
+}
+
+void Hybrid::broadcast_fw_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) {
+  naive_.broadcast_fw_impl(x, dim, size, y);
+}
+
+void Hybrid::batch_sum_fw_impl(const Tensor &x, Tensor &y) {
+  naive_.batch_sum_fw_impl(x, y);
+}
+
+void Hybrid::max_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  naive_.max_bw_impl(x, y, gy, dim, gx);
+}
+
+void Hybrid::min_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  naive_.min_bw_impl(x, y, gy, dim, gx);
+}
+
+void Hybrid::inplace_multiply_const_impl(float k, Tensor &x) {
+  switch (select_backend(KernelClass::UNARY, x.shape().size())) {
+    case Backend::NAIVE:
+      naive_.inplace_multiply_const_impl(k, x);
+      break;
+    case Backend::EIGEN:
+      eigen_.inplace_multiply_const_impl(k, x);
+      break;
+    default:
+      {
+        float *px = MDATA(x);
+        parallel_for(
+            x.shape().size(), ::MIN_GRAIN_SIZE,
+            [&](std::uint32_t begin, std::uint32_t end) {
+              Tensor xx = VIEW(px, begin, end);
+              eigen_.inplace_multiply_const_impl(k, xx);
+            });
+      }
+  }
+}
+
+#define HYBRID_INPLACE_AB(name) \
+void Hybrid::inplace_##name##_impl(const Tensor &x, Tensor &y) { \
+  const Backend backend = select_backend( \
+      KernelClass::BINARY, y.shape().size()); \
+  if (backend == Backend::NAIVE) { \
+    naive_.inplace_##name##_impl(x, y); \
+  } else if (backend == Backend::EIGEN || x.shape() != y.shape()) { \
+    eigen_.inplace_##name##_impl(x, y); \
+  } else { \
+    const float *px = CDATA(x); \
+    float *py = MDATA(y); \
+    parallel_for( \
+        y.shape().size(), ::MIN_GRAIN_SIZE, \
+        [&](std::uint32_t begin, std::uint32_t end) { \
+          const Tensor xx = VIEW(px, begin, end); \
+          Tensor yy = VIEW(py, begin, end); \
+          eigen_.inplace_##name##_impl(xx, yy); \
+        }); \
+  } \
+}
+
+HYBRID_INPLACE_AB(add);
+HYBRID_INPLACE_AB(subtract);
+
+#undef HYBRID_INPLACE_AB
+#undef VIEW
+
+}  // namespace devices
+}  // namespace primitiv
@@ -0,0 +1,281 @@
+#ifndef PRIMITIV_HYBRID_DEVICE_H_
+#define PRIMITIV_HYBRID_DEVICE_H_
+
+#include <array>
+#include <memory>
+
+#include <primitiv/autotuner.h>
+#include <primitiv/device.h>
+#include <primitiv/eigen_device.h>
+#include <primitiv/naive_device.h>
+
+namespace primitiv {
+namespace devices {
+
+class HybridThreadPool;
+
+/**
+ * Device class which dispatches each call to the Naive, Eigen or multithreaded
+ * implementations.
+ *
+ * Kernels are categorized into some classes, and the implementation of each
+ * call is selected by the class and the number of elements. The fastest
+ * implementation for each pair of the class and the power-of-2 size range is
+ * calibrated on first use by benchmarking a representative kernel, and stored
+ * through Autotuner (see also the `PRIMITIV_TUNING_CACHE` environment
+ * variable).
+ *
+ * Kernels without any difference between Naive and Eigen (e.g., reductions
+ * and array manipulations) always use the Naive implementations.
+ *
+ * Random numbers are generated in parallel by the counter-based randomizer.
+ * Results with the same seed are identical to those of
+ * primitiv::devices::Eigen and do not depend on the number of threads.
+ */
+class Hybrid : public Device {
+public:
+  /**
+   * Implementations of kernels.
+   */
+  enum class Backend : std::uint32_t {
+    /**
+     * Selects the implementation automatically.
+     */
+    AUTO = 0,
+
+    /**
+     * Implementations of primitiv::devices::Naive.
+     */
+    NAIVE = 1,
+
+    /**
+     * Implementations of primitiv::devices::Eigen.
+     */
+    EIGEN = 2,
+
+    /**
+     * Implementations of primitiv::devices::Eigen distributed over multiple
+     * threads.
+     */
+    THREADED = 3,
+  };
+
+  /**
+   * Classes of kernels which share the same selection.
+   */
+  enum class KernelClass : std::uint32_t {
+    /**
+     * Elementwise operations with one tensor argument.
+     */
+    UNARY = 0,
+
+    /**
+     * Elementwise operations with two tensor arguments.
+     */
+    BINARY = 1,
+
+    /**
+     * Matrix multiplication. The size is the number of multiply-adds.
+     */
+    MATMUL = 2,
+  };
+
+  /**
+   * Creates a Hybrid object.
+   */
+  Hybrid();
+
+  /**
+   * Creates a Hybrid object.
+   * @param seed The seed value of internal random number generator.
+   */
+  explicit Hybrid(std::uint32_t seed);
+
+  /**
+   * Creates a Hybrid object.
+   * @param seed The seed value of internal random number generator.
+   * @param num_threads Maximum number of threads used by each kernel. If 0,
+   *                    the number of hardware threads is used.
+   */
+  Hybrid(std::uint32_t seed, std::uint32_t num_threads);
+
+  ~Hybrid() override;
+
+  void dump_description() const override;
+  Device::DeviceType type() const override { return Device::DeviceType::HYBRID; }
+
+  /**
+   * Retrieves the number of threads used by each kernel.
+   * @return The number of threads.
+   */
+  std::uint32_t num_threads() const;
+
+  /**
+   * Selects the implementation of kernels.
+   * @param kc Class of the kernel.
+   * @param size Size of the problem.
+   * @return Backend::NAIVE, Backend::EIGEN or Backend::THREADED.
+   * @remarks This function calibrates the selection if it is not determined
+   *          yet.
+   */
+  Backend select_backend(KernelClass kc, std::uint32_t size);
+
+  /**
+   * Forces all kernels to use the specified implementation.
+   * @param backend Implementation to be used, or Backend::AUTO to restore the
+   *                automatic selection.
+   */
+  void force_backend(Backend backend) { forced_ = backend; }
+
+private:
+  std::shared_ptr<void> new_handle(const Shape &shape) override;
+  bool has_linear_memory() const override { return true; }
+
+  std::vector<float> tensor_to_vector_impl(const Tensor &x) override;
+  std::vector<std::uint32_t> argmax_impl(const Tensor &x, std::uint32_t dim) override;
+  std::vector<std::uint32_t> argmin_impl(const Tensor &x, std::uint32_t dim) override;
+  void topk_impl(const Tensor &x, std::uint32_t dim, std::uint32_t k, std::vector<float> &values, std::vector<std::uint32_t> &ids) override;
+
+  void reset_tensor_impl(float k, Tensor &x) override;
+  void reset_tensor_by_array_impl(const float values[], Tensor &x) override;
+
+  void copy_tensor_impl(const Tensor &x, Tensor &y) override;
+
+  void identity_impl(Tensor &y) override;
+
+  void random_bernoulli_impl(float p, Tensor &y) override;
+  void random_uniform_impl(float lower, float upper, Tensor &y) override;
+  void random_normal_impl(float mean, float sd, Tensor &y) override;
+  void random_log_normal_impl(float mean, float sd, Tensor &y) override;
+
+  void pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &y) override;
+  void slice_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t offset, Tensor &y) override;
+  void concat_fw_impl(const std::vector<const Tensor *> &xs, std::uint32_t dim, Tensor &y) override;
+  void batch_pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) override;
+
+  void pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &gx) override;
+  void slice_bw_impl(const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx) override;
+  void batch_pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) override;
+
+  void dropout_fw_impl(const Tensor &x, float p, Tensor &mask, Tensor &y) override;
+  void dropout_bw_impl(const Tensor &gy, const Tensor &mask, float p, Tensor &gx) override;
+
+  void negate_fw_impl(const Tensor &x, Tensor &y) override;
+  void sqrt_fw_impl(const Tensor &x, Tensor &y) override;
+  void exp_fw_impl(const Tensor &x, Tensor &y) override;
+  void log_fw_impl(const Tensor &x, Tensor &y) override;
+  void tanh_fw_impl(const Tensor &x, Tensor &y) override;
+  void sigmoid_fw_impl(const Tensor &x, Tensor &y) override;
+  void softplus_fw_impl(const Tensor &x, Tensor &y) override;
+  void sin_fw_impl(const Tensor &x, Tensor &y) override;
+  void cos_fw_impl(const Tensor &x, Tensor &y) override;
+  void tan_fw_impl(const Tensor &x, Tensor &y) override;
+  void transpose_fw_impl(const Tensor &x, Tensor &y) override;
+
+  void sqrt_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void exp_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void log_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void tanh_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void sigmoid_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void softplus_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void sin_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void cos_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void tan_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+  void transpose_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) override;
+
+  void add_const_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void subtract_const_r_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void subtract_const_l_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void multiply_const_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void divide_const_r_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void divide_const_l_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void pow_const_r_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void pow_const_l_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void prelu_fw_impl(const Tensor &x, float k, Tensor &y) override;
+  void elu_fw_impl(const Tensor &x, float k, Tensor &y) override;
+
+  void add_const_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void subtract_const_r_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void subtract_const_l_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void multiply_const_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void divide_const_r_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void divide_const_l_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void pow_const_r_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void pow_const_l_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void prelu_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+  void elu_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, float k, Tensor &gx) override;
+
+  void add_scalar_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void subtract_scalar_r_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void subtract_scalar_l_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void multiply_scalar_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void divide_scalar_r_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void divide_scalar_l_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void pow_scalar_r_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+  void pow_scalar_l_fw_impl(const Tensor &x, const Tensor &k, Tensor &y) override;
+
+  void add_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+  void subtract_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+  void multiply_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+  void divide_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+  void pow_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+  void matmul_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) override;
+
+  void add_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+  void subtract_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+  void multiply_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+  void divide_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+  void pow_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+  void matmul_bw_impl(
+      const Tensor &a, const Tensor &b, const Tensor &y, const Tensor &gy,
+      Tensor &ga, Tensor &gb) override;
+
+  void sum_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void squared_norm_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void broadcast_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) override;
+  void batch_sum_fw_impl(const Tensor &x, Tensor &y) override;
+
+  void max_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+  void min_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+
+  void inplace_multiply_const_impl(float k, Tensor &x) override;
+
+  void inplace_add_impl(const Tensor &x, Tensor &y) override;
+  void inplace_subtract_impl(const Tensor &x, Tensor &y) override;
+
+private:
+  static constexpr std::uint32_t NUM_KERNEL_CLASSES = 3;
+  static constexpr std::uint32_t NUM_SIZE_CLASSES = 33;
+
+  void sync_math_mode();
+  Backend calibrate(KernelClass kc, std::uint32_t size_class);
+  void parallel_for(
+      std::uint32_t size, std::uint32_t grain,
+      const std::function<void(std::uint32_t, std::uint32_t)> &fn);
+
+  Naive naive_;
+  Eigen eigen_;
+  std::unique_ptr<HybridThreadPool> pool_;
+  Autotuner tuner_;
+  Backend forced_;
+  std::array<
+    std::array<Backend, NUM_SIZE_CLASSES>, NUM_KERNEL_CLASSES> selected_;
+};
+
+}  // namespace devices
+}  // namespace primitiv
+
+#endif  // PRIMITIV_HYBRID_DEVICE_H_
@@ -5,12 +5,54 @@
 #include <cstring>
 #include <cmath>
 #include <iostream>
+#include <sstream>
 #include <primitiv/naive_device.h>
 #include <primitiv/error.h>
+#include <primitiv/numeric_utils.h>
+#include <primitiv/small_kernels.h>
 
 using std::cerr;
 using std::endl;
 
+namespace {
+
+/**
+ * Calculates one matrix multiplication y = a . b with tiling.
+ * @param a Pointer to the d1xd2 matrix.
+ * @param b Pointer to the d2xd3 matrix.
+ * @param y Pointer to the d1xd3 resulting matrix.
+ * @param tile Tile size of rows/columns of the resulting matrix.
+ */
+void matmul_blocked(
+    const float *a, const float *b, float *y,
+    std::uint32_t d1, std::uint32_t d2, std::uint32_t d3, std::uint32_t tile) {
+  for (std::uint32_t n = 0; n < d1 * d3; ++n) {
+    y[n] = 0;
+  }
+  for (std::uint32_t k = 0; k < d3; k += tile) {
+    const std::uint32_t ek = std::min(k + tile, d3);
+    for (std::uint32_t i = 0; i < d1; i += tile) {
+      const std::uint32_t ei = std::min(i + tile, d1);
+      for (std::uint32_t j = 0; j < d2; j += 8) {
+        const std::uint32_t ej = std::min(j + 8, d2);
+        for (std::uint32_t kk = k; kk < ek; ++kk) {
+          const std::uint32_t kk_d1 = kk * d1;
+          const std::uint32_t kk_d2 = kk * d2;
+          for (std::uint32_t ii = i; ii < ei; ++ii) {
+            float tmp = 0;
+            for (std::uint32_t jj = j; jj < ej; ++jj) {
+              tmp += a[ii + jj * d1] * b[jj + kk_d2];
+            }
+            y[ii + kk_d1] += tmp;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 namespace primitiv {
 namespace devices {
 
@@ -91,6 +133,38 @@ std::vector<std::uint32_t> Naive::argmin_impl(const Tensor &x, std::uint32_t dim
   return ret;
 }
 
+void Naive::topk_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    std::vector<float> &values, std::vector<std::uint32_t> &ids) {
+  const Shape &s = x.shape();
+  const std::uint32_t n = s[dim];
+  const std::uint32_t repeat = s.size() / n;
+  const std::uint32_t skip1 = s.lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  const float *src = CDATA(x);
+  values.clear();
+  values.reserve(repeat * k);
+  ids.clear();
+  ids.reserve(repeat * k);
+  std::vector<std::uint32_t> buf(n);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    const float *src_i = src + i % skip1 + (i / skip1) * skip2;
+    for (std::uint32_t j = 0; j < n; ++j) buf[j] = j;
+    // NOTE: Only the first k elements are ordered by partial_sort.
+    std::partial_sort(
+        buf.begin(), buf.begin() + k, buf.end(),
+        [src_i, skip1](std::uint32_t a, std::uint32_t b) {
+          const float va = src_i[a * skip1];
+          const float vb = src_i[b * skip1];
+          return va > vb || (va == vb && a < b);
+        });
+    for (std::uint32_t j = 0; j < k; ++j) {
+      values.emplace_back(src_i[buf[j] * skip1]);
+      ids.emplace_back(buf[j]);
+    }
+  }
+}
+
 void Naive::reset_tensor_impl(float k, Tensor &x) {
   float *dest = MDATA(x);
   const std::uint32_t size = x.shape().size();
@@ -198,6 +272,16 @@ void Naive::concat_fw_impl(
   }
 }
 
+void Naive::batch_pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) {
+  const std::uint32_t size = x.shape().volume();
+  float *dest = MDATA(y);
+  for (const std::uint32_t id : ids) {
+    const float *src = CDATA(x) + id * size;
+    REPEAT_OP(i, size, *dest++ = *src++);
+  }
+}
+
 void Naive::pick_bw_impl(
     const Tensor &gy, const std::vector<std::uint32_t>& ids, std::uint32_t dim,
     Tensor &gx) {
@@ -244,6 +328,40 @@ void Naive::slice_bw_impl(
   }
 }
 
+void Naive::batch_pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) {
+  const std::uint32_t size = gx.shape().volume();
+  const float *src = CDATA(gy);
+  for (const std::uint32_t id : ids) {
+    float *dest = MDATA(gx) + id * size;
+    REPEAT_OP(i, size, *dest++ += *src++);
+  }
+}
+
+void Naive::dropout_fw_impl(
+    const Tensor &x, float p, Tensor &mask, Tensor &y) {
+  const std::uint32_t size = x.shape().size();
+  const float scale = 1. / p;
+  std::uint32_t *pm = static_cast<std::uint32_t *>(get_mutable_handle(mask));
+  randomizer_.fill_bernoulli_bits(p, size, pm);
+  const float *px = CDATA(x);
+  float *py = MDATA(y);
+  REPEAT_OP(i, size,
+      py[i] = (pm[i >> 5] >> (i & 31)) & 1 ? px[i] * scale : 0);
+}
+
+void Naive::dropout_bw_impl(
+    const Tensor &gy, const Tensor &mask, float p, Tensor &gx) {
+  const std::uint32_t size = gy.shape().size();
+  const float scale = 1. / p;
+  const std::uint32_t *pm = static_cast<const std::uint32_t *>(
+      get_handle(mask));
+  const float *pgy = CDATA(gy);
+  float *pgx = MDATA(gx);
+  REPEAT_OP(i, size,
+      pgx[i] += (pm[i >> 5] >> (i & 31)) & 1 ? pgy[i] * scale : 0);
+}
+
 #define CPUDEV_FW_X(name, op) \
 void Naive::name##_fw_impl(const Tensor &x, Tensor &y) { \
   float *dest = MDATA(y); \
@@ -263,6 +381,35 @@ void Naive::name##_bw_impl( \
   REPEAT_OP(i, size, pgx[i] += (op)); \
 }
 
+// Same as CPUDEV_FW_X, but uses `fast_op` in MathMode::FAST.
+#define CPUDEV_FW_X_MATH(name, op, fast_op) \
+void Naive::name##_fw_impl(const Tensor &x, Tensor &y) { \
+  float *dest = MDATA(y); \
+  const float *src = CDATA(x); \
+  const std::uint32_t size = x.shape().size(); \
+  if (math_mode() == MathMode::FAST) { \
+    REPEAT_OP(i, size, dest[i] = (fast_op)); \
+  } else { \
+    REPEAT_OP(i, size, dest[i] = (op)); \
+  } \
+}
+
+// Same as CPUDEV_BW_X, but uses `fast_op` in MathMode::FAST.
+#define CPUDEV_BW_X_MATH(name, op, fast_op) \
+void Naive::name##_bw_impl( \
+    const Tensor &x, const Tensor &y, const Tensor &gy, Tensor &gx) { \
+  const float *px = CDATA(x); static_cast<void>(px); \
+  const float *py = CDATA(y); static_cast<void>(py); \
+  const float *pgy = CDATA(gy); \
+  float *pgx = MDATA(gx); \
+  const std::uint32_t size = x.shape().size(); \
+  if (math_mode() == MathMode::FAST) { \
+    REPEAT_OP(i, size, pgx[i] += (fast_op)); \
+  } else { \
+    REPEAT_OP(i, size, pgx[i] += (op)); \
+  } \
+}
+
 #define CPUDEV_FW_X_CONST(name, op) \
 void Naive::name##_fw_impl(const Tensor &x, float k, Tensor &y) { \
   float *dest = MDATA(y); \
@@ -318,14 +465,20 @@ void Naive::name##_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) { \
 
 CPUDEV_FW_X(negate, -src[i]);
 CPUDEV_FW_X(sqrt, std::sqrt(src[i]));
-CPUDEV_FW_X(exp, std::exp(src[i]));
-CPUDEV_FW_X(log, std::log(src[i]));
-CPUDEV_FW_X(tanh, std::tanh(src[i]));
-CPUDEV_FW_X(sigmoid, .5 + .5 * std::tanh(.5 * src[i]));
-CPUDEV_FW_X(
+CPUDEV_FW_X_MATH(
+    exp, std::exp(src[i]), numeric_utils::fast_exp(src[i]));
+CPUDEV_FW_X_MATH(
+    log, std::log(src[i]), numeric_utils::fast_log(src[i]));
+CPUDEV_FW_X_MATH(
+    tanh, std::tanh(src[i]), numeric_utils::fast_tanh(src[i]));
+CPUDEV_FW_X_MATH(
+    sigmoid, .5 + .5 * std::tanh(.5 * src[i]),
+    numeric_utils::fast_sigmoid(src[i]));
+CPUDEV_FW_X_MATH(
     softplus, src[i] > 0
       ? src[i] + std::log(1 + std::exp(-src[i]))
-      : std::log(1 + std::exp(src[i])));
+      : std::log(1 + std::exp(src[i])),
+    numeric_utils::fast_softplus(src[i]));
 CPUDEV_FW_X(sin, std::sin(src[i]));
 CPUDEV_FW_X(cos, std::cos(src[i]));
 CPUDEV_FW_X(tan, std::tan(src[i]));
@@ -335,7 +488,9 @@ CPUDEV_BW_X(exp, py[i] * pgy[i]);
 CPUDEV_BW_X(log, pgy[i] / px[i]);
 CPUDEV_BW_X(tanh, (1. - py[i] * py[i]) * pgy[i]);
 CPUDEV_BW_X(sigmoid, py[i] * (1. - py[i]) * pgy[i]);
-CPUDEV_BW_X(softplus, (.5 + .5 * std::tanh(.5 * px[i])) * pgy[i]);
+CPUDEV_BW_X_MATH(
+    softplus, (.5 + .5 * std::tanh(.5 * px[i])) * pgy[i],
+    numeric_utils::fast_sigmoid(px[i]) * pgy[i]);
 CPUDEV_BW_X(sin, std::cos(px[i]) * pgy[i]);
 CPUDEV_BW_X(cos, -std::sin(px[i]) * pgy[i]);
 CPUDEV_BW_X(tan, (1 + py[i] * py[i]) * pgy[i]);
@@ -380,6 +535,8 @@ CPUDEV_FW_AB(pow, std::pow(src_a[i], src_b[i]));
 
 #undef CPUDEV_FW_X
 #undef CPUDEV_BW_X
+#undef CPUDEV_FW_X_MATH
+#undef CPUDEV_BW_X_MATH
 #undef CPUDEV_FW_X_CONST
 #undef CPUDEV_BW_X_CONST
 #undef CPUDEV_FW_X_SCALAR
@@ -544,30 +701,35 @@ void Naive::matmul_fw_impl(const Tensor &a, const Tensor &b, Tensor &y) {
   const float *src_a = CDATA(a);
   const float *src_b = CDATA(b);
 
-  for (std::uint32_t batch = 0; batch < bs; ++batch) {
-    for (std::uint32_t n = 0; n < dest_shift; ++n) {
-      dest[n] = 0;
-    }
-    for (std::uint32_t k = 0; k < d3; k += 8) {
-      const std::uint32_t ek = std::min(k + 8, d3);
-      for (std::uint32_t i = 0; i < d1; i += 8) {
-        const std::uint32_t ei = std::min(i + 8, d1);
-        for (std::uint32_t j = 0; j < d2; j += 8) {
-          const std::uint32_t ej = std::min(j + 8, d2);
-          for (std::uint32_t kk = k; kk < ek; ++kk) {
-            const std::uint32_t kk_d1 = kk * d1;
-            const std::uint32_t kk_d2 = kk * d2;
-            for (std::uint32_t ii = i; ii < ei; ++ii) {
-              float tmp = 0;
-              for (std::uint32_t jj = j; jj < ej; ++jj) {
-                tmp += src_a[ii + jj * d1] * src_b[jj + kk_d2];
-              }
-              dest[ii + kk_d1] += tmp;
-            }
-          }
-        }
-      }
+  const auto kernel = small_kernels::get_matmul_kernel(d1, d3);
+  if (kernel) {
+    // Small matrices: uses the kernel specialized for the shape.
+    for (std::uint32_t batch = 0; batch < bs; ++batch) {
+      kernel(src_a, src_b, dest, d2);
+      dest += dest_shift;
+      src_a += src_a_shift;
+      src_b += src_b_shift;
     }
+    return;
+  }
+
+  // The tile size of the resulting matrix is tuned for each class of shapes.
+  // The blocking of the inner dimension is fixed to keep results identical
+  // regardless of the selected tile size.
+  std::uint32_t tile = 8;
+  if (static_cast<std::uint64_t>(d1) * d2 * d3 >= 32 * 32 * 32) {
+    std::ostringstream key;
+    key << "naive.matmul_fw:"
+        << numeric_utils::calculate_shifts(d1) << ','
+        << numeric_utils::calculate_shifts(d2) << ','
+        << numeric_utils::calculate_shifts(d3);
+    tile = tuner_.select(key.str(), {8, 16, 32, 64}, [&](std::uint32_t t) {
+        ::matmul_blocked(src_a, src_b, dest, d1, d2, d3, t);
+    });
+  }
+
+  for (std::uint32_t batch = 0; batch < bs; ++batch) {
+    ::matmul_blocked(src_a, src_b, dest, d1, d2, d3, tile);
     dest += dest_shift;
     src_a += src_a_shift;
     src_b += src_b_shift;
@@ -628,6 +790,61 @@ void Naive::logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
   }
 }
 
+void Naive::max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t repeat = y.shape().size();
+  const std::uint32_t skip1 = y.shape().lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  float *dest = MDATA(y);
+  const float *src = CDATA(x);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    std::uint32_t offset = i % skip1 + (i / skip1) * skip2;
+    float tmp = src[offset];
+    for (std::uint32_t j = 1; j < n; ++j) {
+      offset += skip1;
+      if (src[offset] > tmp) tmp = src[offset];
+    }
+    dest[i] = tmp;
+  }
+}
+
+void Naive::min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t repeat = y.shape().size();
+  const std::uint32_t skip1 = y.shape().lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  float *dest = MDATA(y);
+  const float *src = CDATA(x);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    std::uint32_t offset = i % skip1 + (i / skip1) * skip2;
+    float tmp = src[offset];
+    for (std::uint32_t j = 1; j < n; ++j) {
+      offset += skip1;
+      if (src[offset] < tmp) tmp = src[offset];
+    }
+    dest[i] = tmp;
+  }
+}
+
+void Naive::squared_norm_fw_impl(
+    const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t repeat = y.shape().size();
+  const std::uint32_t skip1 = y.shape().lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  float *dest = MDATA(y);
+  const float *src = CDATA(x);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    std::uint32_t offset = i % skip1 + (i / skip1) * skip2;
+    float tmp = 0;
+    for (std::uint32_t j = 0; j < n; ++j) {
+      tmp += src[offset] * src[offset];
+      offset += skip1;
+    }
+    dest[i] = tmp;
+  }
+}
+
 void Naive::broadcast_fw_impl(
     const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) {
   const std::uint32_t repeat = x.shape().size();
@@ -659,6 +876,38 @@ void Naive::batch_sum_fw_impl(const Tensor &x, Tensor &y) {
   }
 }
 
+void Naive::max_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The gradient is routed only to the first element that has
+  // the resulting value, which matches the behavior of argmax().
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t repeat = y.shape().size();
+  const std::uint32_t skip1 = y.shape().lower_volume(dim);
+  const std::uint32_t skip2 = skip1 * n;
+  const float *src_x = CDATA(x);
+  const float *src_y = CDATA(y);
+  const float *src_gy = CDATA(gy);
+  float *dest = MDATA(gx);
+  for (std::uint32_t i = 0; i < repeat; ++i) {
+    std::uint32_t offset = i % skip1 + (i / skip1) * skip2;
+    for (std::uint32_t j = 0; j < n; ++j) {
+      if (src_x[offset] == src_y[i]) {
+        dest[offset] += src_gy[i];
+        break;
+      }
+      offset += skip1;
+    }
+  }
+}
+
+void Naive::min_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The backward operation of min() is same as that of max().
+  max_bw_impl(x, y, gy, dim, gx);
+}
+
 void Naive::inplace_multiply_const_impl(float k, Tensor &x) {
   const std::uint32_t size = x.shape().size();
   float *dest = MDATA(x);
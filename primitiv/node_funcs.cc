@@ -113,6 +113,11 @@ Node input_node(
       Input(shape, data, Device::get_reference_or_default(dev)));
 }
 
+Node input_node(const Tensor &x, Graph *g) {
+  x.check_valid();
+  return REG(Graph::get_reference_or_default(g), Input(x));
+}
+
 Node parameter_node(Parameter &param, Graph *g) {
   return REG(Graph::get_reference_or_default(g), ParameterInput(param));
 }
@@ -247,6 +252,21 @@ Node logsumexp(const Node &x, std::uint32_t dim) {
   return REGX(x, LogSumExp(dim), x);
 }
 
+template<>
+Node max(const Node &x, std::uint32_t dim) {
+  return REGX(x, Max(dim), x);
+}
+
+template<>
+Node min(const Node &x, std::uint32_t dim) {
+  return REGX(x, Min(dim), x);
+}
+
+template<>
+Node squared_norm(const Node &x, std::uint32_t dim) {
+  return REGX(x, SquaredNorm(dim), x);
+}
+
 template<>
 Node log_softmax(const Node &x, std::uint32_t dim) {
   return x - broadcast(logsumexp(x, dim), dim, x.shape()[dim]);
@@ -273,8 +293,37 @@ Node stop_gradient(const Node &x) {
   return REGX(x, StopGradient(), x);
 }
 
+template<>
+Node dropout(const Node &x, float rate, bool enabled) {
+  if (!enabled) return x;
+  if (rate == 1.) return 0. * x;
+  return REGX(x, Dropout(rate), x);
+}
+
 namespace batch {
 
+template<>
+Node pick(const Node &x, const std::vector<std::uint32_t> &ids) {
+  return REGX(x, BatchPick(ids), x);
+}
+
+template<>
+Node slice(const Node &x, std::uint32_t lower, std::uint32_t upper) {
+  return REGX(x, BatchSlice(lower, upper), x);
+}
+
+template<>
+Node concat(const std::vector<Node> &xs) {
+  if (xs.empty()) THROW_ERROR("No nodes to concat.");
+  return xs[0].graph().add_operator(
+      std::unique_ptr<Operator>(new operators::BatchConcat()), xs);
+}
+
+template<>
+Node concat(const std::vector<const Node *> &xs) {
+  return concat(::ptr_to_obj(xs));
+}
+
 template<>
 Node sum(const Node &x) {
   return REGX(x, BatchSum(), x);
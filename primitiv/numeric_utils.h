@@ -2,6 +2,8 @@
 #define PRIMITIV_NUMERIC_UTILS_H_
 
 #include <cstdint>
+#include <cstring>
+#include <limits>
 
 namespace primitiv {
 namespace numeric_utils {
@@ -36,6 +38,175 @@ inline std::uint64_t calculate_shifts(std::uint64_t x) {
   return b - (1ull << (b - 1) == x);
 }
 
+/**
+ * Reinterprets bits of a float value as an integer.
+ * @param x A float value.
+ * @return Bit representation of `x`.
+ */
+inline std::uint32_t float_to_bits(float x) {
+  std::uint32_t ret;
+  std::memcpy(&ret, &x, sizeof(ret));
+  return ret;
+}
+
+/**
+ * Reinterprets an integer as a float value.
+ * @param x Bit representation of a float value.
+ * @return The float value.
+ */
+inline float bits_to_float(std::uint32_t x) {
+  float ret;
+  std::memcpy(&ret, &x, sizeof(ret));
+  return ret;
+}
+
+// Fast approximations of transcendental functions.
+//
+// These functions consist of only arithmetic operations and selections
+// without branches or calls, so that the compiler can vectorize loops using
+// them. Polynomials are taken from the Cephes library. Maximum errors measured
+// over the whole float range are tested in numeric_utils_test.cc.
+
+/**
+ * Calculates an approximation of `exp(x)`.
+ * @param x An argument.
+ * @return Approximation of `exp(x)`, within 2 ULPs for normal results.
+ */
+inline float fast_exp(float x) {
+  const float LOG2E = 1.44269504088896341f;
+  const float LN2_HI = .693359375f;
+  const float LN2_LO = -2.12194440e-4f;
+  // exp(HI) rounds to +inf, and exp(LO) rounds to 0.
+  const float HI = 88.7228394f;
+  const float LO = -103.972084f;
+  // Also maps NaN to LO to avoid undefined conversions.
+  const float xc = !(x >= LO) ? LO : x > HI ? HI : x;
+
+  // x = n * log(2) + r, |r| <= log(2) / 2
+  // n is rounded by adding 1.5 * 2^23 and taken from the mantissa bits.
+  // Conversions between int and float are avoided because they prevent
+  // if-conversion of the callers.
+  const float SHIFTER = 12582912.f;
+  const float kf = xc * LOG2E + SHIFTER;
+  const float nf = kf - SHIFTER;
+  const std::int32_t n = static_cast<std::int32_t>(
+      float_to_bits(kf) - float_to_bits(SHIFTER));
+  const float r = xc - nf * LN2_HI - nf * LN2_LO;
+
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  const float er = p * r * r + r + 1.f;
+
+  // 2^n is split into two factors to support subnormal results.
+  const std::int32_t n1 = n / 2;
+  const float s1 = bits_to_float(static_cast<std::uint32_t>(n1 + 127) << 23);
+  const float s2 = bits_to_float(
+      static_cast<std::uint32_t>(n - n1 + 127) << 23);
+  const float y = er * s1 * s2;
+
+  return x != x
+    ? x
+    : x > HI ? std::numeric_limits<float>::infinity()
+    : x < LO ? 0.f
+    : y;
+}
+
+/**
+ * Calculates an approximation of `log(x)`.
+ * @param x An argument.
+ * @return Approximation of `log(x)`, within 2 ULPs.
+ */
+inline float fast_log(float x) {
+  const float SQRT_HALF = .707106781186547524f;
+  const float LN2_HI = .693359375f;
+  const float LN2_LO = -2.12194440e-4f;
+  const float INF = std::numeric_limits<float>::infinity();
+
+  // Subnormal values are normalized before extracting the exponent.
+  const bool subnormal = x < std::numeric_limits<float>::min();
+  const std::uint32_t bits = float_to_bits(subnormal ? x * 8388608.f : x);
+
+  // x = m * 2^e, SQRT_HALF <= m < SQRT_HALF * 2
+  // e is obtained as a float by putting the exponent bits into the mantissa of
+  // 2^23, for the same reason as fast_exp().
+  float e = bits_to_float(((bits >> 23) & 0xff) | 0x4b000000) - 8388734.f;
+  e -= subnormal ? 23.f : 0.f;
+  float m = bits_to_float((bits & 0x007fffff) | 0x3f000000);
+  const bool small = m < SQRT_HALF;
+  e -= small ? 1.f : 0.f;
+  m = small ? m + m - 1.f : m - 1.f;
+
+  const float z = m * m;
+  float p = 7.0376836292e-2f;
+  p = p * m - 1.1514610310e-1f;
+  p = p * m + 1.1676998740e-1f;
+  p = p * m - 1.2420140846e-1f;
+  p = p * m + 1.4249322787e-1f;
+  p = p * m - 1.6668057665e-1f;
+  p = p * m + 2.0000714765e-1f;
+  p = p * m - 2.4999993993e-1f;
+  p = p * m + 3.3333331174e-1f;
+  const float y = m * z * p + e * LN2_LO - .5f * z + m + e * LN2_HI;
+
+  return x > 0 && x < INF
+    ? y
+    : x == 0 ? -INF
+    : x == INF ? INF
+    : std::numeric_limits<float>::quiet_NaN();
+}
+
+/**
+ * Calculates an approximation of `tanh(x)`.
+ * @param x An argument.
+ * @return Approximation of `tanh(x)`, within 2 ULPs.
+ */
+inline float fast_tanh(float x) {
+  const float ax = x < 0 ? -x : x;
+
+  // Small arguments: odd polynomial.
+  const float z = x * x;
+  float p = -5.70498872745e-3f;
+  p = p * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  const float ys = x + x * z * p;
+
+  // Large arguments: 1 - 2 / (exp(2|x|) + 1)
+  const float yl = 1.f - 2.f / (fast_exp(2.f * ax) + 1.f);
+
+  return ax < .625f ? ys : x < 0 ? -yl : yl;
+}
+
+/**
+ * Calculates an approximation of `1 / (1 + exp(-x))`.
+ * @param x An argument.
+ * @return Approximation of the sigmoid function, within 4 ULPs for normal
+ *         results.
+ */
+inline float fast_sigmoid(float x) {
+  return 1.f / (1.f + fast_exp(-x));
+}
+
+/**
+ * Calculates an approximation of `log(1 + exp(x))`.
+ * @param x An argument.
+ * @return Approximation of the softplus function, within 4 ULPs for normal
+ *         results.
+ */
+inline float fast_softplus(float x) {
+  // softplus(x) = max(x, 0) + log1p(exp(-|x|)), and log1p(e) is calculated
+  // by log(u) * e / (u - 1), u = 1 + e to avoid cancellation.
+  const float e = fast_exp(x < 0 ? x : -x);
+  const float u = 1.f + e;
+  const float l = u == 1.f ? e : fast_log(u) * (e / (u - 1.f));
+  return (x > 0 ? x : 0.f) + l;
+}
+
 }  // namespace numeric_utils
 }  // namespace primitiv
 
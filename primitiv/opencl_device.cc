@@ -1,8 +1,14 @@
 #include <primitiv/config.h>
 
 #include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <random>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
 
 #define CL_HPP_ENABLE_EXCEPTIONS
 #define CL_HPP_MINIMUM_OPENCL_VERSION 120
@@ -11,8 +17,11 @@
 #include <CL/cl2.hpp>
 #include <clBLAS.h>
 
+#include <primitiv/autotuner.h>
+#include <primitiv/binary_cache.h>
 #include <primitiv/error.h>
 #include <primitiv/memory_pool.h>
+#include <primitiv/mixins.h>
 #include <primitiv/opencl_device.h>
 #include <primitiv/random.h>
 
@@ -33,30 +42,145 @@ void read_buffer(
 }
 
 /**
- * Copies a host array to a device buffer.
- * @param queue cl::CommandQueue object to perform operations.
- * @param buffer cl::Buffer object to be updated.
- * @param data Array of the data.
- * @param size Number of objects in `data`.
+ * Resources which are kept alive until corresponding commands finish.
  */
-template<typename T>
-void write_buffer(
-    cl::CommandQueue &queue, cl::Buffer &buffer,
-    const T data[], std::size_t size) {
-  // NOTE(odashi):
-  // Some devices could not directly write their buffers.
-  // (I observed this issue using Intel GPUs.)
-  // For now, we disabled below code,
-  //
-  //queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, sizeof(T) * size, data);
-  //
-  // and enables copying through memory mapping.
-  T *mapped_ptr = static_cast<T *>(
-      queue.enqueueMapBuffer(
-        buffer, CL_TRUE, CL_MAP_WRITE, 0, sizeof(T) * size, 0));
-  std::memcpy(mapped_ptr, data, sizeof(T) * size);
-  queue.enqueueUnmapMemObject(buffer, mapped_ptr);
-}
+class PendingReleases {
+  PendingReleases(const PendingReleases &) = delete;
+  PendingReleases &operator=(const PendingReleases &) = delete;
+
+public:
+  PendingReleases() = default;
+  ~PendingReleases() { wait_all(); }
+
+  /**
+   * Registers a resource.
+   * @param event Event of the last command which uses the resource.
+   * @param resource Resource to be released after `event` completes.
+   */
+  void add(const cl::Event &event, std::shared_ptr<void> resource) {
+    entries_.emplace_back(event, std::move(resource));
+  }
+
+  /**
+   * Releases resources of completed commands without blocking.
+   */
+  void sweep() {
+    // NOTE: Commands on one in-order queue complete in order, so checking
+    // the front entries is enough in most cases.
+    while (!entries_.empty() &&
+        entries_.front().first.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>()
+        == CL_COMPLETE) {
+      entries_.pop_front();
+    }
+  }
+
+  /**
+   * Waits for all commands and releases all resources.
+   */
+  void wait_all() {
+    while (!entries_.empty()) {
+      entries_.front().first.wait();
+      entries_.pop_front();
+    }
+  }
+
+private:
+  std::deque<std::pair<cl::Event, std::shared_ptr<void>>> entries_;
+};
+
+/**
+ * Allocator which carves small buffers out of a few large slabs.
+ *
+ * Small buffers are created as sub-buffers of the current slab by bumping
+ * an offset aligned to CL_DEVICE_MEM_BASE_ADDR_ALIGN. Slabs are never
+ * compacted; reusing freed buffers is the job of MemoryPool. Each slab is
+ * released when the last sub-buffer in it is deleted.
+ */
+class SlabAllocator {
+  SlabAllocator(const SlabAllocator &) = delete;
+  SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+public:
+  /**
+   * Creates a new SlabAllocator object.
+   * @param context cl::Context object.
+   * @param device cl::Device object.
+   */
+  SlabAllocator(const cl::Context &context, const cl::Device &device)
+    : context_(context)
+    , align_(std::max<std::size_t>(
+          device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8, 1))
+    , slab_size_(std::min<std::size_t>(
+          DEFAULT_SLAB_SIZE, device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>()))
+    , used_(0) {}
+
+  /**
+   * Allocates a new buffer.
+   * @param size Size of the buffer in bytes.
+   * @return Pointer to a new cl::Buffer object.
+   */
+  void *allocate(std::size_t size) {
+    if (size > slab_size_ / MIN_BLOCKS_PER_SLAB) {
+      // Large buffers are created directly.
+      return static_cast<void *>(new cl::Buffer(context_, FLAGS, size, NULL));
+    }
+    const std::size_t aligned = (size + align_ - 1) / align_ * align_;
+    if (!slab_ || used_ + aligned > slab_size_) {
+      // The rest of the current slab is abandoned.
+      slab_ = std::make_shared<cl::Buffer>(context_, FLAGS, slab_size_);
+      used_ = 0;
+    }
+    cl_buffer_region region { used_, size };
+    cl::Buffer *sub = new cl::Buffer(
+        slab_->createSubBuffer(
+          CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region));
+    used_ += aligned;
+    parents_.emplace(sub, slab_);
+    return static_cast<void *>(sub);
+  }
+
+  /**
+   * Creates a shared_ptr which deletes the buffer, and the slab of the
+   * buffer if no other buffers use it.
+   * @param ptr Pointer to the cl::Buffer object made by allocate().
+   * @return A shared_ptr object which holds `ptr`.
+   */
+  std::shared_ptr<void> make_holder(void *ptr) {
+    std::shared_ptr<cl::Buffer> slab;
+    const auto it = parents_.find(ptr);
+    if (it != parents_.end()) {
+      slab = std::move(it->second);
+      parents_.erase(it);
+    }
+    // NOTE: `slab` is captured to be deleted after the sub-buffer.
+    return std::shared_ptr<void>(ptr, [slab](void *p) {
+        delete static_cast<cl::Buffer *>(p);
+    });
+  }
+
+  /**
+   * Deletes the buffer immediately.
+   * @param ptr Pointer to the cl::Buffer object made by allocate().
+   */
+  void free(void *ptr) { make_holder(ptr); }
+
+private:
+  static constexpr cl_mem_flags FLAGS
+    = CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR;
+  static constexpr std::size_t DEFAULT_SLAB_SIZE = 1 << 26;
+  static constexpr std::size_t MIN_BLOCKS_PER_SLAB = 16;
+
+  cl::Context context_;
+  std::size_t align_;
+  std::size_t slab_size_;
+  std::shared_ptr<cl::Buffer> slab_;
+  std::size_t used_;
+  std::unordered_map<void *, std::shared_ptr<cl::Buffer>> parents_;
+};
+
+constexpr cl_mem_flags SlabAllocator::FLAGS;
+constexpr std::size_t SlabAllocator::DEFAULT_SLAB_SIZE;
+constexpr std::size_t SlabAllocator::MIN_BLOCKS_PER_SLAB;
 
 /**
  * Obtains mutable cl::Buffer from shared_ptr<void>.
@@ -128,6 +252,112 @@ cl::Device get_device(std::uint32_t platform_id, std::uint32_t device_id) {
   return all_devs[device_id];
 }
 
+/**
+ * Returns the key of the device to store tuning results.
+ * @param device cl::Device object.
+ * @return A string which contains the vendor, the name and the driver version
+ *         of the device.
+ */
+std::string get_hardware_key(const cl::Device &device) {
+  return "opencl:"
+    + device.getInfo<CL_DEVICE_VENDOR>() + ':'
+    + device.getInfo<CL_DEVICE_NAME>() + ':'
+    + device.getInfo<CL_DRIVER_VERSION>();
+}
+
+/**
+ * Returns the key of the compiled program.
+ * @param device cl::Device object.
+ * @param source Source code of the program.
+ * @return A string which contains the platform, the device, the driver
+ *         version and the digest of the source code.
+ */
+std::string get_program_key(
+    const cl::Device &device, const std::string &source) {
+  const cl::Platform platform(device.getInfo<CL_DEVICE_PLATFORM>());
+  return "opencl:"
+    + platform.getInfo<CL_PLATFORM_NAME>() + ':'
+    + platform.getInfo<CL_PLATFORM_VERSION>() + ':'
+    + device.getInfo<CL_DEVICE_VENDOR>() + ':'
+    + device.getInfo<CL_DEVICE_NAME>() + ':'
+    + device.getInfo<CL_DRIVER_VERSION>() + ':'
+    + primitiv::BinaryCache::digest(source);
+}
+
+/**
+ * Builds a program.
+ * Compiled binaries are reused through BinaryCache (see also the
+ * `PRIMITIV_KERNEL_CACHE_DIR` environment variable).
+ * @param context cl::Context object.
+ * @param device cl::Device object.
+ * @param source Source code of the program.
+ * @return Built program.
+ */
+cl::Program build_program(
+    const cl::Context &context, const cl::Device &device,
+    const std::string &source) {
+  const primitiv::BinaryCache cache(
+      primitiv::BinaryCache::default_directory());
+  std::string key;
+  if (!cache.directory().empty()) {
+    key = ::get_program_key(device, source);
+    std::string binary;
+    if (cache.load(key, binary)) {
+      // Binaries rejected by the driver are compiled again.
+      try {
+        cl::Program program(
+            context, { device },
+            cl::Program::Binaries { std::vector<unsigned char>(
+                binary.begin(), binary.end()) });
+        program.build({device});
+        return program;
+      } catch (...) {}
+    }
+  }
+
+  cl::Program program(context, source);
+  try {
+    program.build({device});
+  } catch (...) {
+    THROW_ERROR("OpenCL kernel compile error:" << std::endl << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device));
+  }
+
+  if (!key.empty()) {
+    const auto binaries = program.getInfo<CL_PROGRAM_BINARIES>();
+    if (!binaries.empty() && !binaries[0].empty()) {
+      cache.store(key, std::string(binaries[0].begin(), binaries[0].end()));
+    }
+  }
+  return program;
+}
+
+/**
+ * Generates the source code of a fused elementwise kernel.
+ * @param num_args Number of arguments.
+ * @param expr OpenCL C expression over `x0`, `x1`, ...
+ * @return Source code of `fused_kernel`.
+ */
+std::string generate_fused_kernel(
+    std::uint32_t num_args, const std::string &expr) {
+  std::ostringstream ss;
+  ss << "kernel void fused_kernel(";
+  for (std::uint32_t j = 0; j < num_args; ++j) {
+    ss << "const global float *px" << j << ", const unsigned s" << j << ", ";
+  }
+  ss << "const unsigned size, global float *py) {\n"
+     << "  const unsigned i = get_global_id(0);\n"
+     << "  const unsigned bid_y = get_group_id(1);\n"
+     << "  if (i < size) {\n";
+  for (std::uint32_t j = 0; j < num_args; ++j) {
+    ss << "    const float x" << j
+       << " = px" << j << "[i + bid_y * s" << j << "];\n";
+  }
+  ss << "    py[i + bid_y * size] = " << expr << ";\n"
+     << "  }\n"
+     << "}\n";
+  return ss.str();
+}
+
 }  // namespace
 
 #define CDATA(x) (*static_cast<const cl::Buffer *>(get_handle(x)))
@@ -139,7 +369,8 @@ namespace devices {
 /**
  * Hidden objects of OpenCL devices.
  */
-struct OpenCLInternalState {
+struct OpenCLInternalState
+  : public mixins::Identifiable<OpenCLInternalState> {
 private:
   /**
    * aHelper to obtain maximum work group size of the kernel.
@@ -174,39 +405,60 @@ private:
     }
   }
 
+  /**
+   * Creates a new buffer on the host-accessible memory.
+   * Buffers waiting for deletion are released and the allocation is retried
+   * if the first attempt failed.
+   */
+  void *new_buffer(std::size_t size) {
+    releases.sweep();
+    try {
+      return slabs.allocate(size);
+    } catch (...) {
+      releases.wait_all();
+      return slabs.allocate(size);
+    }
+  }
+
 public:
   OpenCLInternalState(
-      std::uint32_t pf_id, std::uint32_t dev_id, std::uint32_t rng_seed)
+      std::uint32_t pf_id, std::uint32_t dev_id, std::uint32_t rng_seed,
+      std::uint32_t num_queues)
     : randomizer_(rng_seed)
     , device(::get_device(pf_id, dev_id))
     , context({ device })
     , queue(context, device, 0)
+    , transfer_queue(context, device, 0)
+    , tuner(::get_hardware_key(device), Autotuner::default_cache_path())
+    , slabs(context, device)
+    , staging_pool(
+        [this](std::size_t size) -> void * {  // allocator
+          return new_buffer(size);
+        },
+        [this](void *ptr) -> void {  // deleter
+          // Staging buffers return to the pool only after their copies
+          // finished.
+          slabs.free(ptr);
+        })
     , pool(
         [this](std::size_t size) -> void * {  // allocator
-          return static_cast<void *>(
-              new cl::Buffer(
-                context,
-                CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
-                size,
-                NULL));
+          return new_buffer(size);
         },
         [this](void *ptr) -> void {  // deleter
-          // NOTE(odashi):
           // Deleting cl::Buffer does NOT block the process regardless whether
           // the remaining kernel functions are still working or not.
-          // We have to manually wait for finishing all kernel functions to
-          // prevent memory corruption.
-          queue.finish();
-          // Then, we can delete the buffer safely.
-          delete static_cast<cl::Buffer *>(ptr);
+          // The buffer is deleted after all commands enqueued so far finished.
+          releases.add(enqueue_global_marker(), slabs.make_holder(ptr));
+          releases.sweep();
         }) {
-      cl::Program program(context, ::generate_kernels());
-      try {
-        program.build({device});
-      } catch (...) {
-        THROW_ERROR("OpenCL kernel compile error:" << std::endl << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device));
+      queues.emplace_back(queue);
+      for (std::uint32_t i = 1; i < num_queues; ++i) {
+        queues.emplace_back(context, device, 0);
       }
 
+      cl::Program program = ::build_program(
+          context, device, ::generate_kernels());
+
 #define CONFIGURE_KERNEL(name) \
       { \
         name##_kernel = cl::Kernel(program, #name "_kernel"); \
@@ -227,6 +479,8 @@ public:
       CONFIGURE_KERNEL_LIST(argmin);
       argmax_group_size = calc_dim1_size(argmax_group_size);
       argmin_group_size = calc_dim1_size(argmin_group_size);
+      CONFIGURE_KERNEL_LIST(topk);
+      topk_group_size = calc_dim1_size(topk_group_size);
 
       CONFIGURE_KERNEL(set_identity);
 
@@ -317,22 +571,277 @@ public:
       CONFIGURE_KERNEL_LIST(logsumexp_fw);
       sum_fw_group_size = calc_dim1_size(sum_fw_group_size);
       logsumexp_fw_group_size = calc_dim1_size(logsumexp_fw_group_size);
+      CONFIGURE_KERNEL_LIST(max_fw);
+      CONFIGURE_KERNEL_LIST(min_fw);
+      CONFIGURE_KERNEL_LIST(squared_norm_fw);
+      max_fw_group_size = calc_dim1_size(max_fw_group_size);
+      min_fw_group_size = calc_dim1_size(min_fw_group_size);
+      squared_norm_fw_group_size = calc_dim1_size(squared_norm_fw_group_size);
 
       CONFIGURE_KERNEL(broadcast_fw);
       CONFIGURE_KERNEL(batch_sum_fw);
 
+      CONFIGURE_KERNEL(max_bw);
+
+      CONFIGURE_KERNEL(dropout_fw);
+      CONFIGURE_KERNEL(dropout_bw);
+
       CONFIGURE_KERNEL(inplace_multiply_const);
       CONFIGURE_KERNEL(inplace_add);
       CONFIGURE_KERNEL(inplace_subtract);
 
 #undef CONFIGURE_KERNEL
 #undef CONFIGURE_KERNEL_LIST
+
+      tune_elementwise_group_size();
+    }
+
+  /**
+   * Selects the work group size of elementwise kernels.
+   * The negate_fw kernel is benchmarked as a representative, and the result
+   * is used as the upper bound of work group sizes of all elementwise kernels.
+   */
+  void tune_elementwise_group_size() {
+    std::vector<std::uint32_t> candidates;
+    for (std::uint32_t gs = 32; gs <= negate_fw_group_size; gs <<= 1) {
+      candidates.emplace_back(gs);
+    }
+    if (candidates.empty()) return;
+
+    const std::uint32_t size = 1 << 20;
+    cl::Buffer x(context, CL_MEM_READ_WRITE, sizeof(float) * size, NULL);
+    cl::Buffer y(context, CL_MEM_READ_WRITE, sizeof(float) * size, NULL);
+    negate_fw_kernel.setArg(0, x);
+    negate_fw_kernel.setArg(1, size);
+    negate_fw_kernel.setArg(2, y);
+    const std::uint32_t gs = tuner.select(
+        "opencl.elementwise_group_size", candidates,
+        [&](std::uint32_t c) {
+          queue.enqueueNDRangeKernel(
+              negate_fw_kernel, cl::NullRange,
+              cl::NDRange(::calc_num_blocks(size, c) * c),
+              cl::NDRange(c));
+          queue.finish();
+        });
+
+#define LIMIT_GROUP_SIZE(name) \
+    name##_group_size = std::min(name##_group_size, gs)
+
+    LIMIT_GROUP_SIZE(negate_fw);
+    LIMIT_GROUP_SIZE(sqrt_fw);
+    LIMIT_GROUP_SIZE(exp_fw);
+    LIMIT_GROUP_SIZE(log_fw);
+    LIMIT_GROUP_SIZE(tanh_fw);
+    LIMIT_GROUP_SIZE(sigmoid_fw);
+    LIMIT_GROUP_SIZE(softplus_fw);
+    LIMIT_GROUP_SIZE(sin_fw);
+    LIMIT_GROUP_SIZE(cos_fw);
+    LIMIT_GROUP_SIZE(tan_fw);
+
+    LIMIT_GROUP_SIZE(sqrt_bw);
+    LIMIT_GROUP_SIZE(exp_bw);
+    LIMIT_GROUP_SIZE(log_bw);
+    LIMIT_GROUP_SIZE(tanh_bw);
+    LIMIT_GROUP_SIZE(sigmoid_bw);
+    LIMIT_GROUP_SIZE(softplus_bw);
+    LIMIT_GROUP_SIZE(sin_bw);
+    LIMIT_GROUP_SIZE(cos_bw);
+    LIMIT_GROUP_SIZE(tan_bw);
+
+    LIMIT_GROUP_SIZE(add_const_fw);
+    LIMIT_GROUP_SIZE(subtract_const_r_fw);
+    LIMIT_GROUP_SIZE(subtract_const_l_fw);
+    LIMIT_GROUP_SIZE(multiply_const_fw);
+    LIMIT_GROUP_SIZE(divide_const_r_fw);
+    LIMIT_GROUP_SIZE(divide_const_l_fw);
+    LIMIT_GROUP_SIZE(pow_const_r_fw);
+    LIMIT_GROUP_SIZE(pow_const_l_fw);
+    LIMIT_GROUP_SIZE(prelu_fw);
+    LIMIT_GROUP_SIZE(elu_fw);
+
+    LIMIT_GROUP_SIZE(add_const_bw);
+    LIMIT_GROUP_SIZE(subtract_const_r_bw);
+    LIMIT_GROUP_SIZE(subtract_const_l_bw);
+    LIMIT_GROUP_SIZE(multiply_const_bw);
+    LIMIT_GROUP_SIZE(divide_const_r_bw);
+    LIMIT_GROUP_SIZE(divide_const_l_bw);
+    LIMIT_GROUP_SIZE(pow_const_r_bw);
+    LIMIT_GROUP_SIZE(pow_const_l_bw);
+    LIMIT_GROUP_SIZE(prelu_bw);
+    LIMIT_GROUP_SIZE(elu_bw);
+
+    LIMIT_GROUP_SIZE(add_scalar_fw);
+    LIMIT_GROUP_SIZE(subtract_scalar_r_fw);
+    LIMIT_GROUP_SIZE(subtract_scalar_l_fw);
+    LIMIT_GROUP_SIZE(multiply_scalar_fw);
+    LIMIT_GROUP_SIZE(divide_scalar_r_fw);
+    LIMIT_GROUP_SIZE(divide_scalar_l_fw);
+    LIMIT_GROUP_SIZE(pow_scalar_r_fw);
+    LIMIT_GROUP_SIZE(pow_scalar_l_fw);
+
+    LIMIT_GROUP_SIZE(add_fw);
+    LIMIT_GROUP_SIZE(subtract_fw);
+    LIMIT_GROUP_SIZE(multiply_fw);
+    LIMIT_GROUP_SIZE(divide_fw);
+    LIMIT_GROUP_SIZE(pow_fw);
+
+    LIMIT_GROUP_SIZE(add_bw);
+    LIMIT_GROUP_SIZE(subtract_bw);
+    LIMIT_GROUP_SIZE(multiply_bw);
+    LIMIT_GROUP_SIZE(divide_bw);
+    LIMIT_GROUP_SIZE(pow_bw);
+
+    LIMIT_GROUP_SIZE(inplace_multiply_const);
+    LIMIT_GROUP_SIZE(inplace_add);
+    LIMIT_GROUP_SIZE(inplace_subtract);
+
+#undef LIMIT_GROUP_SIZE
+  }
+
+  /**
+   * Obtains the fused elementwise kernel of the expression.
+   * Kernels are compiled at the first use and kept while the device lives.
+   * @param num_args Number of arguments.
+   * @param expr OpenCL C expression over `x0`, `x1`, ...
+   * @return cl::Kernel object.
+   */
+  cl::Kernel &get_fused_kernel(
+      std::uint32_t num_args, const std::string &expr) {
+    const std::string source = ::generate_fused_kernel(num_args, expr);
+    auto it = fused_kernels.find(source);
+    if (it == fused_kernels.end()) {
+      const cl::Program program = ::build_program(context, device, source);
+      it = fused_kernels.emplace(
+          source, cl::Kernel(program, "fused_kernel")).first;
     }
+    return it->second;
+  }
+
+  ~OpenCLInternalState() {
+    // Staging buffers must return to staging_pool before it is destroyed.
+    for (cl::CommandQueue &q : queues) q.finish();
+    transfer_queue.finish();
+    releases.wait_all();
+  }
+
+  /**
+   * Enqueues a marker which completes after all commands enqueued so far to
+   * any queues.
+   * @return Event of the marker.
+   */
+  cl::Event enqueue_global_marker() {
+    std::vector<cl::Event> deps;
+    for (cl::CommandQueue &q : queues) {
+      if (q() == queue()) continue;
+      deps.emplace_back();
+      q.enqueueMarkerWithWaitList(NULL, &deps.back());
+    }
+    cl::Event marker;
+    queue.enqueueMarkerWithWaitList(deps.empty() ? NULL : &deps, &marker);
+    return marker;
+  }
+
+  /**
+   * Allocates a block of the memory pool.
+   * With multiple queues, released blocks return to the pool after all queues
+   * finished the commands enqueued so far, because the next user may be on
+   * another queue.
+   * The deleter looks up the state by its ID, and drops the block directly if
+   * the device has already gone.
+   * @param size Size of the block in bytes.
+   * @return A shared_ptr object of the cl::Buffer.
+   */
+  std::shared_ptr<void> allocate(std::size_t size) {
+    if (queues.size() <= 1) return pool.allocate(size);
+    releases.sweep();
+    std::shared_ptr<void> block = pool.allocate(size);
+    void *ptr = block.get();
+    const std::uint64_t state_id = id();
+    return std::shared_ptr<void>(ptr, [state_id, block](void *) {
+        try {
+          OpenCLInternalState &state = get_object(state_id);
+          state.releases.add(state.enqueue_global_marker(), block);
+        } catch (const primitiv::Error &) {
+          // The device already has gone and the block is released by its
+          // memory pool.
+        }
+    });
+  }
+
+  /**
+   * Switches the current queue.
+   * @param id Index of the new queue.
+   * @param waits Indices of queues to be waited by the new queue.
+   */
+  void select_queue(std::uint32_t id, const std::vector<std::uint32_t> &waits) {
+    std::vector<cl::Event> deps;
+    for (const std::uint32_t w : waits) {
+      if (w == id) continue;
+      deps.emplace_back();
+      queues[w].enqueueMarkerWithWaitList(NULL, &deps.back());
+    }
+    queue = queues[id];
+    if (!deps.empty()) queue.enqueueBarrierWithWaitList(&deps);
+  }
+
+  /**
+   * Writes data into a device buffer without blocking the host.
+   * Data is prepared in a staging buffer which is mapped on transfer_queue,
+   * and copied on queue after preceding commands. The host does not wait for
+   * any kernels.
+   * @param buffer Destination buffer.
+   * @param size Size of the data in bytes.
+   * @param fill Function to write the data into the mapped staging memory.
+   */
+  void write_staged(
+      cl::Buffer &buffer, std::size_t size,
+      const std::function<void(void *)> &fill) {
+    std::shared_ptr<void> staging = staging_pool.allocate(size);
+    cl::Buffer &staging_buffer = ::get_buffer(staging);
+    // NOTE: The staging buffer is not used by any other commands, and mapping
+    // it returns immediately.
+    void *mapped_ptr = transfer_queue.enqueueMapBuffer(
+        staging_buffer, CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, 0, size);
+    fill(mapped_ptr);
+    cl::Event unmapped;
+    transfer_queue.enqueueUnmapMemObject(
+        staging_buffer, mapped_ptr, NULL, &unmapped);
+    transfer_queue.flush();
+    const std::vector<cl::Event> deps { unmapped };
+    cl::Event copied;
+    queue.enqueueCopyBuffer(staging_buffer, buffer, 0, 0, size, &deps, &copied);
+    queue.flush();
+    releases.add(copied, std::move(staging));
+  }
+
+  /**
+   * Copies a host array to a device buffer without blocking the host.
+   * @param buffer cl::Buffer object to be updated.
+   * @param data Array of the data.
+   * @param size Number of objects in `data`.
+   */
+  template<typename T>
+  void write_buffer(cl::Buffer &buffer, const T data[], std::size_t size) {
+    // NOTE(odashi):
+    // Some devices could not directly write their buffers.
+    // (I observed this issue using Intel GPUs.)
+    // Data is written through memory mapping instead of enqueueWriteBuffer().
+    write_staged(buffer, sizeof(T) * size, [&](void *dest) {
+        std::memcpy(dest, data, sizeof(T) * size);
+    });
+  }
 
   DefaultRandomizer randomizer_;
   cl::Device device;
   cl::Context context;
+  // Current queue, which is one of `queues`.
   cl::CommandQueue queue;
+  std::vector<cl::CommandQueue> queues;
+  cl::CommandQueue transfer_queue;
+  Autotuner tuner;
+  SlabAllocator slabs;
+  PendingReleases releases;
+  MemoryPool staging_pool;
   MemoryPool pool;
 
 #define DECL_KERNEL(name) \
@@ -344,6 +853,7 @@ public:
 
   DECL_KERNEL_LIST(argmax, 11);
   DECL_KERNEL_LIST(argmin, 11);
+  DECL_KERNEL_LIST(topk, 11);
 
   DECL_KERNEL(set_identity);
 
@@ -428,14 +938,24 @@ public:
 
   DECL_KERNEL_LIST(sum_fw, 11);
   DECL_KERNEL_LIST(logsumexp_fw, 11);
+  DECL_KERNEL_LIST(max_fw, 11);
+  DECL_KERNEL_LIST(min_fw, 11);
+  DECL_KERNEL_LIST(squared_norm_fw, 11);
 
   DECL_KERNEL(broadcast_fw);
   DECL_KERNEL(batch_sum_fw);
 
+  DECL_KERNEL(max_bw);
+
+  DECL_KERNEL(dropout_fw);
+  DECL_KERNEL(dropout_bw);
+
   DECL_KERNEL(inplace_multiply_const);
   DECL_KERNEL(inplace_add);
   DECL_KERNEL(inplace_subtract);
 
+  std::unordered_map<std::string, cl::Kernel> fused_kernels;
+
 #undef DECL_KERNEL
 #undef DECL_KERNEL_LIST
 };
@@ -499,13 +1019,15 @@ void OpenCL::assert_support(
 
 void OpenCL::initialize() {
   assert_support(pf_id_, dev_id_);
-  state_.reset(new OpenCLInternalState(pf_id_, dev_id_, rng_seed_));
+  state_.reset(
+      new OpenCLInternalState(pf_id_, dev_id_, rng_seed_, num_queues_));
 }
 
 OpenCL::OpenCL(std::uint32_t platform_id, std::uint32_t device_id)
 : pf_id_(platform_id)
 , dev_id_(device_id)
-, rng_seed_(std::random_device()()) {
+, rng_seed_(std::random_device()())
+, num_queues_(1) {
   initialize();
 }
 
@@ -513,12 +1035,25 @@ OpenCL::OpenCL(
     std::uint32_t platform_id, std::uint32_t device_id, std::uint32_t rng_seed)
 : pf_id_(platform_id)
 , dev_id_(device_id)
-, rng_seed_(rng_seed) {
+, rng_seed_(rng_seed)
+, num_queues_(1) {
+  initialize();
+}
+
+OpenCL::OpenCL(
+    std::uint32_t platform_id, std::uint32_t device_id, std::uint32_t rng_seed,
+    std::uint32_t num_queues)
+: pf_id_(platform_id)
+, dev_id_(device_id)
+, rng_seed_(rng_seed)
+, num_queues_(num_queues) {
+  if (num_queues == 0) THROW_ERROR("num_queues should be greater than 0.");
   initialize();
 }
 
 OpenCL::~OpenCL() {
-  // Nothing to do for now.
+  // Deferred operations hold memories allocated by the memory pool.
+  discard_deferred_operations();
 }
 
 void OpenCL::dump_description() const {
@@ -547,7 +1082,7 @@ void OpenCL::dump_description() const {
 }
 
 std::shared_ptr<void> OpenCL::new_handle(const Shape &shape) {
-  return state_->pool.allocate(sizeof(float) * shape.size());
+  return state_->allocate(sizeof(float) * shape.size());
 }
 
 std::vector<float> OpenCL::tensor_to_vector_impl(const Tensor &x) {
@@ -565,7 +1100,7 @@ std::vector<std::uint32_t> OpenCL::argmax_impl(
   const std::uint32_t s = shape.lower_volume(dim);
   std::uint32_t group_size = std::min(state_->argmax_group_size, 1024u);
   while (group_size >> 1 >= n) group_size >>= 1;
-  std::shared_ptr<void> py = state_->pool.allocate(sizeof(std::uint32_t) * r);
+  std::shared_ptr<void> py = state_->allocate(sizeof(std::uint32_t) * r);
   switch (group_size) {
 #define CASE(k, m) \
     case k: \
@@ -603,7 +1138,7 @@ std::vector<std::uint32_t> OpenCL::argmin_impl(
   const std::uint32_t s = shape.lower_volume(dim);
   std::uint32_t group_size = std::min(state_->argmin_group_size, 1024u);
   while (group_size >> 1 >= n) group_size >>= 1;
-  std::shared_ptr<void> py = state_->pool.allocate(sizeof(std::uint32_t) * r);
+  std::shared_ptr<void> py = state_->allocate(sizeof(std::uint32_t) * r);
   switch (group_size) {
 #define CASE(k, m) \
     case k: \
@@ -633,6 +1168,50 @@ std::vector<std::uint32_t> OpenCL::argmin_impl(
   return ret;
 }
 
+void OpenCL::topk_impl(
+    const Tensor &x, std::uint32_t dim, std::uint32_t k,
+    std::vector<float> &values, std::vector<std::uint32_t> &ids) {
+  const Shape &shape = x.shape();
+  const std::uint32_t n = shape[dim];
+  const std::uint32_t r = shape.size() / n;
+  const std::uint32_t s = shape.lower_volume(dim);
+  std::uint32_t group_size = std::min(state_->topk_group_size, 1024u);
+  while (group_size >> 1 >= n) group_size >>= 1;
+  std::shared_ptr<void> py = state_->allocate(sizeof(float) * r * k);
+  std::shared_ptr<void> pi = state_->allocate(
+      sizeof(std::uint32_t) * r * k);
+  switch (group_size) {
+#define CASE(gs, m) \
+    case gs: \
+      state_->topk_kernel[m].setArg(0, CDATA(x)); \
+      state_->topk_kernel[m].setArg(1, s); \
+      state_->topk_kernel[m].setArg(2, n); \
+      state_->topk_kernel[m].setArg(3, k); \
+      state_->topk_kernel[m].setArg(4, ::get_buffer(py)); \
+      state_->topk_kernel[m].setArg(5, ::get_buffer(pi)); \
+      state_->queue.enqueueNDRangeKernel( \
+          state_->topk_kernel[m], \
+          cl::NullRange, cl::NDRange(r * gs), cl::NDRange(gs)); \
+      break;
+    CASE(1024, 10);
+    CASE(512, 9);
+    CASE(256, 8);
+    CASE(128, 7);
+    CASE(64, 6);
+    CASE(32, 5);
+    CASE(16, 4);
+    CASE(8, 3);
+    CASE(4, 2);
+    CASE(2, 1);
+    CASE(1, 0);
+#undef CASE
+  }
+  values.resize(r * k);
+  ids.resize(r * k);
+  ::read_buffer(state_->queue, ::get_buffer(py), values.data(), r * k);
+  ::read_buffer(state_->queue, ::get_buffer(pi), ids.data(), r * k);
+}
+
 void OpenCL::reset_tensor_impl(float k, Tensor &x) {
   const std::uint32_t size = x.shape().size();
   state_->queue.enqueueFillBuffer<float>(MDATA(x), k, 0, sizeof(float) * size);
@@ -640,7 +1219,7 @@ void OpenCL::reset_tensor_impl(float k, Tensor &x) {
 
 void OpenCL::reset_tensor_by_array_impl(const float values[], Tensor &x) {
   const std::uint32_t size = x.shape().size();
-  ::write_buffer(state_->queue, MDATA(x), values, size);
+  state_->write_buffer(MDATA(x), values, size);
 }
 
 void OpenCL::copy_tensor_impl(const Tensor &x, Tensor &y) {
@@ -656,16 +1235,13 @@ void OpenCL::copy_tensor_impl(const Tensor &x, Tensor &y) {
       } else {
         const std::uint32_t size = x.shape().size();
         cl::CommandQueue &queue_x = static_cast<OpenCL &>(x.device()).state_->queue;
+        // Only the source has to be waited for.
         const float *mapped_ptr_x = static_cast<const float *>(
             queue_x.enqueueMapBuffer(
               CDATA(x), CL_TRUE, CL_MAP_READ, 0, sizeof(float) * size, 0));
-        float *mapped_ptr_y = static_cast<float *>(
-            state_->queue.enqueueMapBuffer(
-              MDATA(y), CL_TRUE, CL_MAP_WRITE, 0, sizeof(float) * size, 0));
-        std::memcpy(mapped_ptr_y, mapped_ptr_x, sizeof(float) * size);
+        state_->write_buffer(MDATA(y), mapped_ptr_x, size);
         queue_x.enqueueUnmapMemObject(
             CDATA(x), const_cast<float *>(mapped_ptr_x));
-        state_->queue.enqueueUnmapMemObject(MDATA(y), mapped_ptr_y);
       }
       break;
     default:
@@ -689,38 +1265,34 @@ void OpenCL::identity_impl(Tensor &y) {
 
 void OpenCL::random_bernoulli_impl(float p, Tensor &y) {
   const std::uint32_t size = y.shape().size();
-  float *mapped_ptr = static_cast<float *>(
-      state_->queue.enqueueMapBuffer(
-        MDATA(y), CL_TRUE, CL_MAP_WRITE, 0, sizeof(float) * size, 0));
-  state_->randomizer_.fill_bernoulli(p, size, mapped_ptr);
-  state_->queue.enqueueUnmapMemObject(MDATA(y), mapped_ptr);
+  state_->write_staged(MDATA(y), sizeof(float) * size, [&](void *dest) {
+      float *mapped_ptr = static_cast<float *>(dest);
+      state_->randomizer_.fill_bernoulli(p, size, mapped_ptr);
+  });
 }
 
 void OpenCL::random_uniform_impl(float lower, float upper, Tensor &y) {
   const std::uint32_t size = y.shape().size();
-  float *mapped_ptr = static_cast<float *>(
-      state_->queue.enqueueMapBuffer(
-        MDATA(y), CL_TRUE, CL_MAP_WRITE, 0, sizeof(float) * size, 0));
-  state_->randomizer_.fill_uniform(lower, upper, size, mapped_ptr);
-  state_->queue.enqueueUnmapMemObject(MDATA(y), mapped_ptr);
+  state_->write_staged(MDATA(y), sizeof(float) * size, [&](void *dest) {
+      float *mapped_ptr = static_cast<float *>(dest);
+      state_->randomizer_.fill_uniform(lower, upper, size, mapped_ptr);
+  });
 }
 
 void OpenCL::random_normal_impl(float mean, float sd, Tensor &y) {
   const std::uint32_t size = y.shape().size();
-  float *mapped_ptr = static_cast<float *>(
-      state_->queue.enqueueMapBuffer(
-        MDATA(y), CL_TRUE, CL_MAP_WRITE, 0, sizeof(float) * size, 0));
-  state_->randomizer_.fill_normal(mean, sd, size, mapped_ptr);
-  state_->queue.enqueueUnmapMemObject(MDATA(y), mapped_ptr);
+  state_->write_staged(MDATA(y), sizeof(float) * size, [&](void *dest) {
+      float *mapped_ptr = static_cast<float *>(dest);
+      state_->randomizer_.fill_normal(mean, sd, size, mapped_ptr);
+  });
 }
 
 void OpenCL::random_log_normal_impl(float mean, float sd, Tensor &y) {
   const std::uint32_t size = y.shape().size();
-  float *mapped_ptr = static_cast<float *>(
-      state_->queue.enqueueMapBuffer(
-        MDATA(y), CL_TRUE, CL_MAP_WRITE, 0, sizeof(float) * size, 0));
-  state_->randomizer_.fill_log_normal(mean, sd, size, mapped_ptr);
-  state_->queue.enqueueUnmapMemObject(MDATA(y), mapped_ptr);
+  state_->write_staged(MDATA(y), sizeof(float) * size, [&](void *dest) {
+      float *mapped_ptr = static_cast<float *>(dest);
+      state_->randomizer_.fill_log_normal(mean, sd, size, mapped_ptr);
+  });
 }
 
 void OpenCL::pick_fw_impl(
@@ -733,9 +1305,9 @@ void OpenCL::pick_fw_impl(
   const std::uint32_t sy = y.shape().volume();
   const std::uint32_t g1 = ::calc_num_blocks(sy, state_->pick_fw_group_size);
   const std::uint32_t bs = y.shape().batch();
-  std::shared_ptr<void> ids_buf = state_->pool.allocate(
+  std::shared_ptr<void> ids_buf = state_->allocate(
       sizeof(std::uint32_t) * ids.size());
-  ::write_buffer(state_->queue, ::get_buffer(ids_buf), ids.data(), ids.size());
+  state_->write_buffer(::get_buffer(ids_buf), ids.data(), ids.size());
   state_->pick_fw_kernel.setArg(0, CDATA(x));
   state_->pick_fw_kernel.setArg(1, ::get_buffer(ids_buf));
   state_->pick_fw_kernel.setArg(2, wx);
@@ -799,6 +1371,33 @@ void OpenCL::concat_fw_impl(
   }
 }
 
+void OpenCL::batch_pick_fw_impl(
+    const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) {
+  // NOTE:
+  // Selecting minibatches is equivalent to pick() over the flattened tensor
+  // with shape ([volume, batch]) along the last dimension.
+  const std::uint32_t size = y.shape().volume();
+  const std::uint32_t si = 1;
+  const std::uint32_t sx = 0;
+  const std::uint32_t g1 = ::calc_num_blocks(size, state_->pick_fw_group_size);
+  const std::uint32_t bs = y.shape().batch();
+  std::shared_ptr<void> ids_buf = state_->allocate(
+      sizeof(std::uint32_t) * ids.size());
+  state_->write_buffer(::get_buffer(ids_buf), ids.data(), ids.size());
+  state_->pick_fw_kernel.setArg(0, CDATA(x));
+  state_->pick_fw_kernel.setArg(1, ::get_buffer(ids_buf));
+  state_->pick_fw_kernel.setArg(2, size);
+  state_->pick_fw_kernel.setArg(3, size);
+  state_->pick_fw_kernel.setArg(4, sx);
+  state_->pick_fw_kernel.setArg(5, si);
+  state_->pick_fw_kernel.setArg(6, size);
+  state_->pick_fw_kernel.setArg(7, MDATA(y));
+  state_->queue.enqueueNDRangeKernel(
+      state_->pick_fw_kernel, cl::NullRange,
+      cl::NDRange(g1 * state_->pick_fw_group_size, bs),
+      cl::NDRange(state_->pick_fw_group_size, 1));
+}
+
 void OpenCL::pick_bw_impl(
     const Tensor &gy, const std::vector<std::uint32_t> &ids,
     std::uint32_t dim, Tensor &gx) {
@@ -809,9 +1408,9 @@ void OpenCL::pick_bw_impl(
   const std::uint32_t sy = gy.shape().volume();
   const std::uint32_t g1 = ::calc_num_blocks(sy, state_->concat_fw_group_size);
   const std::uint32_t bs = gy.shape().batch();
-  std::shared_ptr<void> ids_buf = state_->pool.allocate(
+  std::shared_ptr<void> ids_buf = state_->allocate(
       sizeof(std::uint32_t) * ids.size());
-  ::write_buffer(state_->queue, ::get_buffer(ids_buf), ids.data(), ids.size());
+  state_->write_buffer(::get_buffer(ids_buf), ids.data(), ids.size());
   state_->pick_bw_kernel.setArg(0, CDATA(gy));
   state_->pick_bw_kernel.setArg(1, ::get_buffer(ids_buf));
   state_->pick_bw_kernel.setArg(2, wx);
@@ -852,6 +1451,30 @@ void OpenCL::slice_bw_impl(
       cl::NDRange(state_->slice_bw_group_size));
 }
 
+void OpenCL::batch_pick_bw_impl(
+    const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) {
+  const std::uint32_t size = gy.shape().volume();
+  const std::uint32_t si = 1;
+  const std::uint32_t sx = 0;
+  const std::uint32_t g1 = ::calc_num_blocks(size, state_->pick_bw_group_size);
+  const std::uint32_t bs = gy.shape().batch();
+  std::shared_ptr<void> ids_buf = state_->allocate(
+      sizeof(std::uint32_t) * ids.size());
+  state_->write_buffer(::get_buffer(ids_buf), ids.data(), ids.size());
+  state_->pick_bw_kernel.setArg(0, CDATA(gy));
+  state_->pick_bw_kernel.setArg(1, ::get_buffer(ids_buf));
+  state_->pick_bw_kernel.setArg(2, size);
+  state_->pick_bw_kernel.setArg(3, size);
+  state_->pick_bw_kernel.setArg(4, sx);
+  state_->pick_bw_kernel.setArg(5, si);
+  state_->pick_bw_kernel.setArg(6, size);
+  state_->pick_bw_kernel.setArg(7, MDATA(gx));
+  state_->queue.enqueueNDRangeKernel(
+      state_->pick_bw_kernel, cl::NullRange,
+      cl::NDRange(g1 * state_->pick_bw_group_size, bs),
+      cl::NDRange(state_->pick_bw_group_size, 1));
+}
+
 #define OPENCLDEV_FW_X(name) \
 void OpenCL::name##_fw_impl(const Tensor &x, Tensor &y) { \
   const std::uint32_t size = x.shape().size(); \
@@ -1258,6 +1881,103 @@ void OpenCL::logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
   }
 }
 
+void OpenCL::max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t group_size = std::min(state_->max_fw_group_size, 1024u);
+  while (group_size >> 1 >= n) group_size >>= 1;
+  switch (group_size) {
+#define CASE(k, m) \
+    case k: \
+      state_->max_fw_kernel[m].setArg(0, CDATA(x)); \
+      state_->max_fw_kernel[m].setArg(1, s); \
+      state_->max_fw_kernel[m].setArg(2, n); \
+      state_->max_fw_kernel[m].setArg(3, MDATA(y)); \
+      state_->queue.enqueueNDRangeKernel( \
+          state_->max_fw_kernel[m], \
+          cl::NullRange, cl::NDRange(r * k), cl::NDRange(k)); \
+      break;
+    CASE(1024, 10);
+    CASE(512, 9);
+    CASE(256, 8);
+    CASE(128, 7);
+    CASE(64, 6);
+    CASE(32, 5);
+    CASE(16, 4);
+    CASE(8, 3);
+    CASE(4, 2);
+    CASE(2, 1);
+    CASE(1, 0);
+#undef CASE
+  }
+}
+
+void OpenCL::min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t group_size = std::min(state_->min_fw_group_size, 1024u);
+  while (group_size >> 1 >= n) group_size >>= 1;
+  switch (group_size) {
+#define CASE(k, m) \
+    case k: \
+      state_->min_fw_kernel[m].setArg(0, CDATA(x)); \
+      state_->min_fw_kernel[m].setArg(1, s); \
+      state_->min_fw_kernel[m].setArg(2, n); \
+      state_->min_fw_kernel[m].setArg(3, MDATA(y)); \
+      state_->queue.enqueueNDRangeKernel( \
+          state_->min_fw_kernel[m], \
+          cl::NullRange, cl::NDRange(r * k), cl::NDRange(k)); \
+      break;
+    CASE(1024, 10);
+    CASE(512, 9);
+    CASE(256, 8);
+    CASE(128, 7);
+    CASE(64, 6);
+    CASE(32, 5);
+    CASE(16, 4);
+    CASE(8, 3);
+    CASE(4, 2);
+    CASE(2, 1);
+    CASE(1, 0);
+#undef CASE
+  }
+}
+
+void OpenCL::squared_norm_fw_impl(
+    const Tensor &x, std::uint32_t dim, Tensor &y) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  std::uint32_t group_size = std::min(state_->squared_norm_fw_group_size, 1024u);
+  while (group_size >> 1 >= n) group_size >>= 1;
+  switch (group_size) {
+#define CASE(k, m) \
+    case k: \
+      state_->squared_norm_fw_kernel[m].setArg(0, CDATA(x)); \
+      state_->squared_norm_fw_kernel[m].setArg(1, s); \
+      state_->squared_norm_fw_kernel[m].setArg(2, n); \
+      state_->squared_norm_fw_kernel[m].setArg(3, MDATA(y)); \
+      state_->queue.enqueueNDRangeKernel( \
+          state_->squared_norm_fw_kernel[m], \
+          cl::NullRange, cl::NDRange(r * k), cl::NDRange(k)); \
+      break;
+    CASE(1024, 10);
+    CASE(512, 9);
+    CASE(256, 8);
+    CASE(128, 7);
+    CASE(64, 6);
+    CASE(32, 5);
+    CASE(16, 4);
+    CASE(8, 3);
+    CASE(4, 2);
+    CASE(2, 1);
+    CASE(1, 0);
+#undef CASE
+  }
+}
+
 void OpenCL::broadcast_fw_impl(
     const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) {
   const std::uint32_t skip1 = y.shape().lower_volume(dim);
@@ -1291,6 +2011,74 @@ void OpenCL::batch_sum_fw_impl(const Tensor &x, Tensor &y) {
       cl::NDRange(state_->batch_sum_fw_group_size));
 }
 
+void OpenCL::max_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  const std::uint32_t n = x.shape()[dim];
+  const std::uint32_t r = y.shape().size();
+  const std::uint32_t s = y.shape().lower_volume(dim);
+  const std::uint32_t g1 = ::calc_num_blocks(r, state_->max_bw_group_size);
+  state_->max_bw_kernel.setArg(0, CDATA(x));
+  state_->max_bw_kernel.setArg(1, CDATA(y));
+  state_->max_bw_kernel.setArg(2, CDATA(gy));
+  state_->max_bw_kernel.setArg(3, s);
+  state_->max_bw_kernel.setArg(4, n);
+  state_->max_bw_kernel.setArg(5, r);
+  state_->max_bw_kernel.setArg(6, MDATA(gx));
+  state_->queue.enqueueNDRangeKernel(
+      state_->max_bw_kernel, cl::NullRange,
+      cl::NDRange(g1 * state_->max_bw_group_size),
+      cl::NDRange(state_->max_bw_group_size));
+}
+
+void OpenCL::min_bw_impl(
+    const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim,
+    Tensor &gx) {
+  // NOTE: The backward operation of min() is same as that of max().
+  max_bw_impl(x, y, gy, dim, gx);
+}
+
+void OpenCL::dropout_fw_impl(
+    const Tensor &x, float p, Tensor &mask, Tensor &y) {
+  const std::uint32_t size = x.shape().size();
+  const std::uint32_t num_words = mask.shape().size();
+  // NOTE: Like other random operations on this device, the mask is generated
+  // on the host by the device's randomizer and uploaded as packed bits.
+  state_->write_staged(
+      MDATA(mask), sizeof(std::uint32_t) * num_words, [&](void *dest) {
+      std::uint32_t *mapped_ptr = static_cast<std::uint32_t *>(dest);
+      state_->randomizer_.fill_bernoulli_bits(p, size, mapped_ptr);
+  });
+
+  const std::uint32_t g1 = ::calc_num_blocks(
+      size, state_->dropout_fw_group_size);
+  state_->dropout_fw_kernel.setArg(0, CDATA(x));
+  state_->dropout_fw_kernel.setArg(1, CDATA(mask));
+  state_->dropout_fw_kernel.setArg(2, static_cast<float>(1. / p));
+  state_->dropout_fw_kernel.setArg(3, size);
+  state_->dropout_fw_kernel.setArg(4, MDATA(y));
+  state_->queue.enqueueNDRangeKernel(
+      state_->dropout_fw_kernel, cl::NullRange,
+      cl::NDRange(g1 * state_->dropout_fw_group_size),
+      cl::NDRange(state_->dropout_fw_group_size));
+}
+
+void OpenCL::dropout_bw_impl(
+    const Tensor &gy, const Tensor &mask, float p, Tensor &gx) {
+  const std::uint32_t size = gy.shape().size();
+  const std::uint32_t g1 = ::calc_num_blocks(
+      size, state_->dropout_bw_group_size);
+  state_->dropout_bw_kernel.setArg(0, CDATA(gy));
+  state_->dropout_bw_kernel.setArg(1, CDATA(mask));
+  state_->dropout_bw_kernel.setArg(2, static_cast<float>(1. / p));
+  state_->dropout_bw_kernel.setArg(3, size);
+  state_->dropout_bw_kernel.setArg(4, MDATA(gx));
+  state_->queue.enqueueNDRangeKernel(
+      state_->dropout_bw_kernel, cl::NullRange,
+      cl::NDRange(g1 * state_->dropout_bw_group_size),
+      cl::NDRange(state_->dropout_bw_group_size));
+}
+
 void OpenCL::inplace_multiply_const_impl(float k, Tensor &x) {
   const std::uint32_t size = x.shape().size();
   const std::uint32_t g1 = ::calc_num_blocks(
@@ -1340,5 +2128,32 @@ void OpenCL::inplace_subtract_impl(const Tensor &x, Tensor &y) {
       cl::NDRange(state_->inplace_subtract_group_size, 1, 1));
 }
 
+void OpenCL::elementwise_source_fw_impl(
+    const std::vector<const Tensor *> &xs, const std::string &source,
+    Tensor &y) {
+  const std::uint32_t num_args = xs.size();
+  const std::uint32_t size = y.shape().volume();
+  const std::uint32_t bs = y.shape().batch();
+  // Shares the work group size with other elementwise kernels.
+  const std::uint32_t gs = state_->negate_fw_group_size;
+  const std::uint32_t g1 = ::calc_num_blocks(size, gs);
+  cl::Kernel &kernel = state_->get_fused_kernel(num_args, source);
+  for (std::uint32_t j = 0; j < num_args; ++j) {
+    const std::uint32_t s = xs[j]->shape().has_batch() ? size : 0;
+    kernel.setArg(2 * j, CDATA(*xs[j]));
+    kernel.setArg(2 * j + 1, s);
+  }
+  kernel.setArg(2 * num_args, size);
+  kernel.setArg(2 * num_args + 1, MDATA(y));
+  state_->queue.enqueueNDRangeKernel(
+      kernel, cl::NullRange,
+      cl::NDRange(g1 * gs, bs), cl::NDRange(gs, 1));
+}
+
+void OpenCL::set_stream_impl(
+    std::uint32_t stream, const std::vector<std::uint32_t> &waits) {
+  state_->select_queue(stream, waits);
+}
+
 }  // namespace devices
 }  // namespace primitiv
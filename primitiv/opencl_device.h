@@ -67,10 +67,24 @@ public:
    */
   OpenCL(std::uint32_t platform_id, std::uint32_t device_id, std::uint32_t rng_seed);
 
+  /**
+   * Creates a new OpenCL device with multiple command queues.
+   * Each queue works as a stream (see Device::set_stream()), and Graph
+   * submits independent operators to different queues.
+   * @param platform_id Platform ID.
+   * @param device_id Device ID on the selected platform.
+   * @param rng_seed Seed value of the random number generator.
+   * @param num_queues Number of command queues.
+   */
+  OpenCL(
+      std::uint32_t platform_id, std::uint32_t device_id,
+      std::uint32_t rng_seed, std::uint32_t num_queues);
+
   ~OpenCL() override;
 
   void dump_description() const override;
   Device::DeviceType type() const override { return Device::DeviceType::OPENCL; }
+  std::uint32_t num_streams() const override { return num_queues_; }
 
 private:
   std::shared_ptr<void> new_handle(const Shape &shape) override;
@@ -78,6 +92,7 @@ private:
   std::vector<float> tensor_to_vector_impl(const Tensor &x) override;
   std::vector<std::uint32_t> argmax_impl(const Tensor &x, std::uint32_t dim) override;
   std::vector<std::uint32_t> argmin_impl(const Tensor &x, std::uint32_t dim) override;
+  void topk_impl(const Tensor &x, std::uint32_t dim, std::uint32_t k, std::vector<float> &values, std::vector<std::uint32_t> &ids) override;
 
   void reset_tensor_impl(float k, Tensor &x) override;
   void reset_tensor_by_array_impl(const float values[], Tensor &x) override;
@@ -94,9 +109,14 @@ private:
   void pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &y) override;
   void slice_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t offset, Tensor &y) override;
   void concat_fw_impl(const std::vector<const Tensor *> &xs, std::uint32_t dim, Tensor &y) override;
+  void batch_pick_fw_impl(const Tensor &x, const std::vector<std::uint32_t> &ids, Tensor &y) override;
 
   void pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, std::uint32_t dim, Tensor &gx) override;
   void slice_bw_impl(const Tensor &gy, std::uint32_t dim, std::uint32_t offset, Tensor &gx) override;
+  void batch_pick_bw_impl(const Tensor &gy, const std::vector<std::uint32_t> &ids, Tensor &gx) override;
+
+  void dropout_fw_impl(const Tensor &x, float p, Tensor &mask, Tensor &y) override;
+  void dropout_bw_impl(const Tensor &gy, const Tensor &mask, float p, Tensor &gx) override;
 
   void negate_fw_impl(const Tensor &x, Tensor &y) override;
   void sqrt_fw_impl(const Tensor &x, Tensor &y) override;
@@ -180,14 +200,27 @@ private:
 
   void sum_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
   void logsumexp_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void max_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void min_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
+  void squared_norm_fw_impl(const Tensor &x, std::uint32_t dim, Tensor &y) override;
   void broadcast_fw_impl(const Tensor &x, std::uint32_t dim, std::uint32_t size, Tensor &y) override;
   void batch_sum_fw_impl(const Tensor &x, Tensor &y) override;
 
+  void max_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+  void min_bw_impl(const Tensor &x, const Tensor &y, const Tensor &gy, std::uint32_t dim, Tensor &gx) override;
+
   void inplace_multiply_const_impl(float k, Tensor &x) override;
 
   void inplace_add_impl(const Tensor &x, Tensor &y) override;
   void inplace_subtract_impl(const Tensor &x, Tensor &y) override;
 
+  void elementwise_source_fw_impl(
+      const std::vector<const Tensor *> &xs, const std::string &source,
+      Tensor &y) override;
+
+  void set_stream_impl(
+      std::uint32_t stream, const std::vector<std::uint32_t> &waits) override;
+
   /**
    * Internal method to initialize the object.
    */
@@ -197,6 +230,7 @@ private:
   std::uint32_t pf_id_;
   std::uint32_t dev_id_;
   std::uint32_t rng_seed_;
+  std::uint32_t num_queues_;
   std::unique_ptr<OpenCLInternalState> state_;
 };
 
@@ -115,6 +115,77 @@ ARGMIN_KERNEL(1)
 
 #undef REDUCE
 
+#define REDUCE(k, GROUP_SIZE) \
+  if (GROUP_SIZE >= k << 1) { \
+    if (tid < k) { \
+      if (max_val[tid + k] > max_val[tid] || \
+          (max_val[tid + k] == max_val[tid] && \
+           argmax_val[tid + k] < argmax_val[tid])) { \
+        max_val[tid] = max_val[tid + k]; \
+        argmax_val[tid] = argmax_val[tid + k]; \
+      } \
+    } \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+  }
+
+#define TOPK_KERNEL(GROUP_SIZE) \
+kernel void topk_kernel_##GROUP_SIZE( \
+    const global float *px, const unsigned skip, const unsigned n, \
+    const unsigned k, global float *py, global unsigned *pi) { \
+  const unsigned bid = get_group_id(0); \
+  const unsigned tid = get_local_id(0); \
+  local float max_val[GROUP_SIZE]; \
+  local unsigned argmax_val[GROUP_SIZE]; \
+  local float prev_val; \
+  local unsigned prev_arg; \
+  px += bid % skip + (bid / skip) * skip * n; \
+  py += bid * k; \
+  pi += bid * k; \
+  for (unsigned r = 0; r < k; ++r) { \
+    max_val[tid] = -INFINITY; \
+    argmax_val[tid] = n; \
+    for (unsigned i = tid; i < n; i += GROUP_SIZE) { \
+      const float val = px[i * skip]; \
+      if ((r == 0 || val < prev_val || (val == prev_val && i > prev_arg)) && \
+          (val > max_val[tid] || \
+           (val == max_val[tid] && i < argmax_val[tid]))) { \
+        max_val[tid] = val; \
+        argmax_val[tid] = i; \
+      } \
+    } \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+    REDUCE(512, GROUP_SIZE) \
+    REDUCE(256, GROUP_SIZE) \
+    REDUCE(128, GROUP_SIZE) \
+    REDUCE(64, GROUP_SIZE) \
+    REDUCE(32, GROUP_SIZE) \
+    REDUCE(16, GROUP_SIZE) \
+    REDUCE(8, GROUP_SIZE) \
+    REDUCE(4, GROUP_SIZE) \
+    REDUCE(2, GROUP_SIZE) \
+    REDUCE(1, GROUP_SIZE) \
+    if (tid == 0) { \
+      py[r] = prev_val = max_val[0]; \
+      pi[r] = prev_arg = argmax_val[0]; \
+    } \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+  } \
+}
+
+TOPK_KERNEL(1024)
+TOPK_KERNEL(512)
+TOPK_KERNEL(256)
+TOPK_KERNEL(128)
+TOPK_KERNEL(64)
+TOPK_KERNEL(32)
+TOPK_KERNEL(16)
+TOPK_KERNEL(8)
+TOPK_KERNEL(4)
+TOPK_KERNEL(2)
+TOPK_KERNEL(1)
+
+#undef REDUCE
+
 kernel void set_identity_kernel(
     const unsigned size, const unsigned skip, global float *py) {
   const unsigned i = get_global_id(0);
@@ -522,6 +593,162 @@ LOGSUMEXP_FW_KERNEL(1)
 
 #undef REDUCE
 
+#define REDUCE(k, GROUP_SIZE) \
+  if (GROUP_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] = max(temp[tid], temp[tid + k]); \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+  }
+
+#define MAX_FW_KERNEL(GROUP_SIZE) \
+kernel void max_fw_kernel_##GROUP_SIZE( \
+    const global float *px, const unsigned skip, const unsigned n, \
+    global float *py) { \
+  const unsigned bid = get_group_id(0); \
+  const unsigned tid = get_local_id(0); \
+  local float temp[GROUP_SIZE]; \
+  px += bid % skip + (bid / skip) * skip * n; \
+  temp[tid] = -INFINITY; \
+  for (unsigned i = tid; i < n; i += GROUP_SIZE) { \
+    temp[tid] = max(temp[tid], px[i * skip]); \
+  } \
+  barrier(CLK_LOCAL_MEM_FENCE); \
+  REDUCE(512, GROUP_SIZE) \
+  REDUCE(256, GROUP_SIZE) \
+  REDUCE(128, GROUP_SIZE) \
+  REDUCE(64, GROUP_SIZE) \
+  REDUCE(32, GROUP_SIZE) \
+  REDUCE(16, GROUP_SIZE) \
+  REDUCE(8, GROUP_SIZE) \
+  REDUCE(4, GROUP_SIZE) \
+  REDUCE(2, GROUP_SIZE) \
+  REDUCE(1, GROUP_SIZE) \
+  if (tid == 0) py[bid] = temp[0]; \
+}
+
+MAX_FW_KERNEL(1024)
+MAX_FW_KERNEL(512)
+MAX_FW_KERNEL(256)
+MAX_FW_KERNEL(128)
+MAX_FW_KERNEL(64)
+MAX_FW_KERNEL(32)
+MAX_FW_KERNEL(16)
+MAX_FW_KERNEL(8)
+MAX_FW_KERNEL(4)
+MAX_FW_KERNEL(2)
+MAX_FW_KERNEL(1)
+
+#undef REDUCE
+
+#define REDUCE(k, GROUP_SIZE) \
+  if (GROUP_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] = min(temp[tid], temp[tid + k]); \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+  }
+
+#define MIN_FW_KERNEL(GROUP_SIZE) \
+kernel void min_fw_kernel_##GROUP_SIZE( \
+    const global float *px, const unsigned skip, const unsigned n, \
+    global float *py) { \
+  const unsigned bid = get_group_id(0); \
+  const unsigned tid = get_local_id(0); \
+  local float temp[GROUP_SIZE]; \
+  px += bid % skip + (bid / skip) * skip * n; \
+  temp[tid] = INFINITY; \
+  for (unsigned i = tid; i < n; i += GROUP_SIZE) { \
+    temp[tid] = min(temp[tid], px[i * skip]); \
+  } \
+  barrier(CLK_LOCAL_MEM_FENCE); \
+  REDUCE(512, GROUP_SIZE) \
+  REDUCE(256, GROUP_SIZE) \
+  REDUCE(128, GROUP_SIZE) \
+  REDUCE(64, GROUP_SIZE) \
+  REDUCE(32, GROUP_SIZE) \
+  REDUCE(16, GROUP_SIZE) \
+  REDUCE(8, GROUP_SIZE) \
+  REDUCE(4, GROUP_SIZE) \
+  REDUCE(2, GROUP_SIZE) \
+  REDUCE(1, GROUP_SIZE) \
+  if (tid == 0) py[bid] = temp[0]; \
+}
+
+MIN_FW_KERNEL(1024)
+MIN_FW_KERNEL(512)
+MIN_FW_KERNEL(256)
+MIN_FW_KERNEL(128)
+MIN_FW_KERNEL(64)
+MIN_FW_KERNEL(32)
+MIN_FW_KERNEL(16)
+MIN_FW_KERNEL(8)
+MIN_FW_KERNEL(4)
+MIN_FW_KERNEL(2)
+MIN_FW_KERNEL(1)
+
+#undef REDUCE
+
+#define REDUCE(k, GROUP_SIZE) \
+  if (GROUP_SIZE >= k << 1) { \
+    if (tid < k) temp[tid] += temp[tid + k]; \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+  }
+
+#define SQUARED_NORM_FW_KERNEL(GROUP_SIZE) \
+kernel void squared_norm_fw_kernel_##GROUP_SIZE( \
+    const global float *px, const unsigned skip, const unsigned n, \
+    global float *py) { \
+  const unsigned bid = get_group_id(0); \
+  const unsigned tid = get_local_id(0); \
+  local float temp[GROUP_SIZE]; \
+  px += bid % skip + (bid / skip) * skip * n; \
+  temp[tid] = 0; \
+  for (unsigned i = tid; i < n; i += GROUP_SIZE) { \
+    const float val = px[i * skip]; \
+    temp[tid] += val * val; \
+  } \
+  barrier(CLK_LOCAL_MEM_FENCE); \
+  REDUCE(512, GROUP_SIZE) \
+  REDUCE(256, GROUP_SIZE) \
+  REDUCE(128, GROUP_SIZE) \
+  REDUCE(64, GROUP_SIZE) \
+  REDUCE(32, GROUP_SIZE) \
+  REDUCE(16, GROUP_SIZE) \
+  REDUCE(8, GROUP_SIZE) \
+  REDUCE(4, GROUP_SIZE) \
+  REDUCE(2, GROUP_SIZE) \
+  REDUCE(1, GROUP_SIZE) \
+  if (tid == 0) py[bid] = temp[0]; \
+}
+
+SQUARED_NORM_FW_KERNEL(1024)
+SQUARED_NORM_FW_KERNEL(512)
+SQUARED_NORM_FW_KERNEL(256)
+SQUARED_NORM_FW_KERNEL(128)
+SQUARED_NORM_FW_KERNEL(64)
+SQUARED_NORM_FW_KERNEL(32)
+SQUARED_NORM_FW_KERNEL(16)
+SQUARED_NORM_FW_KERNEL(8)
+SQUARED_NORM_FW_KERNEL(4)
+SQUARED_NORM_FW_KERNEL(2)
+SQUARED_NORM_FW_KERNEL(1)
+
+#undef REDUCE
+
+kernel void max_bw_kernel(
+    const global float *px, const global float *py, const global float *pgy,
+    const unsigned skip, const unsigned n, const unsigned size,
+    global float *pgx) {
+  const unsigned i = get_global_id(0);
+  if (i < size) {
+    const float y = py[i];
+    unsigned offset = i % skip + (i / skip) * skip * n;
+    for (unsigned j = 0; j < n; ++j, offset += skip) {
+      if (px[offset] == y) {
+        pgx[offset] += pgy[i];
+        break;
+      }
+    }
+  }
+}
+
 kernel void broadcast_fw_kernel(
     const global float *px, const unsigned skip1, const unsigned skip2,
     const unsigned size, global float *py) {
@@ -543,6 +770,20 @@ kernel void batch_sum_fw_kernel(
   }
 }
 
+kernel void dropout_fw_kernel(
+    const global float *px, const global unsigned *pm, const float scale,
+    const unsigned size, global float *py) {
+  const unsigned i = get_global_id(0);
+  if (i < size) py[i] = (pm[i >> 5] >> (i & 31)) & 1 ? px[i] * scale : 0;
+}
+
+kernel void dropout_bw_kernel(
+    const global float *pgy, const global unsigned *pm, const float scale,
+    const unsigned size, global float *pgx) {
+  const unsigned i = get_global_id(0);
+  if (i < size && (pm[i >> 5] >> (i & 31)) & 1) pgx[i] += pgy[i] * scale;
+}
+
 kernel void inplace_multiply_const_kernel(
     const float k, const unsigned size, global float *px) {
   const unsigned i = get_global_id(0);
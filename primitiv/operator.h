@@ -71,6 +71,38 @@ public:
    * @return Name of the Operator.
    */
   virtual std::string name() const = 0;
+
+  /**
+   * Generates a C++ expression which calculates one element of the forward
+   * value from corresponding elements of arguments.
+   * @param args C++ expressions of elements of argument values.
+   * @return A C++ expression with type float, or an empty string if the
+   *         Operator is not an elementwise operation.
+   * @remarks This function is used by CppExporter to fuse consecutive
+   *          elementwise operations into one loop.
+   */
+  virtual std::string elementwise_cpp(
+      const std::vector<std::string> &args) const {
+    return std::string();
+  }
+
+  /**
+   * Generates C++ statements which calculate the forward value with fixed
+   * shapes.
+   * @param args Names of pointers to argument values.
+   * @param arg_shapes Shapes of argument values.
+   * @param ret Name of the pointer to the resulting value.
+   * @param ret_shape Shape of the resulting value.
+   * @return C++ statements separated by newlines, or an empty string if the
+   *         Operator is not supported.
+   * @remarks Generated statements can use kernels defined by CppExporter.
+   */
+  virtual std::string forward_cpp(
+      const std::vector<std::string> &args,
+      const std::vector<const Shape *> &arg_shapes,
+      const std::string &ret, const Shape &ret_shape) const {
+    return std::string();
+  }
 };
 
 }  // namespace primitiv
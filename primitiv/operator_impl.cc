@@ -1,12 +1,14 @@
 #include <primitiv/config.h>
 
 #include <algorithm>
+#include <sstream>
 #include <primitiv/device.h>
 #include <primitiv/error.h>
 #include <primitiv/functions.h>
 #include <primitiv/operator_impl.h>
 #include <primitiv/parameter.h>
 #include <primitiv/shape_ops.h>
+#include <primitiv/string_utils.h>
 
 using std::vector;
 
@@ -35,6 +37,11 @@ Input::Input(const Shape &shape, const vector<float> &data, Device &device)
   }
 }
 
+Input::Input(const Tensor &value)
+: shape_(value.shape())
+, device_(value.device())
+, value_(value) {}
+
 Shape Input::forward_shape(const vector<const Shape *> &args) const {
   CHECK_ARGNUM(args, 0);
   return shape_;
@@ -195,6 +202,57 @@ void Pick::backward(
   gy.device().pick_bw(gy, ids_, dim_, *gx[0]);
 }
 
+Shape BatchPick::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return shape_ops::batch_pick(*args[0], ids_);
+}
+
+Tensor BatchPick::forward(const vector<const Tensor *> &args) {
+  CHECK_ARGNUM(args, 1);
+  return functions::batch::pick(*args[0], ids_);
+}
+
+void BatchPick::backward(
+    const Tensor &y, const Tensor &gy,
+    const vector<const Tensor *> &x, const vector<Tensor *> &gx) const {
+  gy.device().batch_pick_bw(gy, ids_, *gx[0]);
+}
+
+Shape BatchSlice::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return shape_ops::batch_slice(*args[0], lower_, upper_);
+}
+
+Tensor BatchSlice::forward(const vector<const Tensor *> &args) {
+  CHECK_ARGNUM(args, 1);
+  return functions::batch::slice(*args[0], lower_, upper_);
+}
+
+void BatchSlice::backward(
+    const Tensor &y, const Tensor &gy,
+    const vector<const Tensor *> &x, const vector<Tensor *> &gx) const {
+  gy.device().batch_slice_bw(gy, lower_, *gx[0]);
+}
+
+Shape BatchConcat::forward_shape(const vector<const Shape *> &args) const {
+  return shape_ops::batch_concat(args);
+}
+
+Tensor BatchConcat::forward(const vector<const Tensor *> &args) {
+  return functions::batch::concat(args);
+}
+
+void BatchConcat::backward(
+    const Tensor &y, const Tensor &gy,
+    const vector<const Tensor *> &x, const vector<Tensor *> &gx) const {
+  std::uint32_t offset = 0;
+  for (Tensor *gxi : gx) {
+    const std::uint32_t span = gxi->shape().batch();
+    *gxi += functions::batch::slice(gy, offset, offset + span);
+    offset += span;
+  }
+}
+
 Shape Slice::forward_shape(const vector<const Shape *> &args) const {
   CHECK_ARGNUM(args, 1);
   return shape_ops::slice(*args[0], dim_, lower_, upper_);
@@ -318,6 +376,21 @@ Shape LogSumExp::forward_shape(const vector<const Shape *> &args) const {
   return args[0]->resize_dim(dim_, 1);
 }
 
+Shape Max::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return args[0]->resize_dim(dim_, 1);
+}
+
+Shape Min::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return args[0]->resize_dim(dim_, 1);
+}
+
+Shape SquaredNorm::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return args[0]->resize_dim(dim_, 1);
+}
+
 Shape Broadcast::forward_shape(const vector<const Shape *> &args) const {
   CHECK_ARGNUM(args, 1);
   return shape_ops::broadcast(*args[0], dim_, size_);
@@ -348,6 +421,11 @@ Shape StopGradient::forward_shape(
   return *args[0];
 }
 
+Shape Dropout::forward_shape(const vector<const Shape *> &args) const {
+  CHECK_ARGNUM(args, 1);
+  return *args[0];
+}
+
 #define FORWARD(name) \
     Tensor name::forward(const vector<const Tensor *> &x)
 
@@ -399,6 +477,9 @@ FORWARD(MatrixMultiply) { return functions::matmul(*x[0], *x[1]); }
 
 FORWARD(Sum) { return functions::sum(*x[0], dim_); }
 FORWARD(LogSumExp) { return functions::logsumexp(*x[0], dim_); }
+FORWARD(Max) { return functions::max(*x[0], dim_); }
+FORWARD(Min) { return functions::min(*x[0], dim_); }
+FORWARD(SquaredNorm) { return functions::squared_norm(*x[0], dim_); }
 FORWARD(Broadcast) { return functions::broadcast(*x[0], dim_, size_); }
 
 FORWARD(BatchSum) { return functions::batch::sum(*x[0]); }
@@ -417,6 +498,8 @@ FORWARD(SparseSoftmaxCrossEntropy) {
 
 FORWARD(StopGradient) { return *x[0]; }
 
+FORWARD(Dropout) { return x[0]->device().dropout_fw(*x[0], rate_, mask_); }
+
 #undef FORWARD
 
 #define BACKWARD(name) \
@@ -508,6 +591,11 @@ BACKWARD(LogSumExp) {
     += functions::exp(*x[0] - functions::broadcast(y, dim_, n))
     * functions::broadcast(gy, dim_, n);
 }
+BACKWARD(Max) { gy.device().max_bw(*x[0], y, gy, dim_, *gx[0]); }
+BACKWARD(Min) { gy.device().min_bw(*x[0], y, gy, dim_, *gx[0]); }
+BACKWARD(SquaredNorm) {
+  *gx[0] += 2 * *x[0] * functions::broadcast(gy, dim_, x[0]->shape()[dim_]);
+}
 BACKWARD(Broadcast) { *gx[0] += functions::sum(gy, dim_); }
 
 BACKWARD(BatchSum) { *gx[0] += gy; }
@@ -536,7 +624,268 @@ BACKWARD(SparseSoftmaxCrossEntropy) {
 
 BACKWARD(StopGradient) {}
 
+BACKWARD(Dropout) { gy.device().dropout_bw(gy, mask_, rate_, *gx[0]); }
+
 #undef BACKWARD
 
+namespace {
+
+// Calls a C++ lambda with one argument which appears several times in the body.
+std::string call_cpp(const std::string &body, const std::string &x) {
+  return "[](float x) { return " + body + "; }(" + x + ')';
+}
+
+std::string prelu_cpp(float k, const std::string &x) {
+  return call_cpp(
+      "x * ((x > 0) + " + string_utils::to_cpp_literal(k) + " * (x <= 0))", x);
+}
+
+// Generates a call of the reduction kernel along `dim`.
+std::string reduce_cpp(
+    const std::string &x, const Shape &sx,
+    const std::string &y, const Shape &sy,
+    std::uint32_t dim, const std::string &map, const std::string &combine) {
+  const std::uint32_t base = sy.lower_volume(dim);
+  std::stringstream ss;
+  ss << "reduce<" << base << ", " << sx[dim] << ", " << sy.size() / base
+     << ">(" << y << ", " << x << ",\n    " << map << ",\n    " << combine
+     << ");";
+  return ss.str();
+}
+
+const char *IDENTITY_CPP = "[](float x) { return x; }";
+const char *ADD_CPP = "[](float a, float b) { return a + b; }";
+
+}  // namespace
+
+#define ELEMENTWISE_CPP(name) \
+  std::string name::elementwise_cpp(const vector<std::string> &x) const
+
+#define K_CPP string_utils::to_cpp_literal(k_)
+
+ELEMENTWISE_CPP(Copy) { return x[0]; }
+ELEMENTWISE_CPP(Constant) { return string_utils::to_cpp_literal(k_); }
+ELEMENTWISE_CPP(Reshape) { return x[0]; }
+ELEMENTWISE_CPP(Flatten) { return x[0]; }
+ELEMENTWISE_CPP(StopGradient) { return x[0]; }
+
+ELEMENTWISE_CPP(Positive) { return x[0]; }
+ELEMENTWISE_CPP(Negative) { return "(-" + x[0] + ')'; }
+ELEMENTWISE_CPP(Sqrt) { return "std::sqrt(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Exp) { return "std::exp(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Log) { return "std::log(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Tanh) { return "std::tanh(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Sigmoid) {
+  return "static_cast<float>(.5 + .5 * std::tanh(.5 * " + x[0] + "))";
+}
+ELEMENTWISE_CPP(Softplus) {
+  return call_cpp(
+      "x > 0 ? x + std::log(1 + std::exp(-x)) : std::log(1 + std::exp(x))",
+      x[0]);
+}
+ELEMENTWISE_CPP(Sin) { return "std::sin(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Cos) { return "std::cos(" + x[0] + ')'; }
+ELEMENTWISE_CPP(Tan) { return "std::tan(" + x[0] + ')'; }
+ELEMENTWISE_CPP(ReLU) { return prelu_cpp(0, x[0]); }
+ELEMENTWISE_CPP(LReLU) { return prelu_cpp(.01, x[0]); }
+
+ELEMENTWISE_CPP(AddConst) { return '(' + x[0] + " + " + K_CPP + ')'; }
+ELEMENTWISE_CPP(SubtractConstR) { return '(' + x[0] + " - " + K_CPP + ')'; }
+ELEMENTWISE_CPP(SubtractConstL) { return '(' + K_CPP + " - " + x[0] + ')'; }
+ELEMENTWISE_CPP(MultiplyConst) { return '(' + x[0] + " * " + K_CPP + ')'; }
+ELEMENTWISE_CPP(DivideConstR) { return '(' + x[0] + " / " + K_CPP + ')'; }
+ELEMENTWISE_CPP(DivideConstL) { return '(' + K_CPP + " / " + x[0] + ')'; }
+ELEMENTWISE_CPP(PowConstR) {
+  return "std::pow(" + x[0] + ", " + K_CPP + ')';
+}
+ELEMENTWISE_CPP(PowConstL) {
+  return "std::pow(" + K_CPP + ", " + x[0] + ')';
+}
+ELEMENTWISE_CPP(PReLU) { return prelu_cpp(k_, x[0]); }
+ELEMENTWISE_CPP(ELU) {
+  return call_cpp(
+      "x * (x > 0) + " + K_CPP + " * (std::exp(x * (x <= 0)) - 1)", x[0]);
+}
+
+ELEMENTWISE_CPP(AddScalar) { return '(' + x[0] + " + " + x[1] + ')'; }
+ELEMENTWISE_CPP(SubtractScalarR) { return '(' + x[0] + " - " + x[1] + ')'; }
+ELEMENTWISE_CPP(SubtractScalarL) { return '(' + x[1] + " - " + x[0] + ')'; }
+ELEMENTWISE_CPP(MultiplyScalar) { return '(' + x[0] + " * " + x[1] + ')'; }
+ELEMENTWISE_CPP(DivideScalarR) { return '(' + x[0] + " / " + x[1] + ')'; }
+ELEMENTWISE_CPP(DivideScalarL) { return '(' + x[1] + " / " + x[0] + ')'; }
+ELEMENTWISE_CPP(PowScalarR) {
+  return "std::pow(" + x[0] + ", " + x[1] + ')';
+}
+ELEMENTWISE_CPP(PowScalarL) {
+  return "std::pow(" + x[1] + ", " + x[0] + ')';
+}
+
+ELEMENTWISE_CPP(Add) { return '(' + x[0] + " + " + x[1] + ')'; }
+ELEMENTWISE_CPP(Subtract) { return '(' + x[0] + " - " + x[1] + ')'; }
+ELEMENTWISE_CPP(Multiply) { return '(' + x[0] + " * " + x[1] + ')'; }
+ELEMENTWISE_CPP(Divide) { return '(' + x[0] + " / " + x[1] + ')'; }
+ELEMENTWISE_CPP(Pow) { return "std::pow(" + x[0] + ", " + x[1] + ')'; }
+
+#undef K_CPP
+#undef ELEMENTWISE_CPP
+
+#define FORWARD_CPP(name) \
+  std::string name::forward_cpp( \
+      const vector<std::string> &x, const vector<const Shape *> &sx, \
+      const std::string &y, const Shape &sy) const
+
+FORWARD_CPP(IdentityMatrix) {
+  std::stringstream ss;
+  ss << "std::fill(" << y << ", " << y << " + " << size_ * size_ << ", 0.f);\n"
+     << "for (std::uint32_t i = 0; i < " << size_ << "; ++i) "
+     << y << "[i * " << size_ + 1 << "] = 1.f;";
+  return ss.str();
+}
+
+FORWARD_CPP(Pick) {
+  const std::uint32_t skip_x = sx[0]->has_batch() * sx[0]->volume();
+  const std::uint32_t skip_i = ids_.size() > 1;
+  const std::uint32_t base = sy.lower_volume(dim_);
+  const std::uint32_t skip = base * (*sx[0])[dim_];
+  const std::uint32_t repeat = sy.volume() / base;
+  std::stringstream ss;
+  for (std::uint32_t batch = 0; batch < sy.batch(); ++batch) {
+    if (batch > 0) ss << '\n';
+    ss << "copy_blocks<" << base << ", " << repeat << ", " << skip << ", "
+       << base << ">(" << y << " + " << batch * sy.volume() << ", " << x[0]
+       << " + " << batch * skip_x + base * ids_[batch * skip_i] << ");";
+  }
+  return ss.str();
+}
+
+FORWARD_CPP(BatchPick) {
+  const std::uint32_t volume = sy.volume();
+  std::stringstream ss;
+  for (std::uint32_t i = 0; i < ids_.size(); ++i) {
+    if (i > 0) ss << '\n';
+    ss << "std::copy(" << x[0] << " + " << ids_[i] * volume << ", "
+       << x[0] << " + " << (ids_[i] + 1) * volume << ", "
+       << y << " + " << i * volume << ");";
+  }
+  return ss.str();
+}
+
+FORWARD_CPP(BatchSlice) {
+  const std::uint32_t volume = sy.volume();
+  std::stringstream ss;
+  ss << "std::copy(" << x[0] << " + " << lower_ * volume << ", "
+     << x[0] << " + " << upper_ * volume << ", " << y << ");";
+  return ss.str();
+}
+
+FORWARD_CPP(Slice) {
+  const std::uint32_t base = sy.lower_volume(dim_);
+  const std::uint32_t span = base * sy[dim_];
+  const std::uint32_t skip = base * (*sx[0])[dim_];
+  std::stringstream ss;
+  ss << "copy_blocks<" << span << ", " << sy.size() / span << ", " << skip
+     << ", " << span << ">(" << y << ", " << x[0] << " + " << base * lower_
+     << ");";
+  return ss.str();
+}
+
+FORWARD_CPP(Concat) {
+  const std::uint32_t base = sy.lower_volume(dim_);
+  const std::uint32_t skip = base * sy[dim_];
+  const std::uint32_t repeat = sy.volume() / skip;
+  std::uint32_t offset = 0;
+  std::stringstream ss;
+  for (std::uint32_t i = 0; i < x.size(); ++i) {
+    const std::uint32_t span = base * (*sx[i])[dim_];
+    const std::uint32_t b_skip = sx[i]->has_batch() * span * repeat;
+    if (i > 0) ss << '\n';
+    ss << "for (std::uint32_t n = 0; n < " << sy.batch() << "; ++n) "
+       << "copy_blocks<" << span << ", " << repeat << ", " << span << ", "
+       << skip << ">(" << y << " + " << offset << " + n * " << sy.volume()
+       << ", " << x[i] << " + n * " << b_skip << ");";
+    offset += span;
+  }
+  return ss.str();
+}
+
+FORWARD_CPP(Sum) {
+  return reduce_cpp(x[0], *sx[0], y, sy, dim_, IDENTITY_CPP, ADD_CPP);
+}
+
+FORWARD_CPP(LogSumExp) {
+  return reduce_cpp(
+      x[0], *sx[0], y, sy, dim_, IDENTITY_CPP,
+      "[](float a, float b) {\n"
+      "      return static_cast<float>(a > b\n"
+      "        ? a + std::log(1. + std::exp(b - a))\n"
+      "        : b + std::log(1. + std::exp(a - b)));\n"
+      "    }");
+}
+
+FORWARD_CPP(Max) {
+  return reduce_cpp(
+      x[0], *sx[0], y, sy, dim_, IDENTITY_CPP,
+      "[](float a, float b) { return b > a ? b : a; }");
+}
+
+FORWARD_CPP(Min) {
+  return reduce_cpp(
+      x[0], *sx[0], y, sy, dim_, IDENTITY_CPP,
+      "[](float a, float b) { return b < a ? b : a; }");
+}
+
+FORWARD_CPP(SquaredNorm) {
+  return reduce_cpp(
+      x[0], *sx[0], y, sy, dim_, "[](float x) { return x * x; }", ADD_CPP);
+}
+
+FORWARD_CPP(Broadcast) {
+  const std::uint32_t base = sy.lower_volume(dim_);
+  std::stringstream ss;
+  ss << "broadcast<" << base << ", " << size_ << ", " << sx[0]->size() / base
+     << ">(" << y << ", " << x[0] << ");";
+  return ss.str();
+}
+
+FORWARD_CPP(Transpose) {
+  std::stringstream ss;
+  ss << "transpose<" << (*sx[0])[0] << ", " << (*sx[0])[1] << ", "
+     << sy.batch() << ">(" << y << ", " << x[0] << ");";
+  return ss.str();
+}
+
+FORWARD_CPP(MatrixMultiply) {
+  const Shape &sa = *sx[0];
+  const Shape &sb = *sx[1];
+  std::stringstream ss;
+  ss << "matmul<" << sa[0] << ", " << sa[1] << ", " << sb[1] << ", "
+     << sy.batch() << ", " << sa.has_batch() * sa.volume() << ", "
+     << sb.has_batch() * sb.volume() << ">(" << y << ", " << x[0] << ", "
+     << x[1] << ");";
+  return ss.str();
+}
+
+FORWARD_CPP(BatchConcat) {
+  std::uint32_t offset = 0;
+  std::stringstream ss;
+  for (std::uint32_t i = 0; i < x.size(); ++i) {
+    const std::uint32_t size = sx[i]->size();
+    if (i > 0) ss << '\n';
+    ss << "std::copy(" << x[i] << ", " << x[i] << " + " << size << ", "
+       << y << " + " << offset << ");";
+    offset += size;
+  }
+  return ss.str();
+}
+
+FORWARD_CPP(BatchSum) {
+  std::stringstream ss;
+  ss << "batch_sum<" << sy.size() << ", " << sx[0]->batch() << ">("
+     << y << ", " << x[0] << ");";
+  return ss.str();
+}
+
+#undef FORWARD_CPP
+
 }  // namespace operators
 }  // namespace primitive
@@ -27,16 +27,33 @@ public: \
 private: \
   name_() = delete;
 
+#define ELEMENTWISE_CPP_DECL \
+public: \
+  std::string elementwise_cpp( \
+      const std::vector<std::string> &args) const override;
+
+#define FORWARD_CPP_DECL \
+public: \
+  std::string forward_cpp( \
+      const std::vector<std::string> &args, \
+      const std::vector<const Shape *> &arg_shapes, \
+      const std::string &ret, const Shape &ret_shape) const override;
+
 class Input : public Operator {
   NO_CTOR_CLASS_DECL(Input);
 public:
   Input(const Shape &shape, const std::vector<float> &data, Device &device);
+  explicit Input(const Tensor &value);
   Device *get_device() const override { return &device_; }
+  const Tensor *get_inner_value() const override {
+    return value_.valid() ? &value_ : nullptr;
+  }
   std::string name() const override { return "Input"; }
 private:
   Shape shape_;
   std::vector<float> data_;
   Device &device_;
+  Tensor value_;
 };
 
 class ParameterInput : public Operator {
@@ -52,6 +69,7 @@ private:
 
 class Copy : public Operator {
   NO_CTOR_CLASS_DECL(Copy);
+  ELEMENTWISE_CPP_DECL;
 public:
   Copy(Device &device) : device_(device) {}
   Device *get_device() const override { return &device_; }
@@ -62,6 +80,7 @@ private:
 
 class Constant : public Operator {
   NO_CTOR_CLASS_DECL(Constant);
+  ELEMENTWISE_CPP_DECL;
 public:
   Constant(const Shape &shape, float k, Device &device)
     : shape_(shape), k_(k), device_(device) {}
@@ -77,6 +96,7 @@ private:
 
 class IdentityMatrix : public Operator {
   NO_CTOR_CLASS_DECL(IdentityMatrix);
+  FORWARD_CPP_DECL;
 public:
   IdentityMatrix(std::uint32_t size, Device &device)
     : size_(size), device_(device) {}
@@ -160,6 +180,7 @@ private:
 
 class Pick : public Operator {
   NO_CTOR_CLASS_DECL(Pick);
+  FORWARD_CPP_DECL;
 public:
   Pick(const std::vector<std::uint32_t> &ids, std::uint32_t dim)
     : ids_(ids), dim_(dim) {}
@@ -171,8 +192,35 @@ private:
   std::uint32_t dim_;
 };
 
+class BatchPick : public Operator {
+  NO_CTOR_CLASS_DECL(BatchPick);
+  FORWARD_CPP_DECL;
+public:
+  explicit BatchPick(const std::vector<std::uint32_t> &ids) : ids_(ids) {}
+  std::string name() const override { return "BatchPick"; }
+private:
+  std::vector<std::uint32_t> ids_;
+};
+
+class BatchSlice : public Operator {
+  NO_CTOR_CLASS_DECL(BatchSlice);
+  FORWARD_CPP_DECL;
+public:
+  BatchSlice(std::uint32_t lower, std::uint32_t upper)
+    : lower_(lower), upper_(upper) {}
+  std::string name() const override {
+    return
+      "BatchSlice(" + std::to_string(lower_) +
+      ':' + std::to_string(upper_) + ')';
+  }
+private:
+  std::uint32_t lower_;
+  std::uint32_t upper_;
+};
+
 class Slice : public Operator {
   NO_CTOR_CLASS_DECL(Slice);
+  FORWARD_CPP_DECL;
 public:
   Slice(std::uint32_t dim, std::uint32_t lower, std::uint32_t upper)
     : dim_(dim), lower_(lower), upper_(upper) {}
@@ -188,6 +236,7 @@ private:
 
 class Concat : public Operator {
   NO_CTOR_CLASS_DECL(Concat);
+  FORWARD_CPP_DECL;
 public:
   Concat(std::uint32_t dim) : dim_(dim) {}
   std::string name() const override {
@@ -199,6 +248,7 @@ private:
 
 class Reshape : public Operator {
   NO_CTOR_CLASS_DECL(Reshape);
+  ELEMENTWISE_CPP_DECL;
 public:
   explicit Reshape(const Shape &shape) : shape_(shape) {}
   std::string name() const override {
@@ -210,6 +260,7 @@ private:
 
 class Sum : public Operator {
   NO_CTOR_CLASS_DECL(Sum);
+  FORWARD_CPP_DECL;
 public:
   explicit Sum(std::uint32_t dim) : dim_(dim) {}
   std::string name() const override {
@@ -221,6 +272,7 @@ private:
 
 class LogSumExp : public Operator {
   NO_CTOR_CLASS_DECL(LogSumExp);
+  FORWARD_CPP_DECL;
 public:
   explicit LogSumExp(std::uint32_t dim) : dim_(dim) {}
   std::string name() const override {
@@ -230,8 +282,45 @@ private:
   std::uint32_t dim_;
 };
 
+class Max : public Operator {
+  NO_CTOR_CLASS_DECL(Max);
+  FORWARD_CPP_DECL;
+public:
+  explicit Max(std::uint32_t dim) : dim_(dim) {}
+  std::string name() const override {
+    return "Max(" + std::to_string(dim_) + ')';
+  }
+private:
+  std::uint32_t dim_;
+};
+
+class Min : public Operator {
+  NO_CTOR_CLASS_DECL(Min);
+  FORWARD_CPP_DECL;
+public:
+  explicit Min(std::uint32_t dim) : dim_(dim) {}
+  std::string name() const override {
+    return "Min(" + std::to_string(dim_) + ')';
+  }
+private:
+  std::uint32_t dim_;
+};
+
+class SquaredNorm : public Operator {
+  NO_CTOR_CLASS_DECL(SquaredNorm);
+  FORWARD_CPP_DECL;
+public:
+  explicit SquaredNorm(std::uint32_t dim) : dim_(dim) {}
+  std::string name() const override {
+    return "SquaredNorm(" + std::to_string(dim_) + ')';
+  }
+private:
+  std::uint32_t dim_;
+};
+
 class Broadcast : public Operator {
   NO_CTOR_CLASS_DECL(Broadcast);
+  FORWARD_CPP_DECL;
 public:
   Broadcast(std::uint32_t dim, std::uint32_t size) : dim_(dim), size_(size) {}
   std::string name() const override {
@@ -270,24 +359,49 @@ private:
 
 class StopGradient : public Operator {
   DEFAULT_CLASS_DECL(StopGradient);
+  ELEMENTWISE_CPP_DECL;
 public:
   StopGradient() {}
   std::string name() const override { return "StopGradient"; }
 };
 
-// Operator with no parameter.
+class Dropout : public Operator {
+  NO_CTOR_CLASS_DECL(Dropout);
+public:
+  explicit Dropout(float rate) : rate_(rate) {}
+  std::string name() const override {
+    return "Dropout(" + std::to_string(rate_) + ')';
+  }
+private:
+  float rate_;
+  Tensor mask_;  // Bit-packed mask generated by forward().
+};
+
+// Elementwise operator with no parameter.
 #define DECL_OPERATOR(name_) \
   class name_ : public Operator { \
     DEFAULT_CLASS_DECL(name_); \
+    ELEMENTWISE_CPP_DECL; \
+  public: \
+    name_() {} \
+    std::string name() const override { return #name_; } \
+  }
+
+// Non-elementwise operator with no parameter.
+#define DECL_OPERATOR_NONELEMENTWISE(name_) \
+  class name_ : public Operator { \
+    DEFAULT_CLASS_DECL(name_); \
+    FORWARD_CPP_DECL; \
   public: \
     name_() {} \
     std::string name() const override { return #name_; } \
   }
 
-// Operator with a constant.
+// Elementwise operator with a constant.
 #define DECL_OPERATOR_K(name_) \
   class name_ : public Operator { \
     NO_CTOR_CLASS_DECL(name_); \
+    ELEMENTWISE_CPP_DECL; \
   public: \
     explicit name_(float  k) : k_(k) {} \
     std::string name() const override { \
@@ -328,8 +442,8 @@ DECL_OPERATOR(Multiply);
 DECL_OPERATOR(Divide);
 DECL_OPERATOR(Pow);
 
-DECL_OPERATOR(Transpose);
-DECL_OPERATOR(MatrixMultiply);
+DECL_OPERATOR_NONELEMENTWISE(Transpose);
+DECL_OPERATOR_NONELEMENTWISE(MatrixMultiply);
 
 DECL_OPERATOR(Sqrt);
 DECL_OPERATOR(Exp);
@@ -343,11 +457,15 @@ DECL_OPERATOR(Tan);
 DECL_OPERATOR(ReLU);
 DECL_OPERATOR(LReLU);
 
-DECL_OPERATOR(BatchSum);
+DECL_OPERATOR_NONELEMENTWISE(BatchConcat);
+DECL_OPERATOR_NONELEMENTWISE(BatchSum);
 
 #undef DECL_OPERATOR
+#undef DECL_OPERATOR_NONELEMENTWISE
 #undef DECL_OPERATOR_K
 #undef NO_CTOR_CLASS_DECL
+#undef ELEMENTWISE_CPP_DECL
+#undef FORWARD_CPP_DECL
 #undef DEFAULT_CLASS_DECL
 
 }  // namespace operators
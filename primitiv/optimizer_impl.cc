@@ -6,6 +6,8 @@
 #include <primitiv/parameter.h>
 #include <primitiv/optimizer_impl.h>
 
+using primitiv::expressions::lazy;
+
 namespace primitiv {
 namespace optimizers {
 
@@ -78,7 +80,8 @@ void AdaGrad::update_parameter(float scale, Parameter &param) {
   const Tensor &g = param.gradient();
   Tensor &m = param.stats("AdaGrad.m");
   m += g * g;
-  param.value() -= (scale * eta_) * g / (functions::sqrt(m) + eps_);
+  param.value() -=
+    (scale * eta_) * lazy(g) / (expressions::sqrt(lazy(m)) + eps_);
 }
 
 void AdaGrad::get_configs(
@@ -107,8 +110,9 @@ void RMSProp::configure_parameter(Parameter &param) {
 void RMSProp::update_parameter(float scale, Parameter &param) {
   const Tensor &g = param.gradient();
   Tensor &m = param.stats("RMSProp.m");
-  m = alpha_ * m + (1 - alpha_) * g * g;
-  param.value() -= (scale * eta_) * g / (functions::sqrt(m) + eps_);
+  m = alpha_ * lazy(m) + (1 - alpha_) * lazy(g) * lazy(g);
+  param.value() -=
+    (scale * eta_) * lazy(g) / (expressions::sqrt(lazy(m)) + eps_);
 }
 
 void RMSProp::get_configs(
@@ -141,11 +145,10 @@ void AdaDelta::update_parameter(float scale, Parameter &param) {
   const Tensor &g = param.gradient();
   Tensor &m1 = param.stats("AdaDelta.m1");
   Tensor &m2 = param.stats("AdaDelta.m2");
-  m2 *= rho_;
-  m2 += (1 - rho_) * g * g;
-  const Tensor dx = functions::sqrt((m1 + eps_) / (m2 + eps_)) * g;
-  m1 *= rho_;
-  m1 += (1 - rho_) * dx * dx;
+  m2 = rho_ * lazy(m2) + (1 - rho_) * lazy(g) * lazy(g);
+  const Tensor dx =
+    expressions::sqrt((lazy(m1) + eps_) / (lazy(m2) + eps_)) * lazy(g);
+  m1 = rho_ * lazy(m1) + (1 - rho_) * lazy(dx) * lazy(dx);
   param.value() -= scale * dx;
 }
 
@@ -178,11 +181,11 @@ void Adam::update_parameter(float scale, Parameter &param) {
   const Tensor &g = param.gradient();
   Tensor &m1 = param.stats("Adam.m1");
   Tensor &m2 = param.stats("Adam.m2");
-  m1 = beta1_ * m1 + (1 - beta1_) * g;
-  m2 = beta2_ * m2 + (1 - beta2_) * g * g;
-  const Tensor mm1 = m1 / (1 - std::pow(beta1_, epoch));
-  const Tensor mm2 = m2 / (1 - std::pow(beta2_, epoch));
-  param.value() -= (scale * alpha_) * mm1 / (functions::sqrt(mm2) + eps_);
+  m1 = beta1_ * lazy(m1) + (1 - beta1_) * lazy(g);
+  m2 = beta2_ * lazy(m2) + (1 - beta2_) * lazy(g) * lazy(g);
+  const auto mm1 = lazy(m1) / (1 - std::pow(beta1_, epoch));
+  const auto mm2 = lazy(m2) / (1 - std::pow(beta2_, epoch));
+  param.value() -= (scale * alpha_) * mm1 / (expressions::sqrt(mm2) + eps_);
 }
 
 void Adam::get_configs(
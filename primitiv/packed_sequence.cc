@@ -0,0 +1,35 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <numeric>
+#include <primitiv/packed_sequence.h>
+
+using std::vector;
+
+namespace primitiv {
+
+PackedSequence::PackedSequence(const vector<vector<std::uint32_t>> &seqs)
+: num_elements_(0)
+, order_(seqs.size()) {
+  if (seqs.empty()) THROW_ERROR("No sequences to be packed.");
+  std::iota(order_.begin(), order_.end(), 0);
+  // Stable sorting keeps the original order of sequences with same lengths.
+  std::stable_sort(
+      order_.begin(), order_.end(),
+      [&seqs](std::uint32_t a, std::uint32_t b) {
+        return seqs[a].size() > seqs[b].size();
+      });
+
+  const std::uint32_t max_len = seqs[order_[0]].size();
+  if (max_len == 0) THROW_ERROR("All sequences are empty.");
+  steps_.resize(max_len);
+  for (const std::uint32_t i : order_) {
+    const vector<std::uint32_t> &seq = seqs[i];
+    for (std::uint32_t t = 0; t < seq.size(); ++t) {
+      steps_[t].emplace_back(seq[t]);
+    }
+    num_elements_ += seq.size();
+  }
+}
+
+}  // namespace primitiv
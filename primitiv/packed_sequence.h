@@ -0,0 +1,107 @@
+#ifndef PRIMITIV_PACKED_SEQUENCE_H_
+#define PRIMITIV_PACKED_SEQUENCE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+
+namespace primitiv {
+
+/**
+ * Minibatch of variable-length sequences without paddings.
+ *
+ * Sequences are sorted by their lengths in descending order, so that the
+ * sequences still alive at the time step `t` always form the prefix of the
+ * minibatch with `batch_size(t)` elements. Recurrent states can be shrunk at
+ * each step by `shrink()`, which is backed by `functions::batch::slice()` and
+ * does not copy the memory on devices that support it.
+ *
+ * Typical usage:
+ *
+ *     PackedSequence seq(sentences);
+ *     for (std::uint32_t t = 0; t < seq.max_length(); ++t) {
+ *       h = rnn.forward(embed(seq.step(t)), seq.shrink(h, t));
+ *     }
+ */
+class PackedSequence {
+public:
+  /**
+   * Creates a new PackedSequence object.
+   * @param seqs List of sequences. Each sequence may have different length.
+   */
+  explicit PackedSequence(const std::vector<std::vector<std::uint32_t>> &seqs);
+
+  /**
+   * Returns the number of sequences.
+   * @return Number of sequences.
+   */
+  std::uint32_t num_sequences() const { return order_.size(); }
+
+  /**
+   * Returns the length of the longest sequence.
+   * @return Number of time steps.
+   */
+  std::uint32_t max_length() const { return steps_.size(); }
+
+  /**
+   * Returns the number of all elements in all sequences.
+   * @return Number of elements.
+   */
+  std::uint32_t num_elements() const { return num_elements_; }
+
+  /**
+   * Returns the order of sequences in the minibatch.
+   * @return List of indices of original sequences. The i-th element of the
+   *         minibatch corresponds to `seqs[order()[i]]`.
+   */
+  const std::vector<std::uint32_t> &order() const { return order_; }
+
+  /**
+   * Returns the number of sequences alive at the specified time step.
+   * @param t Time step.
+   * @return Number of sequences whose lengths are greater than `t`.
+   */
+  std::uint32_t batch_size(std::uint32_t t) const {
+    return step(t).size();
+  }
+
+  /**
+   * Returns elements at the specified time step.
+   * @param t Time step.
+   * @return List of `batch_size(t)` elements.
+   */
+  const std::vector<std::uint32_t> &step(std::uint32_t t) const {
+    if (t >= steps_.size()) {
+      THROW_ERROR(
+          "Time step out of range. t: " << t
+          << ", max_length: " << steps_.size());
+    }
+    return steps_[t];
+  }
+
+  /**
+   * Drops minibatch elements of finished sequences from a variable.
+   * @param x A variable whose minibatch corresponds to alive sequences at some
+   *          time step before `t`.
+   * @param t Time step.
+   * @return A variable with `batch_size(t)` minibatch elements. If `x` already
+   *         has the same or smaller minibatch, `x` itself is returned.
+   */
+  template<typename Var>
+  Var shrink(const Var &x, std::uint32_t t) const {
+    const std::uint32_t bs = batch_size(t);
+    if (x.shape().batch() <= bs) return x;
+    return functions::batch::slice(x, 0, bs);
+  }
+
+private:
+  std::uint32_t num_elements_;
+  std::vector<std::uint32_t> order_;
+  std::vector<std::vector<std::uint32_t>> steps_;
+};
+
+}  // namespace primitiv
+
+#endif  // PRIMITIV_PACKED_SEQUENCE_H_
@@ -5,12 +5,18 @@
 
 // This header file describes some include directives and may help users to use
 // the primitiv library.
+#include <primitiv/batch_sampler.h>
+#include <primitiv/beam_search.h>
+#include <primitiv/corpus.h>
+#include <primitiv/cpp_exporter.h>
+#include <primitiv/data_loader.h>
 #include <primitiv/error.h>
 #include <primitiv/functions.h>
 #include <primitiv/graph.h>
 #include <primitiv/initializer_impl.h>
 #include <primitiv/model.h>
 #include <primitiv/naive_device.h>
+#include <primitiv/packed_sequence.h>
 #include <primitiv/parameter.h>
 #include <primitiv/shape.h>
 #include <primitiv/tensor.h>
@@ -19,6 +25,7 @@
 // Header files for specific device classes.
 #ifdef PRIMITIV_USE_EIGEN
 #include <primitiv/eigen_device.h>
+#include <primitiv/hybrid_device.h>
 #endif  // PRIMITIV_USE_EIGEN
 #ifdef PRIMITIV_USE_CUDA
 #include <primitiv/cuda_device.h>
@@ -0,0 +1,313 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <primitiv/random.h>
+
+namespace {
+
+// Constants of Philox4x32-10.
+constexpr std::uint32_t PHILOX_M0 = 0xd2511f53;
+constexpr std::uint32_t PHILOX_M1 = 0xcd9e8d57;
+constexpr std::uint32_t PHILOX_W0 = 0x9e3779b9;
+constexpr std::uint32_t PHILOX_W1 = 0xbb67ae85;
+constexpr std::uint32_t PHILOX_ROUNDS = 10;
+
+// Number of blocks processed at once.
+// Each step of the algorithm is performed over all blocks in the same loop so
+// that the compiler can vectorize it.
+constexpr std::size_t NUM_LANES = 64;
+constexpr std::size_t BLOCK_SIZE = primitiv::PhiloxRandomizer::BLOCK_SIZE;
+
+// Scales for converting 24 upper bits into floats.
+constexpr float INV_2_24 = 1.f / (1 << 24);
+
+// One round of Philox4x32.
+inline void philox_round(
+    std::uint32_t &c0, std::uint32_t &c1, std::uint32_t &c2, std::uint32_t &c3,
+    std::uint32_t k0, std::uint32_t k1) {
+  const std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * c0;
+  const std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * c2;
+  c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+  c1 = static_cast<std::uint32_t>(p1);
+  c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+  c3 = static_cast<std::uint32_t>(p0);
+}
+
+// Calculates `n` consecutive blocks starting from the counter `first`.
+// r[j][l] is the j-th value of the l-th block.
+void philox_lanes(
+    std::uint32_t seed, std::uint32_t stream, std::uint64_t first,
+    std::size_t n, std::uint32_t r[BLOCK_SIZE][NUM_LANES]) {
+  std::uint32_t *c0 = r[0], *c1 = r[1], *c2 = r[2], *c3 = r[3];
+  for (std::size_t l = 0; l < n; ++l) {
+    const std::uint64_t ctr = first + l;
+    c0[l] = static_cast<std::uint32_t>(ctr);
+    c1[l] = static_cast<std::uint32_t>(ctr >> 32);
+    c2[l] = 0;
+    c3[l] = 0;
+  }
+  std::uint32_t k0 = seed, k1 = stream;
+  for (std::uint32_t round = 0; round < PHILOX_ROUNDS; ++round) {
+    for (std::size_t l = 0; l < n; ++l) {
+      ::philox_round(c0[l], c1[l], c2[l], c3[l], k0, k1);
+    }
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+
+// Converts a random integer into a float in [0, 1).
+inline float to_unit_closed_open(std::uint32_t x) {
+  return (x >> 8) * INV_2_24;
+}
+
+// Converts a random integer into a float in (0, 1].
+inline float to_unit_open_closed(std::uint32_t x) {
+  return ((x >> 8) + 1) * INV_2_24;
+}
+
+// Common driver of PhiloxRandomizer::generate_*().
+// `transform(r, n, y)` converts `n` blocks of random integers into floats,
+// where y[l * BLOCK_SIZE + j] should be calculated from r[j][l].
+template<typename Transform>
+void generate(
+    std::uint32_t seed, std::uint32_t stream, std::uint64_t offset,
+    std::size_t begin, std::size_t end, float *data, Transform transform) {
+  if (begin >= end) return;
+  const std::size_t first_block = begin / BLOCK_SIZE;
+  const std::size_t last_block = (end + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  std::uint32_t r[BLOCK_SIZE][NUM_LANES];
+  float y[NUM_LANES * BLOCK_SIZE];
+  for (std::size_t b = first_block; b < last_block; b += NUM_LANES) {
+    const std::size_t n = std::min(NUM_LANES, last_block - b);
+    ::philox_lanes(seed, stream, offset + b, n, r);
+    transform(r, n, y);
+    const std::size_t base = b * BLOCK_SIZE;
+    const std::size_t lo = std::max(begin, base);
+    const std::size_t hi = std::min(end, base + n * BLOCK_SIZE);
+    std::copy(y + lo - base, y + hi - base, data + lo);
+  }
+}
+
+// Elementary functions used by distribution transforms.
+// These are branch-free polynomial approximations (based on Cephes) with
+// errors of a few ULPs, so that loops over lanes can be vectorized unlike
+// calls of std::log() etc.
+
+// Reinterprets bits of float values.
+inline std::uint32_t float_as_bits(float x) {
+  std::uint32_t r;
+  std::memcpy(&r, &x, sizeof(r));
+  return r;
+}
+
+inline float bits_as_float(std::uint32_t x) {
+  float r;
+  std::memcpy(&r, &x, sizeof(r));
+  return r;
+}
+
+// Natural logarithm for finite positive normal numbers.
+inline float poly_log(float x) {
+  const std::uint32_t bits = ::float_as_bits(x);
+  // x = m * 2^e with m in [0.5, 1).
+  float e = static_cast<float>(static_cast<std::int32_t>(bits >> 23) - 126);
+  float m = ::bits_as_float((bits & 0x007fffff) | 0x3f000000);
+  // Shifts m into [sqrt(0.5) - 1, sqrt(2) - 1).
+  const bool small = m < .707106781186547524f;
+  e = small ? e - 1 : e;
+  m = small ? m + m - 1 : m - 1;
+  const float z = m * m;
+  float y = 7.0376836292e-2f;
+  y = y * m - 1.1514610310e-1f;
+  y = y * m + 1.1676998740e-1f;
+  y = y * m - 1.2420140846e-1f;
+  y = y * m + 1.4249322787e-1f;
+  y = y * m - 1.6668057665e-1f;
+  y = y * m + 2.0000714765e-1f;
+  y = y * m - 2.4999993993e-1f;
+  y = y * m + 3.3333331174e-1f;
+  y = y * m * z;
+  y += -2.12194440e-4f * e;
+  y += -.5f * z;
+  return m + y + .693359375f * e;
+}
+
+// Square root for finite non-negative numbers, using Newton's method on the
+// reciprocal square root.
+inline float poly_sqrt(float x) {
+  float y = ::bits_as_float(0x5f3759df - (::float_as_bits(x) >> 1));
+  for (std::uint32_t i = 0; i < 3; ++i) y *= 1.5f - .5f * x * y * y;
+  return x * y;
+}
+
+// Exponential function for finite numbers.
+// NOTE: Selections are written with non-constant operands, otherwise GCC does
+// not vectorize the loop.
+inline float poly_exp(float x) {
+  const bool under = x < -87.f;
+  const bool over = x > 88.f;
+  const float xc = under ? x * 0.f - 87.f : over ? x * 0.f + 88.f : x;
+  // x = n * log(2) + r with |r| <= log(2) / 2.
+  const std::int32_t n = static_cast<std::int32_t>(
+      1.44269504088896341f * xc + 128.5f) - 128;
+  const float nf = static_cast<float>(n);
+  const float r = xc - .693359375f * nf + 2.12194440e-4f * nf;
+  const float z = r * r;
+  float y = 1.9875691500e-4f;
+  y = y * r + 1.3981999507e-3f;
+  y = y * r + 8.3334519073e-3f;
+  y = y * r + 4.1665795894e-2f;
+  y = y * r + 1.6666665459e-1f;
+  y = y * r + 5.0000001201e-1f;
+  y = y * z + r + 1;
+  y *= ::bits_as_float(static_cast<std::uint32_t>(n + 127) << 23);
+  return under ? 0.f * y : over ? HUGE_VALF * y : y;
+}
+
+// Calculates sin(2 * pi * u) and cos(2 * pi * u) for u in [0, 1).
+inline void poly_sincos_2pi(float u, float &s, float &c) {
+  // The argument is reduced in units of pi / 4, which is exact for u.
+  const float t = 8 * u;
+  const std::int32_t j = (static_cast<std::int32_t>(t) + 1) & ~1;
+  const float r = (t - j) * .785398163397448309f;
+  const float z = r * r;
+  const float sr = r + r * z * (
+      (-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+  const float cr = 1 - .5f * z + z * z * (
+      (2.443315711809948e-5f * z - 1.388731625493765e-3f) * z
+      + 4.166664568298827e-2f);
+  // Octants: t in [j - 1, j + 1) is rotated by j * pi / 4.
+  const std::int32_t q = (j >> 1) & 3;
+  const float s0 = (q & 1) ? cr : sr;
+  const float c0 = (q & 1) ? sr : cr;
+  s = (q & 2) ? -s0 : s0;
+  c = ((q + 1) & 2) ? -c0 : c0;
+}
+
+// Box-Muller transform generating 4 normal random numbers from each block.
+void box_muller(
+    float mean, float sd, std::uint32_t r[BLOCK_SIZE][NUM_LANES],
+    std::size_t n, float *y) {
+  for (std::uint32_t j = 0; j < BLOCK_SIZE; j += 2) {
+    for (std::size_t l = 0; l < n; ++l) {
+      const float u1 = ::to_unit_open_closed(r[j][l]);
+      const float u2 = ::to_unit_closed_open(r[j + 1][l]);
+      const float rad = sd * ::poly_sqrt(-2 * ::poly_log(u1));
+      float s, c;
+      ::poly_sincos_2pi(u2, s, c);
+      y[l * BLOCK_SIZE + j] = mean + rad * c;
+      y[l * BLOCK_SIZE + j + 1] = mean + rad * s;
+    }
+  }
+}
+
+}  // namespace
+
+namespace primitiv {
+
+constexpr std::size_t PhiloxRandomizer::BLOCK_SIZE;
+
+void PhiloxRandomizer::philox4x32(
+    const std::uint32_t counter[4], const std::uint32_t key[2],
+    std::uint32_t result[4]) {
+  std::uint32_t c0 = counter[0], c1 = counter[1];
+  std::uint32_t c2 = counter[2], c3 = counter[3];
+  std::uint32_t k0 = key[0], k1 = key[1];
+  for (std::uint32_t round = 0; round < PHILOX_ROUNDS; ++round) {
+    ::philox_round(c0, c1, c2, c3, k0, k1);
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  result[0] = c0;
+  result[1] = c1;
+  result[2] = c2;
+  result[3] = c3;
+}
+
+void PhiloxRandomizer::fill_bernoulli_bits(
+    float p, std::size_t size, std::uint32_t *bits) {
+  const std::uint64_t offset = reserve(size);
+  // 8 blocks make one 32-bit word.
+  constexpr std::size_t BLOCKS_PER_WORD = 32 / BLOCK_SIZE;
+  static_assert(NUM_LANES % BLOCKS_PER_WORD == 0, "");
+  const std::size_t num_words = (size + 31) / 32;
+  std::uint32_t r[BLOCK_SIZE][NUM_LANES];
+  for (std::size_t w = 0; w < num_words; w += NUM_LANES / BLOCKS_PER_WORD) {
+    const std::size_t num_blocks = std::min(
+        NUM_LANES, (size + BLOCK_SIZE - 1) / BLOCK_SIZE - w * BLOCKS_PER_WORD);
+    ::philox_lanes(seed_, stream_, offset + w * BLOCKS_PER_WORD, num_blocks, r);
+    for (std::size_t l = 0; l < num_blocks; ++l) {
+      std::uint32_t nibble = 0;
+      for (std::uint32_t j = 0; j < BLOCK_SIZE; ++j) {
+        nibble |= static_cast<std::uint32_t>(
+            ::to_unit_closed_open(r[j][l]) < p) << j;
+      }
+      const std::size_t shift = (l % BLOCKS_PER_WORD) * BLOCK_SIZE;
+      std::uint32_t &word = bits[w + l / BLOCKS_PER_WORD];
+      word = (shift ? word : 0) | nibble << shift;
+    }
+  }
+  // Clears unused bits in the last word.
+  if (size % 32) bits[num_words - 1] &= (1u << (size % 32)) - 1;
+}
+
+void PhiloxRandomizer::generate_bernoulli(
+    float p, std::uint64_t offset, std::size_t begin, std::size_t end,
+    float *data) const {
+  ::generate(
+      seed_, stream_, offset, begin, end, data,
+      [p](std::uint32_t r[BLOCK_SIZE][NUM_LANES], std::size_t n, float *y) {
+        for (std::size_t l = 0; l < n; ++l) {
+          for (std::uint32_t j = 0; j < BLOCK_SIZE; ++j) {
+            y[l * BLOCK_SIZE + j] = ::to_unit_closed_open(r[j][l]) < p;
+          }
+        }
+      });
+}
+
+void PhiloxRandomizer::generate_uniform(
+    float lower, float upper, std::uint64_t offset,
+    std::size_t begin, std::size_t end, float *data) const {
+  const float scale = upper - lower;
+  ::generate(
+      seed_, stream_, offset, begin, end, data,
+      [lower, upper, scale](
+          std::uint32_t r[BLOCK_SIZE][NUM_LANES], std::size_t n, float *y) {
+        for (std::size_t l = 0; l < n; ++l) {
+          for (std::uint32_t j = 0; j < BLOCK_SIZE; ++j) {
+            const float x = lower + scale * ::to_unit_open_closed(r[j][l]);
+            y[l * BLOCK_SIZE + j] = x == lower ? upper : x;
+          }
+        }
+      });
+}
+
+void PhiloxRandomizer::generate_normal(
+    float mean, float sd, std::uint64_t offset,
+    std::size_t begin, std::size_t end, float *data) const {
+  ::generate(
+      seed_, stream_, offset, begin, end, data,
+      [mean, sd](
+          std::uint32_t r[BLOCK_SIZE][NUM_LANES], std::size_t n, float *y) {
+        ::box_muller(mean, sd, r, n, y);
+      });
+}
+
+void PhiloxRandomizer::generate_log_normal(
+    float mean, float sd, std::uint64_t offset,
+    std::size_t begin, std::size_t end, float *data) const {
+  ::generate(
+      seed_, stream_, offset, begin, end, data,
+      [mean, sd](
+          std::uint32_t r[BLOCK_SIZE][NUM_LANES], std::size_t n, float *y) {
+        ::box_muller(mean, sd, r, n, y);
+        for (std::size_t i = 0; i < n * BLOCK_SIZE; ++i) {
+          y[i] = ::poly_exp(y[i]);
+        }
+      });
+}
+
+}  // namespace primitiv
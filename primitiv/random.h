@@ -1,7 +1,9 @@
 #ifndef PRIMITIV_RANDOM_H_
 #define PRIMITIV_RANDOM_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <random>
 #include <primitiv/mixins.h>
 
@@ -38,6 +40,27 @@ public:
     }
   }
 
+  /**
+   * Fill a bit array using a Bernoulli distribution.
+   * @param p Probability with witch the bit becomes 1.
+   * @param size Number of bits.
+   * @param bits Pointer of the array with `(size + 31) / 32` elements. The
+   *             i-th bit is stored in `(bits[i / 32] >> (i % 32)) & 1`.
+   * @remarks The resulting bits are same as the results of `fill_bernoulli()`
+   *          with the same state.
+   */
+  void fill_bernoulli_bits(float p, std::size_t size, std::uint32_t *bits) {
+    std::bernoulli_distribution dist(p);
+    for (std::size_t w = 0; w < (size + 31) / 32; ++w) {
+      const std::size_t n = std::min<std::size_t>(32, size - 32 * w);
+      std::uint32_t word = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        word |= static_cast<std::uint32_t>(dist(rng_)) << i;
+      }
+      bits[w] = word;
+    }
+  }
+
   /**
    * Fill an array using a uniform distribution.
    * @param lower Lower bound of the distribution.
@@ -83,6 +106,200 @@ public:
   }
 };
 
+/**
+ * Counter-based randomizer using the Philox4x32-10 algorithm.
+ *
+ * Each call of the underlying function maps a 128-bit counter into 4 random
+ * 32-bit values, and the i-th value of a fill operation depends only on the
+ * seed, the stream ID and the position `offset() * 4 + i`. Blocks can be
+ * generated independently of each other, which allows the fill loops to be
+ * vectorized and to be divided among any number of threads without changing
+ * results.
+ */
+class PhiloxRandomizer : mixins::Nonmovable<PhiloxRandomizer> {
+  std::uint32_t seed_;
+  std::uint32_t stream_;
+  std::uint64_t offset_;
+
+public:
+  /**
+   * Number of random values generated by one counter.
+   */
+  static constexpr std::size_t BLOCK_SIZE = 4;
+
+  /**
+   * Creates a randomizer object using environment seeds.
+   */
+  PhiloxRandomizer()
+    : seed_(std::random_device()()), stream_(0), offset_(0) {}
+
+  /**
+   * Creates a randomizer object using a user seed.
+   * @param seed Seed value of the randomizer.
+   * @param stream Stream ID. Randomizers with the same seed and different
+   *               stream IDs generate independent sequences.
+   */
+  explicit PhiloxRandomizer(std::uint32_t seed, std::uint32_t stream = 0)
+    : seed_(seed), stream_(stream), offset_(0) {}
+
+  /**
+   * Returns the seed value.
+   * @return Seed value.
+   */
+  std::uint32_t seed() const { return seed_; }
+
+  /**
+   * Returns the stream ID.
+   * @return Stream ID.
+   */
+  std::uint32_t stream() const { return stream_; }
+
+  /**
+   * Returns the number of counters consumed so far.
+   * @return Current counter value.
+   */
+  std::uint64_t offset() const { return offset_; }
+
+  /**
+   * Consumes counters to generate the specified number of values.
+   * @param size Number of values.
+   * @return Counter value before calling this function, which should be
+   *         passed to `generate_*()` functions.
+   */
+  std::uint64_t reserve(std::size_t size) {
+    const std::uint64_t ret = offset_;
+    offset_ += (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    return ret;
+  }
+
+  /**
+   * Calculates one block of random values.
+   * @param counter 128-bit counter.
+   * @param key 64-bit key.
+   * @param result Array in which 4 results are stored.
+   */
+  static void philox4x32(
+      const std::uint32_t counter[4], const std::uint32_t key[2],
+      std::uint32_t result[4]);
+
+  /**
+   * Fill an array using a Bernoulli distribution.
+   * @param p Probability with witch the variable becomes 1.
+   * @param size Length of the array `data`.
+   * @param data Pointer of the array in which results are stored.
+   */
+  void fill_bernoulli(float p, std::size_t size, float *data) {
+    generate_bernoulli(p, reserve(size), 0, size, data);
+  }
+
+  /**
+   * Fill a bit array using a Bernoulli distribution.
+   * @param p Probability with witch the bit becomes 1.
+   * @param size Number of bits.
+   * @param bits Pointer of the array with `(size + 31) / 32` elements. The
+   *             i-th bit is stored in `(bits[i / 32] >> (i % 32)) & 1`.
+   * @remarks The resulting bits are same as the results of `fill_bernoulli()`
+   *          with the same state.
+   */
+  void fill_bernoulli_bits(float p, std::size_t size, std::uint32_t *bits);
+
+  /**
+   * Fill an array using a uniform distribution.
+   * @param lower Lower bound of the distribution.
+   * @param upper Upper bound of the distribution.
+   * @param size Length of the array `data`.
+   * @param data Pointer of the array in which results are stored.
+   * @remarks Range of the resulting sequence is (lower, upper].
+   */
+  void fill_uniform(float lower, float upper, std::size_t size, float *data) {
+    generate_uniform(lower, upper, reserve(size), 0, size, data);
+  }
+
+  /**
+   * Fill an array using a normal distribution.
+   * @param mean Mean of the distribution.
+   * @param sd Standard deviation of the distribution.
+   * @param size Length of the array `data`.
+   * @param data Pointer of the array in which results are stored.
+   */
+  void fill_normal(float mean, float sd, std::size_t size, float *data) {
+    generate_normal(mean, sd, reserve(size), 0, size, data);
+  }
+
+  /**
+   * Fill an array using a log-normal distribution.
+   * @param mean Mean of the corresponding normal distribution.
+   * @param sd Standard deviation of the corresponding normal distribution.
+   * @param size Length of the array `data`.
+   * @param data Pointer of the array in which results are stored.
+   */
+  void fill_log_normal(float mean, float sd, std::size_t size, float *data) {
+    generate_log_normal(mean, sd, reserve(size), 0, size, data);
+  }
+
+  /**
+   * Generates a part of the sequence of a Bernoulli distribution without
+   * changing the internal state.
+   * @param p Probability with witch the variable becomes 1.
+   * @param offset Counter value of the first element, typically obtained by
+   *               `reserve()`.
+   * @param begin Position of the first element to be generated.
+   * @param end Position of the next to the last element to be generated.
+   * @param data Pointer of the whole array. Only `data[begin]` to
+   *             `data[end - 1]` are modified.
+   * @remarks This function is thread-safe, and the results are identical to
+   *          the corresponding part of `fill_bernoulli()`.
+   */
+  void generate_bernoulli(
+      float p, std::uint64_t offset, std::size_t begin, std::size_t end,
+      float *data) const;
+
+  /**
+   * Generates a part of the sequence of a uniform distribution without
+   * changing the internal state.
+   * @param lower Lower bound of the distribution.
+   * @param upper Upper bound of the distribution.
+   * @param offset Counter value of the first element.
+   * @param begin Position of the first element to be generated.
+   * @param end Position of the next to the last element to be generated.
+   * @param data Pointer of the whole array.
+   * @remarks See also `generate_bernoulli()`.
+   */
+  void generate_uniform(
+      float lower, float upper, std::uint64_t offset,
+      std::size_t begin, std::size_t end, float *data) const;
+
+  /**
+   * Generates a part of the sequence of a normal distribution without
+   * changing the internal state.
+   * @param mean Mean of the distribution.
+   * @param sd Standard deviation of the distribution.
+   * @param offset Counter value of the first element.
+   * @param begin Position of the first element to be generated.
+   * @param end Position of the next to the last element to be generated.
+   * @param data Pointer of the whole array.
+   * @remarks See also `generate_bernoulli()`.
+   */
+  void generate_normal(
+      float mean, float sd, std::uint64_t offset,
+      std::size_t begin, std::size_t end, float *data) const;
+
+  /**
+   * Generates a part of the sequence of a log-normal distribution without
+   * changing the internal state.
+   * @param mean Mean of the corresponding normal distribution.
+   * @param sd Standard deviation of the corresponding normal distribution.
+   * @param offset Counter value of the first element.
+   * @param begin Position of the first element to be generated.
+   * @param end Position of the next to the last element to be generated.
+   * @param data Pointer of the whole array.
+   * @remarks See also `generate_bernoulli()`.
+   */
+  void generate_log_normal(
+      float mean, float sd, std::uint64_t offset,
+      std::size_t begin, std::size_t end, float *data) const;
+};
+
 }  // namespace primitiv
 
 #endif  // PRIMITIV_RANDOM_H_
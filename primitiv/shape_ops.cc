@@ -111,6 +111,46 @@ Shape pick(const Shape &x, const std::vector<std::uint32_t> &ids, std::uint32_t
   return ret;
 }
 
+Shape batch_pick(const Shape &x, const std::vector<std::uint32_t> &ids) {
+  const std::uint32_t n = x.batch();
+  if (ids.empty()) {
+    THROW_ERROR(
+        "Invalid IDs to pick. shape: " << x.to_string()
+        << ", ids.size(): " << ids.size());
+  }
+  for (std::uint32_t i = 0; i < ids.size(); ++i) {
+    if (ids[i] >= n) {
+      THROW_ERROR(
+          "Invalid IDs to pick. shape: " << x.to_string()
+          << ", ids[" << i << "]: " << ids[i]);
+    }
+  }
+  return x.resize_batch(ids.size());
+}
+
+Shape batch_slice(const Shape &x, std::uint32_t lower, std::uint32_t upper) {
+  if (lower >= upper || upper > x.batch()) {
+    THROW_ERROR(
+        "Invalid batch slice. shape: " << x.to_string()
+        << ", lower: " << lower << ", upper: " << upper);
+  }
+  return x.resize_batch(upper - lower);
+}
+
+Shape batch_concat(const std::vector<const Shape *> &xs) {
+  if (xs.empty()) THROW_ERROR("No tensors to be concatenated.");
+  std::uint32_t bs = 0;
+  for (const Shape *x : xs) {
+    if (!x->has_same_dims(*xs[0])) {
+      THROW_ERROR(
+          "Invalid shapes to be concatenated: " << xs[0]->to_string()
+          << ", " << x->to_string());
+    }
+    bs += x->batch();
+  }
+  return xs[0]->resize_batch(bs);
+}
+
 Shape transpose(const Shape &x) {
   if (!x.is_matrix()) {
     THROW_ERROR("Invalid shape to transpose: " << x.to_string());
@@ -84,6 +84,30 @@ Shape broadcast(const Shape &x, std::uint32_t dim, std::uint32_t size);
  */
 Shape pick(const Shape &x, const std::vector<std::uint32_t> &ids, std::uint32_t dim);
 
+/**
+ * Calculates the shape of the batch selection.
+ * @param x A shape.
+ * @param ids Minibatch IDs to be picked.
+ * @return A shape.
+ */
+Shape batch_pick(const Shape &x, const std::vector<std::uint32_t> &ids);
+
+/**
+ * Calculates the shape of the minibatch slice.
+ * @param x A shape.
+ * @param lower Lower bound of the minibatch.
+ * @param upper Upper bound of the minibatch.
+ * @return A shape.
+ */
+Shape batch_slice(const Shape &x, std::uint32_t lower, std::uint32_t upper);
+
+/**
+ * Calculates the shape concatenated along the minibatch.
+ * @param xs A list of shapes.
+ * @return A shape.
+ */
+Shape batch_concat(const std::vector<const Shape *> &xs);
+
 /**
  * Calculates the transposed shape.
  * @param x A shape.
@@ -0,0 +1,91 @@
+#ifndef PRIMITIV_SMALL_KERNELS_H_
+#define PRIMITIV_SMALL_KERNELS_H_
+
+#include <cstdint>
+
+namespace primitiv {
+namespace small_kernels {
+
+/**
+ * Maximum number of rows of the resulting matrix supported by matmul kernels.
+ * Kernels are provided only for powers of 2 up to this value.
+ */
+constexpr std::uint32_t MAX_MATMUL_ROWS = 8;
+
+/**
+ * Maximum number of columns of the resulting matrix supported by matmul
+ * kernels.
+ */
+constexpr std::uint32_t MAX_MATMUL_COLS = 8;
+
+/**
+ * Type of matmul kernels.
+ * Arguments are `(a, b, y, k)`, where `a`, `b` and `y` are column-major
+ * matrices with shapes MxK, KxN and MxN respectively.
+ */
+using MatmulKernel = void (*)(
+    const float *, const float *, float *, std::uint32_t);
+
+/**
+ * Calculates y = a . b with compile-time row/column sizes.
+ * @param a Pointer to the MxK matrix.
+ * @param b Pointer to the KxN matrix.
+ * @param y Pointer to the MxN resulting matrix.
+ * @param k The number of columns of `a`.
+ * @remarks Every R consecutive columns of `a` are treated as one contiguous
+ *          block with 32 elements. The innermost loop then has a fixed length
+ *          and a fixed broadcasting pattern of `b`, which can be vectorized
+ *          without any runtime blocking.
+ */
+template<std::uint32_t M, std::uint32_t N>
+void matmul(const float *a, const float *b, float *y, std::uint32_t k) {
+  static_assert(32 % M == 0, "M should be a divisor of 32.");
+  constexpr std::uint32_t R = 32 / M;
+  constexpr std::uint32_t L = M * R;
+  for (std::uint32_t n = 0; n < N; ++n) {
+    const float *bn = b + n * k;
+    float *yn = y + n * M;
+    float acc[L] = {};
+    std::uint32_t j = 0;
+    for (; j + R <= k; j += R) {
+      const float *pa = a + j * M;
+      const float *pb = bn + j;
+      for (std::uint32_t q = 0; q < L; ++q) acc[q] += pa[q] * pb[q / M];
+    }
+    for (std::uint32_t m = 0; m < M; ++m) {
+      float sum = 0;
+      for (std::uint32_t r = 0; r < R; ++r) sum += acc[r * M + m];
+      yn[m] = sum;
+    }
+    for (; j < k; ++j) {
+      const float *pa = a + j * M;
+      for (std::uint32_t m = 0; m < M; ++m) yn[m] += pa[m] * bn[j];
+    }
+  }
+}
+
+/**
+ * Retrieves the matmul kernel specialized for the given size.
+ * @param m The number of rows of the resulting matrix.
+ * @param n The number of columns of the resulting matrix.
+ * @return The specialized kernel, or nullptr if there is no kernel for the
+ *         size.
+ */
+inline MatmulKernel get_matmul_kernel(std::uint32_t m, std::uint32_t n) {
+#define ROW(m) \
+  matmul<m, 1>, matmul<m, 2>, matmul<m, 3>, matmul<m, 4>, \
+  matmul<m, 5>, matmul<m, 6>, matmul<m, 7>, matmul<m, 8>
+  static const MatmulKernel table[4 * MAX_MATMUL_COLS] {
+    ROW(1), ROW(2), ROW(4), ROW(8),
+  };
+#undef ROW
+  if (m == 0 || m > MAX_MATMUL_ROWS || (m & (m - 1))) return nullptr;
+  if (n == 0 || n > MAX_MATMUL_COLS) return nullptr;
+  const std::uint32_t row = m == 1 ? 0 : m == 2 ? 1 : m == 4 ? 2 : 3;
+  return table[row * MAX_MATMUL_COLS + (n - 1)];
+}
+
+}  // namespace small_kernels
+}  // namespace primitiv
+
+#endif  // PRIMITIV_SMALL_KERNELS_H_
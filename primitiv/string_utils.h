@@ -1,7 +1,9 @@
 #ifndef PRIMITIV_STRING_UTILS_H_
 #define PRIMITIV_STRING_UTILS_H_
 
+#include <cmath>
 #include <cstdint>
+#include <iomanip>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -18,7 +20,7 @@ namespace string_utils {
  *           1 content         : strs[0]
  *           2 contents or more: strs[0] + delim + strs[1] + delim + ...
  */
-std::string join(
+inline std::string join(
     const std::vector<std::string> &strs,
     const std::string &delim) {
   if (strs.empty()) return std::string();
@@ -28,6 +30,42 @@ std::string join(
   return ss.str();
 }
 
+/**
+ * Converts a float value into a C++ expression which represents the same
+ * value.
+ * @param x A float value.
+ * @return A float literal, or an expression using std::numeric_limits for
+ *         infinities and NaN.
+ */
+inline std::string to_cpp_literal(float x) {
+  if (std::isnan(x)) return "std::numeric_limits<float>::quiet_NaN()";
+  if (std::isinf(x)) {
+    return x > 0
+      ? "std::numeric_limits<float>::infinity()"
+      : "-std::numeric_limits<float>::infinity()";
+  }
+  // 9 significant digits are enough to restore any float value.
+  std::stringstream ss;
+  ss << std::setprecision(9) << x;
+  std::string ret = ss.str();
+  if (ret.find_first_of(".e") == std::string::npos) ret += '.';
+  return ret + 'f';
+}
+
+/**
+ * Converts a float value into an expression of C (including OpenCL C) which
+ * represents the same value.
+ * @param x A float value.
+ * @return A float literal, or an expression using INFINITY and NAN macros.
+ */
+inline std::string to_c_literal(float x) {
+  if (std::isnan(x)) return "NAN";
+  if (std::isinf(x)) return x > 0 ? "INFINITY" : "(-INFINITY)";
+  // Negative values are enclosed to be used as operands of any operators.
+  if (std::signbit(x)) return '(' + to_cpp_literal(x) + ')';
+  return to_cpp_literal(x);
+}
+
 }  // namespace string_utils
 }  // namespace primitiv
 
@@ -30,8 +30,36 @@ std::vector<std::uint32_t> Tensor::argmin(std::uint32_t dim) const {
   return device_->argmin(*this, dim);
 }
 
+std::vector<std::uint32_t> Tensor::topk(
+    std::uint32_t dim, std::uint32_t k) const {
+  check_valid();
+  std::vector<float> values;
+  return device_->topk(*this, dim, k, values);
+}
+
+std::vector<std::uint32_t> Tensor::topk(
+    std::uint32_t dim, std::uint32_t k, std::vector<float> &values) const {
+  check_valid();
+  return device_->topk(*this, dim, k, values);
+}
+
+std::vector<std::uint32_t> Tensor::sample(
+    std::uint32_t dim, std::uint32_t k) const {
+  check_valid();
+  return device_->sample(*this, dim, k);
+}
+
+void Tensor::resolve() const {
+  if (!deferred_) return;
+  if (!*deferred_) device_->flush();
+  if (!*deferred_) THROW_ERROR("Deferred operation was not executed.");
+  handle_ = *deferred_;
+  deferred_.reset();
+}
+
 void *Tensor::mutable_handle() {
   check_valid();
+  resolve();
   // If the internal memory is shared with other objects, the memory will be
   // duplicated to maintain the safety of other objects.
   if (handle_.use_count() > 1) {
@@ -57,12 +85,16 @@ void Tensor::reset_by_vector(const std::vector<float> &values) {
 
 Tensor Tensor::reshape(const Shape &new_shape) const {
   check_valid();
-  return Tensor(shape_ops::reshape(shape_, new_shape), *device_, handle_);
+  Tensor ret(shape_ops::reshape(shape_, new_shape), *device_, handle_);
+  ret.deferred_ = deferred_;
+  return ret;
 }
 
 Tensor Tensor::flatten() const {
   check_valid();
-  return Tensor(shape_ops::flatten(shape_), *device_, handle_);
+  Tensor ret(shape_ops::flatten(shape_), *device_, handle_);
+  ret.deferred_ = deferred_;
+  return ret;
 }
 
 Tensor &Tensor::inplace_multiply_const(float k) {
@@ -23,7 +23,8 @@ public:
   Tensor(Tensor &&src)
     : shape_(std::move(src.shape_))
     , device_(src.device_)
-    , handle_(std::move(src.handle_)) {
+    , handle_(std::move(src.handle_))
+    , deferred_(std::move(src.deferred_)) {
       src.device_ = nullptr;
     }
 
@@ -34,6 +35,7 @@ public:
       shape_ = std::move(src.shape_);
       device_ = src.device_;
       handle_ = std::move(src.handle_);
+      deferred_ = std::move(src.deferred_);
       src.device_ = nullptr;
     }
     return *this;
@@ -110,6 +112,40 @@ public:
    */
   std::vector<std::uint32_t> argmin(std::uint32_t dim) const;
 
+  /**
+   * Retrieves indices of the k largest values along an axis.
+   * @param dim A specified axis.
+   * @param k Number of elements to be retrieved from each slice.
+   * @return A list of integers that indicates positions of the k largest
+   *         values. Results of each slice are stored in `k` consecutive
+   *         elements and ordered by descending values.
+   */
+  std::vector<std::uint32_t> topk(std::uint32_t dim, std::uint32_t k) const;
+
+  /**
+   * Retrieves the k largest values and their indices along an axis.
+   * @param dim A specified axis.
+   * @param k Number of elements to be retrieved from each slice.
+   * @param values A list to store the resulting values, which has the same
+   *               layout as the return value.
+   * @return A list of integers that indicates positions of the k largest
+   *         values.
+   */
+  std::vector<std::uint32_t> topk(
+      std::uint32_t dim, std::uint32_t k, std::vector<float> &values) const;
+
+  /**
+   * Draws indices from categorical distributions along an axis.
+   * @param dim A specified axis.
+   * @param k Number of distinct indices to be drawn from each slice.
+   * @return A list of sampled indices. Results of each slice are stored in
+   *         `k` consecutive elements.
+   * @remarks Values of this tensor are treated as unnormalized
+   *          log-probabilities, i.e., each slice is sampled according to
+   *          `softmax(x, dim)`.
+   */
+  std::vector<std::uint32_t> sample(std::uint32_t dim, std::uint32_t k = 1) const;
+
   /**
    * Invalidates this object.
    */
@@ -118,6 +154,7 @@ public:
     // Not necessary to update `shape_` because it is never accessed anywhere.
     //shape_ = Shape();
     handle_.reset();
+    deferred_.reset();
     device_ = nullptr;
   }
 
@@ -198,6 +235,7 @@ private:
    */
   const void *handle() const {
     check_valid();
+    resolve();
     return handle_.get();
   }
 
@@ -207,9 +245,21 @@ private:
    */
   void *mutable_handle();
 
+  /**
+   * Obtains the internal memory calculated by the deferred operation.
+   * @remarks This function executes deferred operations on the device if
+   *          necessary.
+   */
+  void resolve() const;
+
   Shape shape_;
   Device *device_;
-  std::shared_ptr<void> handle_;
+  mutable std::shared_ptr<void> handle_;
+
+  // Result slot of the deferred operation in the lazy mode of the device,
+  // which is shared by all copies of this object. This is nullptr if the
+  // object already has its own internal memory.
+  mutable std::shared_ptr<std::shared_ptr<void>> deferred_;
 };
 
 }  // namespace primitiv
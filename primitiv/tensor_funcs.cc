@@ -257,6 +257,21 @@ Tensor logsumexp(const Tensor &x, std::uint32_t dim) {
   return x.device().logsumexp_fw(x, dim);
 }
 
+template<>
+Tensor max(const Tensor &x, std::uint32_t dim) {
+  return x.device().max_fw(x, dim);
+}
+
+template<>
+Tensor min(const Tensor &x, std::uint32_t dim) {
+  return x.device().min_fw(x, dim);
+}
+
+template<>
+Tensor squared_norm(const Tensor &x, std::uint32_t dim) {
+  return x.device().squared_norm_fw(x, dim);
+}
+
 template<>
 Tensor log_softmax(const Tensor &x, std::uint32_t dim) {
   return x - broadcast(logsumexp(x, dim), dim, x.shape()[dim]);
@@ -281,8 +296,37 @@ Tensor softmax_cross_entropy(
 template<>
 Tensor stop_gradient(const Tensor &x) { return x; }
 
+template<>
+Tensor dropout(const Tensor &x, float rate, bool enabled) {
+  if (!enabled) return x;
+  if (rate == 1.) return 0. * x;
+  Tensor mask;
+  return x.device().dropout_fw(x, rate, mask);
+}
+
 namespace batch {
 
+template<>
+Tensor pick(const Tensor &x, const std::vector<std::uint32_t> &ids) {
+  return x.device().batch_pick_fw(x, ids);
+}
+
+template<>
+Tensor slice(const Tensor &x, std::uint32_t lower, std::uint32_t upper) {
+  return x.device().batch_slice_fw(x, lower, upper);
+}
+
+template<>
+Tensor concat(const std::vector<const Tensor *> &xs) {
+  if (xs.empty()) THROW_ERROR("No tensors to be concatenated.");
+  return xs[0]->device().batch_concat_fw(xs);
+}
+
+template<>
+Tensor concat(const std::vector<Tensor> &xs) {
+  return concat(::obj_to_ptr(xs));
+}
+
 template<>
 Tensor sum(const Tensor &x) {
   return x.device().batch_sum_fw(x);
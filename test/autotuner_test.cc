@@ -0,0 +1,112 @@
+#include <primitiv/config.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/autotuner.h>
+#include <primitiv/error.h>
+#include <primitiv/version.h>
+
+using std::string;
+using std::vector;
+
+namespace primitiv {
+
+class AutotunerTest : public testing::Test {
+protected:
+  // Returns a run function which sleeps a long time except for `fastest`.
+  static std::function<void(std::uint32_t)> make_run(
+      std::uint32_t fastest, vector<std::uint32_t> &log) {
+    return [fastest, &log](std::uint32_t c) {
+      log.emplace_back(c);
+      if (c != fastest) {
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start
+            < std::chrono::microseconds(200));
+      }
+    };
+  }
+};
+
+TEST_F(AutotunerTest, CheckSelect) {
+  Autotuner tuner("hw", "");
+  vector<std::uint32_t> log;
+  EXPECT_EQ(0u, tuner.num_results());
+  EXPECT_EQ(16u, tuner.select("k", {4, 8, 16, 32}, make_run(16, log)));
+  EXPECT_EQ(1u, tuner.num_results());
+  EXPECT_FALSE(log.empty());
+
+  // Results are reused without running kernels.
+  log.clear();
+  EXPECT_EQ(16u, tuner.select("k", {4, 8, 16, 32}, make_run(4, log)));
+  EXPECT_TRUE(log.empty());
+
+  // Other keys are tuned separately.
+  EXPECT_EQ(4u, tuner.select("k2", {4, 8, 16, 32}, make_run(4, log)));
+  EXPECT_EQ(2u, tuner.num_results());
+}
+
+TEST_F(AutotunerTest, CheckEmptyCandidates) {
+  Autotuner tuner("hw", "");
+  vector<std::uint32_t> log;
+  EXPECT_THROW(tuner.select("k", {}, make_run(0, log)), Error);
+}
+
+TEST_F(AutotunerTest, CheckCacheFile) {
+  const string path = "/tmp/primitiv_AutotunerTest_CheckCacheFile.tsv";
+  std::remove(path.c_str());
+  vector<std::uint32_t> log;
+  {
+    Autotuner tuner("hw1", path);
+    EXPECT_EQ(8u, tuner.select("k", {4, 8}, make_run(8, log)));
+  }
+  {
+    Autotuner tuner("hw2", path);
+    EXPECT_EQ(0u, tuner.num_results());
+    EXPECT_EQ(4u, tuner.select("k", {4, 8}, make_run(4, log)));
+  }
+  {
+    // Warm start: the cached result is used without running kernels.
+    Autotuner tuner("hw1", path);
+    EXPECT_EQ(1u, tuner.num_results());
+    log.clear();
+    EXPECT_EQ(8u, tuner.select("k", {4, 8}, make_run(4, log)));
+    EXPECT_TRUE(log.empty());
+  }
+
+  std::ifstream ifs(path);
+  string line;
+  vector<string> lines;
+  while (std::getline(ifs, line)) lines.emplace_back(line);
+  const vector<string> expected {
+    string(PRIMITIV_VERSION) + "\thw1\tk\t8",
+    string(PRIMITIV_VERSION) + "\thw2\tk\t4",
+  };
+  EXPECT_EQ(expected, lines);
+  std::remove(path.c_str());
+}
+
+TEST_F(AutotunerTest, CheckIgnoreOtherVersions) {
+  const string path = "/tmp/primitiv_AutotunerTest_CheckIgnoreOtherVersions.tsv";
+  {
+    std::ofstream ofs(path);
+    ofs << "0.0.0\thw\tk\t8\n";
+    ofs << PRIMITIV_VERSION << "\thw\tk2\tbroken\n";
+    ofs << "garbage\n";
+  }
+  Autotuner tuner("hw", path);
+  EXPECT_EQ(0u, tuner.num_results());
+  std::remove(path.c_str());
+}
+
+TEST_F(AutotunerTest, CheckCpuHardwareKey) {
+  const string key = Autotuner::cpu_hardware_key();
+  EXPECT_EQ(0u, key.find("cpu:"));
+  EXPECT_EQ(string::npos, key.find('\t'));
+}
+
+}  // namespace primitiv
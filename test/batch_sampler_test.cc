@@ -0,0 +1,81 @@
+#include <primitiv/config.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/batch_sampler.h>
+#include <primitiv/error.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class BatchSamplerTest : public testing::Test {
+protected:
+  const vector<std::uint32_t> lengths_ {3, 10, 2, 3, 5, 1, 4, 2, 30, 3};
+};
+
+TEST_F(BatchSamplerTest, CheckInvalidArguments) {
+  EXPECT_THROW(BatchSampler(lengths_, 0), Error);
+  EXPECT_THROW(BatchSampler(lengths_, 10, 0), Error);
+}
+
+TEST_F(BatchSamplerTest, CheckSampleWithoutShuffle) {
+  const BatchSampler sampler(lengths_, 10);
+  const vector<vector<std::uint32_t>> expected {
+    // Lengths: {1, 2, 2}, {3, 3, 3}, {5, 4}, {10}, {30}
+    {2, 7, 5}, {0, 3, 9}, {4, 6}, {1}, {8},
+  };
+  const auto batches = sampler.sample();
+  ASSERT_EQ(expected.size(), batches.size());
+  for (std::uint32_t i = 0; i < expected.size(); ++i) {
+    EXPECT_TRUE(vector_match(expected[i], batches[i]));
+  }
+  EXPECT_EQ(9u, sampler.num_tokens(batches[1]));
+  EXPECT_EQ(9u, sampler.num_padded_tokens(batches[1]));
+  EXPECT_EQ(5u, sampler.num_tokens(batches[0]));
+  EXPECT_EQ(6u, sampler.num_padded_tokens(batches[0]));
+  EXPECT_EQ(30u, sampler.num_padded_tokens(batches[4]));
+}
+
+TEST_F(BatchSamplerTest, CheckMaxBatchSize) {
+  const BatchSampler sampler(lengths_, 100, 1, 2);
+  const vector<vector<std::uint32_t>> expected {
+    {2, 5}, {0, 7}, {3, 9}, {4, 6}, {8, 1},
+  };
+  const auto batches = sampler.sample();
+  ASSERT_EQ(expected.size(), batches.size());
+  for (std::uint32_t i = 0; i < expected.size(); ++i) {
+    EXPECT_TRUE(vector_match(expected[i], batches[i]));
+  }
+}
+
+TEST_F(BatchSamplerTest, CheckSampleWithShuffle) {
+  const BatchSampler sampler(lengths_, 12, 4);
+  std::mt19937 rng(12345);
+  for (std::uint32_t epoch = 0; epoch < 10; ++epoch) {
+    const auto batches = sampler.sample(rng);
+    vector<std::uint32_t> all;
+    for (const auto &batch : batches) {
+      ASSERT_FALSE(batch.empty());
+      // Only a sample longer than the budget exceeds it.
+      if (batch.size() > 1) {
+        EXPECT_GE(12u, sampler.num_padded_tokens(batch));
+      }
+      // Samples are sorted by their lengths in descending order.
+      for (std::uint32_t i = 1; i < batch.size(); ++i) {
+        EXPECT_GE(lengths_[batch[i - 1]], lengths_[batch[i]]);
+      }
+      all.insert(all.end(), batch.begin(), batch.end());
+    }
+    // Each sample appears exactly once.
+    std::sort(all.begin(), all.end());
+    EXPECT_TRUE(vector_match(
+          vector<std::uint32_t> {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, all));
+  }
+}
+
+}  // namespace primitiv
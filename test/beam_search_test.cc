@@ -0,0 +1,155 @@
+#include <primitiv/config.h>
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/beam_search.h>
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+#include <primitiv/graph.h>
+#include <primitiv/naive_device.h>
+#include <primitiv/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+using test_utils::vector_near;
+
+namespace primitiv {
+
+class BeamSearchTest : public testing::Test {
+protected:
+  devices::Naive dev;
+  Graph g;
+
+  // Word IDs: 0 = <bos>, 1 = a, 2 = b, 3 = <eos>
+  // probs[s][w] is the distribution of the next word of the sequence `s`
+  // given the last word `w`.
+  const vector<vector<vector<float>>> probs {
+    {
+      {.01, .5, .4, .09},
+      {.01, .33, .33, .33},
+      {.01, .01, .01, .97},
+      {.25, .25, .25, .25},
+    },
+    {
+      {.01, .6, .1, .29},
+      {.01, .01, .01, .97},
+      {.01, .01, .01, .97},
+      {.25, .25, .25, .25},
+    },
+  };
+
+  void SetUp() override {
+    Device::set_default(dev);
+    Graph::set_default(g);
+  }
+
+  // Makes logits of all hypotheses using the last words.
+  vector<float> make_logits(const BeamSearch &beam, std::uint32_t seq_offset) {
+    vector<float> data;
+    const vector<std::uint32_t> &words = beam.words();
+    for (std::uint32_t h = 0; h < words.size(); ++h) {
+      const std::uint32_t s = seq_offset + h / beam.beam_size();
+      for (const float p : probs[s][words[h]]) data.emplace_back(std::log(p));
+    }
+    return data;
+  }
+};
+
+TEST_F(BeamSearchTest, CheckInitialize) {
+  BeamSearch beam(3, 2, 0, 3);
+  EXPECT_EQ(3u, beam.batch_size());
+  EXPECT_EQ(2u, beam.beam_size());
+  EXPECT_EQ(0u, beam.length());
+  EXPECT_FALSE(beam.finished());
+  EXPECT_TRUE(vector_match(vector<std::uint32_t>(6, 0), beam.words()));
+  EXPECT_TRUE(vector_match(
+        vector<std::uint32_t> {0, 0, 1, 1, 2, 2}, beam.parents()));
+
+  const Tensor x = dev.new_tensor_by_vector(Shape({2}, 3), {1, 2, 3, 4, 5, 6});
+  const Tensor y = beam.expand(x);
+  EXPECT_EQ(Shape({2}, 6), y.shape());
+  EXPECT_TRUE(vector_match(
+        vector<float> {1, 2, 1, 2, 3, 4, 3, 4, 5, 6, 5, 6}, y.to_vector()));
+}
+
+TEST_F(BeamSearchTest, CheckInvalidInitialize) {
+  EXPECT_THROW(BeamSearch(0, 2, 0, 3), Error);
+  EXPECT_THROW(BeamSearch(2, 0, 0, 3), Error);
+}
+
+TEST_F(BeamSearchTest, CheckStep) {
+  BeamSearch beam(2, 2, 0, 3);
+  beam.step(dev.new_tensor_by_vector(Shape({4}, 4), make_logits(beam, 0)));
+  EXPECT_EQ(1u, beam.length());
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {1, 2, 1, 3}, beam.words()));
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {0, 0, 2, 2}, beam.parents()));
+  EXPECT_TRUE(vector_near(
+        vector<float> {std::log(.5f), std::log(.4f), std::log(.6f), std::log(.29f)},
+        beam.scores(), 1e-5));
+
+  beam.step(dev.new_tensor_by_vector(Shape({4}, 4), make_logits(beam, 0)));
+  EXPECT_EQ(2u, beam.length());
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {3, 1, 3, 3}, beam.words()));
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {1, 0, 2, 3}, beam.parents()));
+  EXPECT_FALSE(beam.finished());
+
+  const Tensor x = dev.new_tensor_by_vector(Shape({}, 4), {0, 1, 2, 3});
+  EXPECT_TRUE(vector_match(
+        vector<float> {1, 0, 2, 3}, beam.reorder(x).to_vector()));
+}
+
+TEST_F(BeamSearchTest, CheckDecode) {
+  BeamSearch beam(2, 2, 0, 3);
+  while (!beam.finished() && beam.length() < 10) {
+    beam.step(dev.new_tensor_by_vector(Shape({4}, 4), make_logits(beam, 0)));
+  }
+  EXPECT_EQ(10u, beam.length());
+  const vector<vector<std::uint32_t>> expected {{2}, {1}};
+  EXPECT_EQ(expected, beam.best());
+  EXPECT_NEAR(std::log(.4f * .97f), beam.scores()[0], 1e-5);
+  EXPECT_NEAR(std::log(.6f * .97f), beam.scores()[2], 1e-5);
+}
+
+TEST_F(BeamSearchTest, CheckFinished) {
+  BeamSearch beam(1, 2, 0, 3);
+  while (!beam.finished()) {
+    ASSERT_GT(10u, beam.length());
+    beam.step(dev.new_tensor_by_vector(Shape({4}, 2), make_logits(beam, 1)));
+  }
+  EXPECT_EQ(2u, beam.length());
+  const vector<vector<std::uint32_t>> expected {{1}};
+  EXPECT_EQ(expected, beam.best());
+}
+
+TEST_F(BeamSearchTest, CheckGreedy) {
+  // Beam size 1 is equivalent to greedy decoding.
+  BeamSearch beam(1, 1, 0, 3);
+  while (!beam.finished() && beam.length() < 4) {
+    beam.step(dev.new_tensor_by_vector({4}, make_logits(beam, 0)));
+  }
+  EXPECT_EQ(4u, beam.length());
+  const vector<vector<std::uint32_t>> expected {{1, 1, 1, 1}};
+  EXPECT_EQ(expected, beam.best());
+}
+
+TEST_F(BeamSearchTest, CheckNode) {
+  BeamSearch beam(2, 2, 0, 3);
+  while (!beam.finished() && beam.length() < 10) {
+    g.clear();
+    beam.step(functions::input<Node>(Shape({4}, 4), make_logits(beam, 0)));
+  }
+  const vector<vector<std::uint32_t>> expected {{2}, {1}};
+  EXPECT_EQ(expected, beam.best());
+}
+
+TEST_F(BeamSearchTest, CheckInvalidStep) {
+  BeamSearch beam(2, 2, 0, 3);
+  EXPECT_THROW(
+      beam.step(dev.new_tensor_by_constant(Shape({4}, 2), 0)), Error);
+  EXPECT_THROW(
+      beam.step(dev.new_tensor_by_constant(Shape({4, 2}, 4), 0)), Error);
+}
+
+}  // namespace primitiv
@@ -0,0 +1,109 @@
+#include <primitiv/config.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <primitiv/binary_cache.h>
+
+using std::string;
+
+namespace primitiv {
+
+class BinaryCacheTest : public testing::Test {
+protected:
+  const string dir_ = "/tmp/primitiv_BinaryCacheTest";
+
+  // Binary data including special characters.
+  const string binary_ = string("\x7f" "ELF\0\n\r\xff", 8) + string(1000, 'x');
+
+  void TearDown() override {
+    BinaryCache cache(dir_);
+    for (const char *key : {"k", "k2"}) std::remove(cache.path(key).c_str());
+    std::remove(dir_.c_str());
+  }
+};
+
+TEST_F(BinaryCacheTest, CheckDigest) {
+  // Known answers of FNV-1a 64.
+  EXPECT_EQ("cbf29ce484222325", BinaryCache::digest(""));
+  EXPECT_EQ("af63dc4c8601ec8c", BinaryCache::digest("a"));
+  EXPECT_EQ("85944171f73967e8", BinaryCache::digest("foobar"));
+}
+
+TEST_F(BinaryCacheTest, CheckStoreLoad) {
+  BinaryCache cache(dir_);
+  string observed = "unchanged";
+  EXPECT_FALSE(cache.load("k", observed));
+  EXPECT_EQ("unchanged", observed);
+
+  cache.store("k", binary_);
+  EXPECT_TRUE(cache.load("k", observed));
+  EXPECT_EQ(binary_, observed);
+  EXPECT_FALSE(cache.load("k2", observed));
+
+  // Other objects share the entry.
+  BinaryCache other(dir_);
+  observed.clear();
+  EXPECT_TRUE(other.load("k", observed));
+  EXPECT_EQ(binary_, observed);
+
+  // Entries are overwritten.
+  other.store("k", "new");
+  EXPECT_TRUE(cache.load("k", observed));
+  EXPECT_EQ("new", observed);
+}
+
+TEST_F(BinaryCacheTest, CheckDisabled) {
+  BinaryCache cache("");
+  EXPECT_EQ("", cache.path("k"));
+  cache.store("k", binary_);
+  string observed;
+  EXPECT_FALSE(cache.load("k", observed));
+}
+
+TEST_F(BinaryCacheTest, CheckCorruptEntries) {
+  BinaryCache cache(dir_);
+  const string path = cache.path("k");
+  string observed;
+
+  // Truncated.
+  cache.store("k", binary_);
+  {
+    std::ifstream ifs(path, std::ios::binary);
+    string data((std::istreambuf_iterator<char>(ifs)),
+                std::istreambuf_iterator<char>());
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << data.substr(0, data.size() - 10);
+  }
+  EXPECT_FALSE(cache.load("k", observed));
+
+  // Modified.
+  cache.store("k", binary_);
+  {
+    std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out);
+    fs.seekp(-1, std::ios::end);
+    fs.put('y');
+  }
+  EXPECT_FALSE(cache.load("k", observed));
+
+  // Not a cache file.
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << "garbage";
+  }
+  EXPECT_FALSE(cache.load("k", observed));
+
+  EXPECT_TRUE(observed.empty());
+}
+
+TEST_F(BinaryCacheTest, CheckKeyMismatch) {
+  BinaryCache cache(dir_);
+  cache.store("k", binary_);
+  // Simulates a collision of digests.
+  std::rename(cache.path("k").c_str(), cache.path("k2").c_str());
+  string observed;
+  EXPECT_FALSE(cache.load("k2", observed));
+}
+
+}  // namespace primitiv
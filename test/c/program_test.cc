@@ -0,0 +1,123 @@
+#include <primitiv/config.h>
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/c/graph.h>
+#include <primitiv/c/naive_device.h>
+#include <primitiv/c/parameter.h>
+#include <primitiv/c/program.h>
+#include <primitiv/c/shape.h>
+#include <primitiv/c/status.h>
+#include <primitiv/c/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class CProgramTest : public testing::Test {
+protected:
+  // y = sum(2 * matmul(W, x) + 1), followed by the backward calculation.
+  const vector<::primitiv_Instruction> code {
+    { PRIMITIV_OP_INPUT, {0, 0}, 0, 0 },
+    { PRIMITIV_OP_PARAMETER, {0, 0}, 0, 0 },
+    { PRIMITIV_OP_MATMUL, {1, 0}, 0, 0 },
+    { PRIMITIV_OP_MULTIPLY_CONST, {2, 0}, 0, 2 },
+    { PRIMITIV_OP_ADD_CONST, {3, 0}, 0, 1 },
+    { PRIMITIV_OP_SUM, {4, 0}, 0, 0 },
+    { PRIMITIV_OP_BACKWARD, {5, 0}, 0, 0 },
+  };
+};
+
+TEST_F(CProgramTest, CheckCapture) {
+  ::primitiv_Program *program = ::primitiv_Program_new();
+  for (std::uint32_t i = 0; i < code.size(); ++i) {
+    EXPECT_EQ(i, ::primitiv_Program_append(program, &code[i]));
+  }
+  EXPECT_EQ(code.size(), ::primitiv_Program_num_instructions(program));
+
+  vector<::primitiv_Instruction> serialized(code.size());
+  ::primitiv_Program_get_instructions(program, serialized.data());
+  for (std::uint32_t i = 0; i < code.size(); ++i) {
+    EXPECT_EQ(code[i].opcode, serialized[i].opcode);
+    EXPECT_EQ(code[i].args[0], serialized[i].args[0]);
+    EXPECT_EQ(code[i].args[1], serialized[i].args[1]);
+    EXPECT_EQ(code[i].attr, serialized[i].attr);
+    EXPECT_EQ(code[i].value, serialized[i].value);
+  }
+  ::primitiv_Program_delete(program);
+}
+
+TEST_F(CProgramTest, CheckRun) {
+  ::primitiv_Device *dev = ::primitiv_Naive_new();
+  ::primitiv_Graph *g = ::primitiv_Graph_new();
+  const std::uint32_t w_dims[] {2, 2};
+  const std::uint32_t x_dims[] {2};
+  ::primitiv_Shape *w_shape = ::primitiv_Shape_new_with_dims(w_dims, 2, 1);
+  ::primitiv_Shape *x_shape = ::primitiv_Shape_new_with_dims(x_dims, 1, 1);
+  const float w_data[] {1, 2, 3, 4};
+  ::primitiv_Parameter *w = ::primitiv_Parameter_new_with_values(
+      w_shape, w_data, 4, dev);
+  ::primitiv_Program *program = ::primitiv_Program_new_with_instructions(
+      code.data(), code.size());
+
+  const vector<vector<float>> xs { {1, 2}, {0, 1} };
+  const vector<float> expected_y { 36, 16 };
+  const vector<vector<float>> expected_h { {15, 21}, {7, 9} };
+  const vector<vector<float>> expected_gw { {2, 2, 4, 4}, {2, 2, 6, 6} };
+  for (std::uint32_t i = 0; i < xs.size(); ++i) {
+    const ::primitiv_Shape *input_shapes[] { x_shape };
+    const float *inputs[] { xs[i].data() };
+    ::primitiv_Parameter *params[] { w };
+    const std::uint32_t outputs[] { 5, 4 };
+    float y;
+    vector<float> h(2);
+    float *output_data[] { &y, h.data() };
+    ::primitiv_Program_run(
+        program, g, dev, input_shapes, inputs, 1, params, 1,
+        outputs, output_data, 2);
+    EXPECT_EQ(6u, ::primitiv_Graph_num_operators(g));
+    EXPECT_EQ(expected_y[i], y);
+    EXPECT_TRUE(vector_match(expected_h[i], h));
+
+    // Gradients are accumulated over runs.
+    vector<float> gw(4);
+    ::primitiv_Tensor_to_array(::primitiv_Parameter_gradient(w), gw.data());
+    EXPECT_TRUE(vector_match(expected_gw[i], gw));
+  }
+
+  ::primitiv_Program_delete(program);
+  ::primitiv_Parameter_delete(w);
+  ::primitiv_Shape_delete(x_shape);
+  ::primitiv_Shape_delete(w_shape);
+  ::primitiv_Graph_delete(g);
+  ::primitiv_Naive_delete(dev);
+}
+
+TEST_F(CProgramTest, CheckInvalidInstructions) {
+  ::primitiv_Status *status = ::primitiv_Status_new();
+  {
+    const ::primitiv_Instruction bad[] {
+      { PRIMITIV_OP_INPUT, {0, 0}, 0, 0 },
+      { PRIMITIV_OP_ADD, {0, 1}, 0, 0 },
+    };
+    EXPECT_EQ(
+        nullptr,
+        ::safe_primitiv_Program_new_with_instructions(bad, 2, status));
+    EXPECT_EQ(PRIMITIV_ERROR, ::primitiv_Status_get_code(status));
+  }
+  ::primitiv_Status_delete(status);
+  status = ::primitiv_Status_new();
+  {
+    ::primitiv_Program *program = ::primitiv_Program_new();
+    const ::primitiv_Instruction unknown { 12345, {0, 0}, 0, 0 };
+    ::safe_primitiv_Program_append(program, &unknown, status);
+    EXPECT_EQ(PRIMITIV_ERROR, ::primitiv_Status_get_code(status));
+    EXPECT_EQ(0u, ::primitiv_Program_num_instructions(program));
+    ::primitiv_Program_delete(program);
+  }
+  ::primitiv_Status_delete(status);
+}
+
+}  // namespace primitiv
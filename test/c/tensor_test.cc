@@ -0,0 +1,175 @@
+#include <primitiv/config.h>
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/c/functions.h>
+#include <primitiv/c/naive_device.h>
+#include <primitiv/c/shape.h>
+#include <primitiv/c/status.h>
+#include <primitiv/c/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class CTensorTest : public testing::Test {
+protected:
+  // External array managed by the test.
+  struct External {
+    vector<float> data;
+    vector<std::int64_t> shape;
+    vector<std::int64_t> strides;
+    std::uint32_t num_released;
+    ::primitiv_DLManagedTensor managed;
+  };
+
+  static void release(::primitiv_DLManagedTensor *self) {
+    ++static_cast<External *>(self->manager_ctx)->num_released;
+  }
+
+  static void init(External &ext) {
+    ext.num_released = 0;
+    ::primitiv_DLTensor &dl = ext.managed.dl_tensor;
+    dl.data = ext.data.data();
+    dl.device = {PRIMITIV_DL_CPU, 0};
+    dl.ndim = ext.shape.size();
+    dl.dtype = {PRIMITIV_DL_FLOAT, 32, 1};
+    dl.shape = ext.shape.data();
+    dl.strides = ext.strides.empty() ? nullptr : ext.strides.data();
+    dl.byte_offset = 0;
+    ext.managed.manager_ctx = &ext;
+    ext.managed.deleter = release;
+  }
+
+  void SetUp() override {
+    dev = ::primitiv_Naive_new();
+  }
+
+  void TearDown() override {
+    ::primitiv_Naive_delete(dev);
+  }
+
+  ::primitiv_Device *dev;
+};
+
+TEST_F(CTensorTest, CheckNewFromDLPack) {
+  External ext { {1, 2, 3, 4, 5, 6}, {2, 1, 3}, {1, 2, 2}, 0, {} };
+  init(ext);
+  ::primitiv_Tensor *x = ::primitiv_Tensor_new_from_dlpack(
+      &ext.managed, true, dev);
+  ::primitiv_Shape *shape = ::primitiv_Tensor_shape(x);
+  EXPECT_EQ(1u, ::primitiv_Shape_depth(shape));
+  EXPECT_EQ(2u, ::primitiv_Shape_op_getitem(shape, 0));
+  EXPECT_EQ(1u, ::primitiv_Shape_op_getitem(shape, 1));
+  EXPECT_EQ(3u, ::primitiv_Shape_batch(shape));
+  ::primitiv_Shape_delete(shape);
+
+  // Values are shared with the external array.
+  ext.data[0] = 10;
+  vector<float> values(6);
+  ::primitiv_Tensor_to_array(x, values.data());
+  EXPECT_TRUE(vector_match(vector<float> {10, 2, 3, 4, 5, 6}, values));
+
+  // In-place operations write into the array if it is not shared.
+  ::primitiv_Tensor_inplace_multiply_const(x, 2);
+  EXPECT_TRUE(vector_match(vector<float> {20, 4, 6, 8, 10, 12}, ext.data));
+
+  // Copies are duplicated before modified.
+  ::primitiv_Tensor *y = ::primitiv_Tensor_new_from_tensor(x);
+  ::primitiv_Tensor_inplace_multiply_const(y, 2);
+  EXPECT_TRUE(vector_match(vector<float> {20, 4, 6, 8, 10, 12}, ext.data));
+
+  ::primitiv_Tensor_delete(y);
+  EXPECT_EQ(0u, ext.num_released);
+  ::primitiv_Tensor_delete(x);
+  EXPECT_EQ(1u, ext.num_released);
+}
+
+TEST_F(CTensorTest, CheckNewFromDLPackWithoutBatch) {
+  // Null strides represent a row-major array, which is also column-major if
+  // only one axis is nontrivial.
+  External ext { {1, 2, 3}, {1, 3}, {}, 0, {} };
+  init(ext);
+  ::primitiv_Tensor *x = ::primitiv_Tensor_new_from_dlpack(
+      &ext.managed, false, dev);
+  ::primitiv_Shape *shape = ::primitiv_Tensor_shape(x);
+  EXPECT_EQ(2u, ::primitiv_Shape_depth(shape));
+  EXPECT_EQ(3u, ::primitiv_Shape_op_getitem(shape, 1));
+  EXPECT_EQ(1u, ::primitiv_Shape_batch(shape));
+  ::primitiv_Shape_delete(shape);
+  ::primitiv_Tensor_delete(x);
+  EXPECT_EQ(1u, ext.num_released);
+}
+
+TEST_F(CTensorTest, CheckInvalidDLPack) {
+  ::primitiv_Status *status = ::primitiv_Status_new();
+  {
+    // Row-major.
+    External ext { {1, 2, 3, 4, 5, 6}, {2, 3}, {3, 1}, 0, {} };
+    init(ext);
+    EXPECT_EQ(
+        nullptr,
+        ::safe_primitiv_Tensor_new_from_dlpack(
+          &ext.managed, false, dev, status));
+    EXPECT_EQ(PRIMITIV_ERROR, ::primitiv_Status_get_code(status));
+    EXPECT_EQ(0u, ext.num_released);
+  }
+  {
+    // float64.
+    External ext { {1, 2}, {1}, {}, 0, {} };
+    init(ext);
+    ext.managed.dl_tensor.dtype.bits = 64;
+    EXPECT_EQ(
+        nullptr,
+        ::safe_primitiv_Tensor_new_from_dlpack(
+          &ext.managed, false, dev, status));
+    EXPECT_EQ(PRIMITIV_ERROR, ::primitiv_Status_get_code(status));
+    EXPECT_EQ(0u, ext.num_released);
+  }
+  {
+    // No batch axis.
+    External ext { {1}, {}, {}, 0, {} };
+    init(ext);
+    EXPECT_EQ(
+        nullptr,
+        ::safe_primitiv_Tensor_new_from_dlpack(
+          &ext.managed, true, dev, status));
+    EXPECT_EQ(PRIMITIV_ERROR, ::primitiv_Status_get_code(status));
+    EXPECT_EQ(0u, ext.num_released);
+  }
+  ::primitiv_Status_delete(status);
+}
+
+TEST_F(CTensorTest, CheckToDLPack) {
+  const std::uint32_t dims[] {2, 3};
+  ::primitiv_Shape *shape = ::primitiv_Shape_new_with_dims(dims, 2, 2);
+  const vector<float> values {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  ::primitiv_Tensor *x = ::primitiv_tensor_func_input(
+      shape, values.data(), values.size(), dev);
+  ::primitiv_DLManagedTensor *dl = ::primitiv_Tensor_to_dlpack(x);
+  const ::primitiv_DLTensor &t = dl->dl_tensor;
+  EXPECT_EQ(PRIMITIV_DL_CPU, t.device.device_type);
+  EXPECT_EQ(PRIMITIV_DL_FLOAT, t.dtype.code);
+  EXPECT_EQ(32u, t.dtype.bits);
+  EXPECT_EQ(1u, t.dtype.lanes);
+  EXPECT_EQ(3, t.ndim);
+  EXPECT_TRUE(vector_match(
+        vector<std::int64_t> {2, 3, 2},
+        vector<std::int64_t>(t.shape, t.shape + 3)));
+  EXPECT_TRUE(vector_match(
+        vector<std::int64_t> {1, 2, 6},
+        vector<std::int64_t>(t.strides, t.strides + 3)));
+  EXPECT_EQ(0u, t.byte_offset);
+  const float *data = static_cast<const float *>(t.data);
+  EXPECT_TRUE(vector_match(values, vector<float>(data, data + 12)));
+
+  // The array is kept alive by the result.
+  ::primitiv_Tensor_delete(x);
+  EXPECT_EQ(7.f, data[6]);
+  dl->deleter(dl);
+  ::primitiv_Shape_delete(shape);
+}
+
+}  // namespace primitiv
@@ -0,0 +1,192 @@
+#include <primitiv/config.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <primitiv/corpus.h>
+#include <primitiv/error.h>
+#include <test_utils.h>
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class CorpusTest : public testing::Test {
+protected:
+  const string text_path_ = "/tmp/primitiv_CorpusTest.txt";
+  const string corpus_path_ = "/tmp/primitiv_CorpusTest.bin";
+  const string vocab_path_ = "/tmp/primitiv_CorpusTest.vocab";
+
+  void SetUp() override {
+    // Includes an empty line, redundant spaces and a missing newline.
+    std::ofstream ofs(text_path_);
+    ofs << "a b c\n"
+        << " b  c\ta \r\n"
+        << "\n"
+        << "c d c";
+  }
+
+  void TearDown() override {
+    for (const string &path : {text_path_, corpus_path_, vocab_path_}) {
+      std::remove(path.c_str());
+    }
+  }
+};
+
+TEST_F(CorpusTest, CheckCountWords) {
+  for (const std::uint32_t num_threads : {1u, 2u, 8u}) {
+    const auto freq = Corpus::count_words(text_path_, num_threads);
+    const unordered_map<string, std::uint64_t> expected {
+      {"a", 2}, {"b", 2}, {"c", 4}, {"d", 1},
+    };
+    EXPECT_EQ(expected, freq);
+  }
+}
+
+TEST_F(CorpusTest, CheckMakeVocab) {
+  {
+    const auto vocab = Corpus::make_vocab(text_path_, {"<unk>", "<s>"});
+    const unordered_map<string, std::uint32_t> expected {
+      {"<unk>", 0}, {"<s>", 1}, {"c", 2}, {"a", 3}, {"b", 4}, {"d", 5},
+    };
+    EXPECT_EQ(expected, vocab);
+  }
+  {
+    const auto vocab = Corpus::make_vocab(text_path_, {"<unk>"}, 3, 2);
+    const unordered_map<string, std::uint32_t> expected {
+      {"<unk>", 0}, {"c", 1}, {"a", 2},
+    };
+    EXPECT_EQ(expected, vocab);
+  }
+  EXPECT_THROW(Corpus::make_vocab(text_path_, {"x", "x"}), Error);
+  EXPECT_THROW(Corpus::make_vocab(text_path_, {"x", "y"}, 1), Error);
+}
+
+TEST_F(CorpusTest, CheckWriteAndRead) {
+  const unordered_map<string, std::uint32_t> vocab {
+    {"<unk>", 0}, {"<s>", 1}, {"</s>", 2}, {"a", 3}, {"b", 4}, {"c", 5},
+  };
+  for (const std::uint32_t num_threads : {1u, 3u}) {
+    Corpus::write(
+        text_path_, corpus_path_, vocab, "<unk>", "<s>", "</s>", num_threads);
+    const Corpus corpus(corpus_path_);
+    const vector<vector<std::uint32_t>> expected {
+      {1, 3, 4, 5, 2}, {1, 4, 5, 3, 2}, {1, 2}, {1, 5, 0, 5, 2},
+    };
+    EXPECT_EQ(expected.size(), corpus.num_sentences());
+    EXPECT_EQ(17u, corpus.num_tokens());
+    for (std::uint32_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i].size(), corpus.length(i));
+      EXPECT_TRUE(vector_match(expected[i], corpus.sentence(i)));
+      EXPECT_EQ(expected[i][0], corpus.data(i)[0]);
+    }
+    EXPECT_THROW(corpus.length(4), Error);
+    EXPECT_THROW(corpus.data(4), Error);
+  }
+}
+
+TEST_F(CorpusTest, CheckWriteWithoutSpecials) {
+  const unordered_map<string, std::uint32_t> vocab {
+    {"a", 0}, {"b", 1}, {"c", 2}, {"d", 3},
+  };
+  Corpus::write(text_path_, corpus_path_, vocab, "", "", "");
+  const Corpus corpus(corpus_path_);
+  EXPECT_EQ(4u, corpus.num_sentences());
+  EXPECT_EQ(9u, corpus.num_tokens());
+  EXPECT_EQ(0u, corpus.length(2));
+  EXPECT_TRUE(vector_match(
+        vector<std::uint32_t> {2, 3, 2}, corpus.sentence(3)));
+}
+
+TEST_F(CorpusTest, CheckWriteInvalid) {
+  const unordered_map<string, std::uint32_t> vocab {{"a", 0}, {"b", 1}};
+  // Unknown words without the replacement.
+  EXPECT_THROW(
+      Corpus::write(text_path_, corpus_path_, vocab, "", "", ""), Error);
+  // Failures leave no files.
+  EXPECT_FALSE(std::ifstream(corpus_path_).is_open());
+  EXPECT_FALSE(
+      std::ifstream(corpus_path_ + ".tmp" + std::to_string(::getpid()))
+      .is_open());
+  // Special words out of the vocabulary.
+  EXPECT_THROW(
+      Corpus::write(text_path_, corpus_path_, vocab, "a", "<s>", ""), Error);
+  EXPECT_THROW(
+      Corpus::write("/tmp/primitiv_CorpusTest.none", corpus_path_, vocab,
+                    "a", "", ""),
+      Error);
+}
+
+TEST_F(CorpusTest, CheckInvalidFile) {
+  EXPECT_THROW(Corpus("/tmp/primitiv_CorpusTest.none"), Error);
+  // Text files are not corpus files.
+  EXPECT_THROW({ Corpus c(text_path_); }, Error);
+  {
+    std::ofstream ofs(corpus_path_);
+    ofs << string(100, '\0');
+  }
+  EXPECT_THROW({ Corpus c(corpus_path_); }, Error);
+}
+
+TEST_F(CorpusTest, CheckBrokenOffsets) {
+  const unordered_map<string, std::uint32_t> vocab {
+    {"a", 0}, {"b", 1}, {"c", 2}, {"d", 3},
+  };
+  Corpus::write(text_path_, corpus_path_, vocab, "", "", "");
+  string data;
+  {
+    std::ifstream ifs(corpus_path_, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(ifs), {});
+  }
+  // Offsets are located at the end: {0, 3, 6, 6, 9}.
+  const std::size_t pos = data.size() - 5 * sizeof(std::uint64_t);
+  const auto check = [&](
+      std::uint32_t i, std::uint64_t value, std::uint32_t sentence) {
+    string broken = data;
+    std::memcpy(&broken[pos + i * sizeof(value)], &value, sizeof(value));
+    {
+      std::ofstream ofs(corpus_path_, std::ios::binary);
+      ofs << broken;
+    }
+    // Offsets are checked when the sentence is accessed.
+    const Corpus c(corpus_path_);
+    EXPECT_THROW(c.length(sentence), Error);
+    EXPECT_THROW(c.data(sentence), Error);
+    EXPECT_THROW(c.sentence(sentence), Error);
+  };
+  check(0, 4, 0);
+  check(2, 2, 1);
+  check(3, 100, 2);
+  check(4, 10, 3);
+
+  // Huge numbers in the header.
+  for (const std::uint64_t n : {~0ull, ~0ull / 2, ~0ull / 4}) {
+    for (const std::uint32_t field : {0u, 1u}) {
+      string broken = data;
+      std::memcpy(&broken[16 + field * sizeof(n)], &n, sizeof(n));
+      {
+        std::ofstream ofs(corpus_path_, std::ios::binary);
+        ofs << broken;
+      }
+      EXPECT_THROW({ Corpus c(corpus_path_); }, Error);
+    }
+  }
+}
+
+TEST_F(CorpusTest, CheckSaveLoadVocab) {
+  const auto vocab = Corpus::make_vocab(text_path_, {"<unk>"});
+  Corpus::save_vocab(vocab_path_, vocab);
+  EXPECT_EQ(vocab, Corpus::load_vocab(vocab_path_));
+  EXPECT_THROW(Corpus::save_vocab(vocab_path_, {{"a", 1}}), Error);
+}
+
+}  // namespace primitiv
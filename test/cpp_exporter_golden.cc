@@ -0,0 +1,157 @@
+// Generated by primitiv::CppExporter.
+//
+// Inputs:
+//   x0: [2]x3
+// Outputs:
+//   y0: [2]x3
+//   y1: []x1
+//   y2: [2,2]x3
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace cpp_exporter_golden {
+
+namespace {
+
+// w: [2,2]x1
+alignas(32) const float p0[4] = {
+  1.f, 2.f, 3.f, 4.f,
+};
+
+// b: [2]x1
+alignas(32) const float p1[2] = {
+  0.5f, -0.25f,
+};
+
+// y[r, b] = combine(map(x[r, 0, b]), map(x[r, 1, b]), ...)
+template<
+  std::uint32_t B, std::uint32_t N, std::uint32_t R,
+  typename Map, typename Combine>
+inline void reduce(float *y, const float *x, Map map, Combine combine) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    float *py = y + r * B;
+    const float *px = x + r * B * N;
+    for (std::uint32_t b = 0; b < B; ++b) py[b] = map(px[b]);
+    for (std::uint32_t j = 1; j < N; ++j) {
+      px += B;
+      for (std::uint32_t b = 0; b < B; ++b) py[b] = combine(py[b], map(px[b]));
+    }
+  }
+}
+
+// y[r, j, b] = x[r, b]
+template<std::uint32_t B, std::uint32_t N, std::uint32_t R>
+inline void broadcast(float *y, const float *x) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    for (std::uint32_t j = 0; j < N; ++j) {
+      std::copy(x + r * B, x + (r + 1) * B, y + (r * N + j) * B);
+    }
+  }
+}
+
+// Copies R blocks with SIZE elements.
+template<
+  std::uint32_t SIZE, std::uint32_t R, std::uint32_t SKIP_X,
+  std::uint32_t SKIP_Y>
+inline void copy_blocks(float *y, const float *x) {
+  for (std::uint32_t r = 0; r < R; ++r) {
+    std::copy(x + r * SKIP_X, x + r * SKIP_X + SIZE, y + r * SKIP_Y);
+  }
+}
+
+template<std::uint32_t D1, std::uint32_t D2, std::uint32_t BS>
+inline void transpose(float *y, const float *x) {
+  for (std::uint32_t n = 0; n < BS; ++n) {
+    for (std::uint32_t j = 0; j < D2; ++j) {
+      for (std::uint32_t i = 0; i < D1; ++i) {
+        y[n * D1 * D2 + j + i * D2] = x[n * D1 * D2 + i + j * D1];
+      }
+    }
+  }
+}
+
+// y = a . b, where a is D1xD2 and b is D2xD3.
+// SKIP_A/SKIP_B are 0 if the operand is shared by all minibatch elements.
+template<
+  std::uint32_t D1, std::uint32_t D2, std::uint32_t D3, std::uint32_t BS,
+  std::uint32_t SKIP_A, std::uint32_t SKIP_B>
+inline void matmul(float *y, const float *a, const float *b) {
+  for (std::uint32_t n = 0; n < BS; ++n) {
+    const float *pa = a + n * SKIP_A;
+    const float *pb = b + n * SKIP_B;
+    for (std::uint32_t k = 0; k < D3; ++k) {
+      float *py = y + (n * D3 + k) * D1;
+      for (std::uint32_t i = 0; i < D1; ++i) py[i] = 0;
+      for (std::uint32_t j = 0; j < D2; ++j) {
+        const float bjk = pb[j + k * D2];
+        const float *paj = pa + j * D1;
+        for (std::uint32_t i = 0; i < D1; ++i) py[i] += paj[i] * bjk;
+      }
+    }
+  }
+}
+
+template<std::uint32_t SIZE, std::uint32_t BS>
+inline void batch_sum(float *y, const float *x) {
+  std::copy(x, x + SIZE, y);
+  for (std::uint32_t n = 1; n < BS; ++n) {
+    for (std::uint32_t i = 0; i < SIZE; ++i) y[i] += x[n * SIZE + i];
+  }
+}
+
+alignas(32) thread_local float ws[32];
+
+}  // namespace
+
+void forward(const float *x0, float *y0, float *y1, float *y2) {
+  // MatrixMultiply: [2]x3
+  float *const v3 = ws + 0;
+  matmul<2, 2, 1, 3, 0, 2>(v3, p0, x0);
+  // Tanh: [2]x3
+  float *const v5 = ws + 8;
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    v5[i] = std::tanh((v3[i] + p1[i % 2]));
+  }
+  // LogSumExp(0): []x3
+  float *const v6 = ws + 0;
+  reduce<1, 2, 3>(v6, v5,
+      [](float x) { return x; },
+      [](float a, float b) {
+        return static_cast<float>(a > b
+          ? a + std::log(1. + std::exp(b - a))
+          : b + std::log(1. + std::exp(a - b)));
+      });
+  // Broadcast(0,2): [2]x3
+  float *const v7 = ws + 16;
+  broadcast<1, 2, 3>(v7, v6);
+  // Subtract: [2]x3
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    y0[i] = (v5[i] - v7[i]);
+  }
+  // MultiplyConst(2.000000): [2]x3
+  float *const v10 = ws + 0;
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    v10[i] = ([](float x) { return x * ((x > 0) + 0.f * (x <= 0)); }(x0[i]) * 2.f);
+  }
+  // Max(0): []x3
+  float *const v11 = ws + 16;
+  reduce<1, 2, 3>(v11, v10,
+      [](float x) { return x; },
+      [](float a, float b) { return b > a ? b : a; });
+  // BatchSum: []x1
+  batch_sum<1, 3>(y1, v11);
+  // Concat(1): [2,2]x3
+  float *const v13 = ws + 16;
+  for (std::uint32_t n = 0; n < 3; ++n) copy_blocks<2, 1, 2, 4>(v13 + 0 + n * 4, x0 + n * 2);
+  for (std::uint32_t n = 0; n < 3; ++n) copy_blocks<2, 1, 2, 4>(v13 + 2 + n * 4, v5 + n * 2);
+  // Transpose: [2,2]x1
+  float *const v14 = ws + 0;
+  transpose<2, 2, 1>(v14, p0);
+  // MatrixMultiply: [2,2]x3
+  matmul<2, 2, 2, 3, 0, 4>(y2, v14, v13);
+}
+
+}  // namespace cpp_exporter_golden
@@ -0,0 +1,177 @@
+#include <primitiv/config.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/cpp_exporter.h>
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+#include <primitiv/graph.h>
+#include <primitiv/model.h>
+#include <primitiv/naive_device.h>
+#include <primitiv/parameter.h>
+#include <test_utils.h>
+
+using std::string;
+using std::vector;
+using test_utils::vector_near;
+
+namespace F = primitiv::functions;
+
+// Defined in cpp_exporter_golden.cc, which is generated from the graph in
+// CppExporterTest::make_golden_graph().
+namespace cpp_exporter_golden {
+void forward(const float *x0, float *y0, float *y1, float *y2);
+}  // namespace cpp_exporter_golden
+
+namespace primitiv {
+
+class CppExporterTest : public testing::Test {
+  devices::Naive dev;
+
+protected:
+  Graph g;
+  Model model;
+  Parameter w, b;
+
+  void SetUp() override {
+    Device::set_default(dev);
+    Graph::set_default(g);
+    w.init({2, 2}, {1, 2, 3, 4});
+    b.init({2}, {.5, -.25});
+    model.add("w", w);
+    model.add("b", b);
+  }
+
+  static bool contains(const string &code, const string &str) {
+    return code.find(str) != string::npos;
+  }
+
+  // NOTE: cpp_exporter_golden.cc should be regenerated if this graph or the
+  // exporter is changed.
+  vector<Node> make_golden_graph(const vector<float> &x_data) {
+    const Node x = F::input<Node>(Shape({2}, 3), x_data);
+    const Node wx = F::parameter<Node>(w);
+    const Node h = F::tanh(F::matmul(wx, x) + F::parameter<Node>(b));
+    const Node y0 = h - F::broadcast(F::logsumexp(h, 0), 0, 2);
+    const Node y1 = F::batch::sum(F::max(F::relu(x) * 2, 0));
+    const Node y2 = F::matmul(F::transpose(wx), F::concat({x, h}, 1));
+    return {y0, y1, y2};
+  }
+};
+
+TEST_F(CppExporterTest, CheckSignature) {
+  const Node x1 = F::input<Node>(Shape({2}, 3), vector<float>(6));
+  const Node x2 = F::input<Node>(Shape({2}), {1, 2});
+  F::input<Node>(Shape({5}), vector<float>(5));
+  const Node y = F::matmul(F::parameter<Node>(w), x1) + x2;
+  const string code = CppExporter(model).generate({y, x2}, "foo");
+  EXPECT_TRUE(contains(code, "namespace foo {"));
+  EXPECT_TRUE(contains(
+        code,
+        "void forward(const float *x0, const float *x1, float *y0, float *y1)"));
+  // Inputs which are not used by outputs are omitted.
+  EXPECT_FALSE(contains(code, "x2"));
+  EXPECT_FALSE(contains(code, "[5]"));
+  EXPECT_TRUE(contains(code, "//   x0: [2]x3\n//   x1: [2]x1\n"));
+  EXPECT_TRUE(contains(code, "//   y0: [2]x3\n//   y1: [2]x1\n"));
+  EXPECT_TRUE(contains(code, "matmul<2, 2, 1, 3, 0, 2>(v"));
+  EXPECT_TRUE(contains(code, "std::copy(x1, x1 + 2, y1);"));
+}
+
+TEST_F(CppExporterTest, CheckParameters) {
+  const Node x = F::input<Node>(Shape({2}), {1, 2});
+  const Node y = F::matmul(F::parameter<Node>(w), x) + F::parameter<Node>(b);
+  const string code = CppExporter(model).generate({y}, "foo");
+  EXPECT_TRUE(contains(
+        code,
+        "// w: [2,2]x1\n"
+        "alignas(32) const float p"));
+  EXPECT_TRUE(contains(code, "[4] = {\n  1.f, 2.f, 3.f, 4.f,\n};\n"));
+  EXPECT_TRUE(contains(
+        code,
+        "// b: [2]x1\n"
+        "alignas(32) const float p"));
+  EXPECT_TRUE(contains(code, "[2] = {\n  0.5f, -0.25f,\n};\n"));
+}
+
+TEST_F(CppExporterTest, CheckFusion) {
+  const Node x = F::input<Node>(Shape({2}, 2), vector<float>(4));
+  const Node h = F::tanh(x * 2 + F::parameter<Node>(b));
+  const Node y = F::exp(-h) * h;
+  const string code = CppExporter(model).generate({y}, "foo");
+  // `h` is used twice and should be materialized.
+  const string h_var = "v" + std::to_string(h.operator_id());
+  EXPECT_TRUE(contains(
+        code,
+        "  for (std::uint32_t i = 0; i < 4; ++i) {\n"
+        "    " + h_var + "[i] = std::tanh(((x0[i] * 2.f) + p0[i % 2]));\n"
+        "  }\n"));
+  EXPECT_TRUE(contains(
+        code,
+        "  for (std::uint32_t i = 0; i < 4; ++i) {\n"
+        "    y0[i] = (std::exp((-" + h_var + "[i])) * " + h_var + "[i]);\n"
+        "  }\n"));
+}
+
+TEST_F(CppExporterTest, CheckWorkspacePlanning) {
+  const Node x = F::input<Node>(Shape({2, 2}), vector<float>(4));
+  const Node wx = F::parameter<Node>(w);
+  Node y = x;
+  for (std::uint32_t i = 0; i < 10; ++i) y = F::matmul(wx, y);
+  const string code = CppExporter(model).generate({y}, "foo");
+  // Only two buffers are used alternately.
+  EXPECT_TRUE(contains(code, "alignas(32) thread_local float ws[16];"));
+  EXPECT_TRUE(contains(code, "matmul<2, 2, 2, 1, 0, 0>(y0, p0, v"));
+}
+
+TEST_F(CppExporterTest, CheckDeadOperators) {
+  const Node x = F::input<Node>(Shape({2}), {1, 2});
+  const Node y = F::sum(x, 0);
+  F::max(F::tanh(x), 0);
+  const string code = CppExporter(model).generate({y}, "foo");
+  EXPECT_FALSE(contains(code, "std::tanh"));
+  EXPECT_FALSE(contains(code, "ws["));
+  EXPECT_TRUE(contains(code, "reduce<1, 2, 1>(y0, x0,"));
+}
+
+TEST_F(CppExporterTest, CheckGoldenSource) {
+  const vector<Node> ys = make_golden_graph(vector<float>(6));
+  const string code = CppExporter(model).generate(ys, "cpp_exporter_golden");
+  std::ifstream ifs("cpp_exporter_golden.cc");
+  ASSERT_TRUE(ifs.is_open());
+  std::stringstream golden;
+  golden << ifs.rdbuf();
+  EXPECT_EQ(golden.str(), code);
+}
+
+TEST_F(CppExporterTest, CheckGoldenForward) {
+  const vector<float> x_data {1, -2, .5, 0, -1.5, 3};
+  const vector<Node> ys = make_golden_graph(x_data);
+  vector<float> y0(6), y1(1), y2(12);
+  cpp_exporter_golden::forward(x_data.data(), y0.data(), y1.data(), y2.data());
+  EXPECT_TRUE(vector_near(ys[0].to_vector(), y0, 1e-5));
+  EXPECT_TRUE(vector_near(ys[1].to_vector(), y1, 1e-5));
+  EXPECT_TRUE(vector_near(ys[2].to_vector(), y2, 1e-5));
+}
+
+TEST_F(CppExporterTest, CheckInvalidGraphs) {
+  Graph g2;
+  const Node x = F::input<Node>(Shape({2}), {1, 2});
+  const Node x2 = F::input_node(Shape({2}), {1, 2}, nullptr, &g2);
+  EXPECT_THROW(CppExporter(model).generate({}, "foo"), Error);
+  EXPECT_THROW(CppExporter(model).generate({x, x2}, "foo"), Error);
+
+  // Unsupported operators.
+  const Node r = x + F::random::normal<Node>({2}, 0, 1);
+  EXPECT_THROW(CppExporter(model).generate({r}, "foo"), Error);
+
+  // Parameters out of the model.
+  Parameter p({2}, {3, 4});
+  const Node y = x + F::parameter<Node>(p);
+  EXPECT_THROW(CppExporter(model).generate({y}, "foo"), Error);
+}
+
+}  // namespace primitiv
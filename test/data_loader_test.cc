@@ -0,0 +1,131 @@
+#include <primitiv/config.h>
+
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/data_loader.h>
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+#include <primitiv/graph.h>
+#include <primitiv/naive_device.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class DataLoaderTest : public testing::Test {
+protected:
+  devices::Naive dev;
+  Graph g;
+
+  // Plan of 5 batches with 1 to 3 samples.
+  const vector<vector<std::uint32_t>> plan {
+    {0, 1}, {2}, {3, 4, 5}, {6, 7}, {8},
+  };
+
+  // Packs 2 values `10 * id, 10 * id + 1` and 1 label `id` for each sample.
+  static void build(DataLoader::Batch &b) {
+    const std::uint32_t bs = b.samples.size();
+    b.shapes.assign({Shape({2}, bs)});
+    b.values.resize(1);
+    b.values[0].clear();
+    b.ids.resize(1);
+    b.ids[0].clear();
+    for (const std::uint32_t id : b.samples) {
+      b.values[0].emplace_back(10 * id);
+      b.values[0].emplace_back(10 * id + 1);
+      b.ids[0].emplace_back(id);
+    }
+  }
+
+  void SetUp() override {
+    Device::set_default(dev);
+    Graph::set_default(g);
+  }
+};
+
+TEST_F(DataLoaderTest, CheckInvalidArguments) {
+  EXPECT_THROW(DataLoader(nullptr), Error);
+  EXPECT_THROW(DataLoader(build, 0), Error);
+  EXPECT_THROW(DataLoader(build, 1, 0), Error);
+}
+
+TEST_F(DataLoaderTest, CheckHostBatches) {
+  for (const std::uint32_t num_workers : {1u, 3u}) {
+    for (const std::uint32_t capacity : {1u, 4u}) {
+      DataLoader loader(build, num_workers, capacity);
+      // Runs 2 epochs to reuse buffers.
+      for (std::uint32_t epoch = 0; epoch < 2; ++epoch) {
+        loader.start(plan);
+        EXPECT_EQ(plan.size(), loader.num_batches());
+        for (std::uint32_t i = 0; i < plan.size(); ++i) {
+          const DataLoader::Batch *b = loader.next();
+          ASSERT_NE(nullptr, b);
+          EXPECT_EQ(i, b->index);
+          EXPECT_TRUE(vector_match(plan[i], b->samples));
+          EXPECT_TRUE(vector_match(plan[i], b->ids[0]));
+          EXPECT_EQ(2 * plan[i].size(), b->values[0].size());
+          EXPECT_EQ(10.f * plan[i][0] + 1, b->values[0][1]);
+          EXPECT_TRUE(b->tensors.empty());
+        }
+        EXPECT_EQ(nullptr, loader.next());
+        EXPECT_EQ(nullptr, loader.next());
+      }
+    }
+  }
+}
+
+TEST_F(DataLoaderTest, CheckRestart) {
+  DataLoader loader(build, 2, 2);
+  loader.start(plan);
+  ASSERT_NE(nullptr, loader.next());
+  // Remaining batches are discarded.
+  loader.start({{9}});
+  const DataLoader::Batch *b = loader.next();
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(0u, b->index);
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {9}, b->ids[0]));
+  EXPECT_EQ(nullptr, loader.next());
+}
+
+TEST_F(DataLoaderTest, CheckDeviceBatches) {
+  DataLoader loader(build, 2, 2, &dev);
+  loader.start(plan);
+  for (std::uint32_t i = 0; i < plan.size(); ++i) {
+    const DataLoader::Batch *b = loader.next();
+    ASSERT_NE(nullptr, b);
+    ASSERT_EQ(1u, b->tensors.size());
+    const Tensor &x = b->tensors[0];
+    EXPECT_EQ(Shape({2}, plan[i].size()), x.shape());
+    EXPECT_EQ(&dev, &x.device());
+    EXPECT_TRUE(vector_match(b->values[0], x.to_vector()));
+
+    // The tensor is used in the graph without copying.
+    g.clear();
+    const Node y = 2 * functions::input_node(x, nullptr);
+    vector<float> expected = b->values[0];
+    for (float &v : expected) v *= 2;
+    EXPECT_TRUE(vector_match(expected, y.to_vector()));
+  }
+  EXPECT_EQ(nullptr, loader.next());
+}
+
+TEST_F(DataLoaderTest, CheckBuilderError) {
+  DataLoader loader([](DataLoader::Batch &b) {
+      if (b.index == 2) throw std::runtime_error("error");
+      build(b);
+  }, 1, 1);
+  loader.start(plan);
+  EXPECT_NE(nullptr, loader.next());
+  EXPECT_NE(nullptr, loader.next());
+  EXPECT_THROW(loader.next(), std::runtime_error);
+  EXPECT_EQ(nullptr, loader.next());
+
+  // Next epoch can be started after errors.
+  loader.start({{1}});
+  EXPECT_NE(nullptr, loader.next());
+}
+
+}  // namespace primitiv
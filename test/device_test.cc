@@ -26,4 +26,24 @@ TEST_F(DeviceTest, CheckDefault) {
   EXPECT_THROW(Device::get_default(), Error);
 }
 
+TEST_F(DeviceTest, CheckMathMode) {
+  devices::Naive dev;
+  EXPECT_EQ(Device::MathMode::PRECISE, dev.math_mode());
+  dev.set_math_mode(Device::MathMode::FAST);
+  EXPECT_EQ(Device::MathMode::FAST, dev.math_mode());
+  dev.set_math_mode(Device::MathMode::PRECISE);
+  EXPECT_EQ(Device::MathMode::PRECISE, dev.math_mode());
+}
+
+TEST_F(DeviceTest, CheckStreams) {
+  devices::Naive dev;
+  EXPECT_EQ(1u, dev.num_streams());
+  EXPECT_EQ(0u, dev.current_stream());
+  EXPECT_NO_THROW(dev.set_stream(0, {0}));
+  EXPECT_THROW(dev.set_stream(1, {}), Error);
+  EXPECT_THROW(dev.set_stream(0, {1}), Error);
+  EXPECT_NO_THROW(dev.join_streams());
+  EXPECT_EQ(0u, dev.current_stream());
+}
+
 }  // namespace primitiv
@@ -79,10 +79,10 @@ TEST_F(EigenDeviceTest, CheckRandomBernoulli) {
 
 TEST_F(EigenDeviceTest, CheckRandomBernoulliWithSeed) {
   const vector<float> expected {
-    0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 0,
-    0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0,
+    0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0,
+    0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 0,
+    0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1,
   };
   devices::Eigen dev(12345);
   const Tensor x = dev.random_bernoulli(Shape({4, 4}, 4), 0.3);
@@ -116,8 +116,8 @@ TEST_F(EigenDeviceTest, CheckRandomUniform) {
 
 TEST_F(EigenDeviceTest, CheckRandomUniformWithSeed) {
   const vector<float> expected {
-    7.7330894e+00, 7.0227852e+00, -3.3052402e+00, -6.6472688e+00,
-    -5.6894612e+00, -8.2843294e+00, -5.3179150e+00, 5.8758497e+00,
+    5.7640448e+00, -5.6601787e+00, 5.8212681e+00, 6.9721255e+00,
+    -8.9498987e+00, -6.4026690e+00, 7.0737801e+00, 2.6277013e+00,
   };
   devices::Eigen dev(12345);
   const Tensor x = dev.random_uniform(Shape({2, 2}, 2), -9, 9);
@@ -150,20 +150,10 @@ TEST_F(EigenDeviceTest, CheckRandomNormal) {
 #endif  // PRIMITIV_BUILD_TESTS_PROBABILISTIC
 
 TEST_F(EigenDeviceTest, CheckRandomNormalWithSeed) {
-#ifdef __GLIBCXX__
   const vector<float> expected {
-    -1.3574908e+00, -1.7222166e-01, 2.5865970e+00, -4.3594337e-01,
-    4.5383353e+00, 8.4703674e+00, 2.5535507e+00, 1.3252910e+00,
+    1.7441468e+00, 2.7359235e+00, 2.4208724e+00, -2.1600839e-01,
+    7.3435869e+00, 9.1038418e+00, 1.3216169e-01, -1.3319865e-01,
   };
-#elif defined _LIBCPP_VERSION
-  const vector<float> expected {
-    -1.7222166e-01, -1.3574908e+00, -4.3594337e-01, 2.5865970e+00,
-    8.4703674e+00, 4.5383353e+00, 1.3252910e+00, 2.5535507e+00,
-  };
-#else
-  const vector<float> expected {};
-  std::cerr << "Unknown C++ library. Expected results can't be defined." << std::endl;
-#endif
   devices::Eigen dev(12345);
   const Tensor x = dev.random_normal(Shape({2, 2}, 2), 1, 3);
   EXPECT_TRUE(vector_match(expected, x.to_vector()));
@@ -195,20 +185,10 @@ TEST_F(EigenDeviceTest, CheckRandomLogNormal) {
 #endif  // PRIMITIV_BUILD_TESTS_PROBABILISTIC
 
 TEST_F(EigenDeviceTest, CheckRandomLogNormalWithSeed) {
-#ifdef __GLIBCXX__
-  const vector<float> expected {
-    2.5730559e-01, 8.4179258e-01, 1.3284487e+01, 6.4665437e-01,
-    9.3534966e+01, 4.7712681e+03, 1.2852659e+01, 3.7632804e+00,
-  };
-#elif defined _LIBCPP_VERSION
   const vector<float> expected {
-    8.4179258e-01, 2.5730559e-01, 6.4665437e-01, 1.3284487e+01,
-    4.7712681e+03, 9.3534966e+01, 3.7632804e+00, 1.2852659e+01,
+    5.7210183e+00, 1.5423982e+01, 1.1255675e+01, 8.0572855e-01,
+    1.5462485e+03, 8.9897627e+03, 1.1412928e+00, 8.7529123e-01,
   };
-#else
-  const vector<float> expected {};
-  std::cerr << "Unknown C++ library. Expected results can't be defined." << std::endl;
-#endif
   devices::Eigen dev(12345);
   const Tensor x = dev.random_log_normal(Shape({2, 2}, 2), 1, 3);
   EXPECT_TRUE(vector_match(expected, x.to_vector()));
@@ -0,0 +1,200 @@
+#include <primitiv/config.h>
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/error.h>
+#include <primitiv/expressions.h>
+#include <primitiv/functions.h>
+#include <primitiv/naive_device.h>
+#include <primitiv/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+using test_utils::vector_match_ulps;
+
+namespace primitiv {
+namespace expressions {
+
+class ExpressionsTest : public testing::Test {
+protected:
+  static vector<Device *> devices;
+
+  static void SetUpTestCase() {
+    test_utils::add_available_devices(devices);
+  }
+
+  static void TearDownTestCase() {
+    for (Device *dev : devices) {
+      delete dev;
+    }
+  }
+};
+
+vector<Device *> ExpressionsTest::devices;
+
+TEST_F(ExpressionsTest, CheckLazy) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    const Tensor y = lazy(x);
+    EXPECT_EQ(Shape({2, 2}), y.shape());
+    EXPECT_EQ(dev, &y.device());
+    EXPECT_TRUE(vector_match(x.to_vector(), y.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckArithmetic) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    const Tensor b = dev->new_tensor_by_vector({2, 2}, {5, 6, 7, 8});
+    const vector<float> y_data {5.375, 14.25, 25.125, 38};
+    const Tensor y = 2 * lazy(a) + -lazy(b) / 8 + lazy(a) * b - 1;
+    EXPECT_EQ(Shape({2, 2}), y.shape());
+    EXPECT_TRUE(vector_match(y_data, y.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckMixedOperands) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({3}, {1, 2, 4});
+    const Tensor b = dev->new_tensor_by_vector({3}, {2, 4, 8});
+    EXPECT_TRUE(vector_match(
+          vector<float> {3, 6, 12}, (lazy(a) + b).to_vector()));
+    EXPECT_TRUE(vector_match(
+          vector<float> {1, 2, 4}, (b - lazy(a)).to_vector()));
+    EXPECT_TRUE(vector_match(
+          vector<float> {2, 1, .5}, (2 / lazy(a)).to_vector()));
+    EXPECT_TRUE(vector_match(
+          vector<float> {-1, 0, 2}, (lazy(a) - 2).to_vector()));
+    EXPECT_TRUE(vector_match(
+          vector<float> {.5, .5, .5}, (a / lazy(b)).to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckFunctions) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector({4}, {.5, 1, 2, 4});
+    const Tensor y = sqrt(lazy(x)) + exp(lazy(x)) * log(lazy(x))
+      - tanh(lazy(x)) / sigmoid(lazy(x));
+    const Tensor expected =
+      functions::sqrt(x) + functions::exp(x) * functions::log(x)
+      - functions::tanh(x) / functions::sigmoid(x);
+    EXPECT_TRUE(vector_match_ulps(expected.to_vector(), y.to_vector(), 8));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckBatchBroadcast) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({2}, {1, 2});
+    const Tensor b =
+      dev->new_tensor_by_vector(Shape({2}, 3), {1, 2, 3, 4, 5, 6});
+    const vector<float> y_data {2, 4, 4, 6, 6, 8};
+    const Tensor y1 = lazy(a) + b;
+    const Tensor y2 = lazy(b) + a;
+    EXPECT_EQ(Shape({2}, 3), y1.shape());
+    EXPECT_EQ(Shape({2}, 3), y2.shape());
+    EXPECT_TRUE(vector_match(y_data, y1.to_vector()));
+    EXPECT_TRUE(vector_match(y_data, y2.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckInplaceOperations) {
+  for (Device *dev : devices) {
+    Tensor x = dev->new_tensor_by_vector({2}, {1, 2});
+    const Tensor g = dev->new_tensor_by_vector({2}, {3, 4});
+    x += 2 * lazy(g) * g;
+    EXPECT_TRUE(vector_match(vector<float> {19, 34}, x.to_vector()));
+    x -= lazy(g) + 1;
+    EXPECT_TRUE(vector_match(vector<float> {15, 29}, x.to_vector()));
+    x = .5 * lazy(x) - g;
+    EXPECT_TRUE(vector_match(vector<float> {4.5, 10.5}, x.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckStoredExpression) {
+  for (Device *dev : devices) {
+    const auto e = [dev]() {
+      // Temporary tensors are kept alive by the expression.
+      const Tensor a = dev->new_tensor_by_vector({2}, {1, 2});
+      return lazy(a) * 3 + 1;
+    }();
+    EXPECT_TRUE(vector_match(vector<float> {4, 7}, e.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckInvalidArguments) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_constant({2}, 1);
+    const Tensor b = dev->new_tensor_by_constant({3}, 1);
+    const Tensor c = dev->new_tensor_by_constant(Shape({2}, 2), 1);
+    const Tensor d = dev->new_tensor_by_constant(Shape({2}, 3), 1);
+    EXPECT_THROW(Tensor(lazy(a) + b), Error);
+    EXPECT_THROW(Tensor(lazy(c) * d), Error);
+    EXPECT_THROW(lazy(Tensor()), Error);
+  }
+}
+
+TEST_F(ExpressionsTest, CheckInvalidDevice) {
+  if (devices.size() < 2) return;
+  const Tensor a = devices[0]->new_tensor_by_constant({2}, 1);
+  const Tensor b = devices[1]->new_tensor_by_constant({2}, 1);
+  EXPECT_THROW(Tensor(lazy(a) + b), Error);
+}
+
+TEST_F(ExpressionsTest, CheckElementwiseFw) {
+  for (Device *dev : devices) {
+    if (!dev->supports_host_kernels()) continue;
+    const Tensor a = dev->new_tensor_by_vector(Shape({2}, 2), {1, 2, 3, 4});
+    const Tensor b = dev->new_tensor_by_vector({2}, {10, 20});
+    std::uint32_t num_calls = 0;
+    const Tensor y = dev->elementwise_fw(
+        {&a, &b}, Shape({2}, 2),
+        [&num_calls](
+          const float *const *srcs, float *dest, std::uint32_t size) {
+          ++num_calls;
+          for (std::uint32_t i = 0; i < size; ++i) {
+            dest[i] = srcs[0][i] + srcs[1][i];
+          }
+        });
+    EXPECT_EQ(2u, num_calls);
+    EXPECT_EQ(Shape({2}, 2), y.shape());
+    EXPECT_TRUE(vector_match(vector<float> {11, 22, 13, 24}, y.to_vector()));
+  }
+}
+
+TEST_F(ExpressionsTest, CheckSource) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_constant({2}, 1);
+    const Tensor b = dev->new_tensor_by_constant({2}, 1);
+    std::uint32_t n = 0;
+    EXPECT_EQ(
+        "((x0 + 2.f) * exp((-x1)))",
+        ((lazy(a) + 2.f) * exp(-lazy(b))).source(n));
+    EXPECT_EQ(2u, n);
+    n = 0;
+    EXPECT_EQ(
+        "(((-1.5f) - sqrt(x0)) / x1)",
+        ((-1.5f - sqrt(lazy(a))) / b).source(n));
+    EXPECT_EQ(2u, n);
+  }
+}
+
+TEST_F(ExpressionsTest, CheckElementwiseSourceFw) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector(Shape({2}, 2), {1, 2, 3, 4});
+    const Tensor b = dev->new_tensor_by_vector({2}, {10, 20});
+    if (!dev->supports_source_kernels()) {
+      EXPECT_THROW(
+          dev->elementwise_source_fw({&a, &b}, Shape({2}, 2), "(x0 + x1)"),
+          Error);
+      continue;
+    }
+    const Tensor y = dev->elementwise_source_fw(
+        {&a, &b}, Shape({2}, 2), "(x0 + x1)");
+    EXPECT_EQ(Shape({2}, 2), y.shape());
+    EXPECT_TRUE(vector_match(vector<float> {11, 22, 13, 24}, y.to_vector()));
+  }
+}
+
+}  // namespace expressions
+}  // namespace primitiv
@@ -0,0 +1,149 @@
+#include <primitiv/config.h>
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/eigen_device.h>
+#include <primitiv/error.h>
+#include <primitiv/hybrid_device.h>
+#include <primitiv/naive_device.h>
+#include <primitiv/shape.h>
+#include <primitiv/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match_ulps;
+
+namespace primitiv {
+
+class HybridDeviceTest : public testing::Test {
+protected:
+  using Backend = devices::Hybrid::Backend;
+  using KernelClass = devices::Hybrid::KernelClass;
+
+  static vector<float> make_values(std::uint32_t n) {
+    vector<float> ret(n);
+    // Products and sums of these values are exactly representable.
+    for (std::uint32_t i = 0; i < n; ++i) ret[i] = .25 * (i % 9) - 1;
+    return ret;
+  }
+};
+
+TEST_F(HybridDeviceTest, CheckDeviceType) {
+  devices::Hybrid dev;
+  EXPECT_EQ(Device::DeviceType::HYBRID, dev.type());
+}
+
+TEST_F(HybridDeviceTest, CheckNumThreads) {
+  devices::Hybrid dev1(0, 1);
+  EXPECT_EQ(1u, dev1.num_threads());
+  devices::Hybrid dev3(0, 3);
+  EXPECT_EQ(3u, dev3.num_threads());
+  devices::Hybrid dev0(0, 0);
+  EXPECT_LE(1u, dev0.num_threads());
+}
+
+TEST_F(HybridDeviceTest, CheckSelectBackend) {
+  devices::Hybrid dev(0, 2);
+  for (KernelClass kc : {
+      KernelClass::UNARY, KernelClass::BINARY, KernelClass::MATMUL}) {
+    for (std::uint32_t size : {1u, 100u, 1u << 20}) {
+      const Backend b = dev.select_backend(kc, size);
+      EXPECT_NE(Backend::AUTO, b);
+      // Selections are fixed after calibration.
+      EXPECT_EQ(b, dev.select_backend(kc, size));
+    }
+  }
+  dev.force_backend(Backend::NAIVE);
+  EXPECT_EQ(Backend::NAIVE, dev.select_backend(KernelClass::UNARY, 1));
+}
+
+TEST_F(HybridDeviceTest, CheckThreadedFallback) {
+  devices::Hybrid dev(0, 1);
+  dev.force_backend(Backend::THREADED);
+  EXPECT_EQ(Backend::EIGEN, dev.select_backend(KernelClass::UNARY, 1));
+}
+
+TEST_F(HybridDeviceTest, CheckForcedBackends) {
+  // Sizes are larger than the grain of the multithreaded implementations.
+  const Shape sx({123, 45}, 3);
+  const Shape sa({31, 57});
+  const Shape sb({57, 1000});
+  const Shape sab({31, 57}, 3);
+  const Shape sbb({57, 100}, 3);
+  const vector<float> x_data = make_values(sx.size());
+  const vector<float> a_data = make_values(sa.size());
+  const vector<float> b_data = make_values(sb.size());
+  const vector<float> ab_data = make_values(sab.size());
+  const vector<float> bb_data = make_values(sbb.size());
+
+  devices::Naive ref;
+  const Tensor rx = ref.new_tensor_by_vector(sx, x_data);
+  const vector<float> exp_y = ref.exp_fw(rx).to_vector();
+  const vector<float> add_y = ref.add_fw(rx, rx).to_vector();
+  const vector<float> mul_y = ref.multiply_const_fw(rx, 3).to_vector();
+  const vector<float> mm_y = ref.matmul_fw(
+      ref.new_tensor_by_vector(sa, a_data),
+      ref.new_tensor_by_vector(sb, b_data)).to_vector();
+  const vector<float> mmb_y = ref.matmul_fw(
+      ref.new_tensor_by_vector(sab, ab_data),
+      ref.new_tensor_by_vector(sbb, bb_data)).to_vector();
+
+  for (Backend b : {Backend::NAIVE, Backend::EIGEN, Backend::THREADED}) {
+    devices::Hybrid dev(0, 3);
+    dev.force_backend(b);
+    const Tensor x = dev.new_tensor_by_vector(sx, x_data);
+    EXPECT_TRUE(vector_match_ulps(exp_y, dev.exp_fw(x).to_vector(), 4));
+    EXPECT_TRUE(vector_match_ulps(add_y, dev.add_fw(x, x).to_vector(), 0));
+    EXPECT_TRUE(vector_match_ulps(
+          mul_y, dev.multiply_const_fw(x, 3).to_vector(), 0));
+    EXPECT_TRUE(vector_match_ulps(
+          mm_y,
+          dev.matmul_fw(
+            dev.new_tensor_by_vector(sa, a_data),
+            dev.new_tensor_by_vector(sb, b_data)).to_vector(),
+          0));
+    EXPECT_TRUE(vector_match_ulps(
+          mmb_y,
+          dev.matmul_fw(
+            dev.new_tensor_by_vector(sab, ab_data),
+            dev.new_tensor_by_vector(sbb, bb_data)).to_vector(),
+          0));
+    Tensor y = dev.new_tensor_by_vector(sx, x_data);
+    y *= 3;
+    EXPECT_TRUE(vector_match_ulps(mul_y, y.to_vector(), 0));
+  }
+}
+
+TEST_F(HybridDeviceTest, CheckRandomReproducibility) {
+  const Shape shape({123, 45}, 7);
+  devices::Eigen ref(12345);
+  const vector<float> expected[] {
+    ref.random_bernoulli(shape, .3).to_vector(),
+    ref.random_uniform(shape, -1, 1).to_vector(),
+    ref.random_normal(shape, 1, 2).to_vector(),
+    ref.random_log_normal(shape, 1, 2).to_vector(),
+  };
+  for (std::uint32_t num_threads : {1u, 2u, 5u}) {
+    devices::Hybrid dev(12345, num_threads);
+    EXPECT_TRUE(vector_match_ulps(
+          expected[0], dev.random_bernoulli(shape, .3).to_vector(), 0));
+    EXPECT_TRUE(vector_match_ulps(
+          expected[1], dev.random_uniform(shape, -1, 1).to_vector(), 0));
+    EXPECT_TRUE(vector_match_ulps(
+          expected[2], dev.random_normal(shape, 1, 2).to_vector(), 0));
+    EXPECT_TRUE(vector_match_ulps(
+          expected[3], dev.random_log_normal(shape, 1, 2).to_vector(), 0));
+  }
+}
+
+TEST_F(HybridDeviceTest, CheckInvalidArguments) {
+  devices::Hybrid dev(0, 2);
+  const Tensor x = dev.new_tensor_by_constant(Shape({2}, 2), 1);
+  const Tensor y = dev.new_tensor_by_constant(Shape({2}, 3), 1);
+  for (Backend b : {Backend::NAIVE, Backend::EIGEN, Backend::THREADED}) {
+    dev.force_backend(b);
+    EXPECT_THROW(dev.add_fw(x, y), Error);
+  }
+}
+
+}  // namespace primitiv
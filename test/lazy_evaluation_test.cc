@@ -0,0 +1,185 @@
+#include <primitiv/config.h>
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/device.h>
+#include <primitiv/functions.h>
+#include <primitiv/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace F = primitiv::functions;
+
+namespace primitiv {
+
+class LazyEvaluationTest : public testing::Test {
+protected:
+  static vector<Device *> devices;
+
+  static void SetUpTestCase() {
+    test_utils::add_available_devices(devices);
+  }
+
+  static void TearDownTestCase() {
+    for (Device *dev : devices) {
+      delete dev;
+    }
+  }
+
+  void TearDown() override {
+    for (Device *dev : devices) {
+      dev->set_lazy(false);
+    }
+  }
+
+  // Calculates a composite function which contains both fusible and
+  // non-fusible operations.
+  static Tensor composite(const Tensor &x, const Tensor &w) {
+    const Tensor h = F::tanh(F::matmul(w, x) + 1);
+    const Tensor e = F::exp(-h * h) * 3 - F::sigmoid(h);
+    return F::sum(e / (F::sqrt(h * h + 1) + h), 0) + F::sum(e, 0);
+  }
+};
+
+vector<Device *> LazyEvaluationTest::devices;
+
+TEST_F(LazyEvaluationTest, CheckSetLazy) {
+  for (Device *dev : devices) {
+    EXPECT_FALSE(dev->is_lazy());
+    dev->set_lazy(true);
+    EXPECT_TRUE(dev->is_lazy());
+    dev->set_lazy(false);
+    EXPECT_FALSE(dev->is_lazy());
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckSameResults) {
+  // Sizes which are smaller/larger than the block size of the fusion.
+  for (const std::uint32_t n : {3u, 1000u, 12345u}) {
+    for (Device *dev : devices) {
+      const vector<float> x_data {.5f, -1.f};
+      vector<float> w_data(2 * n);
+      for (std::uint32_t i = 0; i < 2 * n; ++i) {
+        w_data[i] = std::cos(.3f * i);
+      }
+      const Tensor x = dev->new_tensor_by_vector({2}, x_data);
+      const Tensor w = dev->new_tensor_by_vector({n, 2}, w_data);
+      const vector<float> expected = composite(x, w).to_vector();
+
+      dev->set_lazy(true);
+      const Tensor y = composite(x, w);
+      EXPECT_EQ(Shape({1}), y.shape());
+      EXPECT_GT(dev->flush(), 0u);
+      EXPECT_TRUE(vector_match(expected, y.to_vector()));
+    }
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckAutoFlush) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor x = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    const Tensor y = F::exp(x) + x;
+    EXPECT_EQ(Shape({2, 2}), y.shape());
+    const vector<float> y_data {
+      std::exp(1.f) + 1, std::exp(2.f) + 2,
+      std::exp(3.f) + 3, std::exp(4.f) + 4,
+    };
+    EXPECT_TRUE(vector_match(y_data, y.to_vector()));
+    EXPECT_EQ(0u, dev->flush());
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckDeadCodeElimination) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor x = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    {
+      const Tensor a = F::exp(x);
+      const Tensor b = F::matmul(a, a);
+      const Tensor c = F::log(b) + a;
+    }
+    const Tensor y = F::tanh(x);
+    {
+      const Tensor d = F::sum(y, 1);
+    }
+    EXPECT_EQ(1u, dev->flush());
+    EXPECT_TRUE(vector_match(
+          vector<float> {
+            std::tanh(1.f), std::tanh(2.f), std::tanh(3.f), std::tanh(4.f) },
+          y.to_vector()));
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckIntermediateResults) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor x = dev->new_tensor_by_vector({3}, {1, 2, 3});
+    const Tensor a = x + 1;
+    const Tensor b = a * a;
+    const Tensor c = b - a;
+    EXPECT_EQ(3u, dev->flush());
+    EXPECT_TRUE(vector_match(vector<float> {2, 3, 4}, a.to_vector()));
+    EXPECT_TRUE(vector_match(vector<float> {4, 9, 16}, b.to_vector()));
+    EXPECT_TRUE(vector_match(vector<float> {2, 6, 12}, c.to_vector()));
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckBroadcast) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor a = dev->new_tensor_by_vector(
+        Shape({3}, 2), {1, 2, 3, 4, 5, 6});
+    const Tensor b = dev->new_tensor_by_vector({3}, {1, 1, 2});
+    const Tensor y = F::exp(a - a) * b + a;
+    EXPECT_EQ(Shape({3}, 2), y.shape());
+    EXPECT_TRUE(vector_match(
+          vector<float> {2, 3, 5, 5, 6, 8}, y.to_vector()));
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckReshape) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor x = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    const Tensor y = (x * 2).reshape({4});
+    const Tensor z = F::flatten(x + 1);
+    EXPECT_EQ(Shape({4}), y.shape());
+    EXPECT_EQ(Shape({4}), z.shape());
+    EXPECT_TRUE(vector_match(vector<float> {2, 4, 6, 8}, y.to_vector()));
+    EXPECT_TRUE(vector_match(vector<float> {2, 3, 4, 5}, z.to_vector()));
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckInplaceAfterDeferral) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    Tensor x = dev->new_tensor_by_vector({3}, {1, 2, 3});
+    const Tensor y = x * 2;
+    x *= 10;
+    Tensor z = x + 1;
+    z += y;
+    EXPECT_TRUE(vector_match(vector<float> {2, 4, 6}, y.to_vector()));
+    EXPECT_TRUE(vector_match(vector<float> {10, 20, 30}, x.to_vector()));
+    EXPECT_TRUE(vector_match(vector<float> {13, 25, 37}, z.to_vector()));
+  }
+}
+
+TEST_F(LazyEvaluationTest, CheckDisableLazy) {
+  for (Device *dev : devices) {
+    dev->set_lazy(true);
+    const Tensor x = dev->new_tensor_by_vector({3}, {1, 2, 3});
+    const Tensor y = x * x;
+    dev->set_lazy(false);
+    EXPECT_EQ(0u, dev->flush());
+    EXPECT_TRUE(vector_match(vector<float> {1, 4, 9}, y.to_vector()));
+    const Tensor z = y + x;
+    EXPECT_EQ(0u, dev->flush());
+    EXPECT_TRUE(vector_match(vector<float> {2, 6, 12}, z.to_vector()));
+  }
+}
+
+}  // namespace primitiv
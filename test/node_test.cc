@@ -8,6 +8,7 @@
 #include <primitiv/functions.h>
 #include <primitiv/graph.h>
 #include <primitiv/naive_device.h>
+#include <primitiv/parameter.h>
 #include <test_utils.h>
 
 using std::vector;
@@ -88,4 +89,35 @@ TEST_F(NodeTest, CheckArgMinLarge) {
   }
 }
 
+TEST_F(NodeTest, CheckBatchSliceAndConcat) {
+  Parameter w({2}, {1, 1});
+  w.reset_gradient();
+  const Node x = functions::input<Node>(Shape({2}, 3), {1, 2, 3, 4, 5, 6});
+  const Node a = x * functions::parameter<Node>(w);
+  const Node b = functions::batch::concat(
+      {functions::batch::slice(a, 2, 3), functions::batch::pick(a, {0, 1})});
+  EXPECT_EQ(Shape({2}, 3), b.shape());
+  EXPECT_TRUE(vector_match(vector<float> {5, 6, 1, 2, 3, 4}, b.to_vector()));
+  const Node c = functions::input<Node>(
+      Shape({2}, 3), {1, 1, 10, 10, 100, 100});
+  functions::batch::sum(functions::sum(b * c, 0)).backward();
+  EXPECT_TRUE(vector_match(vector<float> {315, 426}, w.gradient().to_vector()));
+}
+
+TEST_F(NodeTest, CheckTopK) {
+  const vector<float> data = {1, 3, 2, 3, 1, 2};
+  const Node a = functions::input<Node>({6}, data);
+  vector<float> values;
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {1, 3, 2}, a.topk(0, 3)));
+  EXPECT_TRUE(vector_match(
+        vector<std::uint32_t> {1, 3, 2, 5}, a.topk(0, 4, values)));
+  EXPECT_TRUE(vector_match(vector<float> {3, 3, 2, 2}, values));
+}
+
+TEST_F(NodeTest, CheckSample) {
+  const vector<float> data = {0, 0, 100, 0, 100, 0};
+  const Node a = functions::input<Node>(Shape({3}, 2), data);
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {2, 1}, a.sample(0)));
+}
+
 }  // namespace primitiv
@@ -0,0 +1,52 @@
+// Reports the throughput of precise and fast math functions in
+// primitiv/numeric_utils.h. This is not a part of the test suite because the
+// results depend on the environment.
+//
+// Usage:
+//   $ ./numeric_utils_bench
+
+#include <primitiv/config.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include <primitiv/numeric_utils.h>
+
+using namespace primitiv::numeric_utils;
+
+namespace {
+
+// Measures the average time to apply `f` to each element.
+template<typename F>
+double measure_ns(F f, const std::vector<float> &x, std::vector<float> &y) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < x.size(); ++i) y[i] = f(x[i]);
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count()
+    / x.size();
+}
+
+}  // namespace
+
+int main() {
+  const std::size_t size = 1 << 22;
+  std::vector<float> x(size), y(size);
+  for (std::size_t i = 0; i < size; ++i) x[i] = (i % 2000) / 100.f - 10.f;
+
+#define MEASURE(name, precise, fast) \
+  std::cout << name << ": precise " \
+    << ::measure_ns([](float v) { return (precise); }, x, y) << " ns, fast " \
+    << ::measure_ns([](float v) { return (fast); }, x, y) << " ns" \
+    << std::endl;
+
+  MEASURE("exp", std::exp(v), fast_exp(v));
+  MEASURE("log", std::log(v + 11.f), fast_log(v + 11.f));
+  MEASURE("tanh", std::tanh(v), fast_tanh(v));
+  MEASURE("sigmoid", .5f + .5f * std::tanh(.5f * v), fast_sigmoid(v));
+  MEASURE("softplus", std::log1p(std::exp(v)), fast_softplus(v));
+#undef MEASURE
+
+  return 0;
+}
@@ -1,6 +1,8 @@
 #include <primitiv/config.h>
 
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <vector>
 #include <gtest/gtest.h>
 #include <primitiv/numeric_utils.h>
@@ -8,7 +10,35 @@
 namespace primitiv {
 namespace numeric_utils {
 
-class NumericUtilsTest : public testing::Test {};
+class NumericUtilsTest : public testing::Test {
+protected:
+  // Calculates the error of `actual` in ULPs of the correctly rounded result.
+  static double ulp_error(float actual, double expected) {
+    const float rounded = static_cast<float>(expected);
+    if (std::isinf(rounded) || std::isinf(actual)) {
+      return rounded == actual ? 0 : std::numeric_limits<double>::infinity();
+    }
+    const float a = std::fabs(rounded);
+    const double ulp = a < std::numeric_limits<float>::min()
+      ? std::numeric_limits<float>::denorm_min()
+      : std::nextafter(a, std::numeric_limits<float>::infinity()) - a;
+    return std::fabs(actual - expected) / ulp;
+  }
+
+  // Calculates the maximum error of `f` over float values in [lower, upper].
+  template<typename F, typename R>
+  static double max_ulp_error(F f, R ref, float lower, float upper) {
+    double ret = 0;
+    // Samples about 4 million values over all bit patterns.
+    for (std::uint64_t b = 0; b <= 0xffffffffull; b += 1021) {
+      const float x = bits_to_float(static_cast<std::uint32_t>(b));
+      if (!(x >= lower && x <= upper)) continue;
+      const double err = ulp_error(f(x), ref(static_cast<double>(x)));
+      if (err > ret) ret = err;
+    }
+    return ret;
+  }
+};
 
 TEST_F(NumericUtilsTest, CheckCalculateShifts) {
   std::vector<std::uint64_t> samples {
@@ -28,5 +58,94 @@ TEST_F(NumericUtilsTest, CheckCalculateShifts) {
   EXPECT_EQ(64ull, calculate_shifts(0xffffffffffffffffull));
 }
 
+TEST_F(NumericUtilsTest, CheckBitsConversion) {
+  EXPECT_EQ(0x3f800000u, float_to_bits(1.f));
+  EXPECT_EQ(0xc0000000u, float_to_bits(-2.f));
+  EXPECT_EQ(1.f, bits_to_float(0x3f800000u));
+  EXPECT_EQ(-2.f, bits_to_float(0xc0000000u));
+}
+
+TEST_F(NumericUtilsTest, CheckFastExpError) {
+  const double err = max_ulp_error(
+      [](float x) { return fast_exp(x); },
+      [](double x) { return std::exp(x); },
+      -104.f, 89.f);
+  EXPECT_LE(err, 2.);
+}
+
+TEST_F(NumericUtilsTest, CheckFastLogError) {
+  const double err = max_ulp_error(
+      [](float x) { return fast_log(x); },
+      [](double x) { return std::log(x); },
+      0.f, std::numeric_limits<float>::max());
+  EXPECT_LE(err, 2.);
+}
+
+TEST_F(NumericUtilsTest, CheckFastTanhError) {
+  const double err = max_ulp_error(
+      [](float x) { return fast_tanh(x); },
+      [](double x) { return std::tanh(x); },
+      -std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+  EXPECT_LE(err, 2.);
+}
+
+TEST_F(NumericUtilsTest, CheckFastSigmoidError) {
+  // Results become subnormal below -87.
+  const double err = max_ulp_error(
+      [](float x) { return fast_sigmoid(x); },
+      [](double x) { return 1. / (1. + std::exp(-x)); },
+      -87.f, std::numeric_limits<float>::max());
+  EXPECT_LE(err, 4.);
+}
+
+TEST_F(NumericUtilsTest, CheckFastSoftplusError) {
+  // Results become subnormal below -87.
+  const double err = max_ulp_error(
+      [](float x) { return fast_softplus(x); },
+      [](double x) {
+        return x > 0 ? x + std::log1p(std::exp(-x)) : std::log1p(std::exp(x));
+      },
+      -87.f, std::numeric_limits<float>::max());
+  EXPECT_LE(err, 4.);
+}
+
+TEST_F(NumericUtilsTest, CheckFastSpecialValues) {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  EXPECT_EQ(1.f, fast_exp(0.f));
+  EXPECT_EQ(inf, fast_exp(inf));
+  EXPECT_EQ(inf, fast_exp(100.f));
+  EXPECT_EQ(0.f, fast_exp(-inf));
+  EXPECT_EQ(0.f, fast_exp(-110.f));
+  EXPECT_TRUE(std::isnan(fast_exp(nan)));
+
+  EXPECT_EQ(0.f, fast_log(1.f));
+  EXPECT_EQ(-inf, fast_log(0.f));
+  EXPECT_EQ(-inf, fast_log(-0.f));
+  EXPECT_EQ(inf, fast_log(inf));
+  EXPECT_TRUE(std::isnan(fast_log(-1.f)));
+  EXPECT_TRUE(std::isnan(fast_log(-inf)));
+  EXPECT_TRUE(std::isnan(fast_log(nan)));
+  EXPECT_NEAR(
+      std::log(std::numeric_limits<float>::denorm_min()),
+      fast_log(std::numeric_limits<float>::denorm_min()), 1e-4);
+
+  EXPECT_EQ(0.f, fast_tanh(0.f));
+  EXPECT_EQ(1.f, fast_tanh(inf));
+  EXPECT_EQ(-1.f, fast_tanh(-inf));
+  EXPECT_TRUE(std::isnan(fast_tanh(nan)));
+
+  EXPECT_EQ(.5f, fast_sigmoid(0.f));
+  EXPECT_EQ(1.f, fast_sigmoid(inf));
+  EXPECT_EQ(0.f, fast_sigmoid(-inf));
+  EXPECT_TRUE(std::isnan(fast_sigmoid(nan)));
+
+  EXPECT_EQ(inf, fast_softplus(inf));
+  EXPECT_EQ(0.f, fast_softplus(-inf));
+  EXPECT_EQ(100.f, fast_softplus(100.f));
+  EXPECT_TRUE(std::isnan(fast_softplus(nan)));
+}
+
 }  // namespace numeric_utils
 }  // namespace primitiv
@@ -5,6 +5,8 @@
 #include <vector>
 #include <gtest/gtest.h>
 #include <primitiv/error.h>
+#include <primitiv/functions.h>
+#include <primitiv/graph.h>
 #include <primitiv/opencl_device.h>
 #include <primitiv/shape.h>
 #include <primitiv/tensor.h>
@@ -265,4 +267,96 @@ TEST_F(OpenCLDeviceTest, CheckRandomLogNormalWithSeed) {
   }
 }
 
+TEST_F(OpenCLDeviceTest, CheckElementwiseSourceFw) {
+  for (const Config &cfg : configs) {
+    devices::OpenCL dev(cfg.pf_id, cfg.dev_id);
+    EXPECT_TRUE(dev.supports_source_kernels());
+    const Tensor a = dev.new_tensor_by_vector(Shape({2}, 2), {1, 2, 3, 4});
+    const Tensor b = dev.new_tensor_by_vector({2}, {10, 20});
+    const Tensor y = dev.elementwise_source_fw(
+        {&a, &b}, Shape({2}, 2), "(x0 * 2.f + x1)");
+    EXPECT_TRUE(vector_match(vector<float> {12, 24, 16, 28}, y.to_vector()));
+    // The same kernel is reused.
+    const Tensor z = dev.elementwise_source_fw(
+        {&b, &a}, Shape({2}, 2), "(x0 * 2.f + x1)");
+    EXPECT_TRUE(vector_match(vector<float> {21, 42, 23, 44}, z.to_vector()));
+    EXPECT_THROW(
+        dev.elementwise_source_fw({&a}, Shape({2}, 2), "(x0 +)"), Error);
+  }
+}
+
+TEST_F(OpenCLDeviceTest, CheckAsyncTransfers) {
+  for (const Config &cfg : configs) {
+    devices::OpenCL dev(cfg.pf_id, cfg.dev_id);
+    // Host data is copied before returning, and later writes never overtake
+    // earlier kernels.
+    Tensor y = dev.new_tensor_by_constant({256}, 0);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+      vector<float> data(256, i);
+      const Tensor x = dev.new_tensor_by_vector({256}, data);
+      data.assign(256, -1);
+      y.inplace_add(x);
+    }
+    EXPECT_TRUE(vector_match(vector<float>(256, 4950), y.to_vector()));
+  }
+}
+
+TEST_F(OpenCLDeviceTest, CheckSubBuffers) {
+  for (const Config &cfg : configs) {
+    devices::OpenCL dev(cfg.pf_id, cfg.dev_id);
+    // Small tensors share slabs, and large tensors have their own buffers.
+    vector<Tensor> xs;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+      xs.emplace_back(dev.new_tensor_by_constant({i % 7 + 1}, i));
+    }
+    const Tensor large = dev.new_tensor_by_constant({1 << 22}, -1);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+      EXPECT_TRUE(vector_match(
+            vector<float>(i % 7 + 1, i), xs[i].to_vector()));
+    }
+    EXPECT_EQ(-1, large.to_vector().back());
+  }
+}
+
+TEST_F(OpenCLDeviceTest, CheckMultipleQueues) {
+  const vector<float> a_data {1, 2, 3, 4};
+  const vector<float> b_data {-1, 0, .5, 2};
+  for (const Config &cfg : configs) {
+    devices::OpenCL dev1(cfg.pf_id, cfg.dev_id, 12345, 1);
+    devices::OpenCL dev4(cfg.pf_id, cfg.dev_id, 12345, 4);
+    EXPECT_EQ(1u, dev1.num_streams());
+    EXPECT_EQ(4u, dev4.num_streams());
+    EXPECT_THROW(devices::OpenCL(cfg.pf_id, cfg.dev_id, 12345, 0), Error);
+
+    // Two independent chains are calculated on different queues.
+    vector<vector<float>> results;
+    for (Device *dev : vector<Device *> {&dev1, &dev4}) {
+      Graph g;
+      const Node a = functions::input<Node>({4}, a_data, *dev, g);
+      const Node b = functions::input<Node>({4}, b_data, *dev, g);
+      const Node ya = functions::exp(functions::tanh(a) * 2);
+      const Node yb = functions::sigmoid(b - 1) + b;
+      const Node y = functions::sum(ya * yb, 0);
+      results.emplace_back(y.to_vector());
+      EXPECT_EQ(0u, dev->current_stream());
+      g.backward(y);
+      EXPECT_EQ(0u, dev->current_stream());
+    }
+    EXPECT_TRUE(vector_match(results[0], results[1]));
+  }
+}
+
+TEST_F(OpenCLDeviceTest, CheckTensorOutlivesMultipleQueues) {
+  for (const Config &cfg : configs) {
+    Tensor x;
+    {
+      devices::OpenCL dev(cfg.pf_id, cfg.dev_id, 12345, 4);
+      x = dev.new_tensor_by_constant({4}, 1);
+      EXPECT_TRUE(vector_match(vector<float>(4, 1), x.to_vector()));
+    }
+    // Releasing the memory after the device has gone should not crash.
+    EXPECT_NO_THROW(x = Tensor());
+  }
+}
+
 }  // namespace primitiv
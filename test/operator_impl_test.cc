@@ -545,6 +545,98 @@ TEST_F(OperatorImplTest, CheckPick) {
   }
 }
 
+TEST_F(OperatorImplTest, CheckBatchPick) {
+  struct TestCase {
+    vector<std::uint32_t> ids;
+    Shape ret_shape;
+    vector<float> ret_data;
+    vector<float> bw_grad;
+  };
+  const vector<TestCase> test_cases {
+    {{0}, {2, 2},
+      {1, 2, 3, 4},
+      {1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {{2, 0}, Shape({2, 2}, 2),
+      {-1, -2, -3, -4, 1, 2, 3, 4},
+      {1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1}},
+    {{1, 2, 2, 1}, Shape({2, 2}, 4),
+      {0, 0, 0, 0, -1, -2, -3, -4, -1, -2, -3, -4, 0, 0, 0, 0},
+      {0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2}},
+  };
+  setup_1arg();
+  for (const TestCase &tc : test_cases) {
+    BatchPick node(tc.ids);
+    const Shape cur_shape = node.forward_shape(arg_shapes);
+    const Tensor cur_value = node.forward(arg_values);
+    const Tensor cur_grad = functions::ones<Tensor>(tc.ret_shape, *dev);
+    reset_gradients();
+    node.backward(cur_value, cur_grad, arg_values, arg_grads);
+    EXPECT_EQ("BatchPick", node.name());
+    EXPECT_EQ(tc.ret_shape, cur_shape);
+    EXPECT_EQ(nullptr, node.get_device());
+    EXPECT_TRUE(vector_match(tc.ret_data, cur_value.to_vector()));
+    EXPECT_TRUE(vector_match(tc.bw_grad, arg_grads[0]->to_vector()));
+  }
+}
+
+TEST_F(OperatorImplTest, CheckBatchSlice) {
+  struct TestCase {
+    std::uint32_t lower, upper;
+    Shape ret_shape;
+    vector<float> ret_data;
+    vector<float> bw_grad;
+  };
+  const vector<TestCase> test_cases {
+    {0, 1, {2, 2},
+      {1, 2, 3, 4},
+      {1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {1, 3, Shape({2, 2}, 2),
+      {0, 0, 0, 0, -1, -2, -3, -4},
+      {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1}},
+  };
+  setup_1arg();
+  for (const TestCase &tc : test_cases) {
+    BatchSlice node(tc.lower, tc.upper);
+    const Shape cur_shape = node.forward_shape(arg_shapes);
+    const Tensor cur_value = node.forward(arg_values);
+    const Tensor cur_grad = functions::ones<Tensor>(tc.ret_shape, *dev);
+    reset_gradients();
+    node.backward(cur_value, cur_grad, arg_values, arg_grads);
+    EXPECT_EQ(
+        "BatchSlice(" + std::to_string(tc.lower) +
+        ':' + std::to_string(tc.upper) + ')', node.name());
+    EXPECT_EQ(tc.ret_shape, cur_shape);
+    EXPECT_EQ(nullptr, node.get_device());
+    EXPECT_TRUE(vector_match(tc.ret_data, cur_value.to_vector()));
+    EXPECT_TRUE(vector_match(tc.bw_grad, arg_grads[0]->to_vector()));
+  }
+}
+
+TEST_F(OperatorImplTest, CheckBatchConcat) {
+  const Shape ret_shape({2}, 3);
+  const vector<float> ret_data {1, 2, 3, 4, 5, 6};
+  const vector<vector<float>> bw_grads {{1, 2, 3, 4}, {5, 6}};
+  vector<const Shape *> shapes;
+  vector<const Tensor *> values;
+  vector<Tensor *> grads;
+  const Shape s1({2}, 2), s2({2});
+  const Tensor v1 = dev->new_tensor_by_vector(s1, {1, 2, 3, 4});
+  const Tensor v2 = dev->new_tensor_by_vector(s2, {5, 6});
+  Tensor g1 = dev->new_tensor_by_constant(s1, 0);
+  Tensor g2 = dev->new_tensor_by_constant(s2, 0);
+  BatchConcat node;
+  const Shape cur_shape = node.forward_shape({&s1, &s2});
+  const Tensor cur_value = node.forward({&v1, &v2});
+  const Tensor cur_grad = dev->new_tensor_by_vector(ret_shape, ret_data);
+  node.backward(cur_value, cur_grad, {&v1, &v2}, {&g1, &g2});
+  EXPECT_EQ("BatchConcat", node.name());
+  EXPECT_EQ(ret_shape, cur_shape);
+  EXPECT_EQ(nullptr, node.get_device());
+  EXPECT_TRUE(vector_match(ret_data, cur_value.to_vector()));
+  EXPECT_TRUE(vector_match(bw_grads[0], g1.to_vector()));
+  EXPECT_TRUE(vector_match(bw_grads[1], g2.to_vector()));
+}
+
 TEST_F(OperatorImplTest, CheckSlice) {
   struct TestCase {
     std::uint32_t dim, lower, upper;
@@ -1322,6 +1414,102 @@ TEST_F(OperatorImplTest, CheckLogSumExp) {
   }
 }
 
+TEST_F(OperatorImplTest, CheckMax) {
+  // y = max(x, dim)
+  // dy/dx = 1 at the first maximum element, 0 otherwise
+  setup_1arg();
+  struct TestCase {
+    std::uint32_t dim;
+    Shape ret_shape;
+    vector<float> ret_data;
+    vector<float> bw_grad;
+  };
+  const vector<TestCase> test_cases {
+    {0, Shape({1, 2}, 3), {2, 4, 0, 0, -1, -3},
+      {0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0}},
+    {1, Shape({2}, 3), {3, 4, 0, 0, -1, -2},
+      {0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0}},
+    {2, Shape({2, 2}, 3), {1, 2, 3, 4, 0, 0, 0, 0, -1, -2, -3, -4},
+      vector<float>(12, 1)},
+  };
+  for (const TestCase &tc : test_cases) {
+    Max node(tc.dim);
+    const Shape cur_shape = node.forward_shape(arg_shapes);
+    const Tensor cur_value = node.forward(arg_values);
+    const Tensor cur_grad = functions::ones<Tensor>(tc.ret_shape, *dev);
+    reset_gradients();
+    node.backward(cur_value, cur_grad, arg_values, arg_grads);
+    EXPECT_EQ("Max(" + std::to_string(tc.dim) + ')', node.name());
+    EXPECT_EQ(tc.ret_shape, cur_shape);
+    EXPECT_EQ(nullptr, node.get_device());
+    EXPECT_TRUE(vector_match(tc.ret_data, cur_value.to_vector()));
+    EXPECT_TRUE(vector_match(tc.bw_grad, arg_grads[0]->to_vector()));
+  }
+}
+
+TEST_F(OperatorImplTest, CheckMin) {
+  // y = min(x, dim)
+  // dy/dx = 1 at the first minimum element, 0 otherwise
+  setup_1arg();
+  struct TestCase {
+    std::uint32_t dim;
+    Shape ret_shape;
+    vector<float> ret_data;
+    vector<float> bw_grad;
+  };
+  const vector<TestCase> test_cases {
+    {0, Shape({1, 2}, 3), {1, 3, 0, 0, -2, -4},
+      {1, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 1}},
+    {1, Shape({2}, 3), {1, 2, 0, 0, -3, -4},
+      {1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1}},
+    {2, Shape({2, 2}, 3), {1, 2, 3, 4, 0, 0, 0, 0, -1, -2, -3, -4},
+      vector<float>(12, 1)},
+  };
+  for (const TestCase &tc : test_cases) {
+    Min node(tc.dim);
+    const Shape cur_shape = node.forward_shape(arg_shapes);
+    const Tensor cur_value = node.forward(arg_values);
+    const Tensor cur_grad = functions::ones<Tensor>(tc.ret_shape, *dev);
+    reset_gradients();
+    node.backward(cur_value, cur_grad, arg_values, arg_grads);
+    EXPECT_EQ("Min(" + std::to_string(tc.dim) + ')', node.name());
+    EXPECT_EQ(tc.ret_shape, cur_shape);
+    EXPECT_EQ(nullptr, node.get_device());
+    EXPECT_TRUE(vector_match(tc.ret_data, cur_value.to_vector()));
+    EXPECT_TRUE(vector_match(tc.bw_grad, arg_grads[0]->to_vector()));
+  }
+}
+
+TEST_F(OperatorImplTest, CheckSquaredNorm) {
+  // y = sum(x * x, dim)
+  // dy/dx = 2 * x
+  setup_1arg();
+  struct TestCase {
+    std::uint32_t dim;
+    Shape ret_shape;
+    vector<float> ret_data;
+  };
+  const vector<TestCase> test_cases {
+    {0, Shape({1, 2}, 3), {5, 25, 0, 0, 5, 25}},
+    {1, Shape({2}, 3), {10, 20, 0, 0, 10, 20}},
+    {2, Shape({2, 2}, 3), {1, 4, 9, 16, 0, 0, 0, 0, 1, 4, 9, 16}},
+  };
+  const vector<float> bw_grad {2, 4, 6, 8, 0, 0, 0, 0, -2, -4, -6, -8};
+  for (const TestCase &tc : test_cases) {
+    SquaredNorm node(tc.dim);
+    const Shape cur_shape = node.forward_shape(arg_shapes);
+    const Tensor cur_value = node.forward(arg_values);
+    const Tensor cur_grad = functions::ones<Tensor>(tc.ret_shape, *dev);
+    reset_gradients();
+    node.backward(cur_value, cur_grad, arg_values, arg_grads);
+    EXPECT_EQ("SquaredNorm(" + std::to_string(tc.dim) + ')', node.name());
+    EXPECT_EQ(tc.ret_shape, cur_shape);
+    EXPECT_EQ(nullptr, node.get_device());
+    EXPECT_TRUE(vector_match(tc.ret_data, cur_value.to_vector()));
+    EXPECT_TRUE(vector_match(bw_grad, arg_grads[0]->to_vector()));
+  }
+}
+
 TEST_F(OperatorImplTest, CheckBroadcast) {
   // y = broadcast(x, dim, size)
   // dy/dx = sum(1, dim)
@@ -1468,5 +1656,31 @@ TEST_F(OperatorImplTest, CheckStopGradient) {
   TEST_1ARG(StopGradient);
 }
 
+TEST_F(OperatorImplTest, CheckDropout) {
+  // y = x * m / (1 - rate), m ~ Bernoulli(1 - rate)
+  // dy/dx = m / (1 - rate)
+  setup_1arg();
+  const Shape ret_shape({2, 2}, 3);
+  // Another device with the same seed generates the same mask.
+  devices::Naive dev2(12345);
+  const vector<float> mask = dev2.random_bernoulli(ret_shape, .5).to_vector();
+  const vector<float> x_data = arg_values[0]->to_vector();
+  vector<float> ret_data, bw_grad;
+  for (std::uint32_t i = 0; i < mask.size(); ++i) {
+    ret_data.emplace_back(2 * mask[i] * x_data[i]);
+    bw_grad.emplace_back(2 * mask[i]);
+  }
+  Dropout node(.5);
+  const Shape cur_shape = node.forward_shape(arg_shapes);
+  const Tensor cur_value = node.forward(arg_values);
+  const Tensor cur_grad = functions::ones<Tensor>(ret_shape, *dev);
+  node.backward(cur_value, cur_grad, arg_values, arg_grads);
+  EXPECT_EQ("Dropout(" + std::to_string(.5f) + ')', node.name());
+  EXPECT_EQ(ret_shape, cur_shape);
+  EXPECT_EQ(nullptr, node.get_device());
+  EXPECT_TRUE(vector_match(ret_data, cur_value.to_vector()));
+  EXPECT_TRUE(vector_match(bw_grad, arg_grads[0]->to_vector()));
+}
+
 }  // namespace operators
 }  // namespace primitiv
@@ -0,0 +1,86 @@
+#include <primitiv/config.h>
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/error.h>
+#include <primitiv/functions.h>
+#include <primitiv/graph.h>
+#include <primitiv/naive_device.h>
+#include <primitiv/packed_sequence.h>
+#include <primitiv/tensor.h>
+#include <test_utils.h>
+
+using std::vector;
+using test_utils::vector_match;
+
+namespace primitiv {
+
+class PackedSequenceTest : public testing::Test {
+protected:
+  devices::Naive dev;
+  Graph g;
+
+  void SetUp() override {
+    Device::set_default(dev);
+    Graph::set_default(g);
+  }
+};
+
+TEST_F(PackedSequenceTest, CheckInitialize) {
+  const PackedSequence seq({{1, 2}, {3, 4, 5, 6}, {7}, {8, 9, 10, 11}});
+  EXPECT_EQ(4u, seq.num_sequences());
+  EXPECT_EQ(4u, seq.max_length());
+  EXPECT_EQ(11u, seq.num_elements());
+  EXPECT_TRUE(vector_match(vector<std::uint32_t> {1, 3, 0, 2}, seq.order()));
+
+  const vector<vector<std::uint32_t>> expected {
+    {3, 8, 1, 7}, {4, 9, 2}, {5, 10}, {6, 11},
+  };
+  for (std::uint32_t t = 0; t < seq.max_length(); ++t) {
+    EXPECT_EQ(expected[t].size(), seq.batch_size(t));
+    EXPECT_TRUE(vector_match(expected[t], seq.step(t)));
+  }
+}
+
+TEST_F(PackedSequenceTest, CheckInvalidInitialize) {
+  EXPECT_THROW(PackedSequence({}), Error);
+  EXPECT_THROW(PackedSequence({{}, {}}), Error);
+}
+
+TEST_F(PackedSequenceTest, CheckInvalidStep) {
+  const PackedSequence seq({{1, 2}, {3}});
+  EXPECT_THROW(seq.step(2), Error);
+  EXPECT_THROW(seq.batch_size(2), Error);
+  EXPECT_THROW(seq.shrink(dev.new_tensor_by_constant(Shape({}, 2), 0), 2), Error);
+}
+
+TEST_F(PackedSequenceTest, CheckShrink) {
+  const PackedSequence seq({{1}, {2, 3, 4}, {5, 6}});
+  const Tensor x = dev.new_tensor_by_vector(Shape({2}, 3), {1, 2, 3, 4, 5, 6});
+
+  const Tensor y0 = seq.shrink(x, 0);
+  EXPECT_EQ(Shape({2}, 3), y0.shape());
+  EXPECT_TRUE(vector_match(x.to_vector(), y0.to_vector()));
+
+  const Tensor y1 = seq.shrink(x, 1);
+  EXPECT_EQ(Shape({2}, 2), y1.shape());
+  EXPECT_TRUE(vector_match(vector<float> {1, 2, 3, 4}, y1.to_vector()));
+
+  const Tensor y2 = seq.shrink(y1, 2);
+  EXPECT_EQ(Shape({2}), y2.shape());
+  EXPECT_TRUE(vector_match(vector<float> {1, 2}, y2.to_vector()));
+
+  // Variables already shrunk are not modified.
+  const Tensor y3 = seq.shrink(y2, 1);
+  EXPECT_EQ(Shape({2}), y3.shape());
+}
+
+TEST_F(PackedSequenceTest, CheckShrinkNode) {
+  const PackedSequence seq({{1, 2}, {3}});
+  const Node x = functions::input<Node>(Shape({2}, 2), {1, 2, 3, 4});
+  const Node y = seq.shrink(x, 1);
+  EXPECT_EQ(Shape({2}), y.shape());
+  EXPECT_TRUE(vector_match(vector<float> {1, 2}, y.to_vector()));
+}
+
+}  // namespace primitiv
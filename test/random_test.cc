@@ -1,5 +1,6 @@
 #include <primitiv/config.h>
 
+#include <cmath>
 #include <vector>
 #include <gtest/gtest.h>
 #include <primitiv/random.h>
@@ -7,6 +8,7 @@
 
 using std::vector;
 using test_utils::vector_match;
+using test_utils::vector_near;
 
 namespace primitiv {
 
@@ -31,6 +33,22 @@ TEST_F(DefaultRandomizerTest, CheckFillBernoulli) {
   EXPECT_TRUE(vector_match(expected, observed));
 }
 
+TEST_F(DefaultRandomizerTest, CheckFillBernoulliBits) {
+  for (const std::size_t size : {1, 31, 32, 33, 100}) {
+    DefaultRandomizer r1(12345), r2(12345);
+    vector<float> expected(size);
+    r1.fill_bernoulli(.3, size, expected.data());
+    vector<std::uint32_t> bits((size + 31) / 32, 0xffffffff);
+    r2.fill_bernoulli_bits(.3, size, bits.data());
+    vector<float> observed;
+    for (std::size_t i = 0; i < 32 * bits.size(); ++i) {
+      observed.emplace_back((bits[i / 32] >> (i % 32)) & 1);
+    }
+    expected.resize(observed.size(), 0);
+    EXPECT_TRUE(vector_match(expected, observed));
+  }
+}
+
 TEST_F(DefaultRandomizerTest, CheckFillUniform) {
   const vector<float> expected {
     7.7330894e+00, 7.0227852e+00, -3.3052402e+00, -6.6472688e+00,
@@ -87,4 +105,203 @@ TEST_F(DefaultRandomizerTest, CheckFillLogNormal) {
   EXPECT_TRUE(vector_match(expected, observed));
 }
 
+class PhiloxRandomizerTest : public testing::Test {
+protected:
+  PhiloxRandomizer randomizer_;
+
+  PhiloxRandomizerTest() : randomizer_(12345) {}
+
+  // Calculates mean and variance of the data.
+  static void moments(const vector<float> &data, float &mean, float &var) {
+    double s1 = 0, s2 = 0;
+    for (const float x : data) {
+      s1 += x;
+      s2 += x * x;
+    }
+    mean = s1 / data.size();
+    var = s2 / data.size() - mean * mean;
+  }
+};
+
+TEST_F(PhiloxRandomizerTest, CheckKnownAnswers) {
+  // Test vectors from the Random123 library.
+  struct TestCase {
+    std::uint32_t counter[4];
+    std::uint32_t key[2];
+    std::uint32_t expected[4];
+  };
+  const vector<TestCase> test_cases {
+    {{0, 0, 0, 0}, {0, 0},
+      {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+      {0xffffffff, 0xffffffff},
+      {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+      {0xa4093822, 0x299f31d0},
+      {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+  };
+  for (const TestCase &tc : test_cases) {
+    std::uint32_t observed[4];
+    PhiloxRandomizer::philox4x32(tc.counter, tc.key, observed);
+    EXPECT_TRUE(vector_match(
+          vector<std::uint32_t>(tc.expected, tc.expected + 4),
+          vector<std::uint32_t>(observed, observed + 4)));
+  }
+}
+
+TEST_F(PhiloxRandomizerTest, CheckOffset) {
+  EXPECT_EQ(0u, randomizer_.offset());
+  EXPECT_EQ(0u, randomizer_.reserve(5));
+  EXPECT_EQ(2u, randomizer_.offset());
+  vector<float> data(9);
+  randomizer_.fill_uniform(0, 1, data.size(), data.data());
+  EXPECT_EQ(5u, randomizer_.offset());
+  EXPECT_EQ(5u, randomizer_.reserve(0));
+  EXPECT_EQ(5u, randomizer_.offset());
+}
+
+TEST_F(PhiloxRandomizerTest, CheckReproducibility) {
+  const std::size_t size = 1001;
+  vector<float> expected(size);
+  randomizer_.fill_normal(1, 3, size, expected.data());
+
+  // Generating parts separately, e.g. in different threads, yields the same
+  // sequence regardless of the number of parts.
+  for (const std::size_t num_parts : {1, 2, 3, 7, 64}) {
+    vector<float> observed(size, -1e10);
+    const std::size_t step = (size + num_parts - 1) / num_parts;
+    for (std::size_t begin = 0; begin < size; begin += step) {
+      randomizer_.generate_normal(
+          1, 3, 0, begin, std::min(begin + step, size), observed.data());
+    }
+    EXPECT_TRUE(vector_match(expected, observed));
+  }
+
+  PhiloxRandomizer other(12345);
+  vector<float> observed(size);
+  other.fill_normal(1, 3, size, observed.data());
+  EXPECT_TRUE(vector_match(expected, observed));
+}
+
+TEST_F(PhiloxRandomizerTest, CheckStreams) {
+  const std::size_t size = 16;
+  vector<float> a(size), b(size), c(size);
+  PhiloxRandomizer(12345, 0).fill_uniform(0, 1, size, a.data());
+  PhiloxRandomizer(12345, 1).fill_uniform(0, 1, size, b.data());
+  PhiloxRandomizer(12346, 0).fill_uniform(0, 1, size, c.data());
+  for (std::size_t i = 0; i < size; ++i) {
+    EXPECT_NE(a[i], b[i]);
+    EXPECT_NE(a[i], c[i]);
+  }
+}
+
+TEST_F(PhiloxRandomizerTest, CheckFillBernoulli) {
+  const std::size_t size = 100000;
+  vector<float> observed(size, -1e10);
+  randomizer_.fill_bernoulli(.3, size, observed.data());
+  for (const float x : observed) EXPECT_TRUE(x == 0 || x == 1);
+  float mean, var;
+  moments(observed, mean, var);
+  EXPECT_NEAR(.3, mean, .01);
+}
+
+TEST_F(PhiloxRandomizerTest, CheckFillBernoulliBits) {
+  for (const std::size_t size : {1, 31, 32, 33, 100, 1000, 3000}) {
+    PhiloxRandomizer r1(12345), r2(12345);
+    vector<float> expected(size);
+    r1.fill_bernoulli(.3, size, expected.data());
+    vector<std::uint32_t> bits((size + 31) / 32, 0xffffffff);
+    r2.fill_bernoulli_bits(.3, size, bits.data());
+    EXPECT_EQ(r1.offset(), r2.offset());
+    vector<float> observed;
+    for (std::size_t i = 0; i < 32 * bits.size(); ++i) {
+      observed.emplace_back((bits[i / 32] >> (i % 32)) & 1);
+    }
+    expected.resize(observed.size(), 0);
+    EXPECT_TRUE(vector_match(expected, observed));
+  }
+}
+
+TEST_F(PhiloxRandomizerTest, CheckFillUniform) {
+  const std::size_t size = 100000;
+  vector<float> observed(size, -1e10);
+  randomizer_.fill_uniform(-9, 9, size, observed.data());
+  for (const float x : observed) {
+    EXPECT_LT(-9, x);
+    EXPECT_GE(9, x);
+  }
+  float mean, var;
+  moments(observed, mean, var);
+  EXPECT_NEAR(0, mean, .1);
+  EXPECT_NEAR(27, var, .5);
+}
+
+TEST_F(PhiloxRandomizerTest, CheckFillNormal) {
+  const std::size_t size = 100000;
+  vector<float> observed(size, -1e10);
+  randomizer_.fill_normal(1, 3, size, observed.data());
+  float mean, var;
+  moments(observed, mean, var);
+  EXPECT_NEAR(1, mean, .05);
+  EXPECT_NEAR(9, var, .2);
+}
+
+TEST_F(PhiloxRandomizerTest, CheckFillLogNormal) {
+  const std::size_t size = 100000;
+  vector<float> observed(size, -1e10);
+  randomizer_.fill_log_normal(1, .5, size, observed.data());
+  for (float &x : observed) {
+    ASSERT_LT(0, x);
+    x = std::log(x);
+  }
+  float mean, var;
+  moments(observed, mean, var);
+  EXPECT_NEAR(1, mean, .01);
+  EXPECT_NEAR(.25, var, .01);
+}
+
+TEST_F(PhiloxRandomizerTest, CheckTransformAccuracy) {
+  // Reference implementation of the Box-Muller transform using the standard
+  // library.
+  const std::size_t size = 4096;
+  const float mean = 1, sd = 3;
+  vector<float> expected(size);
+  const std::uint32_t key[2] { 12345, 0 };
+  for (std::size_t b = 0; b < size / 4; ++b) {
+    const std::uint32_t counter[4] { static_cast<std::uint32_t>(b), 0, 0, 0 };
+    std::uint32_t r[4];
+    PhiloxRandomizer::philox4x32(counter, key, r);
+    for (std::size_t j = 0; j < 4; j += 2) {
+      const double u1 = ((r[j] >> 8) + 1) / 16777216.;
+      const double u2 = (r[j + 1] >> 8) / 16777216.;
+      const double rad = sd * std::sqrt(-2 * std::log(u1));
+      const double theta = 2 * std::acos(-1.) * u2;
+      expected[4 * b + j] = mean + rad * std::cos(theta);
+      expected[4 * b + j + 1] = mean + rad * std::sin(theta);
+    }
+  }
+
+  vector<float> observed(size);
+  randomizer_.fill_normal(mean, sd, size, observed.data());
+  EXPECT_TRUE(vector_near(expected, observed, 1e-5));
+
+  // Log-normal values are exponentials of the same normal values.
+  vector<float> observed_ln(size);
+  PhiloxRandomizer(12345).fill_log_normal(
+      mean, sd, size, observed_ln.data());
+  for (std::size_t i = 0; i < size; ++i) {
+    const float y = std::exp(observed[i]);
+    EXPECT_NEAR(y, observed_ln[i], 1e-6 * y);
+  }
+}
+
+TEST_F(PhiloxRandomizerTest, CheckLogNormalRange) {
+  const std::size_t size = 1000;
+  vector<float> observed(size);
+  randomizer_.fill_log_normal(-200, 1, size, observed.data());
+  for (const float x : observed) EXPECT_EQ(0, x);
+  randomizer_.fill_log_normal(200, 1, size, observed.data());
+  for (const float x : observed) EXPECT_TRUE(std::isinf(x));
+}
+
 }  // namespace primitiv
@@ -280,6 +280,43 @@ TEST_F(ShapeOpsTest, CheckInvalidPick) {
   }
 }
 
+TEST_F(ShapeOpsTest, CheckBatchPick) {
+  EXPECT_EQ(Shape({2, 2}), batch_pick(Shape({2, 2}, 3), {1}));
+  EXPECT_EQ(Shape({2, 2}, 3), batch_pick(Shape({2, 2}, 3), {2, 0, 1}));
+  EXPECT_EQ(Shape({2, 2}, 5), batch_pick(Shape({2, 2}, 3), {0, 0, 1, 1, 2}));
+  EXPECT_EQ(Shape({}, 2), batch_pick({}, {0, 0}));
+}
+
+TEST_F(ShapeOpsTest, CheckInvalidBatchPick) {
+  EXPECT_THROW(batch_pick(Shape({2, 2}, 3), {}), Error);
+  EXPECT_THROW(batch_pick(Shape({2, 2}, 3), {3}), Error);
+  EXPECT_THROW(batch_pick(Shape({2, 2}, 3), {0, 1, 2, 3}), Error);
+  EXPECT_THROW(batch_pick({2, 2}, {1}), Error);
+}
+
+TEST_F(ShapeOpsTest, CheckBatchSlice) {
+  EXPECT_EQ(Shape({2, 2}), batch_slice(Shape({2, 2}, 3), 0, 1));
+  EXPECT_EQ(Shape({2, 2}, 2), batch_slice(Shape({2, 2}, 3), 1, 3));
+  EXPECT_EQ(Shape({2, 2}, 3), batch_slice(Shape({2, 2}, 3), 0, 3));
+  EXPECT_EQ(Shape(), batch_slice({}, 0, 1));
+}
+
+TEST_F(ShapeOpsTest, CheckInvalidBatchSlice) {
+  EXPECT_THROW(batch_slice(Shape({2, 2}, 3), 0, 0), Error);
+  EXPECT_THROW(batch_slice(Shape({2, 2}, 3), 2, 1), Error);
+  EXPECT_THROW(batch_slice(Shape({2, 2}, 3), 0, 4), Error);
+  EXPECT_THROW(batch_slice({2, 2}, 1, 2), Error);
+}
+
+TEST_F(ShapeOpsTest, CheckBatchConcat) {
+  const Shape a({2, 2}), b({2, 2}, 3), c({2, 3});
+  EXPECT_EQ(Shape({2, 2}), batch_concat({&a}));
+  EXPECT_EQ(Shape({2, 2}, 4), batch_concat({&a, &b}));
+  EXPECT_EQ(Shape({2, 2}, 7), batch_concat({&b, &a, &b}));
+  EXPECT_THROW(batch_concat({}), Error);
+  EXPECT_THROW(batch_concat({&a, &c}), Error);
+}
+
 TEST_F(ShapeOpsTest, CheckTranspose) {
   EXPECT_EQ(Shape(), transpose({}));
   EXPECT_EQ(Shape({}, 5), transpose(Shape({}, 5)));
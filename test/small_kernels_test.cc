@@ -0,0 +1,50 @@
+#include <primitiv/config.h>
+
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include <primitiv/small_kernels.h>
+
+using std::vector;
+
+namespace primitiv {
+namespace small_kernels {
+
+class SmallKernelsTest : public testing::Test {};
+
+TEST_F(SmallKernelsTest, CheckMatmul) {
+  for (std::uint32_t m = 1; m <= MAX_MATMUL_ROWS; m <<= 1) {
+    for (std::uint32_t n = 1; n <= MAX_MATMUL_COLS; ++n) {
+      for (std::uint32_t k : {1u, 3u, 16u, 77u}) {
+        vector<float> a(m * k), b(k * n);
+        for (std::uint32_t i = 0; i < m * k; ++i) a[i] = i % 7 - 3;
+        for (std::uint32_t i = 0; i < k * n; ++i) b[i] = i % 5 - 2;
+        vector<float> expected(m * n, 0);
+        for (std::uint32_t i = 0; i < m; ++i) {
+          for (std::uint32_t j = 0; j < k; ++j) {
+            for (std::uint32_t l = 0; l < n; ++l) {
+              expected[i + l * m] += a[i + j * m] * b[j + l * k];
+            }
+          }
+        }
+        const MatmulKernel kernel = get_matmul_kernel(m, n);
+        ASSERT_NE(nullptr, kernel);
+        vector<float> y(m * n, -1);
+        kernel(a.data(), b.data(), y.data(), k);
+        EXPECT_EQ(expected, y) << "m=" << m << ", n=" << n << ", k=" << k;
+      }
+    }
+  }
+}
+
+TEST_F(SmallKernelsTest, CheckOutOfBounds) {
+  EXPECT_EQ(nullptr, get_matmul_kernel(0, 1));
+  EXPECT_EQ(nullptr, get_matmul_kernel(1, 0));
+  EXPECT_EQ(nullptr, get_matmul_kernel(3, 1));
+  EXPECT_EQ(nullptr, get_matmul_kernel(6, 1));
+  EXPECT_EQ(nullptr, get_matmul_kernel(MAX_MATMUL_ROWS + 1, 1));
+  EXPECT_EQ(nullptr, get_matmul_kernel(1, MAX_MATMUL_COLS + 1));
+}
+
+}  // namespace small_kernels
+}  // namespace primitiv
@@ -1,5 +1,7 @@
 #include <primitiv/config.h>
 
+#include <cstdlib>
+#include <limits>
 #include <string>
 #include <vector>
 #include <gtest/gtest.h>
@@ -28,5 +30,29 @@ TEST_F(StringUtilsTest, CheckJoin) {
   EXPECT_EQ("fooxxxbarxxxbaz", join(vector<string> {"foo", "bar", "baz"}, "xxx"));
 }
 
+TEST_F(StringUtilsTest, CheckToCppLiteral) {
+  EXPECT_EQ("0.f", to_cpp_literal(0));
+  EXPECT_EQ("-0.f", to_cpp_literal(-0.f));
+  EXPECT_EQ("1.f", to_cpp_literal(1));
+  EXPECT_EQ("-42.f", to_cpp_literal(-42));
+  EXPECT_EQ("0.5f", to_cpp_literal(.5));
+  EXPECT_EQ("1e+10f", to_cpp_literal(1e10));
+  EXPECT_EQ("0.00999999978f", to_cpp_literal(.01));
+  EXPECT_EQ(
+      "std::numeric_limits<float>::infinity()",
+      to_cpp_literal(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(
+      "-std::numeric_limits<float>::infinity()",
+      to_cpp_literal(-std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(
+      "std::numeric_limits<float>::quiet_NaN()",
+      to_cpp_literal(std::numeric_limits<float>::quiet_NaN()));
+
+  // Literals restore the same values.
+  for (const float x : {1.f / 3, 3.14159265f, -1e-30f, 1e-45f, 3.4e38f}) {
+    EXPECT_EQ(x, std::strtof(to_cpp_literal(x).c_str(), nullptr));
+  }
+}
+
 }  // namespace string_utils
 }  // namespace primitiv
@@ -242,6 +242,108 @@ TEST_F(TensorBackwardTest, CheckPickNN) {
   }
 }
 
+TEST_F(TensorBackwardTest, CheckBatchPick) {
+  const vector<float> a_data {0, 1, 2, 3, 4, 5};
+  struct TestCase {
+    vector<std::uint32_t> ids;
+    vector<float> b_data;
+    vector<float> y_data;
+  };
+  const vector<TestCase> test_cases {
+    {{1}, {1, 1}, {0, 1, 3, 4, 4, 5}},
+    {{2, 0}, {1, 2, 3, 4}, {3, 5, 2, 3, 5, 7}},
+    {{1, 1, 1}, {1, 1, 2, 2, 3, 3}, {0, 1, 8, 9, 4, 5}},
+    {{0, 2, 0, 2}, {1, 1, 2, 2, 3, 3, 4, 4}, {4, 5, 2, 3, 10, 11}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      Tensor a = dev->new_tensor_by_vector(Shape({2}, 3), a_data);
+      const Tensor b = dev->new_tensor_by_vector(
+          Shape({2}, tc.ids.size()), tc.b_data);
+      dev->batch_pick_bw(b, tc.ids, a);
+      EXPECT_TRUE(vector_match(tc.y_data, a.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckInvalidBatchPick) {
+  for (Device *dev : devices) {
+    Tensor a = dev->new_tensor_by_constant(Shape({2}, 3), 0);
+    const Tensor b1 = dev->new_tensor_by_constant(Shape({2}, 2), 0);
+    const Tensor b2 = dev->new_tensor_by_constant(Shape({3}, 2), 0);
+    EXPECT_THROW(dev->batch_pick_bw(b1, {}, a), Error);
+    EXPECT_THROW(dev->batch_pick_bw(b1, {0, 3}, a), Error);
+    EXPECT_THROW(dev->batch_pick_bw(b1, {0, 1, 2}, a), Error);
+    EXPECT_THROW(dev->batch_pick_bw(b2, {0, 1}, a), Error);
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckBatchSlice) {
+  const vector<float> a_data {0, 1, 2, 3, 4, 5};
+  struct TestCase {
+    std::uint32_t offset;
+    Shape b_shape;
+    vector<float> b_data;
+    vector<float> y_data;
+  };
+  const vector<TestCase> test_cases {
+    {0, {2}, {1, 1}, {1, 2, 2, 3, 4, 5}},
+    {2, {2}, {1, 1}, {0, 1, 2, 3, 5, 6}},
+    {1, Shape({2}, 2), {1, 2, 3, 4}, {0, 1, 3, 5, 7, 9}},
+    {0, Shape({2}, 3), {1, 1, 2, 2, 3, 3}, {1, 2, 4, 5, 7, 8}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      Tensor a = dev->new_tensor_by_vector(Shape({2}, 3), a_data);
+      const Tensor b = dev->new_tensor_by_vector(tc.b_shape, tc.b_data);
+      dev->batch_slice_bw(b, tc.offset, a);
+      EXPECT_TRUE(vector_match(tc.y_data, a.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckDropout) {
+  const Shape shape({7, 11}, 3);
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(shape, 1);
+    Tensor mask;
+    const Tensor y = dev->dropout_fw(x, .25, mask);
+    EXPECT_EQ(Shape({(shape.size() + 31) / 32}), mask.shape());
+    Tensor gx = dev->new_tensor_by_constant(shape, 1);
+    const Tensor gy = dev->new_tensor_by_constant(shape, 3);
+    dev->dropout_bw(gy, mask, .25, gx);
+    // gx = 1 + 3 * y
+    const vector<float> y_data = y.to_vector();
+    vector<float> expected;
+    for (const float y : y_data) expected.emplace_back(1 + 3 * y);
+    EXPECT_TRUE(vector_match(expected, gx.to_vector()));
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckInvalidDropout) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(Shape({2, 2}, 2), 1);
+    Tensor mask;
+    dev->dropout_fw(x, .5, mask);
+    Tensor gx1 = dev->new_tensor_by_constant(Shape({2, 2}, 2), 0);
+    Tensor gx2 = dev->new_tensor_by_constant(Shape({2, 2}, 40), 0);
+    const Tensor gy2 = dev->new_tensor_by_constant(Shape({2, 2}, 40), 0);
+    EXPECT_THROW(dev->dropout_bw(x, mask, 1, gx1), Error);
+    EXPECT_THROW(dev->dropout_bw(gy2, mask, .5, gx1), Error);
+    EXPECT_THROW(dev->dropout_bw(gy2, mask, .5, gx2), Error);
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckInvalidBatchSlice) {
+  for (Device *dev : devices) {
+    Tensor a = dev->new_tensor_by_constant(Shape({2}, 3), 0);
+    const Tensor b1 = dev->new_tensor_by_constant(Shape({2}, 2), 0);
+    const Tensor b2 = dev->new_tensor_by_constant({3}, 0);
+    EXPECT_THROW(dev->batch_slice_bw(b1, 2, a), Error);
+    EXPECT_THROW(dev->batch_slice_bw(b2, 0, a), Error);
+  }
+}
+
 TEST_F(TensorBackwardTest, CheckPickN1) {
   const vector<float> a_data {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
   struct TestCase {
@@ -1148,4 +1250,109 @@ TEST_F(TensorBackwardTest, CheckMatMulN1) {
   }
 }
 
+TEST_F(TensorBackwardTest, CheckMax) {
+  struct TestCase {
+    std::uint32_t dim;
+    vector<float> gx_val;
+  };
+  const vector<TestCase> test_cases {
+    {0, {0, 1, 2, 0, 3, 0, 0, 4}},
+    {1, {0, 2, 1, 0, 3, 0, 0, 4}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      // NOTE: Ties are resolved to the first element, same as argmax().
+      const Tensor x = dev->new_tensor_by_vector(
+          Shape({2, 2}, 2), {1, 3, 3, 3, 0, -1, -1, 0});
+      const Tensor y = dev->max_fw(x, tc.dim);
+      const Tensor gy = dev->new_tensor_by_vector(y.shape(), {1, 2, 3, 4});
+      Tensor gx = dev->new_tensor_by_constant(x.shape(), 0);
+      dev->max_bw(x, y, gy, tc.dim, gx);
+      EXPECT_TRUE(vector_match(tc.gx_val, gx.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckMaxInf) {
+  struct TestCase {
+    std::uint32_t dim;
+    vector<float> gx_val;
+  };
+  const vector<TestCase> test_cases {
+    {0, {1, 0, 2, 0, 3, 0, 4, 0}},
+    {1, {0, 2, 1, 0, 3, 4, 0, 0}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      const Tensor x = dev->new_tensor_by_vector(
+          Shape({2, 2}, 2),
+          {-INFINITY, -INFINITY, 1, -INFINITY,
+           -INFINITY, -INFINITY, -INFINITY, -INFINITY});
+      const Tensor y = dev->max_fw(x, tc.dim);
+      const Tensor gy = dev->new_tensor_by_vector(y.shape(), {1, 2, 3, 4});
+      Tensor gx = dev->new_tensor_by_constant(x.shape(), 0);
+      dev->max_bw(x, y, gy, tc.dim, gx);
+      EXPECT_TRUE(vector_match(tc.gx_val, gx.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckMin) {
+  struct TestCase {
+    std::uint32_t dim;
+    vector<float> gx_val;
+  };
+  const vector<TestCase> test_cases {
+    {0, {1, 0, 2, 0, 0, 3, 4, 0}},
+    {1, {1, 0, 0, 2, 0, 4, 3, 0}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      const Tensor x = dev->new_tensor_by_vector(
+          Shape({2, 2}, 2), {1, 3, 1, 2, 0, -1, -1, 0});
+      const Tensor y = dev->min_fw(x, tc.dim);
+      const Tensor gy = dev->new_tensor_by_vector(y.shape(), {1, 2, 3, 4});
+      Tensor gx = dev->new_tensor_by_constant(x.shape(), 0);
+      dev->min_bw(x, y, gy, tc.dim, gx);
+      EXPECT_TRUE(vector_match(tc.gx_val, gx.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckMinInf) {
+  struct TestCase {
+    std::uint32_t dim;
+    vector<float> gx_val;
+  };
+  const vector<TestCase> test_cases {
+    {0, {1, 0, 2, 0, 3, 0, 4, 0}},
+    {1, {0, 2, 1, 0, 3, 4, 0, 0}},
+  };
+  for (Device *dev : devices) {
+    for (const TestCase &tc : test_cases) {
+      const Tensor x = dev->new_tensor_by_vector(
+          Shape({2, 2}, 2),
+          {INFINITY, INFINITY, -1, INFINITY,
+           INFINITY, INFINITY, INFINITY, INFINITY});
+      const Tensor y = dev->min_fw(x, tc.dim);
+      const Tensor gy = dev->new_tensor_by_vector(y.shape(), {1, 2, 3, 4});
+      Tensor gx = dev->new_tensor_by_constant(x.shape(), 0);
+      dev->min_bw(x, y, gy, tc.dim, gx);
+      EXPECT_TRUE(vector_match(tc.gx_val, gx.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorBackwardTest, CheckInvalidMax) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(Shape({2, 2}, 2), 0);
+    const Tensor y = dev->max_fw(x, 0);
+    Tensor gx = dev->new_tensor_by_constant(x.shape(), 0);
+    EXPECT_THROW(dev->max_bw(x, y, y, 1, gx), Error);
+    EXPECT_THROW(dev->max_bw(x, x, x, 0, gx), Error);
+    Tensor gx2 = dev->new_tensor_by_constant({2, 2}, 0);
+    EXPECT_THROW(dev->max_bw(x, y, y, 0, gx2), Error);
+  }
+}
+
 }  // namespace primitiv
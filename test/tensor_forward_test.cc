@@ -1708,6 +1708,34 @@ TEST_F(TensorForwardTest, CheckSoftplus) {
   }
 }
 
+TEST_F(TensorForwardTest, CheckFastMathMode) {
+  vector<float> x_data, pos_data;
+  vector<vector<float>> y_data(5);
+  for (int i = -200; i <= 200; ++i) {
+    const double x = static_cast<float>(i / 10.);
+    const double pos = static_cast<float>((i + 201) / 10.);
+    x_data.emplace_back(x);
+    pos_data.emplace_back(pos);
+    y_data[0].emplace_back(std::exp(x));
+    y_data[1].emplace_back(std::log(pos));
+    y_data[2].emplace_back(std::tanh(x));
+    y_data[3].emplace_back(1. / (1. + std::exp(-x)));
+    y_data[4].emplace_back(std::log1p(std::exp(x)));
+  }
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({401}), x_data);
+    const Tensor pos = dev->new_tensor_by_vector(Shape({401}), pos_data);
+    dev->set_math_mode(Device::MathMode::FAST);
+    const vector<Tensor> ys {
+      exp(x), log(pos), tanh(x), sigmoid(x), softplus(x),
+    };
+    dev->set_math_mode(Device::MathMode::PRECISE);
+    for (std::uint32_t i = 0; i < ys.size(); ++i) {
+      EXPECT_TRUE(vector_match_ulps(y_data[i], ys[i].to_vector(), 4));
+    }
+  }
+}
+
 TEST_F(TensorForwardTest, CheckSin) {
   const vector<float> x_data {
     0, .5, 1, 2, 3, 4,
@@ -1922,6 +1950,204 @@ TEST_F(TensorForwardTest, CheckLogSumExp2) {
   }
 }
 
+TEST_F(TensorForwardTest, CheckMax) {
+  const vector<float> x_data {
+    1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8,
+  };
+  const vector<Shape> shape {
+    Shape({1, 2, 2}, 2),
+    Shape({2, 1, 2}, 2),
+    Shape({2, 2}, 2),
+    Shape({2, 2, 2}, 2),
+  };
+  const vector<vector<float>> y_data {
+    {2, 4, 6, 8, -1, -3, -5, -7},
+    {3, 4, 7, 8, -1, -2, -5, -6},
+    {5, 6, 7, 8, -1, -2, -3, -4},
+    {1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2, 2}, 2), x_data);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+      const Tensor y = max(x, i);
+      EXPECT_EQ(shape[i], y.shape());
+      EXPECT_TRUE(vector_match(y_data[i], y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMax2) {
+  const vector<std::uint32_t> ns {
+    1, 2, 3, 15, 16, 17, 255, 256, 257, 1023, 1024, 1025, 65535, 65536, 65537,
+  };
+  for (Device *dev : devices) {
+    for (const std::uint32_t n : ns) {
+      vector<float> x_data(n);
+      for (std::uint32_t i = 0; i < n; ++i) x_data[i] = (i + n / 2) % n;
+      const Tensor x = dev->new_tensor_by_vector({n}, x_data);
+      const Tensor y = max(x, 0);
+      EXPECT_EQ(Shape(), y.shape());
+      EXPECT_TRUE(vector_match(vector<float>(1, n - 1), y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMaxInf) {
+  const vector<float> x_data {
+    -INFINITY, -INFINITY, 1, -INFINITY,
+    -INFINITY, -INFINITY, -INFINITY, -INFINITY,
+  };
+  const vector<vector<float>> y_data {
+    {-INFINITY, 1, -INFINITY, -INFINITY},
+    {1, -INFINITY, -INFINITY, -INFINITY},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2}, 2), x_data);
+    for (std::uint32_t i = 0; i < 2; ++i) {
+      const Tensor y = max(x, i);
+      EXPECT_TRUE(vector_match(y_data[i], y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMin) {
+  const vector<float> x_data {
+    1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8,
+  };
+  const vector<Shape> shape {
+    Shape({1, 2, 2}, 2),
+    Shape({2, 1, 2}, 2),
+    Shape({2, 2}, 2),
+    Shape({2, 2, 2}, 2),
+  };
+  const vector<vector<float>> y_data {
+    {1, 3, 5, 7, -2, -4, -6, -8},
+    {1, 2, 5, 6, -3, -4, -7, -8},
+    {1, 2, 3, 4, -5, -6, -7, -8},
+    {1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2, 2}, 2), x_data);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+      const Tensor y = min(x, i);
+      EXPECT_EQ(shape[i], y.shape());
+      EXPECT_TRUE(vector_match(y_data[i], y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMin2) {
+  const vector<std::uint32_t> ns {
+    1, 2, 3, 15, 16, 17, 255, 256, 257, 1023, 1024, 1025, 65535, 65536, 65537,
+  };
+  for (Device *dev : devices) {
+    for (const std::uint32_t n : ns) {
+      vector<float> x_data(n);
+      for (std::uint32_t i = 0; i < n; ++i) x_data[i] = (i + n / 2) % n;
+      const Tensor x = dev->new_tensor_by_vector({n}, x_data);
+      const Tensor y = min(x, 0);
+      EXPECT_EQ(Shape(), y.shape());
+      EXPECT_TRUE(vector_match(vector<float>(1, 0), y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMinInf) {
+  const vector<float> x_data {
+    INFINITY, INFINITY, -1, INFINITY,
+    INFINITY, INFINITY, INFINITY, INFINITY,
+  };
+  const vector<vector<float>> y_data {
+    {INFINITY, -1, INFINITY, INFINITY},
+    {-1, INFINITY, INFINITY, INFINITY},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2}, 2), x_data);
+    for (std::uint32_t i = 0; i < 2; ++i) {
+      const Tensor y = min(x, i);
+      EXPECT_TRUE(vector_match(y_data[i], y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckSquaredNorm) {
+  const vector<float> x_data {
+    1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8,
+  };
+  const vector<Shape> shape {
+    Shape({1, 2, 2}, 2),
+    Shape({2, 1, 2}, 2),
+    Shape({2, 2}, 2),
+    Shape({2, 2, 2}, 2),
+  };
+  const vector<vector<float>> y_data {
+    {5, 25, 61, 113, 5, 25, 61, 113},
+    {10, 20, 74, 100, 10, 20, 74, 100},
+    {26, 40, 58, 80, 26, 40, 58, 80},
+    {1, 4, 9, 16, 25, 36, 49, 64, 1, 4, 9, 16, 25, 36, 49, 64},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2, 2}, 2), x_data);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+      const Tensor y = squared_norm(x, i);
+      EXPECT_EQ(shape[i], y.shape());
+      EXPECT_TRUE(vector_match(y_data[i], y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckMultiAxisReductions) {
+  const vector<float> x_data {
+    1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8,
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2, 2}, 2), x_data);
+    {
+      const Tensor y = sum(x, {0, 1});
+      EXPECT_EQ(Shape({1, 1, 2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(vector<float> {10, 26, -10, -26}, y.to_vector()));
+    }
+    {
+      const Tensor y = sum(x, {2, 0});
+      EXPECT_EQ(Shape({1, 2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(vector<float> {14, 22, -14, -22}, y.to_vector()));
+    }
+    {
+      const Tensor y = sum(x, {0, 1, 2, 5});
+      EXPECT_EQ(Shape({}, 2), y.shape());
+      EXPECT_TRUE(vector_match(vector<float> {36, -36}, y.to_vector()));
+    }
+    {
+      const Tensor y = mean(x, {0, 1});
+      EXPECT_EQ(Shape({1, 1, 2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(
+            vector<float> {2.5, 6.5, -2.5, -6.5}, y.to_vector()));
+    }
+    {
+      const Tensor y = max(x, {0, 2});
+      EXPECT_EQ(Shape({1, 2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(vector<float> {6, 8, -1, -3}, y.to_vector()));
+    }
+    {
+      const Tensor y = min(x, {1, 2});
+      EXPECT_EQ(Shape({2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(vector<float> {1, 2, -7, -8}, y.to_vector()));
+    }
+    {
+      const Tensor y = squared_norm(x, {0, 2});
+      EXPECT_EQ(Shape({1, 2}, 2), y.shape());
+      EXPECT_TRUE(vector_match(
+            vector<float> {66, 138, 66, 138}, y.to_vector()));
+    }
+    {
+      const Tensor y = max(x, {3});
+      EXPECT_EQ(x.shape(), y.shape());
+      EXPECT_TRUE(vector_match(x_data, y.to_vector()));
+    }
+    EXPECT_THROW(sum(x, vector<std::uint32_t> {}), Error);
+  }
+}
+
 TEST_F(TensorForwardTest, CheckLogSoftmax) {
   const vector<float> x_data {
     1, 2, 3, 4, 5, 6, 7, 8, -1, -2, -3, -4, -5, -6, -7, -8,
@@ -2117,6 +2343,118 @@ TEST_F(TensorForwardTest, CheckBatchSum) {
   }
 }
 
+TEST_F(TensorForwardTest, CheckBatchPick) {
+  const vector<float> x_data {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  struct TestCase {
+    vector<std::uint32_t> ids;
+    Shape y_shape;
+    vector<float> y_data;
+  };
+  const vector<TestCase> test_cases {
+    {{0}, {2, 2}, {1, 2, 3, 4}},
+    {{2}, {2, 2}, {9, 10, 11, 12}},
+    {{2, 0, 1}, Shape({2, 2}, 3), {9, 10, 11, 12, 1, 2, 3, 4, 5, 6, 7, 8}},
+    {{1, 1}, Shape({2, 2}, 2), {5, 6, 7, 8, 5, 6, 7, 8}},
+    {{0, 0, 2, 2, 1}, Shape({2, 2}, 5),
+      {1, 2, 3, 4, 1, 2, 3, 4, 9, 10, 11, 12, 9, 10, 11, 12, 5, 6, 7, 8}},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2}, 3), x_data);
+    for (const TestCase &tc : test_cases) {
+      const Tensor y = batch::pick(x, tc.ids);
+      EXPECT_EQ(tc.y_shape, y.shape());
+      EXPECT_TRUE(vector_match(tc.y_data, y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckInvalidBatchPick) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(Shape({2, 2}, 3), 0);
+    EXPECT_THROW(batch::pick(x, {}), Error);
+    EXPECT_THROW(batch::pick(x, {3}), Error);
+    EXPECT_THROW(batch::pick(x, {0, 1, 2, 3}), Error);
+  }
+}
+
+TEST_F(TensorForwardTest, CheckBatchSlice) {
+  const vector<float> x_data {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  struct TestCase {
+    std::uint32_t lower, upper;
+    Shape y_shape;
+    vector<float> y_data;
+  };
+  const vector<TestCase> test_cases {
+    {0, 1, {2, 2}, {1, 2, 3, 4}},
+    {2, 3, {2, 2}, {9, 10, 11, 12}},
+    {1, 3, Shape({2, 2}, 2), {5, 6, 7, 8, 9, 10, 11, 12}},
+    {0, 3, Shape({2, 2}, 3), x_data},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({2, 2}, 3), x_data);
+    for (const TestCase &tc : test_cases) {
+      const Tensor y = batch::slice(x, tc.lower, tc.upper);
+      EXPECT_EQ(tc.y_shape, y.shape());
+      EXPECT_TRUE(vector_match(tc.y_data, y.to_vector()));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckBatchSliceIsolation) {
+  // Updating either the source or the slice never affects the other even if
+  // they share the memory.
+  for (Device *dev : devices) {
+    Tensor x = dev->new_tensor_by_vector(Shape({2}, 3), {1, 2, 3, 4, 5, 6});
+    Tensor y = batch::slice(x, 1, 3);
+    x.inplace_multiply_const(2);
+    EXPECT_TRUE(vector_match(vector<float> {3, 4, 5, 6}, y.to_vector()));
+    y.inplace_multiply_const(-1);
+    EXPECT_TRUE(vector_match(vector<float> {-3, -4, -5, -6}, y.to_vector()));
+    EXPECT_TRUE(vector_match(
+          vector<float> {2, 4, 6, 8, 10, 12}, x.to_vector()));
+  }
+}
+
+TEST_F(TensorForwardTest, CheckInvalidBatchSlice) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(Shape({2, 2}, 3), 0);
+    EXPECT_THROW(batch::slice(x, 0, 0), Error);
+    EXPECT_THROW(batch::slice(x, 2, 1), Error);
+    EXPECT_THROW(batch::slice(x, 0, 4), Error);
+    EXPECT_THROW(batch::slice(x, 3, 4), Error);
+  }
+}
+
+TEST_F(TensorForwardTest, CheckBatchConcat) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({2, 2}, {1, 2, 3, 4});
+    const Tensor b = dev->new_tensor_by_vector(
+        Shape({2, 2}, 2), {5, 6, 7, 8, 9, 10, 11, 12});
+    const Tensor c = dev->new_tensor_by_vector({2, 2}, {13, 14, 15, 16});
+    const Tensor y1 = batch::concat({a, b, c});
+    EXPECT_EQ(Shape({2, 2}, 4), y1.shape());
+    vector<float> y1_data(16);
+    iota(y1_data.begin(), y1_data.end(), 1);
+    EXPECT_TRUE(vector_match(y1_data, y1.to_vector()));
+    const Tensor y2 = batch::concat({&c, &a});
+    EXPECT_EQ(Shape({2, 2}, 2), y2.shape());
+    EXPECT_TRUE(vector_match(
+          vector<float> {13, 14, 15, 16, 1, 2, 3, 4}, y2.to_vector()));
+    const Tensor y3 = batch::concat(vector<Tensor> {b});
+    EXPECT_EQ(b.shape(), y3.shape());
+    EXPECT_TRUE(vector_match(b.to_vector(), y3.to_vector()));
+  }
+}
+
+TEST_F(TensorForwardTest, CheckInvalidBatchConcat) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_constant(Shape({2, 2}, 3), 0);
+    const Tensor b = dev->new_tensor_by_constant({2, 3}, 0);
+    EXPECT_THROW(batch::concat(vector<Tensor> {}), Error);
+    EXPECT_THROW(batch::concat({a, b}), Error);
+  }
+}
+
 TEST_F(TensorForwardTest, CheckSoftmaxCrossEntropy) {
   const vector<vector<float>> x_data {
     {-1, 0, 1, 1, 0, 0, 0, 0, 1},
@@ -2251,6 +2589,77 @@ TEST_F(TensorForwardTest, CheckInvalidSparseSoftmaxCrossEntropy) {
   }
 }
 
+TEST_F(TensorForwardTest, CheckMaskedSoftmaxCrossEntropy) {
+  struct TestCase {
+    vector<bool> mask;
+    Shape y_shape;
+    vector<float> y_data;
+  };
+  const vector<float> x_data {-1, 0, 1, 1, -1, 0, 0, 1, -1};
+  const vector<std::uint32_t> ids {0, 0, 0};
+  const vector<TestCase> test_cases {
+    {{true, true, true}, Shape({}, 3), {2.40760596, 0.40760596, 1.40760596}},
+    {{true, true, false}, Shape({}, 2), {2.40760596, 0.40760596}},
+    {{true, false, false}, {}, {2.40760596}},
+    {{false, true, true}, Shape({}, 2), {0.40760596, 1.40760596}},
+    {{true, false, true}, Shape({}, 2), {2.40760596, 1.40760596}},
+    {{false, false, true}, {}, {1.40760596}},
+  };
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_vector(Shape({3}, 3), x_data);
+    for (const TestCase &tc : test_cases) {
+      const Tensor y = masked_softmax_cross_entropy(x, ids, tc.mask, 0);
+      EXPECT_EQ(tc.y_shape, y.shape());
+      EXPECT_TRUE(vector_near(tc.y_data, y.to_vector(), 1e-6));
+    }
+  }
+}
+
+TEST_F(TensorForwardTest, CheckInvalidMaskedSoftmaxCrossEntropy) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(Shape({3}, 3), 0);
+    EXPECT_THROW(
+        masked_softmax_cross_entropy(x, {0, 0}, {true, true, true}, 0), Error);
+    EXPECT_THROW(
+        masked_softmax_cross_entropy(x, {0, 0, 0}, {true, true}, 0), Error);
+    EXPECT_THROW(
+        masked_softmax_cross_entropy(x, {0, 0, 0}, {false, false, false}, 0),
+        Error);
+  }
+}
+
+TEST_F(TensorForwardTest, CheckDropout) {
+  const Shape shape({50, 50}, 4);
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant(shape, 3);
+    for (const float rate : {0.f, .2f, .5f, .9f}) {
+      const vector<float> y_data = dropout(x, rate, true).to_vector();
+      const float kept = 3 / (1 - rate);
+      std::uint32_t num_kept = 0;
+      for (const float y : y_data) {
+        if (y != 0) {
+          EXPECT_FLOAT_EQ(kept, y);
+          ++num_kept;
+        }
+      }
+      EXPECT_NEAR(1 - rate, static_cast<float>(num_kept) / y_data.size(), .05);
+    }
+    const Tensor y1 = dropout(x, .5, false);
+    EXPECT_TRUE(vector_match(x.to_vector(), y1.to_vector()));
+    const Tensor y2 = dropout(x, 1, true);
+    EXPECT_EQ(shape, y2.shape());
+    EXPECT_TRUE(vector_match(vector<float>(shape.size(), 0), y2.to_vector()));
+  }
+}
+
+TEST_F(TensorForwardTest, CheckInvalidDropout) {
+  for (Device *dev : devices) {
+    const Tensor x = dev->new_tensor_by_constant({2, 2}, 1);
+    EXPECT_THROW(dropout(x, -.1, true), Error);
+    EXPECT_THROW(dropout(x, 1.1, true), Error);
+  }
+}
+
 TEST_F(TensorForwardTest, CheckStopGradient) {
   const vector<float> x_data {
     0, .5, 1, 2, 3, 4,
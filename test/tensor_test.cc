@@ -1,6 +1,7 @@
 #include <primitiv/config.h>
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <numeric>
 #include <random>
@@ -723,4 +724,115 @@ TEST_F(TensorTest, CheckArgMinLarge) {
   }
 }
 
+TEST_F(TensorTest, CheckTopKDims) {
+  const vector<float> data = {
+    3, 4, 5, 0, 1, 2, 6, 7, 8, 0, -1, -2, -6, -7, -8, -3, -4, -5,
+  };
+  const vector<vector<std::uint32_t>> expected_ids = {
+    {2, 1, 2, 1, 2, 1, 0, 1, 0, 1, 0, 1},
+    {2, 0, 2, 0, 2, 0, 0, 2, 0, 2, 0, 2},
+  };
+  const vector<vector<float>> expected_values = {
+    {5, 4, 2, 1, 8, 7, 0, -1, -6, -7, -3, -4},
+    {6, 3, 7, 4, 8, 5, 0, -3, -1, -4, -2, -5},
+  };
+
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector(Shape({3, 3}, 2), data);
+    for (const std::uint32_t i : {0u, 1u}) {
+      vector<float> values;
+      EXPECT_TRUE(vector_match(expected_ids[i], a.topk(i, 2, values)));
+      EXPECT_TRUE(vector_match(expected_values[i], values));
+      EXPECT_TRUE(vector_match(expected_ids[i], a.topk(i, 2)));
+    }
+    EXPECT_TRUE(vector_match(vector<std::uint32_t>(18, 0), a.topk(2, 1)));
+  }
+}
+
+TEST_F(TensorTest, CheckTopKTies) {
+  const vector<float> data = {1, 3, 2, 3, 1, 2};
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({6}, data);
+    vector<float> values;
+    EXPECT_TRUE(vector_match(
+          vector<std::uint32_t> {1, 3, 2, 5, 0, 4}, a.topk(0, 6, values)));
+    EXPECT_TRUE(vector_match(vector<float> {3, 3, 2, 2, 1, 1}, values));
+  }
+}
+
+TEST_F(TensorTest, CheckTopKLarge) {
+  std::mt19937 rng;
+  const vector<std::uint32_t> ns {
+    3, 15, 16, 17, 255, 256, 257, 1023, 1024, 1025, 65535, 65536, 65537,
+  };
+
+  for (Device *dev : devices) {
+    for (const std::uint32_t n : ns) {
+      vector<float> data(n);
+      std::iota(begin(data), end(data), 0);
+      std::shuffle(begin(data), end(data), rng);
+      vector<std::uint32_t> expected(3);
+      for (std::uint32_t j = 0; j < 3; ++j) {
+        const auto it = std::find(begin(data), end(data), n - 1 - j);
+        expected[j] = std::distance(begin(data), it);
+      }
+      const Tensor a = dev->new_tensor_by_vector({n}, data);
+      EXPECT_TRUE(vector_match(expected, a.topk(0, 3)));
+    }
+  }
+}
+
+TEST_F(TensorTest, CheckInvalidTopK) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_constant({3, 3}, 0);
+    EXPECT_THROW(a.topk(0, 0), Error);
+    EXPECT_THROW(a.topk(0, 4), Error);
+    EXPECT_THROW(a.topk(2, 2), Error);
+    EXPECT_THROW(a.sample(0, 0), Error);
+    EXPECT_THROW(a.sample(1, 4), Error);
+  }
+}
+
+TEST_F(TensorTest, CheckSample) {
+  const vector<float> data = {0, 0, 100, 0, 100, 0, 100, 0, 0};
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector({3, 3}, data);
+    for (std::uint32_t t = 0; t < 10; ++t) {
+      EXPECT_TRUE(vector_match(vector<std::uint32_t> {2, 1, 0}, a.sample(0)));
+    }
+  }
+}
+
+TEST_F(TensorTest, CheckSamplePermutation) {
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_constant(Shape({5}, 4), 0);
+    vector<std::uint32_t> ids = a.sample(0, 5);
+    ASSERT_EQ(20u, ids.size());
+    for (std::uint32_t b = 0; b < 4; ++b) {
+      std::sort(ids.begin() + 5 * b, ids.begin() + 5 * (b + 1));
+      for (std::uint32_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(i, ids[5 * b + i]);
+      }
+    }
+  }
+}
+
+TEST_F(TensorTest, CheckSampleDistribution) {
+  // p = softmax(log([1, 2, 3, 4])) = [.1, .2, .3, .4]
+  const std::uint32_t N = 10000;
+  const vector<float> probs = {.1, .2, .3, .4};
+  vector<float> data;
+  for (std::uint32_t n = 0; n < N; ++n) {
+    for (const float p : probs) data.emplace_back(std::log(p));
+  }
+  for (Device *dev : devices) {
+    const Tensor a = dev->new_tensor_by_vector(Shape({4}, N), data);
+    vector<std::uint32_t> counts(4, 0);
+    for (const std::uint32_t id : a.sample(0)) ++counts[id];
+    for (std::uint32_t i = 0; i < 4; ++i) {
+      EXPECT_NEAR(probs[i], static_cast<float>(counts[i]) / N, .02);
+    }
+  }
+}
+
 }  // namespace primitiv
@@ -1,6 +1,7 @@
 #include <primitiv/config.h>
 
 #include <iostream>
+#include <random>
 #include <vector>
 
 #include <primitiv/error.h>
@@ -11,7 +12,9 @@ using primitiv::devices::Naive;
 
 #ifdef PRIMITIV_USE_EIGEN
 #include <primitiv/eigen_device.h>
+#include <primitiv/hybrid_device.h>
 using primitiv::devices::Eigen;
+using primitiv::devices::Hybrid;
 #endif  // PRIMITIV_USE_EIGEN
 
 #ifdef PRIMITIV_USE_CUDA
@@ -38,6 +41,7 @@ namespace test_utils {
 void add_available_devices(std::vector<primitiv::Device *> &devs) {
   add_available_naive_devices(devs);
   add_available_eigen_devices(devs);
+  add_available_hybrid_devices(devs);
   add_available_cuda_devices(devs);
   add_available_opencl_devices(devs);
 }
@@ -55,6 +59,14 @@ void add_available_eigen_devices(std::vector<primitiv::Device *> &devs) {
 #endif  // PRIMITIV_USE_EIGEN
 }
 
+void add_available_hybrid_devices(std::vector<primitiv::Device *> &devs) {
+#ifdef PRIMITIV_USE_EIGEN
+  // Uses at least 2 threads to test the multithreaded implementations.
+  ::add_device(devs, new Hybrid(std::random_device()(), 2));
+  ::add_device(devs, new Hybrid());
+#endif  // PRIMITIV_USE_EIGEN
+}
+
 void add_available_cuda_devices(std::vector<primitiv::Device *> &devs) {
 #ifdef PRIMITIV_USE_CUDA
   const std::uint32_t num_devs = CUDA::num_devices();